@@ -113,6 +113,7 @@ option (ALIMER_D3D12 "Enable D3D12 backend" ${ALIMER_D3D12_DEFAULT})
 option (ALIMER_GLFW "Enable GLFW support" ${ALIMER_GLFW_DEFAULT})
 option (ALIMER_CSHARP "Enable C# support" ${ALIMER_CSHARP_DEFAULT})
 option (ALIMER_THREADING "Enable multithreading" ${ALIMER_THREADS_DEFAULT})
+option (ALIMER_AVX2 "Enable AVX2 SIMD paths, binaries require an AVX2 capable CPU" OFF)
 option (ALIMER_SHADER_COMPILER "Enable ShaderCompiler" ${ALIMER_SHADER_COMPILER_DEFAULT})
 option (ALIMER_TOOLS "Enable Tools" ${ALIMER_TOOLS_DEFAULT})
 
@@ -44,6 +44,11 @@
 #include "Math/Vector4.h"
 #include "Math/Quaternion.h"
 #include "Math/Matrix4x4.h"
+#include "Math/Plane.h"
+#include "Math/BoundingBox.h"
+#include "Math/Sphere.h"
+#include "Math/Frustum.h"
+#include "Math/Ray.h"
 #include "Math/Color.h"
 
 // Graphics
@@ -62,16 +62,25 @@ namespace Alimer
     bool Application::InitializeBeforeRun()
     {
         SetCurrentThreadName("Main");
+        _jobs.reset(new JobSystem(_settings.workerThreads));
 
         ALIMER_LOGINFO("Initializing engine {}...", ALIMER_VERSION_STR);
 
-        // Init Window and Gpu.
+        // Init Window and Gpu, headless with CPU graphics still runs the whole render path without window.
+        const bool cpuGraphics = _settings.graphicsDeviceType == GraphicsDeviceType::Empty
+            || _settings.graphicsDeviceType == GraphicsDeviceType::Software;
         if (!_headless)
         {
             _window = MakeWindow("Alimer", 800, 600);
+        }
 
+        if (!_headless || cpuGraphics)
+        {
             // Create and init graphics.
             _graphics = Graphics::Create(_settings.graphicsDeviceType, _settings.validation);
+            _graphics->SetMaxFramesInFlight(_settings.maxFramesInFlight);
+            _graphics->SetAsyncPipelineCompilation(_settings.asyncPipelineCompilation);
+            _graphics->SetBindlessResources(_settings.bindlessResources);
             GpuAdapter* adapter = nullptr;
             if (!_graphics->Initialize(adapter, _window))
             {
@@ -102,9 +111,6 @@ namespace Alimer
         // Run the first time an update
         //InternalUpdate();
 
-        // 
-        _graphics->SaveScreenshot("Test.png");
-
         return true;
     }
 
@@ -138,7 +144,7 @@ namespace Alimer
 
     void Application::RenderFrame(double frameTime, double elapsedTime)
     {
-        if (_headless)
+        if (!_graphics)
             return;
 
         if (_graphics->BeginFrame())
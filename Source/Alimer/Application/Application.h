@@ -33,6 +33,7 @@
 #include "../Core/Object.h"
 #include "../Core/Log.h"
 #include "../Core/Timer.h"
+#include "../Core/JobSystem.h"
 #include "../Core/PluginManager.h"
 #include "../Application/Window.h"
 #include "../Serialization/Serializable.h"
@@ -50,6 +51,18 @@ namespace Alimer
     public:
         GraphicsDeviceType graphicsDeviceType = GraphicsDeviceType::Default;
 
+        /// Number of job system worker threads, 0 uses one per hardware thread.
+        uint32_t workerThreads = 0;
+
+        /// Number of frames the CPU can record ahead of the GPU.
+        uint32_t maxFramesInFlight = 2;
+
+        /// Compile pipelines on worker threads, draws using a pipeline still compiling are skipped.
+        bool asyncPipelineCompilation = true;
+
+        /// Index textures and storage buffers from a global descriptor heap, falls back to descriptor sets when unsupported.
+        bool bindlessResources = false;
+
 #ifdef _DEBUG
         bool validation = true;
 #else
@@ -132,6 +145,7 @@ namespace Alimer
         ApplicationSettings _settings;
 
         std::unique_ptr<Logger> _log;
+        std::unique_ptr<JobSystem> _jobs;
         Timer _timer;
         ResourceManager _resources;
         WindowPtr _window;
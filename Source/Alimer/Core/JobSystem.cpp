@@ -0,0 +1,438 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Core/JobSystem.h"
+#include "../Core/Platform.h"
+#include <string>
+
+namespace Alimer
+{
+    /// Size of a cache line, members written by different threads are padded apart to avoid false sharing.
+    /// Padding is used instead of alignas so plain new does not need over-aligned allocation.
+    static constexpr size_t CacheLineSize = 64;
+
+    /// Chase-Lev deque, owner pushes and pops at the bottom while other threads steal from the top.
+    class WorkStealingQueue final
+    {
+    public:
+        static constexpr int64_t Capacity = 4096;
+        static constexpr int64_t Mask = Capacity - 1;
+
+        WorkStealingQueue()
+            : _top(0)
+            , _bottom(0)
+        {
+            for (auto& job : _jobs)
+            {
+                job.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        bool Push(Job* job)
+        {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+            const int64_t top = _top.load(std::memory_order_acquire);
+            if (bottom - top >= Capacity)
+                return false;
+
+            _jobs[bottom & Mask].store(job, std::memory_order_relaxed);
+            _bottom.store(bottom + 1, std::memory_order_release);
+            return true;
+        }
+
+        Job* Pop()
+        {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            _bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = _top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                // Empty.
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Job* job = _jobs[bottom & Mask].load(std::memory_order_relaxed);
+            if (top == bottom)
+            {
+                // Last element, race against thieves.
+                if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    job = nullptr;
+                }
+
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return job;
+        }
+
+        Job* Steal()
+        {
+            int64_t top = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = _bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+                return nullptr;
+
+            Job* job = _jobs[top & Mask].load(std::memory_order_relaxed);
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return job;
+        }
+
+    private:
+        std::atomic<int64_t> _top;
+        uint8_t _topPadding[CacheLineSize - sizeof(std::atomic<int64_t>)];
+        std::atomic<int64_t> _bottom;
+        uint8_t _bottomPadding[CacheLineSize - sizeof(std::atomic<int64_t>)];
+        std::atomic<Job*> _jobs[Capacity];
+    };
+
+    /// Free list of jobs owned by one thread, other threads give jobs back through an atomic list.
+    class JobPool final
+    {
+    public:
+        static constexpr uint32_t BlockSize = 256;
+
+        explicit JobPool(uint32_t index)
+            : _index(index)
+            , _remoteFree(nullptr)
+        {
+        }
+
+        /// Allocate job, called by the owning thread only.
+        Job* Allocate()
+        {
+            if (_free == nullptr)
+            {
+                _free = _remoteFree.exchange(nullptr, std::memory_order_acquire);
+            }
+
+            if (_free == nullptr)
+            {
+                _blocks.emplace_back(new Job[BlockSize]);
+                Job* block = _blocks.back().get();
+                for (uint32_t i = 0; i < BlockSize; ++i)
+                {
+                    block[i].next = i + 1 < BlockSize ? &block[i + 1] : nullptr;
+                    block[i].pool = _index;
+                }
+
+                _free = block;
+            }
+
+            Job* job = _free;
+            _free = job->next;
+            return job;
+        }
+
+        /// Return job allocated by this pool, called by the owning thread only.
+        void Free(Job* job)
+        {
+            job->next = _free;
+            _free = job;
+        }
+
+        /// Return job allocated by this pool from any other thread.
+        void FreeRemote(Job* job)
+        {
+            Job* head = _remoteFree.load(std::memory_order_relaxed);
+            do
+            {
+                job->next = head;
+            } while (!_remoteFree.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+    private:
+        uint32_t _index;
+        Job* _free = nullptr;
+        uint8_t _freePadding[CacheLineSize];
+        std::atomic<Job*> _remoteFree;
+        std::vector<std::unique_ptr<Job[]>> _blocks;
+    };
+
+    static JobSystem* __jobSystemInstance = nullptr;
+
+    /// Queue index of the current thread, main thread owns queue 0 and workers the following ones.
+    static thread_local uint32_t __queueIndex = ~0u;
+
+    JobSystem::JobSystem(uint32_t workerCount)
+        : _queuedJobs(0)
+        , _sleepingWorkers(0)
+        , _shutdown(false)
+    {
+#if ALIMER_THREADING
+        if (workerCount == 0)
+        {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+#else
+        workerCount = 0;
+#endif
+
+        _queues.resize(workerCount + 1);
+        _pools.resize(workerCount + 1);
+        for (uint32_t i = 0; i < workerCount + 1; ++i)
+        {
+            _queues[i].reset(new WorkStealingQueue());
+            _pools[i].reset(new JobPool(i));
+        }
+
+        __queueIndex = 0;
+        __jobSystemInstance = this;
+
+        _workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            _workers.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _shutdown = true;
+        }
+
+        _sleepCondition.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+
+        __queueIndex = ~0u;
+        __jobSystemInstance = nullptr;
+    }
+
+    JobSystem* JobSystem::GetInstance()
+    {
+        return __jobSystemInstance;
+    }
+
+    Job* JobSystem::AllocateJob()
+    {
+        const uint32_t index = __queueIndex;
+        if (index < _pools.size())
+            return _pools[index]->Allocate();
+
+        Job* job = new Job();
+        job->pool = ~0u;
+        return job;
+    }
+
+    void JobSystem::FreeJob(Job* job)
+    {
+        if (job->pool == __queueIndex)
+        {
+            _pools[job->pool]->Free(job);
+        }
+        else if (job->pool < _pools.size())
+        {
+            _pools[job->pool]->FreeRemote(job);
+        }
+        else
+        {
+            delete job;
+        }
+    }
+
+    void JobSystem::Submit(Job* job, JobCounter* counter, JobCounter* dependency)
+    {
+        if (counter)
+        {
+            counter->_value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        job->counter = counter;
+
+        if (dependency)
+        {
+            std::lock_guard<std::mutex> lock(dependency->_continuationsMutex);
+            if (!dependency->IsDone())
+            {
+                dependency->_continuations.push_back(job);
+                return;
+            }
+        }
+
+        Push(job);
+    }
+
+    void JobSystem::Push(Job* job)
+    {
+        if (_workers.empty())
+        {
+            Execute(job);
+            return;
+        }
+
+        _queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+        if (__queueIndex >= _queues.size()
+            || !_queues[__queueIndex]->Push(job))
+        {
+            std::lock_guard<std::mutex> lock(_globalJobsMutex);
+            _globalJobs.push_back(job);
+        }
+
+        if (_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _sleepCondition.notify_one();
+        }
+    }
+
+    Job* JobSystem::FindJob()
+    {
+        const uint32_t queueCount = static_cast<uint32_t>(_queues.size());
+        const uint32_t index = __queueIndex;
+
+        Job* job = nullptr;
+        if (index < queueCount)
+        {
+            job = _queues[index]->Pop();
+        }
+
+        if (job == nullptr)
+        {
+            // Steal starting from the next queue to spread contention among victims.
+            const uint32_t start = index < queueCount ? index + 1 : 0;
+            for (uint32_t i = 0; i < queueCount && job == nullptr; ++i)
+            {
+                const uint32_t victim = (start + i) % queueCount;
+                if (victim != index)
+                {
+                    job = _queues[victim]->Steal();
+                }
+            }
+        }
+
+        if (job == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(_globalJobsMutex);
+            if (!_globalJobs.empty())
+            {
+                job = _globalJobs.front();
+                _globalJobs.pop_front();
+            }
+        }
+
+        if (job != nullptr)
+        {
+            _queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        return job;
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        job->invoke(job);
+        JobCounter* counter = job->counter;
+        FreeJob(job);
+
+        if (counter)
+        {
+            Finish(counter);
+        }
+    }
+
+    void JobSystem::Finish(JobCounter* counter)
+    {
+        uint32_t value = counter->_value.load(std::memory_order_relaxed);
+        while (value > 1)
+        {
+            if (counter->_value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return;
+        }
+
+        // Reach zero under the lock, Schedule checks the value under the same lock and Wait acquires it before returning.
+        std::vector<Job*> continuations;
+        {
+            std::lock_guard<std::mutex> lock(counter->_continuationsMutex);
+            if (counter->_value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+
+            continuations.swap(counter->_continuations);
+        }
+
+        for (Job* continuation : continuations)
+        {
+            Push(continuation);
+        }
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            Job* job = FindJob();
+            if (job)
+            {
+                Execute(job);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // Finishing thread may still hold the lock, counter can't be released before that.
+        std::lock_guard<std::mutex> lock(counter._continuationsMutex);
+    }
+
+    void JobSystem::WorkerMain(uint32_t index)
+    {
+        std::string name = "Worker " + std::to_string(index);
+        SetCurrentThreadName(name.c_str());
+        __queueIndex = index;
+
+        while (!_shutdown.load(std::memory_order_relaxed))
+        {
+            Job* job = FindJob();
+            if (job)
+            {
+                Execute(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            _sleepCondition.wait(lock, [this]
+            {
+                return _shutdown.load(std::memory_order_relaxed) || _queuedJobs.load(std::memory_order_seq_cst) > 0;
+            });
+            _sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    JobSystem& gJobSystem()
+    {
+        return *__jobSystemInstance;
+    }
+}
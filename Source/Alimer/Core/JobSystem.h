@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../AlimerConfig.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Alimer
+{
+    class JobCounter;
+    class WorkStealingQueue;
+    class JobPool;
+
+    /// Unit of work executed by JobSystem, the callable is stored inline when it fits.
+    struct Job
+    {
+        /// Bytes available for the callable and its captures.
+        static constexpr size_t StorageSize = 96;
+
+        /// Run the callable and destroy it.
+        void (*invoke)(Job* job);
+        JobCounter* counter;
+        /// Next job in the pool free list.
+        Job* next;
+        /// Pool the job returns to, ~0u for jobs allocated on threads without pool.
+        uint32_t pool;
+        alignas(std::max_align_t) uint8_t storage[StorageSize];
+    };
+
+    /// Counts unfinished jobs, used to wait for jobs and to express dependencies between them.
+    class ALIMER_API JobCounter final
+    {
+        friend class JobSystem;
+
+    public:
+        /// Constructor.
+        JobCounter() : _value(0) {}
+
+        /// Return number of unfinished jobs.
+        uint32_t GetValue() const { return _value.load(std::memory_order_acquire); }
+
+        /// Return true if all jobs have finished.
+        bool IsDone() const { return GetValue() == 0; }
+
+    private:
+        std::atomic<uint32_t> _value;
+        std::mutex _continuationsMutex;
+        std::vector<Job*> _continuations;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(JobCounter);
+    };
+
+    /// Work stealing pool of worker threads, each worker owns a deque and steals from others when idle.
+    class ALIMER_API JobSystem final
+    {
+    public:
+        /// Constructor, when workerCount is 0 one worker per hardware thread (minus the main thread) is created.
+        JobSystem(uint32_t workerCount = 0);
+
+        /// Destructor, waits for worker threads to finish.
+        ~JobSystem();
+
+        /// Return the single instance of the JobSystem or nullptr if not created.
+        static JobSystem* GetInstance();
+
+        /// Schedule function for execution, counter is incremented until it finishes and it starts only after dependency reaches zero.
+        template <typename Func>
+        void Schedule(Func&& function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+        /// Wait for counter to reach zero, executing pending jobs on the calling thread meanwhile.
+        void Wait(JobCounter& counter);
+
+        /// Call func(index) for every index in [0, count) in batches of batchSize, 0 picks batch size from worker count.
+        template <typename Func>
+        void ParallelFor(uint32_t count, uint32_t batchSize, Func&& func);
+
+        /// Return number of worker threads.
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(_workers.size()); }
+
+    private:
+        /// Callables fitting the job storage are stored inline, selected at compile time so only one path is instantiated.
+        template <typename Func>
+        using FitsJobStorage = std::integral_constant<bool,
+            sizeof(Func) <= Job::StorageSize && alignof(Func) <= alignof(std::max_align_t)>;
+
+        template <typename FunctionType, typename Func>
+        static void StoreFunction(Job* job, Func&& function, std::true_type)
+        {
+            new (job->storage) FunctionType(std::forward<Func>(function));
+            job->invoke = &InvokeInline<FunctionType>;
+        }
+
+        template <typename FunctionType, typename Func>
+        static void StoreFunction(Job* job, Func&& function, std::false_type)
+        {
+            // Large captures fall back to the heap.
+            *reinterpret_cast<FunctionType**>(job->storage) = new FunctionType(std::forward<Func>(function));
+            job->invoke = &InvokeHeap<FunctionType>;
+        }
+
+        template <typename Func>
+        static void InvokeInline(Job* job)
+        {
+            Func* function = reinterpret_cast<Func*>(job->storage);
+            (*function)();
+            function->~Func();
+        }
+
+        template <typename Func>
+        static void InvokeHeap(Job* job)
+        {
+            Func* function = *reinterpret_cast<Func**>(job->storage);
+            (*function)();
+            delete function;
+        }
+
+        Job* AllocateJob();
+        void FreeJob(Job* job);
+        void Submit(Job* job, JobCounter* counter, JobCounter* dependency);
+        void WorkerMain(uint32_t index);
+        void Push(Job* job);
+        Job* FindJob();
+        void Execute(Job* job);
+        void Finish(JobCounter* counter);
+
+        std::vector<std::thread> _workers;
+        std::vector<std::unique_ptr<WorkStealingQueue>> _queues;
+        /// Job pools indexed like queues, jobs are allocated from the pool of the scheduling thread.
+        std::vector<std::unique_ptr<JobPool>> _pools;
+        /// Jobs submitted by threads not owning a queue or overflowing their own.
+        std::deque<Job*> _globalJobs;
+        std::mutex _globalJobsMutex;
+        std::atomic<uint32_t> _queuedJobs;
+        std::atomic<uint32_t> _sleepingWorkers;
+        std::mutex _sleepMutex;
+        std::condition_variable _sleepCondition;
+        std::atomic<bool> _shutdown;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(JobSystem);
+    };
+
+    template <typename Func>
+    void JobSystem::Schedule(Func&& function, JobCounter* counter, JobCounter* dependency)
+    {
+        using FunctionType = typename std::decay<Func>::type;
+
+        Job* job = AllocateJob();
+        StoreFunction<FunctionType>(job, std::forward<Func>(function), FitsJobStorage<FunctionType>());
+        Submit(job, counter, dependency);
+    }
+
+    template <typename Func>
+    void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, Func&& func)
+    {
+        if (count == 0)
+            return;
+
+        if (batchSize == 0)
+        {
+            // Few batches per thread leave room for stealing without flooding the queues.
+            const uint32_t batchCount = (GetWorkerCount() + 1) * 4;
+            batchSize = count > batchCount ? (count + batchCount - 1) / batchCount : 1;
+        }
+
+        JobCounter counter;
+        for (uint32_t start = 0; start < count; start += batchSize)
+        {
+            const uint32_t end = count - start > batchSize ? start + batchSize : count;
+            Schedule([&func, start, end]()
+            {
+                for (uint32_t i = start; i < end; ++i)
+                {
+                    func(i);
+                }
+            }, &counter);
+        }
+
+        Wait(counter);
+    }
+
+    /// Access to JobSystem module.
+    ALIMER_API JobSystem& gJobSystem();
+}
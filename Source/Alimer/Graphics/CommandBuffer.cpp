@@ -24,6 +24,7 @@
 #include "Graphics/Graphics.h"
 #include "../Core/Log.h"
 #include "../Math/MathUtil.h"
+#include <algorithm>
 
 namespace Alimer
 {
@@ -34,132 +35,102 @@ namespace Alimer
 
     CommandBuffer::~CommandBuffer()
     {
-        Clear();
+        CommandPage* page = _firstPage;
+        while (page)
+        {
+            CommandPage* next = page->next;
+            delete[] reinterpret_cast<uint8_t*>(page);
+            page = next;
+        }
     }
 
     void CommandBuffer::Clear()
     {
-        if (_buffer)
+        _state = CommandBufferState::Ready;
+        Rewind();
+    }
+
+    void CommandBuffer::Rewind()
+    {
+        for (CommandPage* page = _firstPage; page; page = page->next)
         {
-            DeleteCommands();
-            delete[] _buffer;
+            page->size = 0;
         }
 
-        _state = CommandBufferState::Ready;
-        _buffer = nullptr;
-        _capacity = 0;
-        _size = 0;
-        _position = 0;
+        _writePage = _firstPage;
+        _readPage = _firstPage;
+        _readOffset = 0;
         _count = 0;
         _current = 0;
     }
 
-    Command* CommandBuffer::Front() const
+    uint8_t* CommandBuffer::Allocate(size_t size)
     {
-        if (_current >= _count) return nullptr;
+        if (!_writePage || _writePage->size + size > _writePage->capacity)
+        {
+            // Continue in the next recycled page when large enough, otherwise chain a new one after the write page.
+            CommandPage* next = _writePage ? _writePage->next : _firstPage;
+            if (!next || next->capacity < size)
+            {
+                const size_t capacity = std::max(size, static_cast<size_t>(CommandPageSize));
+                CommandPage* page = reinterpret_cast<CommandPage*>(new uint8_t[AlignCommandSize(sizeof(CommandPage)) + capacity]);
+                page->next = next;
+                page->capacity = capacity;
+                page->size = 0;
+
+                if (_writePage)
+                {
+                    _writePage->next = page;
+                }
+                else
+                {
+                    _firstPage = page;
+                    _readPage = page;
+                }
+
+                next = page;
+            }
 
-        size_t offset = _position;
-        if (offset % CommandAlign != 0)
-            offset += CommandAlign - (offset % CommandAlign);
+            _writePage = next;
+        }
 
-        Command* command = reinterpret_cast<Command*>(_buffer + offset);
-        return command;
+        uint8_t* data = GetPageData(_writePage) + _writePage->size;
+        _writePage->size += size;
+        return data;
     }
 
-    void CommandBuffer::Pop()
+    Command* CommandBuffer::Front() const
     {
-        if (_current >= _count) return;
-
-        if (_position % CommandAlign != 0)
-            _position += CommandAlign - (_position % CommandAlign);
-
-        Command* command = reinterpret_cast<Command*>(_buffer + _position);
+        if (_current >= _count) return nullptr;
 
-        switch (command->type)
+        CommandPage* page = _readPage;
+        size_t offset = _readOffset;
+        while (offset >= page->size)
         {
-        case Command::Type::BeginRenderPass:
-            _position += DeleteCommand(static_cast<BeginRenderPassCommand*>(command));
-            break;
-
-        case Command::Type::EndRenderPass:
-            _position += DeleteCommand(static_cast<EndRenderPassCommand*>(command));
-            break;
-
-        case Command::Type::SetViewport:
-            _position += DeleteCommand(static_cast<SetViewportCommand*>(command));
-            break;
-
-        default: break;
+            page = page->next;
+            offset = 0;
         }
 
-        ++_current;
-
-        if (_current == _count)
-        {
-            _count = 0;
-            _size = 0;
-            _position = 0;
-            _current = 0;
-        }
+        return reinterpret_cast<Command*>(GetPageData(page) + offset);
     }
 
-    void CommandBuffer::MoveCommands(uint8_t* newBuffer)
+    void CommandBuffer::Pop()
     {
-        size_t offset = _position;
+        if (_current >= _count) return;
 
-        for (uint32_t i = _current; i < _count; ++i)
+        while (_readOffset >= _readPage->size)
         {
-            if (offset % CommandAlign != 0)
-                offset += CommandAlign - (offset % CommandAlign);
-
-            Command* command = reinterpret_cast<Command*>(_buffer + offset);
-
-            switch (command->type)
-            {
-            case Command::Type::BeginRenderPass:
-                offset += MoveCommand(static_cast<BeginRenderPassCommand*>(command), newBuffer + offset);
-                break;
-
-            case Command::Type::EndRenderPass:
-                offset += MoveCommand(static_cast<EndRenderPassCommand*>(command), newBuffer + offset);
-                break;
-
-            case Command::Type::SetViewport:
-                offset += MoveCommand(static_cast<SetViewportCommand*>(command), newBuffer + offset);
-                break;
-
-            default: assert(false);
-            }
+            _readPage = _readPage->next;
+            _readOffset = 0;
         }
-    }
 
-    void CommandBuffer::DeleteCommands()
-    {
-        size_t offset = _position;
+        const Command* command = reinterpret_cast<const Command*>(GetPageData(_readPage) + _readOffset);
+        _readOffset += command->size;
+        ++_current;
 
-        for (uint32_t i = _current; i < _count; ++i)
+        if (_current == _count)
         {
-            if (offset % CommandAlign != 0)
-                offset += CommandAlign - (offset % CommandAlign);
-
-            Command* command = reinterpret_cast<Command*>(_buffer + offset);
-
-            switch (command->type)
-            {
-            case Command::Type::BeginRenderPass:
-                offset += DeleteCommand(static_cast<BeginRenderPassCommand*>(command));
-                break;
-
-            case Command::Type::EndRenderPass:
-                offset += DeleteCommand(static_cast<EndRenderPassCommand*>(command));
-                break;
-
-            case Command::Type::SetViewport:
-                offset += DeleteCommand(static_cast<SetViewportCommand*>(command));
-                break;
-
-            default: assert(false);
-            }
+            Rewind();
         }
     }
 
@@ -215,12 +186,17 @@ namespace Alimer
 
     void CommandBuffer::SetViewports(uint32_t numViewports, const Viewport* viewports)
     {
-        Push(SetViewportsCommand(numViewports, viewports));
+        Push(SetViewportsCommand(numViewports), viewports, numViewports * sizeof(Viewport));
     }
 
     void CommandBuffer::SetScissor(const Rectangle& scissor)
     {
-        //SetScissors(1, &scissor);
+        SetScissors(1, &scissor);
+    }
+
+    void CommandBuffer::SetScissors(uint32_t numScissors, const Rectangle* scissors)
+    {
+        Push(SetScissorsCommand(numScissors), scissors, numScissors * sizeof(Rectangle));
     }
 
     void CommandBuffer::SetShader(Shader* shader)
@@ -231,6 +207,19 @@ namespace Alimer
 
     void CommandBuffer::SetShaderCore(Shader* shader)
     {
+        Push(SetShaderCommand(shader));
+    }
+
+    void CommandBuffer::SetPipelineState(PipelineState* pipelineState)
+    {
+        ALIMER_ASSERT(pipelineState);
+        ALIMER_ASSERT(pipelineState->IsGraphics());
+        SetPipelineStateCore(pipelineState);
+    }
+
+    void CommandBuffer::SetPipelineStateCore(PipelineState* pipelineState)
+    {
+        Push(SetPipelineStateCommand(pipelineState));
     }
 
     void CommandBuffer::SetVertexBuffer(uint32_t binding, VertexBuffer* buffer, uint64_t offset, VertexInputRate inputRate)
@@ -243,7 +232,7 @@ namespace Alimer
 
     void CommandBuffer::SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t stride, VertexInputRate inputRate)
     {
-
+        Push(SetVertexBufferCommand(binding, buffer, offset, stride, inputRate));
     }
 
     void CommandBuffer::SetIndexBuffer(GpuBuffer* buffer, uint32_t offset)
@@ -256,7 +245,7 @@ namespace Alimer
 
     void CommandBuffer::SetIndexBufferCore(GpuBuffer* buffer, uint32_t offset, IndexType indexType)
     {
-
+        Push(SetIndexBufferCommand(buffer, offset, indexType));
     }
 
     void CommandBuffer::SetUniformBuffer(uint32_t set, uint32_t binding, GpuBuffer* buffer)
@@ -269,8 +258,31 @@ namespace Alimer
         SetUniformBufferCore(set, binding, buffer, 0, buffer->GetSize());
     }
 
+    void CommandBuffer::SetUniformBuffer(uint32_t set, uint32_t binding, const TransientAllocation& allocation, uint64_t range)
+    {
+        ALIMER_ASSERT(set < MaxDescriptorSets);
+        ALIMER_ASSERT(binding < MaxBindingsPerSet);
+        ALIMER_ASSERT(allocation.buffer);
+        ALIMER_ASSERT(allocation.offset + range <= allocation.buffer->GetSize());
+
+        SetUniformBufferCore(set, binding, allocation.buffer, allocation.offset, range);
+    }
+
     void CommandBuffer::SetUniformBufferCore(uint32_t set, uint32_t binding, GpuBuffer* buffer, uint64_t offset, uint64_t range)
     {
+        Push(SetUniformBufferCommand(set, binding, buffer, offset, range));
+    }
+
+    TransientAllocation CommandBuffer::AllocateUniform(uint64_t size)
+    {
+        ALIMER_ASSERT(size > 0);
+        return AllocateUniformCore(size);
+    }
+
+    TransientAllocation CommandBuffer::AllocateUniformCore(uint64_t size)
+    {
+        ALIMER_LOGERROR("Transient uniform allocation is not supported by the graphics backend");
+        return {};
     }
 
     void CommandBuffer::SetTexture(uint32_t binding, Texture* texture, ShaderStageFlags stage)
@@ -281,7 +293,19 @@ namespace Alimer
 
     void CommandBuffer::SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags stage)
     {
+        Push(SetTextureCommand(binding, texture, stage));
+    }
 
+    void CommandBuffer::PushConstants(const void* data, uint32_t size, uint32_t offset)
+    {
+        ALIMER_ASSERT(data != nullptr);
+        ALIMER_ASSERT(offset + size <= MaxPushConstantSize);
+        PushConstantsCore(data, size, offset);
+    }
+
+    void CommandBuffer::PushConstantsCore(const void* data, uint32_t size, uint32_t offset)
+    {
+        Push(PushConstantsCommand(size, offset), data, size);
     }
 
     void CommandBuffer::Draw(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance)
@@ -304,9 +328,14 @@ namespace Alimer
         DrawIndexedCore(topology, indexCount, instanceCount, startIndex);
     }
 
-    void CommandBuffer::DrawIndexedCore(PrimitiveTopology topology, uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex)
+    void CommandBuffer::DrawCore(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance)
     {
+        Push(DrawCommand(topology, vertexCount, instanceCount, vertexStart, baseInstance));
+    }
 
+    void CommandBuffer::DrawIndexedCore(PrimitiveTopology topology, uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex)
+    {
+        Push(DrawIndexedCommand(topology, indexCount, instanceCount, startIndex));
     }
 
     void CommandBuffer::ExecuteCommands(uint32_t commandBufferCount, CommandBuffer* const* commandBuffers)
@@ -319,7 +348,7 @@ namespace Alimer
 
     void CommandBuffer::BeginRenderPassCore(RenderPass* renderPass, const Rectangle& renderArea, const Color* clearColors, uint32_t numClearColors, float clearDepth, uint8_t clearStencil)
     {
-        Push(BeginRenderPassCommand(renderPass, renderArea, clearColors, numClearColors, clearDepth, clearStencil));
+        Push(BeginRenderPassCommand(renderPass, renderArea, numClearColors, clearDepth, clearStencil), clearColors, numClearColors * sizeof(Color));
     }
 
     void CommandBuffer::EndRenderPassCore()
@@ -329,6 +358,6 @@ namespace Alimer
 
     void CommandBuffer::ExecuteCommandsCore(uint32_t commandBufferCount, CommandBuffer* const* commandBuffers)
     {
-
+        Push(ExecuteCommandsCommand(commandBufferCount), commandBuffers, commandBufferCount * sizeof(CommandBuffer*));
     }
 }
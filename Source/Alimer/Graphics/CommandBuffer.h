@@ -31,6 +31,8 @@
 #include "../Graphics/PipelineState.h"
 #include "../Math/Math.h"
 #include "../Math/Color.h"
+#include <cstring>
+#include <type_traits>
 
 namespace Alimer
 {
@@ -39,23 +41,36 @@ namespace Alimer
     /// Defines the type of CommandBuffer.
     enum class CommandBufferType : uint8_t
     {
-        Default
+        Default,
+        /// Recorded on any thread between BeginRenderPass and EndRenderPass of the render pass it is executed in, clear values are ignored.
+        Secondary
     };
 
     template <>
     struct EnumNames<CommandBufferType>
     {
-        constexpr std::array<const char*, 1> operator()() const {
+        constexpr std::array<const char*, 2> operator()() const {
             return { {
                     "default",
+                    "secondary",
                 } };
         }
     };
 
+    /// Range of per frame data allocated from a persistently mapped buffer, valid until the frame retires.
+    struct TransientAllocation
+    {
+        GpuBuffer* buffer = nullptr;
+        uint64_t offset = 0;
+        uint8_t* data = nullptr;
+    };
+
     /// Defines a command buffer for storing recorded gpu commands.
     class ALIMER_API CommandBuffer : public RefCounted
     {
-        static constexpr size_t CommandAlign = alignof(Command*);
+        static constexpr size_t CommandAlign = alignof(Command);
+        /// Default size of the pages commands are linearly allocated from.
+        static constexpr size_t CommandPageSize = 16u * 1024u;
 
     public:
         CommandBuffer();
@@ -63,46 +78,40 @@ namespace Alimer
         /// Destructor.
         virtual ~CommandBuffer();
 
-        /// Clear all commands
+        /// Clear all commands, pages are kept to record the next commands without allocating.
         void Clear();
 
         template<typename T>
         void Push(const T& command)
         {
-            static_assert(std::is_base_of<Command, T>::value, "Must derive from Command structu");
-
-            size_t offset = _size;
-            if (offset % CommandAlign != 0)
-            {
-                offset += CommandAlign - (offset % CommandAlign);
-            }
+            Push(command, nullptr, 0);
+        }
 
-            if (_capacity < offset + sizeof(T))
+        /// Push command followed by payload of variable length data.
+        template<typename T>
+        void Push(const T& command, const void* payload, size_t payloadSize)
+        {
+            static_assert(std::is_base_of<Command, T>::value, "Must derive from Command structure");
+            static_assert(std::is_trivially_copyable<T>::value, "Commands must be trivially copyable");
+            static_assert(alignof(T) == CommandAlign, "Commands must be aligned as Command");
+
+            const size_t size = sizeof(T) + AlignCommandSize(payloadSize);
+            uint8_t* data = Allocate(size);
+            T* typedCommand = new (data) T(command);
+            typedCommand->size = static_cast<uint32_t>(size);
+            if (payloadSize)
             {
-                _capacity *= 2;
-                if (_capacity < offset + sizeof(T))
-                {
-                    _capacity = offset + sizeof(T);
-                }
-
-                uint8_t* newBuffer = new uint8_t[_capacity];
-                if (_buffer)
-                {
-                    MoveCommands(newBuffer);
-                    DeleteCommands();
-                    delete[] _buffer;
-                }
-                _buffer = newBuffer;
+                memcpy(data + sizeof(T), payload, payloadSize);
             }
-
-            _size = offset + sizeof(T);
             ++_count;
-            new (_buffer + offset) T(command);
         }
 
         Command* Front() const;
         void Pop();
 
+        /// Get number of recorded commands, always zero for backends executing immediately.
+        uint32_t GetCommandCount() const { return _count; }
+
         void BeginRenderPass(RenderPass* renderPass, const Color& clearColor, float clearDepth = 1.0f, uint8_t clearStencil = 0);
         void BeginRenderPass(RenderPass* renderPass, const Rectangle& renderArea, const Color& clearColor, float clearDepth = 1.0f, uint8_t clearStencil = 0);
 
@@ -121,16 +130,25 @@ namespace Alimer
         virtual void SetViewports(uint32_t numViewports, const Viewport* viewports);
 
         virtual void SetScissor(const Rectangle& scissor);
-        virtual void SetScissors(uint32_t numScissors, const Rectangle* scissors) = 0;
+        virtual void SetScissors(uint32_t numScissors, const Rectangle* scissors);
 
         void SetShader(Shader* shader);
+        /// Set shader and render state of graphics pipeline state, SetShader restores the default render state.
+        void SetPipelineState(PipelineState* pipelineState);
 
         void SetVertexBuffer(uint32_t binding, VertexBuffer* buffer, uint64_t offset = 0, VertexInputRate inputRate = VertexInputRate::Vertex);
         void SetIndexBuffer(GpuBuffer* buffer, uint32_t offset = 0);
         
         void SetUniformBuffer(uint32_t set, uint32_t binding, GpuBuffer* buffer);
+        void SetUniformBuffer(uint32_t set, uint32_t binding, const TransientAllocation& allocation, uint64_t range);
+
+        /// Allocate uniform data for the current frame, write it through the mapped pointer and bind it with dynamic offset.
+        TransientAllocation AllocateUniform(uint64_t size);
         void SetTexture(uint32_t binding, Texture* texture, ShaderStageFlags stage = ShaderStage::AllGraphics);
 
+        /// Set push constant data read by the following draws, in bindless mode it carries resource indices. D3D11 binds it as constant buffer b13.
+        void PushConstants(const void* data, uint32_t size, uint32_t offset = 0);
+
         // Draw methods
         void Draw(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount = 1u, uint32_t vertexStart = 0u, uint32_t baseInstance = 0u);
         void DrawIndexed(PrimitiveTopology topology, uint32_t indexCount, uint32_t instanceCount = 1u, uint32_t startIndex = 0u);
@@ -138,15 +156,19 @@ namespace Alimer
         void ExecuteCommands(uint32_t commandBufferCount, CommandBuffer* const* commandBuffers);
 
     protected:
+        // Default implementations record commands, backends executing immediately override them.
         virtual void BeginRenderPassCore(RenderPass* renderPass, const Rectangle& renderArea, const Color* clearColors, uint32_t numClearColors, float clearDepth, uint8_t clearStencil);
         virtual void EndRenderPassCore();
         virtual void ExecuteCommandsCore(uint32_t commandBufferCount, CommandBuffer* const* commandBuffers);
 
         virtual void SetUniformBufferCore(uint32_t set, uint32_t binding, GpuBuffer* buffer, uint64_t offset, uint64_t range);
+        virtual TransientAllocation AllocateUniformCore(uint64_t size);
         virtual void SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags stage);
+        virtual void PushConstantsCore(const void* data, uint32_t size, uint32_t offset);
 
         virtual void SetShaderCore(Shader* shader);
-        virtual void DrawCore(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance) = 0;
+        virtual void SetPipelineStateCore(PipelineState* pipelineState);
+        virtual void DrawCore(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance);
         virtual void DrawIndexedCore(PrimitiveTopology topology, uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex);
         virtual void SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t stride, VertexInputRate inputRate);
         virtual void SetIndexBufferCore(GpuBuffer* buffer, uint32_t offset, IndexType indexType);
@@ -171,30 +193,32 @@ namespace Alimer
         CommandBufferState _state = CommandBufferState::Ready;
 
     private:
-        template<typename T>
-        uint32_t DeleteCommand(T* command)
+        /// Page of linearly allocated commands, data follows the header.
+        struct CommandPage
         {
-            ALIMER_UNUSED(command);
-            command->~T();
-            return sizeof(*command);
+            CommandPage* next;
+            size_t capacity;
+            size_t size;
+        };
+
+        static size_t AlignCommandSize(size_t size)
+        {
+            return (size + CommandAlign - 1) & ~(CommandAlign - 1);
         }
 
-        template<typename T>
-        uint32_t MoveCommand(T* command, void* newPointer)
+        static uint8_t* GetPageData(CommandPage* page)
         {
-            ALIMER_UNUSED(command);
-            new (newPointer) T(std::move(*command));
-            return sizeof(*command);
+            return reinterpret_cast<uint8_t*>(page) + AlignCommandSize(sizeof(CommandPage));
         }
 
-        void MoveCommands(uint8_t* newBuffer);
-        void DeleteCommands();
+        uint8_t* Allocate(size_t size);
+        void Rewind();
 
     private:
-        uint8_t * _buffer = nullptr;
-        size_t _capacity = 0;
-        size_t _size = 0;
-        size_t _position = 0;
+        CommandPage* _firstPage = nullptr;
+        CommandPage* _writePage = nullptr;
+        CommandPage* _readPage = nullptr;
+        size_t _readOffset = 0;
         uint32_t _count = 0;
         uint32_t _current = 0;
 
@@ -22,30 +22,51 @@
 
 #pragma once
 
+#include "../Graphics/Types.h"
+#include "../Graphics/GpuBuffer.h"
+#include "../Graphics/Shader.h"
 #include "../Math/Math.h"
 #include "../Math/Color.h"
-#include <vector>
 
 namespace Alimer
 {
     class RenderPass;
+    class VertexBuffer;
+    class Texture;
+    class CommandBuffer;
+    class PipelineState;
 
-    struct Command
+    /// Header of commands recorded in CommandBuffer, commands are trivially copyable and variable length data follows them in the stream.
+    /// Aligned so that payloads placed right after any command are aligned for pointers and 64-bit values.
+    struct alignas(8) Command
     {
-        enum class Type
+        enum class Type : uint32_t
         {
             Invalid,
             BeginRenderPass,
             EndRenderPass,
             SetViewport,
-            SetViewports
+            SetViewports,
+            SetScissors,
+            SetShader,
+            SetPipelineState,
+            SetVertexBuffer,
+            SetIndexBuffer,
+            SetUniformBuffer,
+            SetTexture,
+            PushConstants,
+            Draw,
+            DrawIndexed,
+            ExecuteCommands
         };
 
-        Command(Type type_) : type(type_)
+        Command(Type type_) : type(type_), size(0)
         {
         }
 
-        const Type type;
+        Type type;
+        /// Size in bytes of command and its payload, set when pushed.
+        uint32_t size;
     };
 
     struct BeginRenderPassCommand : public Command
@@ -53,20 +74,22 @@ namespace Alimer
         BeginRenderPassCommand(
             RenderPass* renderPass_,
             const Rectangle& renderArea_,
-            const Color* clearColors_, uint32_t numClearColors_,
+            uint32_t numClearColors_,
             float clearDepth_, uint8_t clearStencil_)
             : Command(Command::Type::BeginRenderPass)
             , renderPass(renderPass_)
             , renderArea(renderArea_)
-            , clearColors(clearColors_, clearColors_ + numClearColors_)
+            , numClearColors(numClearColors_)
             , clearDepth(clearDepth_)
             , clearStencil(clearStencil_)
         {
         }
 
+        const Color* GetClearColors() const { return reinterpret_cast<const Color*>(this + 1); }
+
         RenderPass* renderPass;
-        const Rectangle renderArea;
-        std::vector<Color> clearColors;
+        Rectangle renderArea;
+        uint32_t numClearColors;
         float clearDepth;
         uint8_t clearStencil;
     };
@@ -87,17 +110,190 @@ namespace Alimer
         {
         }
 
-        const Viewport viewport;
+        Viewport viewport;
     };
 
     struct SetViewportsCommand : public Command
     {
-        SetViewportsCommand(uint32_t numViewports_, const Viewport* viewports_)
+        SetViewportsCommand(uint32_t numViewports_)
             : Command(Command::Type::SetViewports)
-            , viewports(viewports_, viewports_ + numViewports_)
+            , numViewports(numViewports_)
+        {
+        }
+
+        const Viewport* GetViewports() const { return reinterpret_cast<const Viewport*>(this + 1); }
+
+        uint32_t numViewports;
+    };
+
+    struct SetScissorsCommand : public Command
+    {
+        SetScissorsCommand(uint32_t numScissors_)
+            : Command(Command::Type::SetScissors)
+            , numScissors(numScissors_)
+        {
+        }
+
+        const Rectangle* GetScissors() const { return reinterpret_cast<const Rectangle*>(this + 1); }
+
+        uint32_t numScissors;
+    };
+
+    struct SetShaderCommand : public Command
+    {
+        SetShaderCommand(Shader* shader_)
+            : Command(Command::Type::SetShader)
+            , shader(shader_)
+        {
+        }
+
+        Shader* shader;
+    };
+
+    struct SetPipelineStateCommand : public Command
+    {
+        SetPipelineStateCommand(PipelineState* pipelineState_)
+            : Command(Command::Type::SetPipelineState)
+            , pipelineState(pipelineState_)
+        {
+        }
+
+        PipelineState* pipelineState;
+    };
+
+    struct SetVertexBufferCommand : public Command
+    {
+        SetVertexBufferCommand(uint32_t binding_, VertexBuffer* buffer_, uint64_t offset_, uint64_t stride_, VertexInputRate inputRate_)
+            : Command(Command::Type::SetVertexBuffer)
+            , binding(binding_)
+            , buffer(buffer_)
+            , offset(offset_)
+            , stride(stride_)
+            , inputRate(inputRate_)
+        {
+        }
+
+        uint32_t binding;
+        VertexBuffer* buffer;
+        uint64_t offset;
+        uint64_t stride;
+        VertexInputRate inputRate;
+    };
+
+    struct SetIndexBufferCommand : public Command
+    {
+        SetIndexBufferCommand(GpuBuffer* buffer_, uint32_t offset_, IndexType indexType_)
+            : Command(Command::Type::SetIndexBuffer)
+            , buffer(buffer_)
+            , offset(offset_)
+            , indexType(indexType_)
+        {
+        }
+
+        GpuBuffer* buffer;
+        uint32_t offset;
+        IndexType indexType;
+    };
+
+    struct SetUniformBufferCommand : public Command
+    {
+        SetUniformBufferCommand(uint32_t set_, uint32_t binding_, GpuBuffer* buffer_, uint64_t offset_, uint64_t range_)
+            : Command(Command::Type::SetUniformBuffer)
+            , set(set_)
+            , binding(binding_)
+            , buffer(buffer_)
+            , offset(offset_)
+            , range(range_)
+        {
+        }
+
+        uint32_t set;
+        uint32_t binding;
+        GpuBuffer* buffer;
+        uint64_t offset;
+        uint64_t range;
+    };
+
+    struct SetTextureCommand : public Command
+    {
+        SetTextureCommand(uint32_t binding_, Texture* texture_, ShaderStageFlags stage_)
+            : Command(Command::Type::SetTexture)
+            , binding(binding_)
+            , texture(texture_)
+            , stage(static_cast<uint32_t>(stage_))
+        {
+        }
+
+        ShaderStageFlags GetStage() const { return ShaderStageFlags(stage); }
+
+        uint32_t binding;
+        Texture* texture;
+        /// Mask of ShaderStageFlags, stored raw to keep the command trivially copyable.
+        uint32_t stage;
+    };
+
+    struct PushConstantsCommand : public Command
+    {
+        PushConstantsCommand(uint32_t dataSize_, uint32_t offset_)
+            : Command(Command::Type::PushConstants)
+            , dataSize(dataSize_)
+            , offset(offset_)
+        {
+        }
+
+        const void* GetData() const { return this + 1; }
+
+        /// Size of the constant data following the command, size holds the whole command.
+        uint32_t dataSize;
+        uint32_t offset;
+    };
+
+    struct DrawCommand : public Command
+    {
+        DrawCommand(PrimitiveTopology topology_, uint32_t vertexCount_, uint32_t instanceCount_, uint32_t vertexStart_, uint32_t baseInstance_)
+            : Command(Command::Type::Draw)
+            , topology(topology_)
+            , vertexCount(vertexCount_)
+            , instanceCount(instanceCount_)
+            , vertexStart(vertexStart_)
+            , baseInstance(baseInstance_)
+        {
+        }
+
+        PrimitiveTopology topology;
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t vertexStart;
+        uint32_t baseInstance;
+    };
+
+    struct DrawIndexedCommand : public Command
+    {
+        DrawIndexedCommand(PrimitiveTopology topology_, uint32_t indexCount_, uint32_t instanceCount_, uint32_t startIndex_)
+            : Command(Command::Type::DrawIndexed)
+            , topology(topology_)
+            , indexCount(indexCount_)
+            , instanceCount(instanceCount_)
+            , startIndex(startIndex_)
         {
         }
 
-        std::vector<Viewport> viewports;
+        PrimitiveTopology topology;
+        uint32_t indexCount;
+        uint32_t instanceCount;
+        uint32_t startIndex;
+    };
+
+    struct ExecuteCommandsCommand : public Command
+    {
+        ExecuteCommandsCommand(uint32_t commandBufferCount_)
+            : Command(Command::Type::ExecuteCommands)
+            , commandBufferCount(commandBufferCount_)
+        {
+        }
+
+        CommandBuffer* const* GetCommandBuffers() const { return reinterpret_cast<CommandBuffer* const*>(this + 1); }
+
+        uint32_t commandBufferCount;
     };
 }
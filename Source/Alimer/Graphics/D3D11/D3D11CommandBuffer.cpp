@@ -44,6 +44,9 @@ namespace Alimer
 {
     static ID3D11RenderTargetView* nullViews[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {};
 
+    /// Push constants are emulated with a constant buffer in the last slot, shaders declare it at register(b13).
+    static constexpr UINT D3D11PushConstantSlot = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT - 1;
+
     D3D11CommandBuffer::D3D11CommandBuffer(D3D11Graphics* graphics, bool immediate)
         : CommandBuffer()
         , _graphics(graphics)
@@ -65,8 +68,8 @@ namespace Alimer
                 context->BeginRenderPassCore(
                     beginRenderPassCommand->renderPass,
                     beginRenderPassCommand->renderArea,
-                    beginRenderPassCommand->clearColors.data(),
-                    static_cast<uint32_t>(beginRenderPassCommand->clearColors.size()),
+                    beginRenderPassCommand->GetClearColors(),
+                    beginRenderPassCommand->numClearColors,
                     beginRenderPassCommand->clearDepth,
                     beginRenderPassCommand->clearStencil
                 );
@@ -86,6 +89,93 @@ namespace Alimer
             }
             break;
 
+            case Command::Type::SetViewports:
+            {
+                const SetViewportsCommand* typedCmd = static_cast<const SetViewportsCommand*>(command);
+                context->SetViewports(typedCmd->numViewports, typedCmd->GetViewports());
+            }
+            break;
+
+            case Command::Type::SetScissors:
+            {
+                const SetScissorsCommand* typedCmd = static_cast<const SetScissorsCommand*>(command);
+                context->SetScissors(typedCmd->numScissors, typedCmd->GetScissors());
+            }
+            break;
+
+            case Command::Type::SetShader:
+            {
+                const SetShaderCommand* typedCmd = static_cast<const SetShaderCommand*>(command);
+                context->SetShaderCore(typedCmd->shader);
+            }
+            break;
+
+            case Command::Type::SetPipelineState:
+            {
+                const SetPipelineStateCommand* typedCmd = static_cast<const SetPipelineStateCommand*>(command);
+                context->SetPipelineStateCore(typedCmd->pipelineState);
+            }
+            break;
+
+            case Command::Type::SetVertexBuffer:
+            {
+                const SetVertexBufferCommand* typedCmd = static_cast<const SetVertexBufferCommand*>(command);
+                context->SetVertexBufferCore(typedCmd->binding, typedCmd->buffer, typedCmd->offset, typedCmd->stride, typedCmd->inputRate);
+            }
+            break;
+
+            case Command::Type::SetIndexBuffer:
+            {
+                const SetIndexBufferCommand* typedCmd = static_cast<const SetIndexBufferCommand*>(command);
+                context->SetIndexBufferCore(typedCmd->buffer, typedCmd->offset, typedCmd->indexType);
+            }
+            break;
+
+            case Command::Type::SetUniformBuffer:
+            {
+                const SetUniformBufferCommand* typedCmd = static_cast<const SetUniformBufferCommand*>(command);
+                context->SetUniformBufferCore(typedCmd->set, typedCmd->binding, typedCmd->buffer, typedCmd->offset, typedCmd->range);
+            }
+            break;
+
+            case Command::Type::SetTexture:
+            {
+                const SetTextureCommand* typedCmd = static_cast<const SetTextureCommand*>(command);
+                context->SetTextureCore(typedCmd->binding, typedCmd->texture, typedCmd->GetStage());
+            }
+            break;
+
+            case Command::Type::PushConstants:
+            {
+                const PushConstantsCommand* typedCmd = static_cast<const PushConstantsCommand*>(command);
+                context->PushConstantsCore(typedCmd->GetData(), typedCmd->dataSize, typedCmd->offset);
+            }
+            break;
+
+            case Command::Type::Draw:
+            {
+                const DrawCommand* typedCmd = static_cast<const DrawCommand*>(command);
+                context->DrawCore(typedCmd->topology, typedCmd->vertexCount, typedCmd->instanceCount, typedCmd->vertexStart, typedCmd->baseInstance);
+            }
+            break;
+
+            case Command::Type::DrawIndexed:
+            {
+                const DrawIndexedCommand* typedCmd = static_cast<const DrawIndexedCommand*>(command);
+                context->DrawIndexedCore(typedCmd->topology, typedCmd->indexCount, typedCmd->instanceCount, typedCmd->startIndex);
+            }
+            break;
+
+            case Command::Type::ExecuteCommands:
+            {
+                const ExecuteCommandsCommand* typedCmd = static_cast<const ExecuteCommandsCommand*>(command);
+                for (uint32_t i = 0; i < typedCmd->commandBufferCount; ++i)
+                {
+                    static_cast<D3D11CommandBuffer*>(typedCmd->GetCommandBuffers()[i])->Execute(context);
+                }
+            }
+            break;
+
             default:
                 ALIMER_LOGCRITICAL("Invalid CommandBuffer command");
                 break;
@@ -114,6 +204,7 @@ namespace Alimer
         _currentColorAttachmentsBound = 0;
         _currentTopology = PrimitiveTopology::Count;
         _currentShader = nullptr;
+        _currentPipeline = nullptr;
         _currentRasterizerState = nullptr;
         _currentDepthStencilState = nullptr;
         _currentBlendState = nullptr;
@@ -216,7 +307,15 @@ namespace Alimer
 
     void D3D11CommandContext::SetShaderCore(Shader* shader)
     {
+        // Shader set directly draws with the default render state.
         _currentShader = static_cast<D3D11Shader*>(shader);
+        _currentPipeline = nullptr;
+    }
+
+    void D3D11CommandContext::SetPipelineStateCore(PipelineState* pipelineState)
+    {
+        _currentPipeline = static_cast<D3D11PipelineState*>(pipelineState);
+        _currentShader = _currentPipeline->GetShader();
     }
 
     void D3D11CommandContext::SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t stride, VertexInputRate inputRate)
@@ -261,6 +360,12 @@ namespace Alimer
         _context->VSSetConstantBuffers(binding, 1, &d3dBuffer);
     }
 
+    void D3D11CommandContext::PushConstantsCore(const void* data, uint32_t size, uint32_t offset)
+    {
+        memcpy(_pushConstantData + offset, data, size);
+        _pushConstantsDirty = true;
+    }
+
     void D3D11CommandContext::SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags stage)
     {
         auto d3d11Texture = static_cast<D3D11Texture*>(texture);
@@ -295,6 +400,25 @@ namespace Alimer
         });
         _dirtyVbos &= ~updateVboMask;
 
+        if (_pushConstantsDirty)
+        {
+            if (!_pushConstantBuffer)
+            {
+                D3D11_BUFFER_DESC bufferDesc = {};
+                bufferDesc.ByteWidth = MaxPushConstantSize;
+                bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+                bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+                ThrowIfFailed(_graphics->GetD3DDevice()->CreateBuffer(&bufferDesc, nullptr, &_pushConstantBuffer));
+
+                ID3D11Buffer* d3dBuffer = _pushConstantBuffer.Get();
+                _context->VSSetConstantBuffers(D3D11PushConstantSlot, 1, &d3dBuffer);
+                _context->PSSetConstantBuffers(D3D11PushConstantSlot, 1, &d3dBuffer);
+            }
+
+            _context->UpdateSubresource(_pushConstantBuffer.Get(), 0, nullptr, _pushConstantData, 0, 0);
+            _pushConstantsDirty = false;
+        }
+
         if (_currentTopology != topology)
         {
             _context->IASetPrimitiveTopology(d3d::Convert(topology));
@@ -303,26 +427,27 @@ namespace Alimer
 
         _currentShader->Bind(_context);
 
-        /*auto rasterizerState = _currentPipeline->GetD3DRasterizerState();
+        // Null states restore the device defaults.
+        auto rasterizerState = _currentPipeline ? _currentPipeline->GetD3DRasterizerState() : nullptr;
         if (_currentRasterizerState != rasterizerState)
         {
             _currentRasterizerState = rasterizerState;
             _context->RSSetState(rasterizerState);
         }
 
-        auto dsState = _currentPipeline->GetD3DDepthStencilState();
+        auto dsState = _currentPipeline ? _currentPipeline->GetD3DDepthStencilState() : nullptr;
         if (_currentDepthStencilState != dsState)
         {
             _currentDepthStencilState = dsState;
             _context->OMSetDepthStencilState(dsState, 0);
         }
 
-        auto blendState = _currentPipeline->GetD3DBlendState();
+        auto blendState = _currentPipeline ? _currentPipeline->GetD3DBlendState() : nullptr;
         if (_currentBlendState != blendState)
         {
             _currentBlendState = blendState;
             _context->OMSetBlendState(blendState, nullptr, 0xFFFFFFFF);
-        }*/
+        }
 
         return true;
     }
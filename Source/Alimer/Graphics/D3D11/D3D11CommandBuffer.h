@@ -29,6 +29,7 @@ namespace Alimer
 {
     class D3D11RenderPass;
     class D3D11Shader;
+    class D3D11PipelineState;
     class D3D11Graphics;
     class D3D11CommandContext;
 
@@ -71,10 +72,12 @@ namespace Alimer
         void SetScissors(uint32_t numScissors, const Rectangle* scissors) override;
 
         void SetShaderCore(Shader* shader) override;
+        void SetPipelineStateCore(PipelineState* pipelineState) override;
         void SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t stride, VertexInputRate inputRate) override;
         void SetIndexBufferCore(GpuBuffer* buffer, uint32_t offset, IndexType indexType) override;
         void SetUniformBufferCore(uint32_t set, uint32_t binding, GpuBuffer* buffer, uint64_t offset, uint64_t range) override;
         void SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags stage) override;
+        void PushConstantsCore(const void* data, uint32_t size, uint32_t offset) override;
 
         void DrawCore(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance) override;
         void DrawIndexedCore(PrimitiveTopology topology, uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex) override;
@@ -90,6 +93,7 @@ namespace Alimer
         uint32_t _currentColorAttachmentsBound;
         PrimitiveTopology _currentTopology;
         D3D11Shader* _currentShader;
+        D3D11PipelineState* _currentPipeline;
         ID3D11RasterizerState1* _currentRasterizerState;
         ID3D11DepthStencilState* _currentDepthStencilState;
         ID3D11BlendState1* _currentBlendState;
@@ -109,5 +113,10 @@ namespace Alimer
 
         /// Current input layout: vertex buffers' element mask and vertex shader's element mask combined.
         InputLayoutDesc _currentInputLayout;
+
+        /// Push constant data, uploaded to the constant buffer before the next draw when dirty.
+        uint8_t _pushConstantData[MaxPushConstantSize] = {};
+        bool _pushConstantsDirty = false;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> _pushConstantBuffer;
     };
 }
@@ -26,6 +26,7 @@
 #include "../Types.h"
 #include "../PixelFormat.h"
 #include "../GpuBuffer.h"
+#include "../PipelineState.h"
 
 namespace Alimer
 {
@@ -48,5 +49,114 @@ namespace Alimer
                 return D3D11_USAGE_DEFAULT;
             }
         }
+
+        static inline D3D11_BLEND Convert(BlendFactor factor)
+        {
+            switch (factor)
+            {
+            case BlendFactor::Zero:                     return D3D11_BLEND_ZERO;
+            case BlendFactor::One:                      return D3D11_BLEND_ONE;
+            case BlendFactor::SourceColor:              return D3D11_BLEND_SRC_COLOR;
+            case BlendFactor::OneMinusSourceColor:      return D3D11_BLEND_INV_SRC_COLOR;
+            case BlendFactor::SourceAlpha:              return D3D11_BLEND_SRC_ALPHA;
+            case BlendFactor::OneMinusSourceAlpha:      return D3D11_BLEND_INV_SRC_ALPHA;
+            case BlendFactor::DestinationColor:         return D3D11_BLEND_DEST_COLOR;
+            case BlendFactor::OneMinusDestinationColor: return D3D11_BLEND_INV_DEST_COLOR;
+            case BlendFactor::DestinationAlpha:         return D3D11_BLEND_DEST_ALPHA;
+            case BlendFactor::OneMinusDestinationAlpha: return D3D11_BLEND_INV_DEST_ALPHA;
+            case BlendFactor::SourceAlphaSaturated:     return D3D11_BLEND_SRC_ALPHA_SAT;
+            case BlendFactor::BlendColor:               return D3D11_BLEND_BLEND_FACTOR;
+            case BlendFactor::OneMinusBlendColor:       return D3D11_BLEND_INV_BLEND_FACTOR;
+            default:
+                ALIMER_UNREACHABLE();
+                return D3D11_BLEND_ONE;
+            }
+        }
+
+        static inline D3D11_BLEND_OP Convert(BlendOperation operation)
+        {
+            switch (operation)
+            {
+            case BlendOperation::Add:               return D3D11_BLEND_OP_ADD;
+            case BlendOperation::Subtract:          return D3D11_BLEND_OP_SUBTRACT;
+            case BlendOperation::ReverseSubtract:   return D3D11_BLEND_OP_REV_SUBTRACT;
+            case BlendOperation::Min:               return D3D11_BLEND_OP_MIN;
+            case BlendOperation::Max:               return D3D11_BLEND_OP_MAX;
+            default:
+                ALIMER_UNREACHABLE();
+                return D3D11_BLEND_OP_ADD;
+            }
+        }
+
+        static inline D3D11_COMPARISON_FUNC Convert(CompareFunction function)
+        {
+            switch (function)
+            {
+            case CompareFunction::Never:        return D3D11_COMPARISON_NEVER;
+            case CompareFunction::Less:         return D3D11_COMPARISON_LESS;
+            case CompareFunction::Equal:        return D3D11_COMPARISON_EQUAL;
+            case CompareFunction::LessEqual:    return D3D11_COMPARISON_LESS_EQUAL;
+            case CompareFunction::Greater:      return D3D11_COMPARISON_GREATER;
+            case CompareFunction::NotEqual:     return D3D11_COMPARISON_NOT_EQUAL;
+            case CompareFunction::GreaterEqual: return D3D11_COMPARISON_GREATER_EQUAL;
+            case CompareFunction::Always:       return D3D11_COMPARISON_ALWAYS;
+            default:
+                ALIMER_UNREACHABLE();
+                return D3D11_COMPARISON_ALWAYS;
+            }
+        }
+
+        static inline D3D11_STENCIL_OP Convert(StencilOperation operation)
+        {
+            switch (operation)
+            {
+            case StencilOperation::Keep:            return D3D11_STENCIL_OP_KEEP;
+            case StencilOperation::Zero:            return D3D11_STENCIL_OP_ZERO;
+            case StencilOperation::Replace:         return D3D11_STENCIL_OP_REPLACE;
+            case StencilOperation::IncrementClamp:  return D3D11_STENCIL_OP_INCR_SAT;
+            case StencilOperation::DecrementClamp:  return D3D11_STENCIL_OP_DECR_SAT;
+            case StencilOperation::Invert:          return D3D11_STENCIL_OP_INVERT;
+            case StencilOperation::IncrementWrap:   return D3D11_STENCIL_OP_INCR;
+            case StencilOperation::DecrementWrap:   return D3D11_STENCIL_OP_DECR;
+            default:
+                ALIMER_UNREACHABLE();
+                return D3D11_STENCIL_OP_KEEP;
+            }
+        }
+
+        static inline D3D11_DEPTH_STENCILOP_DESC Convert(const StencilOpState& state)
+        {
+            D3D11_DEPTH_STENCILOP_DESC desc;
+            desc.StencilFailOp = Convert(state.failOperation);
+            desc.StencilDepthFailOp = Convert(state.depthFailOperation);
+            desc.StencilPassOp = Convert(state.passOperation);
+            desc.StencilFunc = Convert(state.compareFunction);
+            return desc;
+        }
+
+        static inline D3D11_FILL_MODE Convert(FillMode mode)
+        {
+            switch (mode)
+            {
+            case FillMode::Solid:       return D3D11_FILL_SOLID;
+            case FillMode::Wireframe:   return D3D11_FILL_WIREFRAME;
+            default:
+                ALIMER_UNREACHABLE();
+                return D3D11_FILL_SOLID;
+            }
+        }
+
+        static inline D3D11_CULL_MODE Convert(CullMode mode)
+        {
+            switch (mode)
+            {
+            case CullMode::None:    return D3D11_CULL_NONE;
+            case CullMode::Front:   return D3D11_CULL_FRONT;
+            case CullMode::Back:    return D3D11_CULL_BACK;
+            default:
+                ALIMER_UNREACHABLE();
+                return D3D11_CULL_BACK;
+            }
+        }
     }
 }
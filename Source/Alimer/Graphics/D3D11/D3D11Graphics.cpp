@@ -271,7 +271,8 @@ namespace Alimer
             return _defaultCommandBuffer;
 
         default:
-            ALIMER_LOGCRITICAL("Invalid CommandBuffer type requested: {}", str::ToString(type));
+            ALIMER_LOGERROR("CommandBuffer type not supported by the graphics backend: {}", str::ToString(type));
+            return nullptr;
         }
     }
 
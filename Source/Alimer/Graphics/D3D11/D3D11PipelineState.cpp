@@ -24,35 +24,38 @@
 #include "D3D11Shader.h"
 #include "D3D11Graphics.h"
 #include "../D3D/D3DConvert.h"
+#include "D3D11Convert.h"
 #include "../../Core/Log.h"
 using namespace Microsoft::WRL;
 
 namespace Alimer
 {
     D3D11PipelineState::D3D11PipelineState(D3D11Graphics* graphics, const RenderPipelineDescription& description)
-        : PipelineState(graphics, true)
+        : PipelineState(graphics, description)
     {
-        _shader = StaticCast<D3D11Shader>(description.shader);
         HRESULT hr = S_OK;
 
         // Create blend state.
         D3D11_BLEND_DESC1 bsDesc;
         memset(&bsDesc, 0, sizeof(bsDesc));
 
-        bsDesc.AlphaToCoverageEnable = FALSE;
-        bsDesc.IndependentBlendEnable = FALSE;
-
-        const D3D11_RENDER_TARGET_BLEND_DESC1 renderTargetBlendDesc =
-        {
-            FALSE,FALSE,
-            D3D11_BLEND_ONE, D3D11_BLEND_ZERO, D3D11_BLEND_OP_ADD,
-            D3D11_BLEND_ONE, D3D11_BLEND_ZERO, D3D11_BLEND_OP_ADD,
-            D3D11_LOGIC_OP_NOOP,
-            D3D11_COLOR_WRITE_ENABLE_ALL,
-        };
-        for (UINT i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i)
+        bsDesc.AlphaToCoverageEnable = _blendState.alphaToCoverageEnable ? TRUE : FALSE;
+        bsDesc.IndependentBlendEnable = _blendState.independentBlendEnable ? TRUE : FALSE;
+        for (UINT i = 0; i < MaxColorAttachments; ++i)
         {
-            bsDesc.RenderTarget[i] = renderTargetBlendDesc;
+            const RenderTargetBlendState& renderTarget = _blendState.renderTargets[i];
+            D3D11_RENDER_TARGET_BLEND_DESC1& renderTargetDesc = bsDesc.RenderTarget[i];
+            renderTargetDesc.BlendEnable = renderTarget.blendEnable ? TRUE : FALSE;
+            renderTargetDesc.LogicOpEnable = FALSE;
+            renderTargetDesc.SrcBlend = d3d11::Convert(renderTarget.sourceColorBlendFactor);
+            renderTargetDesc.DestBlend = d3d11::Convert(renderTarget.destinationColorBlendFactor);
+            renderTargetDesc.BlendOp = d3d11::Convert(renderTarget.colorBlendOperation);
+            renderTargetDesc.SrcBlendAlpha = d3d11::Convert(renderTarget.sourceAlphaBlendFactor);
+            renderTargetDesc.DestBlendAlpha = d3d11::Convert(renderTarget.destinationAlphaBlendFactor);
+            renderTargetDesc.BlendOpAlpha = d3d11::Convert(renderTarget.alphaBlendOperation);
+            renderTargetDesc.LogicOp = D3D11_LOGIC_OP_NOOP;
+            // ColorWriteMask bits match D3D11_COLOR_WRITE_ENABLE.
+            renderTargetDesc.RenderTargetWriteMask = static_cast<UINT8>(renderTarget.colorWriteMask);
         }
 
         hr = graphics->GetD3DDevice()->CreateBlendState1(&bsDesc, &_d3d11BlendState);
@@ -64,13 +67,13 @@ namespace Alimer
         // Create rasterizer state.
         D3D11_RASTERIZER_DESC1 rsDesc;
         memset(&rsDesc, 0, sizeof(rsDesc));
-        rsDesc.FillMode = D3D11_FILL_SOLID;
-        rsDesc.CullMode = D3D11_CULL_NONE;
-        rsDesc.FrontCounterClockwise = FALSE;
-        rsDesc.DepthBias = D3D11_DEFAULT_DEPTH_BIAS;
-        rsDesc.DepthBiasClamp = D3D11_DEFAULT_DEPTH_BIAS_CLAMP;
-        rsDesc.SlopeScaledDepthBias = D3D11_DEFAULT_SLOPE_SCALED_DEPTH_BIAS;
-        rsDesc.DepthClipEnable = TRUE;
+        rsDesc.FillMode = d3d11::Convert(_rasterizerState.fillMode);
+        rsDesc.CullMode = d3d11::Convert(_rasterizerState.cullMode);
+        rsDesc.FrontCounterClockwise = _rasterizerState.frontFace == FrontFace::CounterClockwise ? TRUE : FALSE;
+        rsDesc.DepthBias = _rasterizerState.depthBias;
+        rsDesc.DepthBiasClamp = _rasterizerState.depthBiasClamp;
+        rsDesc.SlopeScaledDepthBias = _rasterizerState.slopeScaledDepthBias;
+        rsDesc.DepthClipEnable = _rasterizerState.depthClipEnable ? TRUE : FALSE;
         rsDesc.ScissorEnable = FALSE;
         rsDesc.MultisampleEnable = FALSE;
         rsDesc.AntialiasedLineEnable = FALSE;
@@ -85,23 +88,14 @@ namespace Alimer
         D3D11_DEPTH_STENCIL_DESC dssDesc;
         memset(&dssDesc, 0, sizeof(dssDesc));
 
-        dssDesc.DepthEnable = FALSE;
-        dssDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-        dssDesc.DepthFunc = D3D11_COMPARISON_LESS;
-        dssDesc.StencilEnable = FALSE;
-        dssDesc.StencilReadMask = D3D11_DEFAULT_STENCIL_READ_MASK;
-        dssDesc.StencilWriteMask = D3D11_DEFAULT_STENCIL_WRITE_MASK;
-
-        const D3D11_DEPTH_STENCILOP_DESC defaultStencilOp =
-        {
-            D3D11_STENCIL_OP_KEEP,
-            D3D11_STENCIL_OP_KEEP,
-            D3D11_STENCIL_OP_KEEP,
-            D3D11_COMPARISON_ALWAYS
-        };
-
-        dssDesc.FrontFace = defaultStencilOp;
-        dssDesc.BackFace = defaultStencilOp;
+        dssDesc.DepthEnable = _depthStencilState.depthTestEnable ? TRUE : FALSE;
+        dssDesc.DepthWriteMask = _depthStencilState.depthWriteEnable ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+        dssDesc.DepthFunc = d3d11::Convert(_depthStencilState.depthCompareFunction);
+        dssDesc.StencilEnable = _depthStencilState.stencilEnable ? TRUE : FALSE;
+        dssDesc.StencilReadMask = _depthStencilState.stencilReadMask;
+        dssDesc.StencilWriteMask = _depthStencilState.stencilWriteMask;
+        dssDesc.FrontFace = d3d11::Convert(_depthStencilState.frontFace);
+        dssDesc.BackFace = d3d11::Convert(_depthStencilState.backFace);
 
         hr = graphics->GetD3DDevice()->CreateDepthStencilState(&dssDesc, &_d3d11DepthStencilState);
         if (FAILED(hr))
@@ -116,7 +110,7 @@ namespace Alimer
     {
         if (_isGraphics)
         {
-            _shader->Bind(context);
+            GetShader()->Bind(context);
         }
         else
         {
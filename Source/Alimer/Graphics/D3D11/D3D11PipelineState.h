@@ -23,12 +23,11 @@
 #pragma once
 
 #include "../PipelineState.h"
-#include "D3D11Prerequisites.h"
+#include "D3D11Shader.h"
 
 namespace Alimer
 {
 	class D3D11Graphics;
-    class D3D11Shader;
 
 	/// D3D11 PipelineState implementation.
 	class D3D11PipelineState final : public PipelineState
@@ -42,13 +41,12 @@ namespace Alimer
 
         void Bind(ID3D11DeviceContext1* context);
 
-        D3D11Shader* GetShader() const { return _shader.Get(); }
+        D3D11Shader* GetShader() const { return static_cast<D3D11Shader*>(_shader.Get()); }
         ID3D11RasterizerState1* GetD3DRasterizerState() const { return _d3d11RasterizerState; }
         ID3D11DepthStencilState* GetD3DDepthStencilState() const { return _d3d11DepthStencilState; }
         ID3D11BlendState1* GetD3DBlendState() const { return _d3d11BlendState; }
 
 	private:
-        SharedPtr<D3D11Shader> _shader;
         ID3D11RasterizerState1* _d3d11RasterizerState = nullptr;
         ID3D11DepthStencilState* _d3d11DepthStencilState = nullptr;
         ID3D11BlendState1* _d3d11BlendState = nullptr;
@@ -57,6 +57,11 @@ namespace Alimer
         SafeDelete(_handle);
     }
 
+    uint32_t GpuBuffer::GetBindlessIndex() const
+    {
+        return _handle ? _handle->GetBindlessIndex() : InvalidBindlessIndex;
+    }
+
     static const char* BufferUsageToString(BufferUsageFlags usage)
     {
         if (usage & BufferUsage::Vertex)
@@ -100,6 +100,9 @@ namespace Alimer
         /// Get the backend buffer implementation.
         BufferHandle* GetHandle() { return _handle; }
 
+        /// Get index of the storage buffer in the bindless heap, InvalidBindlessIndex if it has no slot.
+        uint32_t GetBindlessIndex() const;
+
     protected:
         bool Create(const void* initialData);
         bool SetData(uint32_t offset, uint32_t size, const void* data);
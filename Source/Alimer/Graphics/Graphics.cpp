@@ -24,6 +24,8 @@
 #include "ShaderCompiler.h"
 #include "../Resource/ResourceManager.h"
 #include "../Core/Log.h"
+#include "Graphics/Null/NullGraphics.h"
+#include "Graphics/Software/SoftwareGraphics.h"
 
 #if ALIMER_VULKAN
 #include "Graphics/Vulkan/VulkanGraphics.h"
@@ -56,6 +58,9 @@ namespace Alimer
         , _initialized(false)
         , _adapter(nullptr)
         , _features{}
+        , _maxFramesInFlight(2)
+        , _asyncPipelineCompilation(true)
+        , _bindlessResources(false)
     {
     }
 
@@ -103,6 +108,7 @@ namespace Alimer
         if (availableBackends.empty())
         {
             availableBackends.insert(GraphicsDeviceType::Empty);
+            availableBackends.insert(GraphicsDeviceType::Software);
 
 #if ALIMER_VULKAN
             if (VulkanGraphics::IsSupported())
@@ -202,6 +208,15 @@ namespace Alimer
             break;
 
         case GraphicsDeviceType::Empty:
+            ALIMER_LOGINFO("Using Null graphics backend");
+            graphics = new NullGraphics(validation);
+            break;
+
+        case GraphicsDeviceType::Software:
+            ALIMER_LOGINFO("Using Software graphics backend");
+            graphics = new SoftwareGraphics(validation);
+            break;
+
         default:
             break;
         }
@@ -226,14 +241,28 @@ namespace Alimer
             _adapter = adapter;
         }
 
-        ALIMER_ASSERT_MSG(window.Get(), "Invalid window for graphics creation");
+        ALIMER_ASSERT_MSG(window.Get()
+            || _deviceType == GraphicsDeviceType::Empty
+            || _deviceType == GraphicsDeviceType::Software, "Invalid window for graphics creation");
         _window = window;
         _initialized = BackendInitialize();
         return _initialized;
     }
 
+    void Graphics::SetMaxFramesInFlight(uint32_t count)
+    {
+        if (_initialized)
+        {
+            ALIMER_LOGERROR("Cannot change frames in flight after Graphics initialization");
+            return;
+        }
+
+        _maxFramesInFlight = std::max(1u, std::min(count, MaxFramesInFlight));
+    }
+
     void Graphics::SaveScreenshot(const std::string& fileName)
     {
+        GenerateScreenshot(fileName);
     }
 
     Shader* Graphics::CreateShader(const string& vertexShaderFile, const std::string& fragmentShaderFile)
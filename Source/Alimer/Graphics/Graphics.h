@@ -67,6 +67,15 @@ namespace Alimer
         /// Initialize graphics with given adapter and window.
         bool Initialize(GpuAdapter* adapter, WindowPtr window);
 
+        /// Set number of frames the CPU can record ahead of the GPU, must be called before Initialize.
+        void SetMaxFramesInFlight(uint32_t count);
+
+        /// Set whether pipelines missing at draw time are compiled on worker threads, draws are skipped until they are ready.
+        void SetAsyncPipelineCompilation(bool enabled) { _asyncPipelineCompilation = enabled; }
+
+        /// Set whether textures and storage buffers get a stable index in a global descriptor heap, must be called before Initialize.
+        void SetBindlessResources(bool enabled) { _bindlessResources = enabled; }
+
         /// Wait for a device to become idle.
         virtual void WaitIdle() = 0;
 
@@ -79,6 +88,7 @@ namespace Alimer
         /// Try to save screenshot with given file name.
         void SaveScreenshot(const std::string& fileName);
 
+        /// Request command buffer for the current frame, secondary command buffers can be requested and recorded from any thread. Returns null when the backend does not support the type, only Vulkan supports secondary command buffers.
         virtual SharedPtr<CommandBuffer> RequestCommandBuffer(CommandBufferType type = CommandBufferType::Default) = 0;
         virtual void Submit(const SharedPtr<CommandBuffer> &commandBuffer) = 0;
 
@@ -104,6 +114,9 @@ namespace Alimer
         // PipelineState
         virtual PipelineState* CreateRenderPipelineState(const RenderPipelineDescription& description) = 0;
 
+        /// Create pipelines recorded by previous runs for the loaded shaders, avoids compilation hitches on first draw.
+        virtual void WarmUpPipelines() {}
+
         /// Get whether grapics has been initialized.
         bool IsInitialized() const { return _initialized; }
 
@@ -119,6 +132,15 @@ namespace Alimer
         /// Get the device features.
         const GpuDeviceFeatures& GetFeatures() const { return _features; }
 
+        /// Get number of frames the CPU can record ahead of the GPU.
+        uint32_t GetMaxFramesInFlight() const { return _maxFramesInFlight; }
+
+        /// Get whether pipelines missing at draw time are compiled on worker threads.
+        bool GetAsyncPipelineCompilation() const { return _asyncPipelineCompilation; }
+
+        /// Get whether bindless resources are enabled, false after Initialize when the backend does not support them.
+        bool GetBindlessResources() const { return _bindlessResources; }
+
     private:
         /// Add a GpuResource to keep track of. 
         void AddGpuResource(GpuResource* resource);
@@ -137,6 +159,9 @@ namespace Alimer
         bool _initialized;
         std::vector<GpuAdapter*> _adapters;
         GpuDeviceFeatures _features;
+        uint32_t _maxFramesInFlight;
+        bool _asyncPipelineCompilation;
+        bool _bindlessResources;
 
         WindowPtr _window{};
         GpuAdapter* _adapter;
@@ -39,6 +39,10 @@ namespace Alimer
 
         virtual bool SetData(uint32_t offset, uint32_t size, const void* data) = 0;
 
+        /// Get index of the buffer in the bindless heap, InvalidBindlessIndex if it has no slot.
+        uint32_t GetBindlessIndex() const { return _bindlessIndex; }
+
     protected:
+        uint32_t _bindlessIndex = InvalidBindlessIndex;
     };
 }
@@ -0,0 +1,302 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullCommandBuffer.h"
+#include "NullGraphics.h"
+#include "NullGpuBuffer.h"
+#include "../../Core/Log.h"
+#include <algorithm>
+
+namespace Alimer
+{
+    /// Size of the blocks transient uniforms are allocated from.
+    static constexpr uint64_t NullUniformBlockSize = 64u * 1024u;
+    /// Alignment of transient uniform allocations, the largest minUniformBufferOffsetAlignment of GPU backends.
+    static constexpr uint64_t NullUniformAlignment = 256u;
+
+    static uint64_t GetPrimitiveCount(PrimitiveTopology topology, uint32_t count)
+    {
+        switch (topology)
+        {
+        case PrimitiveTopology::Points:
+            return count;
+        case PrimitiveTopology::Lines:
+            return count / 2;
+        case PrimitiveTopology::LineStrip:
+            return count > 1 ? count - 1 : 0;
+        case PrimitiveTopology::Triangles:
+            return count / 3;
+        case PrimitiveTopology::TriangleStrip:
+            return count > 2 ? count - 2 : 0;
+        default:
+            return 0;
+        }
+    }
+
+    NullCommandBuffer::NullCommandBuffer(NullGraphics* graphics)
+        : _graphics(graphics)
+    {
+    }
+
+    NullCommandBuffer::~NullCommandBuffer()
+    {
+    }
+
+    void NullCommandBuffer::Reset()
+    {
+        _state = CommandBufferState::Ready;
+        _currentShader = nullptr;
+        _currentIndexBuffer = nullptr;
+        _currentIndexOffset = 0;
+        _boundVertexBuffers = 0;
+        for (uint32_t i = 0; i < MaxDescriptorSets; ++i)
+        {
+            _boundUniformBuffers[i] = 0;
+        }
+
+        _uniformBlockCount = 0;
+        _uniformOffset = 0;
+    }
+
+    void NullCommandBuffer::BeginRenderPassCore(RenderPass* renderPass, const Rectangle& /*renderArea*/, const Color* /*clearColors*/, uint32_t numClearColors, float /*clearDepth*/, uint8_t /*clearStencil*/)
+    {
+        if (renderPass && numClearColors > renderPass->GetColorAttachmentsCount())
+        {
+            _graphics->ReportError("BeginRenderPass with more clear colors than color attachments");
+        }
+
+        _graphics->GetCurrentStatistics().renderPasses++;
+    }
+
+    void NullCommandBuffer::EndRenderPassCore()
+    {
+    }
+
+    void NullCommandBuffer::ExecuteCommandsCore(uint32_t commandBufferCount, CommandBuffer* const* /*commandBuffers*/)
+    {
+        // Secondary buffers executed while recorded, only their submission is counted.
+        _graphics->GetCurrentStatistics().commandBuffersSubmitted += commandBufferCount;
+    }
+
+    void NullCommandBuffer::SetViewport(const Viewport& viewport)
+    {
+        if (viewport.width <= 0.0f || viewport.height <= 0.0f)
+        {
+            _graphics->ReportError("SetViewport with empty viewport");
+        }
+    }
+
+    void NullCommandBuffer::SetViewports(uint32_t numViewports, const Viewport* viewports)
+    {
+        if (numViewports > MaxViewportsAndScissors)
+        {
+            _graphics->ReportError("SetViewports with too many viewports");
+            return;
+        }
+
+        for (uint32_t i = 0; i < numViewports; ++i)
+        {
+            SetViewport(viewports[i]);
+        }
+    }
+
+    void NullCommandBuffer::SetScissor(const Rectangle& scissor)
+    {
+        SetScissors(1, &scissor);
+    }
+
+    void NullCommandBuffer::SetScissors(uint32_t numScissors, const Rectangle* /*scissors*/)
+    {
+        if (numScissors > MaxViewportsAndScissors)
+        {
+            _graphics->ReportError("SetScissors with too many scissors");
+        }
+    }
+
+    void NullCommandBuffer::SetShaderCore(Shader* shader)
+    {
+        if (_currentShader == shader)
+            return;
+
+        _currentShader = shader;
+        _graphics->GetCurrentStatistics().shaderChanges++;
+    }
+
+    void NullCommandBuffer::SetPipelineStateCore(PipelineState* pipelineState)
+    {
+        if (!pipelineState->GetShader())
+        {
+            _graphics->ReportError("SetPipelineState with pipeline state without shader");
+            return;
+        }
+
+        SetShaderCore(pipelineState->GetShader());
+    }
+
+    void NullCommandBuffer::SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t /*stride*/, VertexInputRate /*inputRate*/)
+    {
+        if (offset >= buffer->GetSize())
+        {
+            _graphics->ReportError("SetVertexBuffer offset out of bounds");
+        }
+
+        _boundVertexBuffers |= 1u << binding;
+        _graphics->GetCurrentStatistics().bufferBindings++;
+    }
+
+    void NullCommandBuffer::SetIndexBufferCore(GpuBuffer* buffer, uint32_t offset, IndexType indexType)
+    {
+        _currentIndexBuffer = buffer;
+        _currentIndexOffset = offset;
+        _currentIndexType = indexType;
+        _graphics->GetCurrentStatistics().bufferBindings++;
+    }
+
+    void NullCommandBuffer::SetUniformBufferCore(uint32_t set, uint32_t binding, GpuBuffer* buffer, uint64_t offset, uint64_t range)
+    {
+        if (offset + range > buffer->GetSize())
+        {
+            _graphics->ReportError("SetUniformBuffer range out of bounds");
+        }
+
+        _boundUniformBuffers[set] |= 1u << binding;
+        _graphics->GetCurrentStatistics().bufferBindings++;
+    }
+
+    TransientAllocation NullCommandBuffer::AllocateUniformCore(uint64_t size)
+    {
+        if (_uniformBlockCount == 0
+            || _uniformOffset + size > _uniformBlocks[_uniformBlockCount - 1]->GetSize())
+        {
+            if (_uniformBlockCount == _uniformBlocks.size()
+                || _uniformBlocks[_uniformBlockCount]->GetSize() < size)
+            {
+                GpuBufferDescription description = {};
+                description.usage = BufferUsage::Uniform;
+                description.elementSize = static_cast<uint32_t>(std::max(size, NullUniformBlockSize));
+                description.resourceUsage = ResourceUsage::Dynamic;
+                _uniformBlocks.emplace(_uniformBlocks.begin() + _uniformBlockCount, new GpuBuffer(_graphics, description));
+            }
+
+            _uniformBlockCount++;
+            _uniformOffset = 0;
+        }
+
+        GpuBuffer* buffer = _uniformBlocks[_uniformBlockCount - 1].Get();
+
+        TransientAllocation allocation;
+        allocation.buffer = buffer;
+        allocation.offset = _uniformOffset;
+        allocation.data = static_cast<NullGpuBuffer*>(buffer->GetHandle())->GetData() + _uniformOffset;
+        _uniformOffset = (_uniformOffset + size + NullUniformAlignment - 1) & ~(NullUniformAlignment - 1);
+        return allocation;
+    }
+
+    void NullCommandBuffer::PushConstantsCore(const void* /*data*/, uint32_t /*size*/, uint32_t /*offset*/)
+    {
+        // Executed at record time, there are no shaders reading the constants.
+    }
+
+    void NullCommandBuffer::SetTextureCore(uint32_t /*binding*/, Texture* texture, ShaderStageFlags /*stage*/)
+    {
+        if (texture && !(texture->GetUsage() & TextureUsage::ShaderRead))
+        {
+            _graphics->ReportError("SetTexture with texture missing ShaderRead usage");
+        }
+
+        _graphics->GetCurrentStatistics().textureBindings++;
+    }
+
+    bool NullCommandBuffer::PrepareDraw(uint32_t count, uint32_t instanceCount)
+    {
+        if (!_currentShader)
+        {
+            _graphics->ReportError("Draw without bound shader");
+            return false;
+        }
+
+        if (_currentShader->IsCompute())
+        {
+            _graphics->ReportError("Draw with compute shader bound");
+            return false;
+        }
+
+        if (count == 0 || instanceCount == 0)
+        {
+            _graphics->ReportError("Draw with zero vertices or instances");
+            return false;
+        }
+
+        const ResourceLayout& layout = _currentShader->GetResourceLayout();
+        for (uint32_t set = 0; set < MaxDescriptorSets; ++set)
+        {
+            const uint32_t required = layout.sets[set].uniformBufferMask;
+            if ((_boundUniformBuffers[set] & required) != required)
+            {
+                _graphics->ReportError("Draw with shader uniform buffer not bound");
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void NullCommandBuffer::RecordDraw(PrimitiveTopology topology, uint32_t count, uint32_t instanceCount)
+    {
+        NullGraphicsStatistics& statistics = _graphics->GetCurrentStatistics();
+        statistics.drawCalls++;
+        statistics.instances += instanceCount;
+        statistics.primitives += GetPrimitiveCount(topology, count) * instanceCount;
+    }
+
+    void NullCommandBuffer::DrawCore(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance)
+    {
+        if (!PrepareDraw(vertexCount, instanceCount))
+            return;
+
+        RecordDraw(topology, vertexCount, instanceCount);
+        ExecuteDraw(topology, vertexCount, instanceCount, vertexStart, baseInstance, false);
+    }
+
+    void NullCommandBuffer::DrawIndexedCore(PrimitiveTopology topology, uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex)
+    {
+        if (!_currentIndexBuffer)
+        {
+            _graphics->ReportError("DrawIndexed without bound index buffer");
+            return;
+        }
+
+        const uint64_t indexSize = _currentIndexType == IndexType::UInt16 ? 2 : 4;
+        if (_currentIndexOffset + (static_cast<uint64_t>(startIndex) + indexCount) * indexSize > _currentIndexBuffer->GetSize())
+        {
+            _graphics->ReportError("DrawIndexed reads past the end of the index buffer");
+            return;
+        }
+
+        if (!PrepareDraw(indexCount, instanceCount))
+            return;
+
+        RecordDraw(topology, indexCount, instanceCount);
+        ExecuteDraw(topology, indexCount, instanceCount, startIndex, 0, true);
+    }
+}
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "Graphics/CommandBuffer.h"
+#include <vector>
+
+namespace Alimer
+{
+    class NullGraphics;
+    class NullRenderPass;
+
+    /// Null CommandBuffer implementation, executes at record time tracking bound state for statistics and validation.
+    class NullCommandBuffer : public CommandBuffer
+    {
+    public:
+        /// Constructor.
+        NullCommandBuffer(NullGraphics* graphics);
+
+        /// Destructor.
+        ~NullCommandBuffer() override;
+
+        /// Reset bound state, called once submitted.
+        virtual void Reset();
+
+        bool IsRecordingRenderPass() const { return IsInsideRenderPass(); }
+
+        void SetViewport(const Viewport& viewport) override;
+        void SetViewports(uint32_t numViewports, const Viewport* viewports) override;
+
+        void SetScissor(const Rectangle& scissor) override;
+        void SetScissors(uint32_t numScissors, const Rectangle* scissors) override;
+
+    protected:
+        void BeginRenderPassCore(RenderPass* renderPass, const Rectangle& renderArea, const Color* clearColors, uint32_t numClearColors, float clearDepth, uint8_t clearStencil) override;
+        void EndRenderPassCore() override;
+        void ExecuteCommandsCore(uint32_t commandBufferCount, CommandBuffer* const* commandBuffers) override;
+
+        void SetShaderCore(Shader* shader) override;
+        void SetPipelineStateCore(PipelineState* pipelineState) override;
+        void SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t stride, VertexInputRate inputRate) override;
+        void SetIndexBufferCore(GpuBuffer* buffer, uint32_t offset, IndexType indexType) override;
+        void SetUniformBufferCore(uint32_t set, uint32_t binding, GpuBuffer* buffer, uint64_t offset, uint64_t range) override;
+        TransientAllocation AllocateUniformCore(uint64_t size) override;
+        void PushConstantsCore(const void* data, uint32_t size, uint32_t offset) override;
+        void SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags stage) override;
+
+        void DrawCore(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance) override;
+        void DrawIndexedCore(PrimitiveTopology topology, uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex) override;
+
+        bool PrepareDraw(uint32_t count, uint32_t instanceCount);
+        void RecordDraw(PrimitiveTopology topology, uint32_t count, uint32_t instanceCount);
+
+        /// Called for draws that passed validation, backends executing draws on the CPU override it.
+        virtual void ExecuteDraw(PrimitiveTopology /*topology*/, uint32_t /*count*/, uint32_t /*instanceCount*/, uint32_t /*first*/, uint32_t /*baseInstance*/, bool /*indexed*/) {}
+
+        NullGraphics* _graphics;
+
+        Shader* _currentShader = nullptr;
+        GpuBuffer* _currentIndexBuffer = nullptr;
+        uint32_t _currentIndexOffset = 0;
+        IndexType _currentIndexType = IndexType::UInt16;
+        uint32_t _boundVertexBuffers = 0;
+        uint32_t _boundUniformBuffers[MaxDescriptorSets] = {};
+
+        /// System memory blocks transient uniforms are allocated from, rewound once submitted.
+        std::vector<SharedPtr<GpuBuffer>> _uniformBlocks;
+        uint32_t _uniformBlockCount = 0;
+        uint64_t _uniformOffset = 0;
+    };
+}
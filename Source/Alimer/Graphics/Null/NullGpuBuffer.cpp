@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullGpuBuffer.h"
+#include "NullGraphics.h"
+#include "../../Core/Log.h"
+#include <cstring>
+
+namespace Alimer
+{
+    NullGpuBuffer::NullGpuBuffer(NullGraphics* graphics, BufferUsageFlags usage, uint64_t size, uint32_t stride, ResourceUsage resourceUsage, const void* initialData)
+        : _graphics(graphics)
+        , _usage(usage)
+        , _stride(stride)
+        , _data(static_cast<size_t>(size))
+    {
+        if (resourceUsage == ResourceUsage::Immutable && !initialData)
+        {
+            _graphics->ReportError("Immutable buffer created without initial data");
+        }
+
+        if (initialData)
+        {
+            memcpy(_data.data(), initialData, _data.size());
+        }
+
+        _graphics->AddAllocatedMemory(_data.size());
+    }
+
+    NullGpuBuffer::~NullGpuBuffer()
+    {
+        _graphics->RemoveAllocatedMemory(_data.size());
+    }
+
+    bool NullGpuBuffer::SetData(uint32_t offset, uint32_t size, const void* data)
+    {
+        if (static_cast<uint64_t>(offset) + size > _data.size())
+        {
+            _graphics->ReportError("Buffer SetData out of bounds");
+            return false;
+        }
+
+        memcpy(_data.data() + offset, data, size);
+        _graphics->GetCurrentStatistics().bufferUploadBytes += size;
+        return true;
+    }
+}
@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "Graphics/GpuBuffer.h"
+#include "../GraphicsImpl.h"
+#include <vector>
+
+namespace Alimer
+{
+	class NullGraphics;
+
+	/// Null GpuBuffer implementation, stores contents in system memory.
+	class NullGpuBuffer final : public BufferHandle
+	{
+	public:
+		/// Constructor.
+		NullGpuBuffer(NullGraphics* graphics, BufferUsageFlags usage, uint64_t size, uint32_t stride, ResourceUsage resourceUsage, const void* initialData);
+
+		/// Destructor.
+		~NullGpuBuffer() override;
+
+        bool SetData(uint32_t offset, uint32_t size, const void* data) override;
+
+        BufferUsageFlags GetUsage() const { return _usage; }
+        uint32_t GetStride() const { return _stride; }
+        const uint8_t* GetData() const { return _data.data(); }
+        uint8_t* GetData() { return _data.data(); }
+        uint64_t GetSize() const { return _data.size(); }
+
+	private:
+        NullGraphics* _graphics;
+        BufferUsageFlags _usage;
+        uint32_t _stride;
+        std::vector<uint8_t> _data;
+	};
+}
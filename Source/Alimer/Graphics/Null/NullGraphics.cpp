@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullGraphics.h"
+#include "NullGpuAdapter.h"
+#include "NullCommandBuffer.h"
+#include "NullGpuBuffer.h"
+#include "NullTexture.h"
+#include "NullRenderPass.h"
+#include "NullShader.h"
+#include "NullPipelineState.h"
+#include "../../Core/String.h"
+#include "../../Core/Log.h"
+
+namespace Alimer
+{
+    static void AccumulateStatistics(NullGraphicsStatistics& total, const NullGraphicsStatistics& frame)
+    {
+        total.frames += frame.frames;
+        total.commandBuffersSubmitted += frame.commandBuffersSubmitted;
+        total.renderPasses += frame.renderPasses;
+        total.drawCalls += frame.drawCalls;
+        total.instances += frame.instances;
+        total.primitives += frame.primitives;
+        total.shaderChanges += frame.shaderChanges;
+        total.bufferBindings += frame.bufferBindings;
+        total.textureBindings += frame.textureBindings;
+        total.bufferUploadBytes += frame.bufferUploadBytes;
+        total.validationErrors += frame.validationErrors;
+    }
+
+    bool NullGraphics::IsSupported()
+    {
+        return true;
+    }
+
+    NullGraphics::NullGraphics(bool validation)
+        : NullGraphics(GraphicsDeviceType::Empty, validation)
+    {
+    }
+
+    NullGraphics::NullGraphics(GraphicsDeviceType deviceType, bool validation)
+        : Graphics(deviceType, validation)
+        , _allocatedMemory(0)
+    {
+        _adapters.push_back(new NullGpuAdapter());
+    }
+
+    NullGraphics::~NullGraphics()
+    {
+        Finalize();
+    }
+
+    void NullGraphics::Finalize()
+    {
+        WaitIdle();
+
+        _defaultCommandBuffer.Reset();
+
+        Graphics::Finalize();
+    }
+
+    bool NullGraphics::BackendInitialize()
+    {
+        _defaultCommandBuffer = new NullCommandBuffer(this);
+        return true;
+    }
+
+    void NullGraphics::WaitIdle()
+    {
+        // Commands execute at record time, nothing is ever in flight.
+    }
+
+    bool NullGraphics::BeginFrame()
+    {
+        if (_inFrame)
+        {
+            ReportError("BeginFrame called before EndFrame");
+        }
+
+        _inFrame = true;
+        _currentStatistics = {};
+        return true;
+    }
+
+    void NullGraphics::EndFrame()
+    {
+        if (!_inFrame)
+        {
+            ReportError("EndFrame called without BeginFrame");
+        }
+
+        _inFrame = false;
+        _currentStatistics.frames = 1;
+        _frameStatistics = _currentStatistics;
+        AccumulateStatistics(_totalStatistics, _currentStatistics);
+    }
+
+    SharedPtr<CommandBuffer> NullGraphics::RequestCommandBuffer(CommandBufferType type)
+    {
+        switch (type)
+        {
+        case CommandBufferType::Default:
+            return _defaultCommandBuffer;
+
+        default:
+            ALIMER_LOGERROR("CommandBuffer type not supported by the graphics backend: {}", str::ToString(type));
+            return nullptr;
+        }
+    }
+
+    void NullGraphics::Submit(const SharedPtr<CommandBuffer> &commandBuffer)
+    {
+        auto nullCommandBuffer = StaticCast<NullCommandBuffer>(commandBuffer);
+        if (nullCommandBuffer->IsRecordingRenderPass())
+        {
+            ReportError("Submit called with CommandBuffer inside render pass");
+        }
+
+        nullCommandBuffer->Reset();
+        _currentStatistics.commandBuffersSubmitted++;
+    }
+
+    void NullGraphics::ReportError(const char* message)
+    {
+        _currentStatistics.validationErrors++;
+
+        if (_validation)
+        {
+            ALIMER_LOGERROR("Null - {}", message);
+        }
+    }
+
+    SharedPtr<RenderPass> NullGraphics::CreateRenderPass(const RenderPassDescription& description)
+    {
+        return MakeShared<NullRenderPass>(this, description);
+    }
+
+    BufferHandle* NullGraphics::CreateBuffer(BufferUsageFlags usage, uint64_t size, uint32_t stride, ResourceUsage resourceUsage, const void* initialData)
+    {
+        return new NullGpuBuffer(this, usage, size, stride, resourceUsage, initialData);
+    }
+
+    SharedPtr<Texture> NullGraphics::CreateTexture(const TextureDescription& description, const ImageLevel* initialData)
+    {
+        return MakeShared<NullTexture>(this, description, initialData);
+    }
+
+    Shader* NullGraphics::CreateComputeShader(const void *pCode, size_t codeSize)
+    {
+        return new NullShader(this, pCode, codeSize);
+    }
+
+    Shader* NullGraphics::CreateShader(
+        const void *pVertexCode, size_t vertexCodeSize,
+        const void *pFragmentCode, size_t fragmentCodeSize)
+    {
+        return new NullShader(this,
+            pVertexCode, vertexCodeSize,
+            pFragmentCode, fragmentCodeSize
+        );
+    }
+
+    PipelineState* NullGraphics::CreateRenderPipelineState(const RenderPipelineDescription& description)
+    {
+        return new NullPipelineState(this, description);
+    }
+}
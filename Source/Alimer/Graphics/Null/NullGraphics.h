@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../../Graphics/Graphics.h"
+
+namespace Alimer
+{
+    class NullCommandBuffer;
+
+    /// Counters recorded by the null backend.
+    struct NullGraphicsStatistics
+    {
+        uint64_t frames = 0;
+        uint64_t commandBuffersSubmitted = 0;
+        uint64_t renderPasses = 0;
+        uint64_t drawCalls = 0;
+        uint64_t instances = 0;
+        uint64_t primitives = 0;
+        uint64_t shaderChanges = 0;
+        uint64_t bufferBindings = 0;
+        uint64_t textureBindings = 0;
+        uint64_t bufferUploadBytes = 0;
+        uint64_t validationErrors = 0;
+    };
+
+    /// Null Low-level 3D graphics API class, implements the whole API in system memory without a GPU.
+    class NullGraphics : public Graphics
+    {
+    public:
+        /// Is backend supported?
+        static bool IsSupported();
+
+        /// Constructor.
+        NullGraphics(bool validation);
+
+        /// Destructor.
+        ~NullGraphics() override;
+
+        void WaitIdle() override;
+
+        bool BeginFrame() override;
+        void EndFrame() override;
+
+        SharedPtr<CommandBuffer> RequestCommandBuffer(CommandBufferType type) override;
+        void Submit(const SharedPtr<CommandBuffer> &commandBuffer) override;
+
+        SharedPtr<RenderPass> CreateRenderPass(const RenderPassDescription& description) override;
+
+        BufferHandle* CreateBuffer(BufferUsageFlags usage, uint64_t size, uint32_t stride, ResourceUsage resourceUsage, const void* initialData) override;
+
+        SharedPtr<Texture> CreateTexture(const TextureDescription& description, const ImageLevel* initialData) override;
+
+        Shader* CreateComputeShader(const void *pCode, size_t codeSize) override;
+        Shader* CreateShader(const void *pVertexCode, size_t vertexCodeSize,
+            const void *pFragmentCode, size_t fragmentCodeSize) override;
+        PipelineState* CreateRenderPipelineState(const RenderPipelineDescription& description) override;
+
+        /// Report API misuse, counted in statistics and logged when validation is enabled.
+        void ReportError(const char* message);
+
+        /// Return whether API usage is validated.
+        bool IsValidationEnabled() const { return _validation; }
+
+        /// Return statistics of the last finished frame.
+        const NullGraphicsStatistics& GetFrameStatistics() const { return _frameStatistics; }
+
+        /// Return statistics accumulated since creation.
+        const NullGraphicsStatistics& GetTotalStatistics() const { return _totalStatistics; }
+
+        /// Return statistics of the frame being recorded.
+        NullGraphicsStatistics& GetCurrentStatistics() { return _currentStatistics; }
+
+        /// Return bytes of system memory held by buffers and textures.
+        uint64_t GetAllocatedMemory() const { return _allocatedMemory; }
+
+        void AddAllocatedMemory(uint64_t size) { _allocatedMemory += size; }
+        void RemoveAllocatedMemory(uint64_t size) { _allocatedMemory -= size; }
+
+    protected:
+        /// Constructor used by backends built on top of the null backend.
+        NullGraphics(GraphicsDeviceType deviceType, bool validation);
+
+        void Finalize() override;
+        bool BackendInitialize() override;
+
+        SharedPtr<NullCommandBuffer> _defaultCommandBuffer;
+
+    private:
+        bool _inFrame = false;
+        std::atomic<uint64_t> _allocatedMemory;
+        NullGraphicsStatistics _currentStatistics;
+        NullGraphicsStatistics _frameStatistics;
+        NullGraphicsStatistics _totalStatistics;
+    };
+}
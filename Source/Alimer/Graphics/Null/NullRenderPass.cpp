@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullRenderPass.h"
+#include "NullGraphics.h"
+
+namespace Alimer
+{
+    NullRenderPass::NullRenderPass(NullGraphics* graphics, const RenderPassDescription& description)
+        : RenderPass(graphics, description)
+    {
+        for (uint32_t i = 0; i < _colorAttachmentsCount; ++i)
+        {
+            const RenderPassAttachment& attachment = _colorAttachments[i];
+            if (attachment.texture->GetLevelWidth(attachment.mipLevel) < _width
+                || attachment.texture->GetLevelHeight(attachment.mipLevel) < _height)
+            {
+                graphics->ReportError("RenderPass color attachment smaller than render area");
+            }
+        }
+
+        if (_depthStencilAttachment.texture
+            && !IsDepthStencilFormat(_depthStencilAttachment.texture->GetFormat()))
+        {
+            graphics->ReportError("RenderPass depth stencil attachment without depth format");
+        }
+    }
+
+    NullRenderPass::~NullRenderPass()
+    {
+    }
+}
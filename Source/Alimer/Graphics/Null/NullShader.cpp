@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullShader.h"
+#include "NullGraphics.h"
+#include <cstring>
+
+namespace Alimer
+{
+    static std::vector<uint32_t> CopySpirv(const void *pCode, size_t codeSize)
+    {
+        std::vector<uint32_t> code(codeSize / sizeof(uint32_t));
+        memcpy(code.data(), pCode, code.size() * sizeof(uint32_t));
+        return code;
+    }
+
+    NullShader::NullShader(NullGraphics* graphics, const void *pCode, size_t codeSize)
+        : Shader(graphics, pCode, codeSize)
+        , _computeCode(CopySpirv(pCode, codeSize))
+    {
+    }
+
+    NullShader::NullShader(NullGraphics* graphics,
+        const void *pVertexCode, size_t vertexCodeSize,
+        const void *pFragmentCode, size_t fragmentCodeSize)
+        : Shader(graphics, pVertexCode, vertexCodeSize, pFragmentCode, fragmentCodeSize)
+        , _vertexCode(CopySpirv(pVertexCode, vertexCodeSize))
+        , _fragmentCode(CopySpirv(pFragmentCode, fragmentCodeSize))
+    {
+    }
+
+    NullShader::~NullShader()
+    {
+    }
+}
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "Graphics/Shader.h"
+#include <vector>
+
+namespace Alimer
+{
+	class NullGraphics;
+
+	/// Null Shader implementation, keeps SPIR-V bytecode and reflected layout.
+	class NullShader final : public Shader
+	{
+	public:
+		/// Constructor.
+        NullShader(NullGraphics* graphics, const void *pCode, size_t codeSize);
+		/// Constructor.
+        NullShader(NullGraphics* graphics,
+            const void *pVertexCode, size_t vertexCodeSize,
+            const void *pFragmentCode, size_t fragmentCodeSize);
+
+		/// Destructor.
+		~NullShader() override;
+
+        const std::vector<uint32_t>& GetVertexCode() const { return _vertexCode; }
+        const std::vector<uint32_t>& GetFragmentCode() const { return _fragmentCode; }
+        const std::vector<uint32_t>& GetComputeCode() const { return _computeCode; }
+
+	private:
+        std::vector<uint32_t> _vertexCode;
+        std::vector<uint32_t> _fragmentCode;
+        std::vector<uint32_t> _computeCode;
+	};
+}
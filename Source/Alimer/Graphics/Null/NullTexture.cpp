@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullTexture.h"
+#include "NullGraphics.h"
+#include "../../Core/Log.h"
+#include <cstring>
+
+namespace Alimer
+{
+    NullTexture::NullTexture(NullGraphics* graphics, const TextureDescription& description, const ImageLevel* initialData)
+        : Texture(graphics, description)
+        , _nullGraphics(graphics)
+    {
+        if (IsDepthStencilFormat(description.format) && !(description.usage & TextureUsage::RenderTarget))
+        {
+            _nullGraphics->ReportError("Depth stencil texture created without RenderTarget usage");
+        }
+
+        const uint32_t subresourceCount = description.arrayLayers * description.mipLevels;
+        _subresourceOffsets.resize(subresourceCount);
+
+        size_t totalSize = 0;
+        for (uint32_t layer = 0; layer < description.arrayLayers; ++layer)
+        {
+            for (uint32_t level = 0; level < description.mipLevels; ++level)
+            {
+                _subresourceOffsets[layer * description.mipLevels + level] = totalSize;
+                totalSize += CalculateDataSize(GetLevelWidth(level), GetLevelHeight(level), description.format) * GetLevelDepth(level);
+            }
+        }
+
+        _data.resize(totalSize);
+        _nullGraphics->AddAllocatedMemory(_data.size());
+
+        if (initialData)
+        {
+            for (uint32_t i = 0; i < subresourceCount; ++i)
+            {
+                const uint32_t level = i % description.mipLevels;
+                uint32_t rows;
+                uint32_t rowPitch;
+                CalculateDataSize(GetLevelWidth(level), GetLevelHeight(level), description.format, &rows, &rowPitch);
+                rows *= GetLevelDepth(level);
+
+                const uint32_t sourcePitch = initialData[i].rowPitch ? initialData[i].rowPitch : rowPitch;
+                const uint8_t* source = static_cast<const uint8_t*>(initialData[i].data);
+                uint8_t* dest = _data.data() + _subresourceOffsets[i];
+                for (uint32_t row = 0; row < rows; ++row)
+                {
+                    memcpy(dest + row * rowPitch, source + row * sourcePitch, rowPitch);
+                }
+            }
+        }
+    }
+
+    NullTexture::~NullTexture()
+    {
+        Destroy();
+    }
+
+    void NullTexture::Destroy()
+    {
+        if (!_data.empty())
+        {
+            _nullGraphics->RemoveAllocatedMemory(_data.size());
+            _data.clear();
+            _data.shrink_to_fit();
+        }
+    }
+
+    uint8_t* NullTexture::GetData(uint32_t mipLevel, uint32_t arrayLayer)
+    {
+        ALIMER_ASSERT(mipLevel < _description.mipLevels);
+        ALIMER_ASSERT(arrayLayer < _description.arrayLayers);
+        if (_data.empty())
+            return nullptr;
+
+        return _data.data() + _subresourceOffsets[arrayLayer * _description.mipLevels + mipLevel];
+    }
+
+    uint32_t NullTexture::GetRowPitch(uint32_t mipLevel) const
+    {
+        uint32_t rows;
+        uint32_t rowPitch;
+        CalculateDataSize(GetLevelWidth(mipLevel), GetLevelHeight(mipLevel), _description.format, &rows, &rowPitch);
+        return rowPitch;
+    }
+}
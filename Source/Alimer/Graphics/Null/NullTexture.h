@@ -0,0 +1,57 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "Graphics/Texture.h"
+#include <vector>
+
+namespace Alimer
+{
+    class NullGraphics;
+
+    /// Null Texture implementation, stores every mip level and layer in system memory.
+    class NullTexture final : public Texture
+    {
+    public:
+        /// Constructor.
+        NullTexture(NullGraphics* graphics, const TextureDescription& description, const ImageLevel* initialData);
+
+        /// Destructor.
+        ~NullTexture() override;
+
+        void Destroy() override;
+
+        /// Return data of given mip level and array layer, tightly packed.
+        uint8_t* GetData(uint32_t mipLevel, uint32_t arrayLayer);
+
+        /// Return row pitch in bytes of given mip level.
+        uint32_t GetRowPitch(uint32_t mipLevel) const;
+
+    private:
+        NullGraphics* _nullGraphics;
+        std::vector<uint8_t> _data;
+        /// Offset of each subresource, layer major like initial data.
+        std::vector<size_t> _subresourceOffsets;
+    };
+}
@@ -25,9 +25,34 @@
 
 namespace Alimer
 {
+    static_assert(sizeof(RenderTargetBlendState) == 8, "RenderTargetBlendState must not contain padding");
+    static_assert(sizeof(BlendState) == 2 + sizeof(RenderTargetBlendState) * MaxColorAttachments, "BlendState must not contain padding");
+    static_assert(sizeof(RasterizerState) == 16, "RasterizerState must not contain padding");
+    static_assert(sizeof(DepthStencilState) == 6 + sizeof(StencilOpState) * 2, "DepthStencilState must not contain padding");
+
 	PipelineState::PipelineState(Graphics* graphics, bool isGraphics)
 		: _graphics(graphics)
 		, _isGraphics(isGraphics)
 	{
 	}
+
+    PipelineState::PipelineState(Graphics* graphics, const RenderPipelineDescription& description)
+        : _graphics(graphics)
+        , _isGraphics(true)
+        , _shader(description.shader)
+        , _blendState(description.blendState)
+        , _rasterizerState(description.rasterizerState)
+        , _depthStencilState(description.depthStencilState)
+    {
+        _renderStateHash = HashRenderState(_blendState, _rasterizerState, _depthStencilState);
+    }
+
+    Hash PipelineState::HashRenderState(const BlendState& blendState, const RasterizerState& rasterizerState, const DepthStencilState& depthStencilState)
+    {
+        Hasher h;
+        h.data(reinterpret_cast<const uint8_t*>(&blendState), sizeof(BlendState));
+        h.data(reinterpret_cast<const uint8_t*>(&rasterizerState), sizeof(RasterizerState));
+        h.data(reinterpret_cast<const uint8_t*>(&depthStencilState), sizeof(DepthStencilState));
+        return h.get();
+    }
 }
@@ -25,24 +25,144 @@
 #include "../Core/Ptr.h"
 #include "../Graphics/Types.h"
 #include "../Graphics/Shader.h"
+#include "../Util/HashMap.h"
 
 namespace Alimer
 {
     class Graphics;
 
-    struct BlendState
+    enum class BlendFactor : uint8_t
+    {
+        Zero,
+        One,
+        SourceColor,
+        OneMinusSourceColor,
+        SourceAlpha,
+        OneMinusSourceAlpha,
+        DestinationColor,
+        OneMinusDestinationColor,
+        DestinationAlpha,
+        OneMinusDestinationAlpha,
+        SourceAlphaSaturated,
+        BlendColor,
+        OneMinusBlendColor
+    };
+
+    enum class BlendOperation : uint8_t
+    {
+        Add,
+        Subtract,
+        ReverseSubtract,
+        Min,
+        Max
+    };
+
+    /// Mask of color components written to a render target.
+    enum class ColorWriteMask : uint8_t
+    {
+        None = 0,
+        Red = 0x1,
+        Green = 0x2,
+        Blue = 0x4,
+        Alpha = 0x8,
+        All = 0xF
+    };
+
+    enum class CompareFunction : uint8_t
+    {
+        Never,
+        Less,
+        Equal,
+        LessEqual,
+        Greater,
+        NotEqual,
+        GreaterEqual,
+        Always
+    };
+
+    enum class StencilOperation : uint8_t
+    {
+        Keep,
+        Zero,
+        Replace,
+        IncrementClamp,
+        DecrementClamp,
+        Invert,
+        IncrementWrap,
+        DecrementWrap
+    };
+
+    enum class FillMode : uint8_t
+    {
+        Solid,
+        Wireframe
+    };
+
+    enum class CullMode : uint8_t
     {
+        None,
+        Front,
+        Back
+    };
 
+    enum class FrontFace : uint8_t
+    {
+        Clockwise,
+        CounterClockwise
+    };
+
+    // State blocks are plain data without padding, they are hashed and written to disk as bytes.
+
+    struct RenderTargetBlendState
+    {
+        bool blendEnable = false;
+        BlendFactor sourceColorBlendFactor = BlendFactor::One;
+        BlendFactor destinationColorBlendFactor = BlendFactor::Zero;
+        BlendOperation colorBlendOperation = BlendOperation::Add;
+        BlendFactor sourceAlphaBlendFactor = BlendFactor::One;
+        BlendFactor destinationAlphaBlendFactor = BlendFactor::Zero;
+        BlendOperation alphaBlendOperation = BlendOperation::Add;
+        ColorWriteMask colorWriteMask = ColorWriteMask::All;
+    };
+
+    struct BlendState
+    {
+        bool alphaToCoverageEnable = false;
+        /// When disabled every render target uses the blend state of the first one.
+        bool independentBlendEnable = false;
+        RenderTargetBlendState renderTargets[MaxColorAttachments];
     };
 
     struct RasterizerState
     {
+        FillMode fillMode = FillMode::Solid;
+        CullMode cullMode = CullMode::None;
+        FrontFace frontFace = FrontFace::Clockwise;
+        /// Disabling depth clip clamps depth instead, ignored on Vulkan devices without the depthClamp feature.
+        bool depthClipEnable = true;
+        int32_t depthBias = 0;
+        float depthBiasClamp = 0.0f;
+        float slopeScaledDepthBias = 0.0f;
+    };
 
+    struct StencilOpState
+    {
+        StencilOperation failOperation = StencilOperation::Keep;
+        StencilOperation depthFailOperation = StencilOperation::Keep;
+        StencilOperation passOperation = StencilOperation::Keep;
+        CompareFunction compareFunction = CompareFunction::Always;
     };
 
     struct DepthStencilState
     {
-
+        bool depthTestEnable = false;
+        bool depthWriteEnable = false;
+        CompareFunction depthCompareFunction = CompareFunction::Less;
+        bool stencilEnable = false;
+        uint8_t stencilReadMask = 0xFF;
+        uint8_t stencilWriteMask = 0xFF;
+        StencilOpState frontFace;
+        StencilOpState backFace;
     };
 
     struct RenderPipelineDescription
@@ -59,16 +179,32 @@ namespace Alimer
     protected:
         /// Constructor.
         PipelineState(Graphics* graphics, bool isGraphics);
+        /// Constructor of graphics pipeline state, hashes the render state once.
+        PipelineState(Graphics* graphics, const RenderPipelineDescription& description);
 
     public:
         /// Destructor.
         virtual ~PipelineState() = default;
 
+        /// Get hash of blend, rasterizer and depth stencil state, stable between runs.
+        static Hash HashRenderState(const BlendState& blendState, const RasterizerState& rasterizerState, const DepthStencilState& depthStencilState);
+
         bool IsGraphics() const { return _isGraphics; }
 
+        Shader* GetShader() const { return _shader.Get(); }
+        const BlendState& GetBlendState() const { return _blendState; }
+        const RasterizerState& GetRasterizerState() const { return _rasterizerState; }
+        const DepthStencilState& GetDepthStencilState() const { return _depthStencilState; }
+        Hash GetRenderStateHash() const { return _renderStateHash; }
+
     protected:
         Graphics * _graphics;
         bool _isGraphics;
+        SharedPtr<Shader> _shader;
+        BlendState _blendState;
+        RasterizerState _rasterizerState;
+        DepthStencilState _depthStencilState;
+        Hash _renderStateHash = 0;
 
     private:
         DISALLOW_COPY_MOVE_AND_ASSIGN(PipelineState);
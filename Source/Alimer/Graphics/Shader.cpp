@@ -23,6 +23,7 @@
 #include "Graphics/Shader.h"
 #include "Graphics/Graphics.h"
 #include <spirv_cross.hpp>
+#include <algorithm>
 #include <vector>
 using namespace std;
 
@@ -90,6 +91,19 @@ namespace Alimer
             }
         }
 
+        for (auto &pushConstant : resources.push_constant_buffers)
+        {
+            size_t size = compiler.get_declared_struct_size(compiler.get_type(pushConstant.base_type_id));
+            if (size > MaxPushConstantSize)
+            {
+                ALIMER_LOGERROR("SPIRV push constant block larger than allowed one");
+                continue;
+            }
+
+            _layout.pushConstantSize = std::max(_layout.pushConstantSize, static_cast<uint32_t>(size));
+            _layout.pushConstantStages |= static_cast<uint32_t>(stage);
+        }
+
         auto ExtractResourcesBinding = [this](
             const ShaderStage& stage,
             const std::vector<spirv_cross::Resource>& resources,
@@ -113,6 +127,7 @@ namespace Alimer
                     _layout.sets[set].uniformBufferMask |= 1u << binding;
                     break;
                 case BindingType::SampledTexture:
+                    _layout.sets[set].sampledImageMask |= 1u << binding;
                     break;
                 case BindingType::Sampler:
                     break;
@@ -78,6 +78,7 @@ namespace Alimer
     struct DescriptorSetLayout
     {
         uint32_t uniformBufferMask = 0;
+        uint32_t sampledImageMask = 0;
         uint32_t stages = 0;
     };
 
@@ -87,6 +88,8 @@ namespace Alimer
         uint32_t renderTargetMask = 0;
         DescriptorSetLayout sets[MaxDescriptorSets] = {};
         uint32_t descriptorSetMask = 0;
+        uint32_t pushConstantSize = 0;
+        uint32_t pushConstantStages = 0;
         //std::map<std::string, ShaderResourceParameter> resources;
     };
 
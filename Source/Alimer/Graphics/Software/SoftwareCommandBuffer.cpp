@@ -0,0 +1,469 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "SoftwareCommandBuffer.h"
+#include "SoftwareGraphics.h"
+#include "SoftwareShader.h"
+#include "../Null/NullGpuBuffer.h"
+#include "../Null/NullTexture.h"
+#include "../../Core/JobSystem.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Alimer
+{
+    /// Vertices shaded by one job, amortizes creating the invocation.
+    static constexpr uint32_t VertexBatchSize = 64u;
+
+    struct VertexAttribute
+    {
+        const uint8_t* data;
+        uint32_t stride;
+        uint32_t count;
+        VertexElementFormat format;
+        bool perInstance;
+    };
+
+    static const uint8_t* GetBufferData(GpuBuffer* buffer)
+    {
+        return static_cast<NullGpuBuffer*>(buffer->GetHandle())->GetData();
+    }
+
+    static uint32_t FetchAttribute(const uint8_t* data, VertexElementFormat format, float* values)
+    {
+        switch (format)
+        {
+        case VertexElementFormat::Float:
+            memcpy(values, data, sizeof(float));
+            return 1;
+        case VertexElementFormat::Float2:
+            memcpy(values, data, 2 * sizeof(float));
+            return 2;
+        case VertexElementFormat::Float3:
+            memcpy(values, data, 3 * sizeof(float));
+            return 3;
+        case VertexElementFormat::Float4:
+            memcpy(values, data, 4 * sizeof(float));
+            return 4;
+
+        case VertexElementFormat::Byte4:
+        case VertexElementFormat::Byte4N:
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const float value = static_cast<float>(static_cast<int8_t>(data[i]));
+                values[i] = format == VertexElementFormat::Byte4N ? std::max(value / 127.0f, -1.0f) : value;
+            }
+            return 4;
+
+        case VertexElementFormat::UByte4:
+        case VertexElementFormat::UByte4N:
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const float value = static_cast<float>(data[i]);
+                values[i] = format == VertexElementFormat::UByte4N ? value / 255.0f : value;
+            }
+            return 4;
+
+        case VertexElementFormat::Short2:
+        case VertexElementFormat::Short2N:
+        case VertexElementFormat::Short4:
+        case VertexElementFormat::Short4N:
+        {
+            const bool normalized = format == VertexElementFormat::Short2N || format == VertexElementFormat::Short4N;
+            const uint32_t count = (format == VertexElementFormat::Short2 || format == VertexElementFormat::Short2N) ? 2 : 4;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                int16_t component;
+                memcpy(&component, data + i * sizeof(int16_t), sizeof(int16_t));
+                const float value = static_cast<float>(component);
+                values[i] = normalized ? std::max(value / 32767.0f, -1.0f) : value;
+            }
+            return count;
+        }
+
+        default:
+            return 0;
+        }
+    }
+
+    static Rectangle Intersect(const Rectangle& a, const Rectangle& b)
+    {
+        const int x0 = std::max(a.x, b.x);
+        const int y0 = std::max(a.y, b.y);
+        const int x1 = std::min(a.x + a.width, b.x + b.width);
+        const int y1 = std::min(a.y + a.height, b.y + b.height);
+        return Rectangle(x0, y0, std::max(x1 - x0, 0), std::max(y1 - y0, 0));
+    }
+
+    SoftwareCommandBuffer::SoftwareCommandBuffer(SoftwareGraphics* graphics)
+        : NullCommandBuffer(graphics)
+        , _softwareGraphics(graphics)
+    {
+    }
+
+    SoftwareCommandBuffer::~SoftwareCommandBuffer()
+    {
+    }
+
+    void SoftwareCommandBuffer::Reset()
+    {
+        NullCommandBuffer::Reset();
+
+        for (uint32_t i = 0; i < MaxVertexBufferBindings; ++i)
+        {
+            _vertexBuffers[i] = {};
+        }
+
+        for (uint32_t set = 0; set < MaxDescriptorSets; ++set)
+        {
+            for (uint32_t binding = 0; binding < MaxBindingsPerSet; ++binding)
+            {
+                _uniformBuffers[set][binding] = {};
+            }
+        }
+
+        for (uint32_t i = 0; i < MaxBindingsPerSet; ++i)
+        {
+            _textures[i] = nullptr;
+        }
+    }
+
+    void SoftwareCommandBuffer::BeginRenderPassCore(RenderPass* renderPass, const Rectangle& renderArea, const Color* clearColors, uint32_t numClearColors, float clearDepth, uint8_t clearStencil)
+    {
+        NullCommandBuffer::BeginRenderPassCore(renderPass, renderArea, clearColors, numClearColors, clearDepth, clearStencil);
+
+        NullTexture* targets[MaxColorAttachments];
+        uint32_t mipLevels[MaxColorAttachments];
+        uint32_t slices[MaxColorAttachments];
+        bool clear[MaxColorAttachments];
+        uint32_t targetCount = 0;
+        if (renderPass)
+        {
+            targetCount = renderPass->GetColorAttachmentsCount();
+            for (uint32_t i = 0; i < targetCount; ++i)
+            {
+                const RenderPassAttachment& attachment = renderPass->GetColorAttachment(i);
+                targets[i] = static_cast<NullTexture*>(attachment.texture);
+                mipLevels[i] = attachment.mipLevel;
+                slices[i] = attachment.slice;
+                clear[i] = attachment.loadAction == LoadAction::Clear;
+            }
+        }
+        else
+        {
+            targets[0] = _softwareGraphics->GetBackbuffer();
+            mipLevels[0] = 0;
+            slices[0] = 0;
+            clear[0] = true;
+            targetCount = 1;
+        }
+
+        _renderPassValid = _rasterizer.Begin(targets, mipLevels, slices, targetCount);
+        if (!_renderPassValid)
+        {
+            _softwareGraphics->ReportError("BeginRenderPass with color attachments the software rasterizer cannot draw to");
+            return;
+        }
+
+        const Rectangle targetArea(static_cast<int>(_rasterizer.GetWidth()), static_cast<int>(_rasterizer.GetHeight()));
+        _renderArea = renderArea.IsEmpty() ? targetArea : Intersect(renderArea, targetArea);
+        _viewport = Viewport(_renderArea);
+        _scissor = _renderArea;
+
+        for (uint32_t i = 0; i < targetCount && i < numClearColors; ++i)
+        {
+            if (clear[i])
+            {
+                _rasterizer.Clear(i, _renderArea, clearColors[i]);
+            }
+        }
+    }
+
+    void SoftwareCommandBuffer::EndRenderPassCore()
+    {
+        if (_renderPassValid)
+        {
+            _rasterizer.End();
+            _renderPassValid = false;
+        }
+
+        NullCommandBuffer::EndRenderPassCore();
+    }
+
+    void SoftwareCommandBuffer::SetViewport(const Viewport& viewport)
+    {
+        NullCommandBuffer::SetViewport(viewport);
+        _viewport = viewport;
+    }
+
+    void SoftwareCommandBuffer::SetViewports(uint32_t numViewports, const Viewport* viewports)
+    {
+        NullCommandBuffer::SetViewports(numViewports, viewports);
+
+        // Only the first viewport is rasterized, no shader selects another one.
+        if (numViewports > 0)
+        {
+            _viewport = viewports[0];
+        }
+    }
+
+    void SoftwareCommandBuffer::SetScissor(const Rectangle& scissor)
+    {
+        SetScissors(1, &scissor);
+    }
+
+    void SoftwareCommandBuffer::SetScissors(uint32_t numScissors, const Rectangle* scissors)
+    {
+        NullCommandBuffer::SetScissors(numScissors, scissors);
+
+        if (numScissors > 0)
+        {
+            _scissor = scissors[0];
+        }
+    }
+
+    void SoftwareCommandBuffer::SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t stride, VertexInputRate inputRate)
+    {
+        NullCommandBuffer::SetVertexBufferCore(binding, buffer, offset, stride, inputRate);
+
+        VertexBufferBinding& vertexBuffer = _vertexBuffers[binding];
+        vertexBuffer.buffer = buffer;
+        vertexBuffer.offset = offset;
+        vertexBuffer.stride = stride;
+        vertexBuffer.inputRate = inputRate;
+    }
+
+    void SoftwareCommandBuffer::SetUniformBufferCore(uint32_t set, uint32_t binding, GpuBuffer* buffer, uint64_t offset, uint64_t range)
+    {
+        NullCommandBuffer::SetUniformBufferCore(set, binding, buffer, offset, range);
+
+        UniformBufferBinding& uniformBuffer = _uniformBuffers[set][binding];
+        uniformBuffer.buffer = buffer;
+        uniformBuffer.offset = offset;
+        uniformBuffer.range = std::min(range, buffer->GetSize() - std::min(offset, buffer->GetSize()));
+    }
+
+    void SoftwareCommandBuffer::SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags stage)
+    {
+        NullCommandBuffer::SetTextureCore(binding, texture, stage);
+
+        _textures[binding] = static_cast<NullTexture*>(texture);
+    }
+
+    void SoftwareCommandBuffer::ExecuteDraw(PrimitiveTopology topology, uint32_t count, uint32_t instanceCount, uint32_t first, uint32_t baseInstance, bool indexed)
+    {
+        if (!IsInsideRenderPass())
+        {
+            _softwareGraphics->ReportError("Draw outside of render pass");
+            return;
+        }
+
+        if (!_renderPassValid)
+            return;
+
+        if (topology != PrimitiveTopology::Triangles && topology != PrimitiveTopology::TriangleStrip)
+        {
+            _softwareGraphics->ReportError("Software rasterizer only draws triangle lists and strips");
+            return;
+        }
+
+        SoftwareShader* shader = static_cast<SoftwareShader*>(_currentShader);
+        if (!shader->IsExecutable())
+        {
+            _softwareGraphics->ReportError("Draw with shader the software rasterizer cannot execute");
+            return;
+        }
+
+        const SpirvProgram& vertexProgram = shader->GetVertexProgram();
+        const SpirvProgram& fragmentProgram = shader->GetFragmentProgram();
+        const uint32_t fragmentInputMask = fragmentProgram.GetInputMask();
+        const uint32_t stride = 4 + SoftwareRasterizer::GetVaryingCount(fragmentProgram);
+        const uint32_t vertexCount = count * instanceCount;
+        _vertices.resize(static_cast<size_t>(vertexCount) * stride);
+
+        // Vertex elements take consecutive locations across bound vertex buffers, as in the Vulkan backend.
+        VertexAttribute attributes[MaxVertexAttributes];
+        uint32_t attributeCount = 0;
+        for (uint32_t binding = 0; binding < MaxVertexBufferBindings; ++binding)
+        {
+            const VertexBufferBinding& vertexBuffer = _vertexBuffers[binding];
+            if (!vertexBuffer.buffer || vertexBuffer.stride == 0)
+                continue;
+
+            const uint64_t size = vertexBuffer.buffer->GetSize();
+            const uint64_t offset = std::min(vertexBuffer.offset, size);
+            for (const VertexElement& element : vertexBuffer.buffer->GetVertexFormat().GetElements())
+            {
+                if (attributeCount == MaxVertexAttributes)
+                    break;
+
+                VertexAttribute& attribute = attributes[attributeCount++];
+                attribute.data = GetBufferData(vertexBuffer.buffer) + offset + element.offset;
+                attribute.stride = static_cast<uint32_t>(vertexBuffer.stride);
+                attribute.count = static_cast<uint32_t>((size - offset) / vertexBuffer.stride);
+                attribute.format = element.format;
+                attribute.perInstance = vertexBuffer.inputRate == VertexInputRate::Instance;
+            }
+        }
+
+        const uint8_t* indexData = indexed ? GetBufferData(_currentIndexBuffer) + _currentIndexOffset : nullptr;
+        const bool shortIndices = _currentIndexType == IndexType::UInt16;
+
+        auto shadeBatch = [&](uint32_t batch)
+        {
+            SpirvInvocation invocation(vertexProgram);
+            for (uint32_t set = 0; set < MaxDescriptorSets; ++set)
+            {
+                for (uint32_t binding = 0; binding < MaxBindingsPerSet; ++binding)
+                {
+                    const UniformBufferBinding& uniformBuffer = _uniformBuffers[set][binding];
+                    if (uniformBuffer.buffer)
+                        invocation.SetUniformBuffer(set, binding, GetBufferData(uniformBuffer.buffer) + uniformBuffer.offset);
+                }
+            }
+
+            for (uint32_t binding = 0; binding < MaxBindingsPerSet; ++binding)
+            {
+                if (_textures[binding])
+                    invocation.SetTexture(binding, _textures[binding]);
+            }
+
+            const uint32_t end = std::min((batch + 1) * VertexBatchSize, vertexCount);
+            for (uint32_t i = batch * VertexBatchSize; i < end; ++i)
+            {
+                const uint32_t element = first + i % count;
+                uint32_t vertexIndex = element;
+                if (indexed)
+                {
+                    if (shortIndices)
+                    {
+                        uint16_t index;
+                        memcpy(&index, indexData + element * sizeof(uint16_t), sizeof(uint16_t));
+                        vertexIndex = index;
+                    }
+                    else
+                    {
+                        memcpy(&vertexIndex, indexData + element * sizeof(uint32_t), sizeof(uint32_t));
+                    }
+                }
+
+                const uint32_t instanceIndex = baseInstance + i / count;
+                invocation.SetVertexIndex(vertexIndex);
+                invocation.SetInstanceIndex(instanceIndex);
+                for (uint32_t location = 0; location < attributeCount; ++location)
+                {
+                    // Out of range fetches read zero, as with robust buffer access.
+                    const VertexAttribute& attribute = attributes[location];
+                    const uint32_t fetchIndex = attribute.perInstance ? instanceIndex : vertexIndex;
+                    float values[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+                    uint32_t valueCount = 0;
+                    if (fetchIndex < attribute.count)
+                        valueCount = FetchAttribute(attribute.data + static_cast<size_t>(fetchIndex) * attribute.stride, attribute.format, values);
+                    invocation.SetInput(location, values, valueCount);
+                }
+
+                float* vertex = &_vertices[static_cast<size_t>(i) * stride];
+                memset(vertex, 0, stride * sizeof(float));
+                invocation.Execute();
+
+                const float* position = invocation.GetPosition();
+                if (position)
+                    memcpy(vertex, position, 4 * sizeof(float));
+
+                uint32_t slot = 0;
+                for (uint32_t mask = fragmentInputMask, location = 0; mask; mask >>= 1, ++location)
+                {
+                    if (!(mask & 1))
+                        continue;
+
+                    uint32_t componentCount;
+                    const uint32_t* output = invocation.GetOutputData(location, &componentCount);
+                    if (output)
+                        memcpy(vertex + 4 + slot * 4, output, std::min(componentCount, 4u) * sizeof(uint32_t));
+                    slot++;
+                }
+            }
+        };
+
+        const uint32_t batchCount = (vertexCount + VertexBatchSize - 1) / VertexBatchSize;
+        JobSystem* jobSystem = JobSystem::GetInstance();
+        if (jobSystem && batchCount > 1)
+        {
+            jobSystem->ParallelFor(batchCount, 1, shadeBatch);
+        }
+        else
+        {
+            for (uint32_t batch = 0; batch < batchCount; ++batch)
+            {
+                shadeBatch(batch);
+            }
+        }
+
+        // Fragments are shaded at the end of the render pass, capture the state they read.
+        SoftwareDrawState state;
+        state.fragmentProgram = &fragmentProgram;
+        state.viewport = _viewport;
+        state.scissor = Intersect(_scissor, _renderArea);
+        const ResourceLayout& layout = shader->GetResourceLayout();
+        for (uint32_t set = 0; set < MaxDescriptorSets; ++set)
+        {
+            for (uint32_t binding = 0; binding < MaxBindingsPerSet; ++binding)
+            {
+                const UniformBufferBinding& uniformBuffer = _uniformBuffers[set][binding];
+                if (!uniformBuffer.buffer || !(layout.sets[set].uniformBufferMask & (1u << binding)))
+                    continue;
+
+                const uint8_t* data = GetBufferData(uniformBuffer.buffer) + uniformBuffer.offset;
+                state.uniformBuffers.push_back({ set, binding, std::vector<uint8_t>(data, data + uniformBuffer.range) });
+            }
+        }
+
+        for (uint32_t binding = 0; binding < MaxBindingsPerSet; ++binding)
+        {
+            if (_textures[binding])
+                state.textures.push_back(std::make_pair(binding, _textures[binding]));
+        }
+
+        const uint32_t draw = _rasterizer.AddDraw(std::move(state));
+        for (uint32_t instance = 0; instance < instanceCount; ++instance)
+        {
+            const float* vertices = &_vertices[static_cast<size_t>(instance) * count * stride];
+            if (topology == PrimitiveTopology::Triangles)
+            {
+                for (uint32_t i = 0; i + 2 < count; i += 3)
+                {
+                    _rasterizer.AddTriangle(draw, vertices + i * stride, vertices + (i + 1) * stride, vertices + (i + 2) * stride);
+                }
+            }
+            else
+            {
+                // Odd strip triangles swap their last two vertices to keep the winding.
+                for (uint32_t i = 0; i + 2 < count; ++i)
+                {
+                    const uint32_t second = i + 1 + (i & 1);
+                    const uint32_t third = i + 2 - (i & 1);
+                    _rasterizer.AddTriangle(draw, vertices + i * stride, vertices + second * stride, vertices + third * stride);
+                }
+            }
+        }
+    }
+}
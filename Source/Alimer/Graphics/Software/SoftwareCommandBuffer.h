@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../../Graphics/Null/NullCommandBuffer.h"
+#include "../../Graphics/Software/SoftwareRasterizer.h"
+#include <vector>
+
+namespace Alimer
+{
+    class SoftwareGraphics;
+    class NullTexture;
+
+    /// Software CommandBuffer implementation, shades vertices when draws are recorded and rasterizes when the render pass ends.
+    class SoftwareCommandBuffer final : public NullCommandBuffer
+    {
+    public:
+        /// Constructor.
+        SoftwareCommandBuffer(SoftwareGraphics* graphics);
+
+        /// Destructor.
+        ~SoftwareCommandBuffer() override;
+
+        void Reset() override;
+
+        void SetViewport(const Viewport& viewport) override;
+        void SetViewports(uint32_t numViewports, const Viewport* viewports) override;
+
+        void SetScissor(const Rectangle& scissor) override;
+        void SetScissors(uint32_t numScissors, const Rectangle* scissors) override;
+
+    private:
+        void BeginRenderPassCore(RenderPass* renderPass, const Rectangle& renderArea, const Color* clearColors, uint32_t numClearColors, float clearDepth, uint8_t clearStencil) override;
+        void EndRenderPassCore() override;
+
+        void SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t stride, VertexInputRate inputRate) override;
+        void SetUniformBufferCore(uint32_t set, uint32_t binding, GpuBuffer* buffer, uint64_t offset, uint64_t range) override;
+        void SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags stage) override;
+
+        void ExecuteDraw(PrimitiveTopology topology, uint32_t count, uint32_t instanceCount, uint32_t first, uint32_t baseInstance, bool indexed) override;
+
+        struct VertexBufferBinding
+        {
+            VertexBuffer* buffer = nullptr;
+            uint64_t offset = 0;
+            uint64_t stride = 0;
+            VertexInputRate inputRate = VertexInputRate::Vertex;
+        };
+
+        struct UniformBufferBinding
+        {
+            GpuBuffer* buffer = nullptr;
+            uint64_t offset = 0;
+            uint64_t range = 0;
+        };
+
+        SoftwareGraphics* _softwareGraphics;
+        SoftwareRasterizer _rasterizer;
+        bool _renderPassValid = false;
+        Rectangle _renderArea;
+        Viewport _viewport;
+        Rectangle _scissor;
+        VertexBufferBinding _vertexBuffers[MaxVertexBufferBindings];
+        UniformBufferBinding _uniformBuffers[MaxDescriptorSets][MaxBindingsPerSet];
+        NullTexture* _textures[MaxBindingsPerSet] = {};
+        /// Shaded vertices of the current draw: clip space position followed by varyings.
+        std::vector<float> _vertices;
+    };
+}
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "SoftwareGraphics.h"
+#include "SoftwareCommandBuffer.h"
+#include "SoftwareShader.h"
+#include "../Null/NullTexture.h"
+#include "../../Core/Log.h"
+#include <STB/stb_image_write.h>
+
+namespace Alimer
+{
+    static constexpr uint32_t DefaultBackbufferWidth = 800u;
+    static constexpr uint32_t DefaultBackbufferHeight = 600u;
+
+    bool SoftwareGraphics::IsSupported()
+    {
+        return true;
+    }
+
+    SoftwareGraphics::SoftwareGraphics(bool validation)
+        : NullGraphics(GraphicsDeviceType::Software, validation)
+    {
+    }
+
+    SoftwareGraphics::~SoftwareGraphics()
+    {
+        Finalize();
+    }
+
+    void SoftwareGraphics::Finalize()
+    {
+        _backbuffer.Reset();
+
+        NullGraphics::Finalize();
+    }
+
+    bool SoftwareGraphics::BackendInitialize()
+    {
+        // Without window render offscreen at default size, useful for tests and servers.
+        TextureDescription description = {};
+        description.usage = TextureUsage::ShaderRead | TextureUsage::RenderTarget;
+        description.format = PixelFormat::RGBA8UNorm;
+        description.width = _window ? _window->GetWidth() : DefaultBackbufferWidth;
+        description.height = _window ? _window->GetHeight() : DefaultBackbufferHeight;
+        _backbuffer = CreateTexture(description, nullptr);
+
+        _defaultCommandBuffer = new SoftwareCommandBuffer(this);
+        return true;
+    }
+
+    Shader* SoftwareGraphics::CreateShader(
+        const void *pVertexCode, size_t vertexCodeSize,
+        const void *pFragmentCode, size_t fragmentCodeSize)
+    {
+        return new SoftwareShader(this,
+            pVertexCode, vertexCodeSize,
+            pFragmentCode, fragmentCodeSize
+        );
+    }
+
+    NullTexture* SoftwareGraphics::GetBackbuffer() const
+    {
+        return static_cast<NullTexture*>(_backbuffer.Get());
+    }
+
+    void SoftwareGraphics::GenerateScreenshot(const std::string& fileName)
+    {
+        NullTexture* backbuffer = GetBackbuffer();
+        if (!stbi_write_png(fileName.c_str(),
+            backbuffer->GetWidth(), backbuffer->GetHeight(), 4,
+            backbuffer->GetData(0, 0), static_cast<int>(backbuffer->GetRowPitch(0))))
+        {
+            ALIMER_LOGERROR("Software - Failed to save screenshot to file '{}'", fileName);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../../Graphics/Null/NullGraphics.h"
+
+namespace Alimer
+{
+    class NullTexture;
+
+    /// Software Low-level 3D graphics API class, rasterizes on the CPU into system memory textures.
+    class SoftwareGraphics final : public NullGraphics
+    {
+    public:
+        /// Is backend supported?
+        static bool IsSupported();
+
+        /// Constructor.
+        SoftwareGraphics(bool validation);
+
+        /// Destructor.
+        ~SoftwareGraphics() override;
+
+        Shader* CreateShader(const void *pVertexCode, size_t vertexCodeSize,
+            const void *pFragmentCode, size_t fragmentCodeSize) override;
+
+        /// Return texture rendered by passes without RenderPass, in place of a swap chain image.
+        NullTexture* GetBackbuffer() const;
+
+    private:
+        void Finalize() override;
+        bool BackendInitialize() override;
+        void GenerateScreenshot(const std::string& fileName) override;
+
+        SharedPtr<Texture> _backbuffer;
+    };
+}
@@ -0,0 +1,629 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "SoftwareRasterizer.h"
+#include "SpirvInterpreter.h"
+#include "../Null/NullTexture.h"
+#include "../../Core/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if ALIMER_SSE2
+#   include <emmintrin.h>
+#elif ALIMER_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace Alimer
+{
+    /// Edge function values at a tile corner are clamped to this range, larger than their change across a tile.
+    static constexpr int64_t EdgeClamp = int64_t(1) << 30;
+    static constexpr int32_t SubpixelScale = 1 << SoftwareRasterizer::SubpixelBits;
+    static constexpr int32_t SubpixelHalf = SubpixelScale / 2;
+
+#if ALIMER_SSE2
+    using EdgeVector = __m128i;
+    static ALIMER_FORCE_INLINE EdgeVector EdgeLanes(int32_t value, int32_t step) { return _mm_setr_epi32(value, value + step, value + 2 * step, value + 3 * step); }
+    static ALIMER_FORCE_INLINE EdgeVector EdgeReplicate(int32_t value) { return _mm_set1_epi32(value); }
+    static ALIMER_FORCE_INLINE EdgeVector EdgeAdd(EdgeVector a, EdgeVector b) { return _mm_add_epi32(a, b); }
+    /// Return mask of the lanes where the three edge functions are non-negative.
+    static ALIMER_FORCE_INLINE uint32_t EdgeCoverage(EdgeVector a, EdgeVector b, EdgeVector c)
+    {
+        return ~static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_or_si128(a, b), c)))) & 0xF;
+    }
+#elif ALIMER_NEON
+    using EdgeVector = int32x4_t;
+    static ALIMER_FORCE_INLINE EdgeVector EdgeLanes(int32_t value, int32_t step)
+    {
+        const int32_t lanes[4] = { value, value + step, value + 2 * step, value + 3 * step };
+        return vld1q_s32(lanes);
+    }
+    static ALIMER_FORCE_INLINE EdgeVector EdgeReplicate(int32_t value) { return vdupq_n_s32(value); }
+    static ALIMER_FORCE_INLINE EdgeVector EdgeAdd(EdgeVector a, EdgeVector b) { return vaddq_s32(a, b); }
+    static ALIMER_FORCE_INLINE uint32_t EdgeCoverage(EdgeVector a, EdgeVector b, EdgeVector c)
+    {
+        const uint32x4_t sign = vshrq_n_u32(vreinterpretq_u32_s32(vorrq_s32(vorrq_s32(a, b), c)), 31);
+        const uint32_t outside = vgetq_lane_u32(sign, 0)
+            | (vgetq_lane_u32(sign, 1) << 1)
+            | (vgetq_lane_u32(sign, 2) << 2)
+            | (vgetq_lane_u32(sign, 3) << 3);
+        return ~outside & 0xF;
+    }
+#else
+    struct EdgeVector
+    {
+        int32_t lanes[4];
+    };
+    static inline EdgeVector EdgeLanes(int32_t value, int32_t step) { return { { value, value + step, value + 2 * step, value + 3 * step } }; }
+    static inline EdgeVector EdgeReplicate(int32_t value) { return { { value, value, value, value } }; }
+    static inline EdgeVector EdgeAdd(EdgeVector a, EdgeVector b)
+    {
+        return { { a.lanes[0] + b.lanes[0], a.lanes[1] + b.lanes[1], a.lanes[2] + b.lanes[2], a.lanes[3] + b.lanes[3] } };
+    }
+    static inline uint32_t EdgeCoverage(EdgeVector a, EdgeVector b, EdgeVector c)
+    {
+        uint32_t mask = 0;
+        for (uint32_t lane = 0; lane < 4; ++lane)
+        {
+            if ((a.lanes[lane] | b.lanes[lane] | c.lanes[lane]) >= 0)
+                mask |= 1u << lane;
+        }
+
+        return mask;
+    }
+#endif
+
+    static inline uint8_t ToUNorm8(float value)
+    {
+        // Comparisons written so NaN ends up as zero.
+        if (!(value > 0.0f))
+            return 0;
+        if (value >= 1.0f)
+            return 255;
+        return static_cast<uint8_t>(value * 255.0f + 0.5f);
+    }
+
+    static uint32_t GetTexelSize(PixelFormat format)
+    {
+        switch (format)
+        {
+        case PixelFormat::R8UNorm:
+            return 1;
+        case PixelFormat::RG8UNorm:
+            return 2;
+        case PixelFormat::RGBA8UNorm:
+        case PixelFormat::BGRA8UNorm:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    static void StoreColor(uint8_t* texel, PixelFormat format, const float* color)
+    {
+        switch (format)
+        {
+        case PixelFormat::R8UNorm:
+            texel[0] = ToUNorm8(color[0]);
+            break;
+        case PixelFormat::RG8UNorm:
+            texel[0] = ToUNorm8(color[0]);
+            texel[1] = ToUNorm8(color[1]);
+            break;
+        case PixelFormat::RGBA8UNorm:
+            texel[0] = ToUNorm8(color[0]);
+            texel[1] = ToUNorm8(color[1]);
+            texel[2] = ToUNorm8(color[2]);
+            texel[3] = ToUNorm8(color[3]);
+            break;
+        case PixelFormat::BGRA8UNorm:
+            texel[0] = ToUNorm8(color[2]);
+            texel[1] = ToUNorm8(color[1]);
+            texel[2] = ToUNorm8(color[0]);
+            texel[3] = ToUNorm8(color[3]);
+            break;
+        default:
+            break;
+        }
+    }
+
+    static uint32_t CountBits(uint32_t value)
+    {
+        uint32_t count = 0;
+        for (; value; value &= value - 1)
+            ++count;
+        return count;
+    }
+
+    /// Return signed distance of clip space vertex to frustum plane, Vulkan depth range is [0, w].
+    static inline float GetPlaneDistance(const float* vertex, uint32_t plane)
+    {
+        switch (plane)
+        {
+        case 0: return vertex[3] + vertex[0];
+        case 1: return vertex[3] - vertex[0];
+        case 2: return vertex[3] + vertex[1];
+        case 3: return vertex[3] - vertex[1];
+        case 4: return vertex[2];
+        default: return vertex[3] - vertex[2];
+        }
+    }
+
+    static inline uint32_t GetClipCode(const float* vertex)
+    {
+        uint32_t code = 0;
+        for (uint32_t plane = 0; plane < 6; ++plane)
+        {
+            if (!(GetPlaneDistance(vertex, plane) >= 0.0f))
+                code |= 1u << plane;
+        }
+
+        return code;
+    }
+
+    bool SoftwareRasterizer::Begin(NullTexture* const* targets, const uint32_t* mipLevels, const uint32_t* slices, uint32_t targetCount)
+    {
+        _targets.clear();
+        _width = 0;
+        _height = 0;
+        for (uint32_t i = 0; i < targetCount; ++i)
+        {
+            NullTexture* texture = targets[i];
+            const uint32_t width = texture->GetLevelWidth(mipLevels[i]);
+            const uint32_t height = texture->GetLevelHeight(mipLevels[i]);
+            if (i == 0)
+            {
+                _width = width;
+                _height = height;
+            }
+
+            if (width != _width || height != _height
+                || width > MaxTargetSize || height > MaxTargetSize
+                || GetTexelSize(texture->GetFormat()) == 0)
+            {
+                _targets.clear();
+                return false;
+            }
+
+            _targets.push_back({ texture->GetData(mipLevels[i], slices[i]), texture->GetRowPitch(mipLevels[i]), texture->GetFormat() });
+        }
+
+        _tilesX = (_width + TileSize - 1) / TileSize;
+        _tilesY = (_height + TileSize - 1) / TileSize;
+        _tileTriangles.resize(_tilesX * _tilesY);
+        return true;
+    }
+
+    void SoftwareRasterizer::Clear(uint32_t target, const Rectangle& area, const Color& color)
+    {
+        const Target& data = _targets[target];
+        const uint32_t texelSize = GetTexelSize(data.format);
+        const float values[4] = { color.r, color.g, color.b, color.a };
+        uint8_t texel[4];
+        StoreColor(texel, data.format, values);
+
+        const int32_t x0 = std::max(area.x, 0);
+        const int32_t y0 = std::max(area.y, 0);
+        const int32_t x1 = std::min(area.x + area.width, static_cast<int32_t>(_width));
+        const int32_t y1 = std::min(area.y + area.height, static_cast<int32_t>(_height));
+        for (int32_t y = y0; y < y1; ++y)
+        {
+            uint8_t* row = data.data + y * data.rowPitch;
+            for (int32_t x = x0; x < x1; ++x)
+            {
+                memcpy(row + x * texelSize, texel, texelSize);
+            }
+        }
+    }
+
+    uint32_t SoftwareRasterizer::GetVaryingCount(const SpirvProgram& fragmentProgram)
+    {
+        return 4 * CountBits(fragmentProgram.GetInputMask());
+    }
+
+    uint32_t SoftwareRasterizer::AddDraw(SoftwareDrawState&& state)
+    {
+        Draw draw;
+        draw.varyingCount = GetVaryingCount(*state.fragmentProgram);
+        draw.flatMask = state.fragmentProgram->GetFlatInputMask();
+        const int32_t x0 = std::max(state.scissor.x, 0);
+        const int32_t y0 = std::max(state.scissor.y, 0);
+        const int32_t x1 = std::min(state.scissor.x + state.scissor.width, static_cast<int32_t>(_width));
+        const int32_t y1 = std::min(state.scissor.y + state.scissor.height, static_cast<int32_t>(_height));
+        draw.bounds = Rectangle(x0, y0, x1 - x0, y1 - y0);
+        draw.state = std::move(state);
+        _draws.push_back(std::move(draw));
+        return static_cast<uint32_t>(_draws.size() - 1);
+    }
+
+    void SoftwareRasterizer::AddTriangle(uint32_t draw, const float* v0, const float* v1, const float* v2)
+    {
+        const Draw& drawData = _draws[draw];
+        if (drawData.bounds.width <= 0 || drawData.bounds.height <= 0)
+            return;
+
+        const float* input[3] = { v0, v1, v2 };
+        uint32_t anyOutside = 0;
+        uint32_t allOutside = 0x3F;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const uint32_t code = GetClipCode(input[i]);
+            anyOutside |= code;
+            allOutside &= code;
+        }
+
+        if (allOutside)
+            return;
+
+        if (!anyOutside)
+        {
+            SetupTriangle(draw, input);
+            return;
+        }
+
+        // Sutherland-Hodgman clipping, only against the planes crossed by the triangle.
+        const uint32_t stride = 4 + drawData.varyingCount;
+        uint32_t current = 0;
+        uint32_t count = 3;
+        _clipVertices[0].resize(3 * stride);
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            memcpy(&_clipVertices[0][i * stride], input[i], stride * sizeof(float));
+        }
+
+        for (uint32_t plane = 0; plane < 6; ++plane)
+        {
+            if (!(anyOutside & (1u << plane)))
+                continue;
+
+            const std::vector<float>& in = _clipVertices[current];
+            std::vector<float>& out = _clipVertices[current ^ 1];
+            out.resize((count + 1) * stride);
+            uint32_t outCount = 0;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const float* a = &in[i * stride];
+                const float* b = &in[((i + 1) % count) * stride];
+                const float distanceA = GetPlaneDistance(a, plane);
+                const float distanceB = GetPlaneDistance(b, plane);
+                if (distanceA >= 0.0f)
+                {
+                    memcpy(&out[outCount++ * stride], a, stride * sizeof(float));
+                }
+
+                if ((distanceA >= 0.0f) != (distanceB >= 0.0f))
+                {
+                    const float t = distanceA / (distanceA - distanceB);
+                    float* vertex = &out[outCount++ * stride];
+                    for (uint32_t c = 0; c < stride; ++c)
+                    {
+                        vertex[c] = a[c] + (b[c] - a[c]) * t;
+                    }
+                }
+            }
+
+            current ^= 1;
+            count = outCount;
+            if (count < 3)
+                return;
+        }
+
+        std::vector<float>& polygon = _clipVertices[current];
+        if (drawData.flatMask)
+        {
+            // Flat varyings are not interpolated by clipping, every vertex gets the provoking one.
+            uint32_t slot = 0;
+            for (uint32_t mask = drawData.state.fragmentProgram->GetInputMask(), location = 0; mask; mask >>= 1, ++location)
+            {
+                if (!(mask & 1))
+                    continue;
+
+                if (drawData.flatMask & (1u << location))
+                {
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        memcpy(&polygon[i * stride + 4 + slot * 4], v0 + 4 + slot * 4, 4 * sizeof(float));
+                    }
+                }
+
+                slot++;
+            }
+        }
+
+        // Fan triangulation keeps the winding of the input triangle.
+        for (uint32_t i = 1; i + 1 < count; ++i)
+        {
+            const float* vertices[3] = { &polygon[0], &polygon[i * stride], &polygon[(i + 1) * stride] };
+            SetupTriangle(draw, vertices);
+        }
+    }
+
+    void SoftwareRasterizer::SetupTriangle(uint32_t draw, const float* const* vertices)
+    {
+        const Draw& drawData = _draws[draw];
+        const Viewport& viewport = drawData.state.viewport;
+        const float guardMin = -static_cast<float>(MaxTargetSize);
+        const float guardMax = 2.0f * MaxTargetSize;
+
+        Triangle triangle;
+        triangle.draw = draw;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const float* vertex = vertices[i];
+            const float invW = 1.0f / vertex[3];
+            // Viewport is flipped as in the Vulkan backend, NDC y = 1 is the top row.
+            const float x = viewport.x + (vertex[0] * invW + 1.0f) * 0.5f * viewport.width;
+            const float y = viewport.y + (1.0f - vertex[1] * invW) * 0.5f * viewport.height;
+            if (!(x >= guardMin && x < guardMax && y >= guardMin && y < guardMax))
+                return;
+
+            triangle.x[i] = static_cast<int32_t>(floorf(x * SubpixelScale + 0.5f));
+            triangle.y[i] = static_cast<int32_t>(floorf(y * SubpixelScale + 0.5f));
+            triangle.z[i] = viewport.minDepth + vertex[2] * invW * (viewport.maxDepth - viewport.minDepth);
+            triangle.invW[i] = invW;
+        }
+
+        // Clockwise in framebuffer space is front facing, back faces and degenerate triangles are culled.
+        triangle.area = static_cast<int64_t>(triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0])
+            - static_cast<int64_t>(triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+        if (triangle.area <= 0)
+            return;
+
+        const Rectangle& bounds = drawData.bounds;
+        triangle.minX = std::max(std::min({ triangle.x[0], triangle.x[1], triangle.x[2] }) >> SubpixelBits, bounds.x);
+        triangle.minY = std::max(std::min({ triangle.y[0], triangle.y[1], triangle.y[2] }) >> SubpixelBits, bounds.y);
+        triangle.maxX = std::min(std::max({ triangle.x[0], triangle.x[1], triangle.x[2] }) >> SubpixelBits, bounds.x + bounds.width - 1);
+        triangle.maxY = std::min(std::max({ triangle.y[0], triangle.y[1], triangle.y[2] }) >> SubpixelBits, bounds.y + bounds.height - 1);
+        if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+            return;
+
+        triangle.varyingOffset = static_cast<uint32_t>(_varyings.size());
+        _varyings.resize(_varyings.size() + 3 * drawData.varyingCount);
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            memcpy(&_varyings[triangle.varyingOffset + i * drawData.varyingCount], vertices[i] + 4, drawData.varyingCount * sizeof(uint32_t));
+        }
+
+        const uint32_t index = static_cast<uint32_t>(_triangles.size());
+        _triangles.push_back(triangle);
+        for (int32_t tileY = triangle.minY / TileSize; tileY <= triangle.maxY / static_cast<int32_t>(TileSize); ++tileY)
+        {
+            for (int32_t tileX = triangle.minX / TileSize; tileX <= triangle.maxX / static_cast<int32_t>(TileSize); ++tileX)
+            {
+                _tileTriangles[tileY * _tilesX + tileX].push_back(index);
+            }
+        }
+    }
+
+    void SoftwareRasterizer::End()
+    {
+        if (!_triangles.empty())
+        {
+            // Tiles own disjoint pixels and shade their triangles in submission order, output does not depend on scheduling.
+            const uint32_t tileCount = _tilesX * _tilesY;
+            JobSystem* jobSystem = JobSystem::GetInstance();
+            if (jobSystem)
+            {
+                jobSystem->ParallelFor(tileCount, 1, [this](uint32_t tile) { RasterizeTile(tile); });
+            }
+            else
+            {
+                for (uint32_t tile = 0; tile < tileCount; ++tile)
+                {
+                    RasterizeTile(tile);
+                }
+            }
+        }
+
+        for (auto& triangles : _tileTriangles)
+        {
+            triangles.clear();
+        }
+
+        _draws.clear();
+        _triangles.clear();
+        _varyings.clear();
+        _targets.clear();
+    }
+
+    void SoftwareRasterizer::RasterizeTile(uint32_t tile)
+    {
+        const std::vector<uint32_t>& triangles = _tileTriangles[tile];
+        if (triangles.empty())
+            return;
+
+        const int32_t tileMinX = static_cast<int32_t>((tile % _tilesX) * TileSize);
+        const int32_t tileMinY = static_cast<int32_t>((tile / _tilesX) * TileSize);
+        const int32_t tileMaxX = std::min(tileMinX + static_cast<int32_t>(TileSize), static_cast<int32_t>(_width)) - 1;
+        const int32_t tileMaxY = std::min(tileMinY + static_cast<int32_t>(TileSize), static_cast<int32_t>(_height)) - 1;
+
+        std::unique_ptr<SpirvInvocation> invocation;
+        const SpirvProgram* invocationProgram = nullptr;
+        uint32_t boundDraw = ~0u;
+
+        for (uint32_t index : triangles)
+        {
+            const Triangle& triangle = _triangles[index];
+            const Draw& draw = _draws[triangle.draw];
+            const int32_t minX = std::max(triangle.minX, tileMinX);
+            const int32_t minY = std::max(triangle.minY, tileMinY);
+            const int32_t maxX = std::min(triangle.maxX, tileMaxX);
+            const int32_t maxY = std::min(triangle.maxY, tileMaxY);
+            if (minX > maxX || minY > maxY)
+                continue;
+
+            if (draw.state.fragmentProgram != invocationProgram)
+            {
+                invocationProgram = draw.state.fragmentProgram;
+                invocation.reset(new SpirvInvocation(*invocationProgram));
+                boundDraw = ~0u;
+            }
+
+            if (boundDraw != triangle.draw)
+            {
+                for (const SoftwareUniformBuffer& buffer : draw.state.uniformBuffers)
+                {
+                    invocation->SetUniformBuffer(buffer.set, buffer.binding, buffer.data.data());
+                }
+
+                for (const auto& texture : draw.state.textures)
+                {
+                    invocation->SetTexture(texture.first, texture.second);
+                }
+
+                boundDraw = triangle.draw;
+            }
+
+            // Edge i goes from vertex i to the next one, non top-left edges exclude pixels exactly on them.
+            int32_t rowEdges[3];
+            int32_t stepX[3];
+            int32_t stepY[3];
+            const int32_t pixelX = minX * SubpixelScale + SubpixelHalf;
+            const int32_t pixelY = minY * SubpixelScale + SubpixelHalf;
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                const uint32_t next = (i + 1) % 3;
+                const int32_t dx = triangle.x[next] - triangle.x[i];
+                const int32_t dy = triangle.y[next] - triangle.y[i];
+                const bool topLeft = (dy == 0 && dx > 0) || dy < 0;
+                const int64_t edge = static_cast<int64_t>(dx) * (pixelY - triangle.y[i])
+                    - static_cast<int64_t>(dy) * (pixelX - triangle.x[i]);
+                rowEdges[i] = static_cast<int32_t>(std::min(std::max(edge, -EdgeClamp), EdgeClamp)) - (topLeft ? 0 : 1);
+                stepX[i] = -dy * SubpixelScale;
+                stepY[i] = dx * SubpixelScale;
+            }
+
+            const EdgeVector blockStep0 = EdgeReplicate(4 * stepX[0]);
+            const EdgeVector blockStep1 = EdgeReplicate(4 * stepX[1]);
+            const EdgeVector blockStep2 = EdgeReplicate(4 * stepX[2]);
+            for (int32_t y = minY; y <= maxY; ++y)
+            {
+                // Test 4 pixels at once, edge functions step linearly along the row.
+                EdgeVector edge0 = EdgeLanes(rowEdges[0], stepX[0]);
+                EdgeVector edge1 = EdgeLanes(rowEdges[1], stepX[1]);
+                EdgeVector edge2 = EdgeLanes(rowEdges[2], stepX[2]);
+                for (int32_t x = minX; x <= maxX; x += 4)
+                {
+                    uint32_t mask = EdgeCoverage(edge0, edge1, edge2);
+                    if (maxX - x < 3)
+                        mask &= (1u << (maxX - x + 1)) - 1;
+
+                    for (; mask; mask &= mask - 1)
+                    {
+                        uint32_t lane = 0;
+                        while (!(mask & (1u << lane)))
+                            ++lane;
+
+                        ShadeFragment(triangle, draw, x + lane, y, *invocation);
+                    }
+
+                    edge0 = EdgeAdd(edge0, blockStep0);
+                    edge1 = EdgeAdd(edge1, blockStep1);
+                    edge2 = EdgeAdd(edge2, blockStep2);
+                }
+
+                for (uint32_t i = 0; i < 3; ++i)
+                    rowEdges[i] += stepY[i];
+            }
+        }
+    }
+
+    void SoftwareRasterizer::ShadeFragment(const Triangle& triangle, const Draw& draw, uint32_t x, uint32_t y, SpirvInvocation& invocation)
+    {
+        // Exact barycentrics from the fixed point edge functions.
+        const int64_t pixelX = static_cast<int64_t>(x) * SubpixelScale + SubpixelHalf;
+        const int64_t pixelY = static_cast<int64_t>(y) * SubpixelScale + SubpixelHalf;
+        const double invArea = 1.0 / static_cast<double>(triangle.area);
+        float linear[3];
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const uint32_t next = (i + 1) % 3;
+            const int64_t edge = (triangle.x[next] - triangle.x[i]) * (pixelY - triangle.y[i])
+                - (triangle.y[next] - triangle.y[i]) * (pixelX - triangle.x[i]);
+            linear[(i + 2) % 3] = static_cast<float>(edge * invArea);
+        }
+
+        float perspective[3];
+        float invW = 0.0f;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            perspective[i] = linear[i] * triangle.invW[i];
+            invW += perspective[i];
+        }
+
+        for (uint32_t i = 0; i < 3; ++i)
+            perspective[i] /= invW;
+
+        const float z = linear[0] * triangle.z[0] + linear[1] * triangle.z[1] + linear[2] * triangle.z[2];
+        invocation.SetFragCoord(x + 0.5f, y + 0.5f, z, invW);
+        invocation.SetFrontFacing(true);
+
+        const uint32_t* varyings = &_varyings[triangle.varyingOffset];
+        uint32_t slot = 0;
+        for (uint32_t mask = draw.state.fragmentProgram->GetInputMask(), location = 0; mask; mask >>= 1, ++location)
+        {
+            if (!(mask & 1))
+                continue;
+
+            uint32_t componentCount;
+            uint32_t* input = invocation.GetInputData(location, &componentCount);
+            const uint32_t* v0 = varyings + slot * 4;
+            if (draw.flatMask & (1u << location))
+            {
+                memcpy(input, v0, componentCount * sizeof(uint32_t));
+            }
+            else
+            {
+                const uint32_t* v1 = v0 + draw.varyingCount;
+                const uint32_t* v2 = v1 + draw.varyingCount;
+                for (uint32_t c = 0; c < componentCount; ++c)
+                {
+                    float a, b, d;
+                    memcpy(&a, &v0[c], sizeof(float));
+                    memcpy(&b, &v1[c], sizeof(float));
+                    memcpy(&d, &v2[c], sizeof(float));
+                    const float value = a * perspective[0] + b * perspective[1] + d * perspective[2];
+                    memcpy(&input[c], &value, sizeof(float));
+                }
+            }
+
+            slot++;
+        }
+
+        if (!invocation.Execute())
+            return;
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(_targets.size()); ++i)
+        {
+            uint32_t componentCount;
+            const uint32_t* output = invocation.GetOutputData(i, &componentCount);
+            if (!output)
+                continue;
+
+            float color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+            memcpy(color, output, std::min(componentCount, 4u) * sizeof(float));
+            const Target& target = _targets[i];
+            StoreColor(target.data + y * target.rowPitch + x * GetTexelSize(target.format), target.format, color);
+        }
+    }
+}
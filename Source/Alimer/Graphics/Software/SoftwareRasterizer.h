@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../../Graphics/PixelFormat.h"
+#include "../../Math/Math.h"
+#include "../../Math/Color.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Alimer
+{
+    class NullTexture;
+    class SpirvProgram;
+    class SpirvInvocation;
+
+    /// Uniform buffer contents captured when a draw is recorded.
+    struct SoftwareUniformBuffer
+    {
+        uint32_t set;
+        uint32_t binding;
+        std::vector<uint8_t> data;
+    };
+
+    /// State used to shade the fragments of a draw once its render pass ends.
+    struct SoftwareDrawState
+    {
+        const SpirvProgram* fragmentProgram = nullptr;
+        std::vector<SoftwareUniformBuffer> uniformBuffers;
+        std::vector<std::pair<uint32_t, NullTexture*>> textures;
+        Viewport viewport;
+        Rectangle scissor;
+    };
+
+    /// Tile based triangle rasterizer, bins the triangles of a render pass and shades tiles in parallel.
+    class SoftwareRasterizer final
+    {
+    public:
+        static constexpr uint32_t TileSize = 64u;
+        static constexpr uint32_t SubpixelBits = 4u;
+        /// Largest render target side, keeps edge functions of a tile in 32-bit range.
+        static constexpr uint32_t MaxTargetSize = 8192u;
+
+        SoftwareRasterizer() = default;
+        ~SoftwareRasterizer() = default;
+
+        /// Begin render pass, color targets must have the same size.
+        bool Begin(NullTexture* const* targets, const uint32_t* mipLevels, const uint32_t* slices, uint32_t targetCount);
+
+        /// Clear area of color target.
+        void Clear(uint32_t target, const Rectangle& area, const Color& color);
+
+        /// Add state of a draw, returns index to pass to AddTriangle.
+        uint32_t AddDraw(SoftwareDrawState&& state);
+
+        /// Return number of 32-bit varying words following the clip space position of every vertex of draw.
+        static uint32_t GetVaryingCount(const SpirvProgram& fragmentProgram);
+
+        /// Clip, cull and bin triangle of clip space vertices, each followed by its varyings.
+        void AddTriangle(uint32_t draw, const float* v0, const float* v1, const float* v2);
+
+        /// Shade all binned triangles into color targets.
+        void End();
+
+        uint32_t GetWidth() const { return _width; }
+        uint32_t GetHeight() const { return _height; }
+
+    private:
+        struct Target
+        {
+            uint8_t* data;
+            uint32_t rowPitch;
+            PixelFormat format;
+        };
+
+        struct Draw
+        {
+            SoftwareDrawState state;
+            uint32_t varyingCount;
+            uint32_t flatMask;
+            Rectangle bounds;
+        };
+
+        struct Triangle
+        {
+            uint32_t draw;
+            /// Screen position in fixed point with SubpixelBits of precision.
+            int32_t x[3];
+            int32_t y[3];
+            float z[3];
+            float invW[3];
+            int64_t area;
+            int32_t minX;
+            int32_t minY;
+            int32_t maxX;
+            int32_t maxY;
+            /// Offset of the varyings of the 3 vertices.
+            uint32_t varyingOffset;
+        };
+
+        void SetupTriangle(uint32_t draw, const float* const* vertices);
+        void RasterizeTile(uint32_t tile);
+        void ShadeFragment(const Triangle& triangle, const Draw& draw, uint32_t x, uint32_t y, SpirvInvocation& invocation);
+
+        uint32_t _width = 0;
+        uint32_t _height = 0;
+        uint32_t _tilesX = 0;
+        uint32_t _tilesY = 0;
+        std::vector<Target> _targets;
+        std::vector<Draw> _draws;
+        std::vector<Triangle> _triangles;
+        std::vector<uint32_t> _varyings;
+        /// Triangle indices overlapping each tile, in submission order.
+        std::vector<std::vector<uint32_t>> _tileTriangles;
+        /// Scratch polygons used by clipping.
+        std::vector<float> _clipVertices[2];
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(SoftwareRasterizer);
+    };
+}
@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "SoftwareShader.h"
+#include "SoftwareGraphics.h"
+#include "../../Core/Log.h"
+
+namespace Alimer
+{
+    static void LoadProgram(SpirvProgram& program, const void *pCode, size_t codeSize, const char* stageName)
+    {
+        std::string error;
+        if (!program.Load(static_cast<const uint32_t*>(pCode), codeSize / sizeof(uint32_t), error))
+        {
+            ALIMER_LOGERROR("Software - Failed to load {} shader: {}", stageName, error);
+        }
+    }
+
+    SoftwareShader::SoftwareShader(SoftwareGraphics* graphics,
+        const void *pVertexCode, size_t vertexCodeSize,
+        const void *pFragmentCode, size_t fragmentCodeSize)
+        : Shader(graphics, pVertexCode, vertexCodeSize, pFragmentCode, fragmentCodeSize)
+    {
+        LoadProgram(_vertexProgram, pVertexCode, vertexCodeSize, "vertex");
+        LoadProgram(_fragmentProgram, pFragmentCode, fragmentCodeSize, "fragment");
+    }
+
+    SoftwareShader::~SoftwareShader()
+    {
+    }
+}
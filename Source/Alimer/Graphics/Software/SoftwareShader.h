@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../../Graphics/Shader.h"
+#include "../../Graphics/Software/SpirvInterpreter.h"
+
+namespace Alimer
+{
+    class SoftwareGraphics;
+
+    /// Software Shader implementation, decodes SPIR-V once for the interpreter.
+    class SoftwareShader final : public Shader
+    {
+    public:
+        /// Constructor.
+        SoftwareShader(SoftwareGraphics* graphics,
+            const void *pVertexCode, size_t vertexCodeSize,
+            const void *pFragmentCode, size_t fragmentCodeSize);
+
+        /// Destructor.
+        ~SoftwareShader() override;
+
+        /// Return whether both stages only use instructions supported by the interpreter.
+        bool IsExecutable() const { return _vertexProgram.IsLoaded() && _fragmentProgram.IsLoaded(); }
+
+        const SpirvProgram& GetVertexProgram() const { return _vertexProgram; }
+        const SpirvProgram& GetFragmentProgram() const { return _fragmentProgram; }
+
+    private:
+        SpirvProgram _vertexProgram;
+        SpirvProgram _fragmentProgram;
+    };
+}
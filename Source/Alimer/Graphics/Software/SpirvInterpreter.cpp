@@ -0,0 +1,1971 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../../Graphics/Software/SpirvInterpreter.h"
+#include "../../Graphics/Null/NullTexture.h"
+#include <spirv.hpp>
+#include <GLSL.std.450.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#define FMT_NO_FMT_STRING_ALIAS
+#include <fmt/format.h>
+
+namespace Alimer
+{
+    namespace
+    {
+        template <typename F>
+        inline void UnaryFloat(SpirvValue& result, const SpirvValue& a, uint32_t count, F func)
+        {
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = func(a.f[c]);
+        }
+
+        template <typename F>
+        inline void BinaryFloat(SpirvValue& result, const SpirvValue& a, const SpirvValue& b, uint32_t count, F func)
+        {
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = func(a.f[c], b.f[c]);
+        }
+
+        template <typename F>
+        inline void BinaryInt(SpirvValue& result, const SpirvValue& a, const SpirvValue& b, uint32_t count, F func)
+        {
+            for (uint32_t c = 0; c < count; ++c)
+                result.i[c] = func(a.i[c], b.i[c]);
+        }
+
+        template <typename F>
+        inline void BinaryUInt(SpirvValue& result, const SpirvValue& a, const SpirvValue& b, uint32_t count, F func)
+        {
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = func(a.u[c], b.u[c]);
+        }
+
+        template <typename F>
+        inline void CompareFloat(SpirvValue& result, const SpirvValue& a, const SpirvValue& b, uint32_t count, F func)
+        {
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = func(a.f[c], b.f[c]) ? 1u : 0u;
+        }
+
+        template <typename F>
+        inline void CompareInt(SpirvValue& result, const SpirvValue& a, const SpirvValue& b, uint32_t count, F func)
+        {
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = func(a.i[c], b.i[c]) ? 1u : 0u;
+        }
+
+        template <typename F>
+        inline void CompareUInt(SpirvValue& result, const SpirvValue& a, const SpirvValue& b, uint32_t count, F func)
+        {
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = func(a.u[c], b.u[c]) ? 1u : 0u;
+        }
+
+        inline float Clamp(float value, float minValue, float maxValue)
+        {
+            return std::min(std::max(value, minValue), maxValue);
+        }
+
+        inline float Dot(const float* a, const float* b, uint32_t count)
+        {
+            float result = 0.0f;
+            for (uint32_t c = 0; c < count; ++c)
+                result += a[c] * b[c];
+            return result;
+        }
+
+        bool IsSupportedExtInst(uint32_t instruction)
+        {
+            switch (instruction)
+            {
+            case GLSLstd450Round:
+            case GLSLstd450RoundEven:
+            case GLSLstd450Trunc:
+            case GLSLstd450FAbs:
+            case GLSLstd450SAbs:
+            case GLSLstd450FSign:
+            case GLSLstd450SSign:
+            case GLSLstd450Floor:
+            case GLSLstd450Ceil:
+            case GLSLstd450Fract:
+            case GLSLstd450Radians:
+            case GLSLstd450Degrees:
+            case GLSLstd450Sin:
+            case GLSLstd450Cos:
+            case GLSLstd450Tan:
+            case GLSLstd450Asin:
+            case GLSLstd450Acos:
+            case GLSLstd450Atan:
+            case GLSLstd450Sinh:
+            case GLSLstd450Cosh:
+            case GLSLstd450Tanh:
+            case GLSLstd450Atan2:
+            case GLSLstd450Pow:
+            case GLSLstd450Exp:
+            case GLSLstd450Log:
+            case GLSLstd450Exp2:
+            case GLSLstd450Log2:
+            case GLSLstd450Sqrt:
+            case GLSLstd450InverseSqrt:
+            case GLSLstd450FMin:
+            case GLSLstd450UMin:
+            case GLSLstd450SMin:
+            case GLSLstd450FMax:
+            case GLSLstd450UMax:
+            case GLSLstd450SMax:
+            case GLSLstd450FClamp:
+            case GLSLstd450UClamp:
+            case GLSLstd450SClamp:
+            case GLSLstd450FMix:
+            case GLSLstd450Step:
+            case GLSLstd450SmoothStep:
+            case GLSLstd450Fma:
+            case GLSLstd450Length:
+            case GLSLstd450Distance:
+            case GLSLstd450Cross:
+            case GLSLstd450Normalize:
+            case GLSLstd450FaceForward:
+            case GLSLstd450Reflect:
+            case GLSLstd450Refract:
+            case GLSLstd450NMin:
+            case GLSLstd450NMax:
+            case GLSLstd450NClamp:
+                return true;
+            default:
+                return false;
+            }
+        }
+    }
+
+    bool SpirvProgram::Load(const uint32_t* code, size_t wordCount, std::string& error)
+    {
+        if (wordCount < 5 || code[0] != spv::MagicNumber)
+        {
+            error = "Invalid SPIR-V module";
+            return false;
+        }
+
+        _code.assign(code, code + wordCount);
+        const uint32_t bound = code[3];
+        _types.resize(bound);
+        _decorations.resize(bound);
+        _memberDecorations.resize(bound);
+        _constants.resize(bound);
+        _constantDataOffsets.assign(bound, ~0u);
+        _resultTypes.assign(bound, 0);
+        _variableOffsets.assign(bound, ~0u);
+        _labels.assign(bound, ~0u);
+        _functions.resize(bound);
+
+        uint32_t executionModel = ~0u;
+        bool inFunction = false;
+        Function* function = nullptr;
+        for (size_t offset = 5; offset < wordCount;)
+        {
+            const uint32_t* ins = _code.data() + offset;
+            const uint32_t instructionWordCount = ins[0] >> spv::WordCountShift;
+            const uint32_t op = ins[0] & spv::OpCodeMask;
+            if (instructionWordCount == 0 || offset + instructionWordCount > wordCount)
+            {
+                error = "Truncated SPIR-V instruction";
+                return false;
+            }
+
+            switch (op)
+            {
+            case spv::OpNop:
+            case spv::OpSource:
+            case spv::OpSourceContinued:
+            case spv::OpSourceExtension:
+            case spv::OpName:
+            case spv::OpMemberName:
+            case spv::OpString:
+            case spv::OpLine:
+            case spv::OpNoLine:
+            case spv::OpModuleProcessed:
+            case spv::OpCapability:
+            case spv::OpExtension:
+            case spv::OpMemoryModel:
+            case spv::OpExecutionMode:
+            case spv::OpSelectionMerge:
+            case spv::OpLoopMerge:
+                break;
+
+            case spv::OpExtInstImport:
+                if (strcmp(reinterpret_cast<const char*>(ins + 2), "GLSL.std.450") == 0)
+                    _glslInstructions = ins[1];
+                break;
+
+            case spv::OpEntryPoint:
+                if (_entryFunction == 0)
+                {
+                    executionModel = ins[1];
+                    _entryFunction = ins[2];
+                }
+                break;
+
+            case spv::OpDecorate:
+            {
+                Decoration& decoration = _decorations[ins[1]];
+                switch (ins[2])
+                {
+                case spv::DecorationLocation: decoration.location = ins[3]; break;
+                case spv::DecorationBuiltIn: decoration.builtIn = ins[3]; break;
+                case spv::DecorationDescriptorSet: decoration.set = ins[3]; break;
+                case spv::DecorationBinding: decoration.binding = ins[3]; break;
+                case spv::DecorationArrayStride: decoration.arrayStride = ins[3]; break;
+                case spv::DecorationFlat: decoration.flat = true; break;
+                default: break;
+                }
+                break;
+            }
+
+            case spv::OpMemberDecorate:
+                _memberDecorations[ins[1]].push_back({ ins[2], ins[3], instructionWordCount > 4 ? ins[4] : 0 });
+                break;
+
+            case spv::OpTypeVoid:
+            case spv::OpTypeBool:
+            case spv::OpTypeInt:
+            case spv::OpTypeFloat:
+            case spv::OpTypeVector:
+            case spv::OpTypeMatrix:
+            case spv::OpTypeImage:
+            case spv::OpTypeSampler:
+            case spv::OpTypeSampledImage:
+            case spv::OpTypeArray:
+            case spv::OpTypeRuntimeArray:
+            case spv::OpTypeStruct:
+            case spv::OpTypePointer:
+            case spv::OpTypeFunction:
+                if (!LoadType(ins, op, error))
+                    return false;
+                break;
+
+            case spv::OpConstantTrue:
+            case spv::OpConstantFalse:
+            case spv::OpConstant:
+            case spv::OpConstantComposite:
+            case spv::OpConstantNull:
+            case spv::OpSpecConstantTrue:
+            case spv::OpSpecConstantFalse:
+            case spv::OpSpecConstant:
+            case spv::OpSpecConstantComposite:
+                if (!LoadConstant(ins, op, instructionWordCount, error))
+                    return false;
+                break;
+
+            case spv::OpUndef:
+                _resultTypes[ins[2]] = ins[1];
+                if (IsAggregate(ins[1]))
+                {
+                    _constantDataOffsets[ins[2]] = static_cast<uint32_t>(_constantData.size());
+                    _constantData.resize(_constantData.size() + _types[ins[1]].naturalSize);
+                }
+                break;
+
+            case spv::OpVariable:
+                if (!LoadVariable(ins, error))
+                    return false;
+
+                if (inFunction)
+                    _instructions.push_back(static_cast<uint32_t>(offset));
+                else if (instructionWordCount > 4)
+                    _initializers.push_back(std::make_pair(ins[2], ins[4]));
+                break;
+
+            case spv::OpFunction:
+                inFunction = true;
+                function = &_functions[ins[2]];
+                function->firstInstruction = ~0u;
+                _resultTypes[ins[2]] = ins[1];
+                break;
+
+            case spv::OpFunctionParameter:
+                function->parameters.push_back(ins[2]);
+                _resultTypes[ins[2]] = ins[1];
+                if (IsAggregate(ins[1]))
+                    _variableOffsets[ins[2]] = AllocateArena(_types[ins[1]].naturalSize);
+                break;
+
+            case spv::OpFunctionEnd:
+                inFunction = false;
+                function = nullptr;
+                break;
+
+            case spv::OpLabel:
+                if (function->firstInstruction == ~0u)
+                    function->firstInstruction = static_cast<uint32_t>(_instructions.size());
+                _labels[ins[1]] = static_cast<uint32_t>(_instructions.size());
+                _instructions.push_back(static_cast<uint32_t>(offset));
+                break;
+
+            default:
+                if (!inFunction)
+                {
+                    error = fmt::format("Unsupported SPIR-V instruction {} at module scope", op);
+                    return false;
+                }
+
+                if (!ValidateInstruction(ins, op, instructionWordCount, error))
+                    return false;
+
+                _instructions.push_back(static_cast<uint32_t>(offset));
+                break;
+            }
+
+            offset += instructionWordCount;
+        }
+
+        switch (executionModel)
+        {
+        case spv::ExecutionModelVertex:
+            _stage = ShaderStage::Vertex;
+            break;
+        case spv::ExecutionModelFragment:
+            _stage = ShaderStage::Fragment;
+            break;
+        default:
+            error = "Only vertex and fragment entry points are supported";
+            _entryFunction = 0;
+            return false;
+        }
+
+        for (uint32_t id = 0; id < bound; ++id)
+        {
+            if (_constantDataOffsets[id] != ~0u)
+                _constants[id].pointer = _constantData.data() + _constantDataOffsets[id];
+        }
+
+        return true;
+    }
+
+    bool SpirvProgram::LoadType(const uint32_t* ins, uint32_t op, std::string& error)
+    {
+        Type& type = _types[ins[1]];
+        type.op = op;
+        switch (op)
+        {
+        case spv::OpTypeBool:
+            type.componentCount = type.columns = type.rows = 1;
+            type.isInteger = true;
+            type.naturalSize = 4;
+            break;
+
+        case spv::OpTypeInt:
+        case spv::OpTypeFloat:
+            if (ins[2] != 32)
+            {
+                error = "Only 32-bit scalar types are supported";
+                return false;
+            }
+
+            type.componentCount = type.columns = type.rows = 1;
+            type.isInteger = op == spv::OpTypeInt;
+            type.isSigned = type.isInteger && ins[3] != 0;
+            type.naturalSize = 4;
+            break;
+
+        case spv::OpTypeVector:
+        {
+            const Type& component = _types[ins[2]];
+            type.componentCount = type.rows = ins[3];
+            type.columns = 1;
+            type.isInteger = component.isInteger;
+            type.isSigned = component.isSigned;
+            type.elementType = ins[2];
+            type.naturalSize = 4 * type.componentCount;
+            break;
+        }
+
+        case spv::OpTypeMatrix:
+        {
+            const Type& column = _types[ins[2]];
+            type.columns = ins[3];
+            type.rows = column.rows;
+            type.componentCount = type.columns * type.rows;
+            type.elementType = ins[2];
+            type.naturalSize = 4 * type.componentCount;
+            break;
+        }
+
+        case spv::OpTypeArray:
+            type.elementType = ins[2];
+            type.length = _constants[ins[3]].u[0];
+            type.arrayStride = _decorations[ins[1]].arrayStride;
+            type.naturalSize = type.length * _types[ins[2]].naturalSize;
+            break;
+
+        case spv::OpTypeRuntimeArray:
+            type.elementType = ins[2];
+            type.arrayStride = _decorations[ins[1]].arrayStride;
+            break;
+
+        case spv::OpTypeStruct:
+        {
+            const uint32_t wordCount = ins[0] >> spv::WordCountShift;
+            type.members.assign(ins + 2, ins + wordCount);
+            const size_t memberCount = type.members.size();
+            type.memberOffsets.assign(memberCount, 0);
+            type.memberMatrixStrides.assign(memberCount, 0);
+            type.memberRowMajor.assign(memberCount, 0);
+            type.memberBuiltIns.assign(memberCount, ~0u);
+            for (const MemberDecoration& decoration : _memberDecorations[ins[1]])
+            {
+                if (decoration.member >= memberCount)
+                    continue;
+
+                switch (decoration.decoration)
+                {
+                case spv::DecorationOffset: type.memberOffsets[decoration.member] = decoration.value; break;
+                case spv::DecorationMatrixStride: type.memberMatrixStrides[decoration.member] = decoration.value; break;
+                case spv::DecorationRowMajor: type.memberRowMajor[decoration.member] = 1; break;
+                case spv::DecorationBuiltIn: type.memberBuiltIns[decoration.member] = decoration.value; break;
+                default: break;
+                }
+            }
+
+            ComputeNaturalLayout(type);
+            break;
+        }
+
+        case spv::OpTypePointer:
+            type.storageClass = ins[2];
+            type.elementType = ins[3];
+            break;
+
+        default:
+            break;
+        }
+
+        return true;
+    }
+
+    void SpirvProgram::ComputeNaturalLayout(Type& type)
+    {
+        type.naturalOffsets.resize(type.members.size());
+        uint32_t size = 0;
+        for (size_t i = 0; i < type.members.size(); ++i)
+        {
+            type.naturalOffsets[i] = size;
+            size += _types[type.members[i]].naturalSize;
+        }
+
+        type.naturalSize = size;
+    }
+
+    bool SpirvProgram::LoadConstant(const uint32_t* ins, uint32_t op, uint32_t wordCount, std::string& error)
+    {
+        const uint32_t typeId = ins[1];
+        const uint32_t id = ins[2];
+        const Type& type = _types[typeId];
+        SpirvValue& value = _constants[id];
+        _resultTypes[id] = typeId;
+
+        switch (op)
+        {
+        case spv::OpConstantTrue:
+        case spv::OpSpecConstantTrue:
+            value.u[0] = 1;
+            return true;
+
+        case spv::OpConstantFalse:
+        case spv::OpSpecConstantFalse:
+            value.u[0] = 0;
+            return true;
+
+        case spv::OpConstant:
+        case spv::OpSpecConstant:
+            if (wordCount != 4)
+            {
+                error = "Only 32-bit constants are supported";
+                return false;
+            }
+
+            value.u[0] = ins[3];
+            return true;
+
+        default:
+            break;
+        }
+
+        if (!IsAggregate(typeId))
+        {
+            // Composite of value type, concatenate constituent components.
+            uint32_t component = 0;
+            if (op == spv::OpConstantComposite || op == spv::OpSpecConstantComposite)
+            {
+                for (uint32_t i = 3; i < wordCount; ++i)
+                {
+                    const SpirvValue& constituent = _constants[ins[i]];
+                    const uint32_t count = _types[_resultTypes[ins[i]]].componentCount;
+                    for (uint32_t c = 0; c < count && component < 16; ++c)
+                        value.u[component++] = constituent.u[c];
+                }
+            }
+
+            return true;
+        }
+
+        const uint32_t offset = static_cast<uint32_t>(_constantData.size());
+        _constantDataOffsets[id] = offset;
+        _constantData.resize(offset + type.naturalSize);
+        if (op == spv::OpConstantNull)
+            return true;
+
+        for (uint32_t i = 3; i < wordCount; ++i)
+        {
+            const uint32_t constituent = ins[i];
+            const uint32_t constituentType = _resultTypes[constituent];
+            const uint32_t memberOffset = type.op == spv::OpTypeStruct
+                ? type.naturalOffsets[i - 3]
+                : (i - 3) * _types[type.elementType].naturalSize;
+            const uint32_t size = _types[constituentType].naturalSize;
+            if (_constantDataOffsets[constituent] != ~0u)
+                memcpy(_constantData.data() + offset + memberOffset, _constantData.data() + _constantDataOffsets[constituent], size);
+            else
+                memcpy(_constantData.data() + offset + memberOffset, _constants[constituent].u, size);
+        }
+
+        return true;
+    }
+
+    bool SpirvProgram::LoadVariable(const uint32_t* ins, std::string& error)
+    {
+        const uint32_t pointerType = ins[1];
+        const uint32_t id = ins[2];
+        const uint32_t storageClass = ins[3];
+        const uint32_t typeId = _types[pointerType].elementType;
+        const Type& type = _types[typeId];
+        const Decoration& decoration = _decorations[id];
+        _resultTypes[id] = pointerType;
+
+        switch (storageClass)
+        {
+        case spv::StorageClassUniform:
+            _uniformBuffers.push_back({ id, decoration.set, decoration.binding });
+            return true;
+
+        case spv::StorageClassUniformConstant:
+            if (type.op != spv::OpTypeSampledImage)
+            {
+                error = "Only combined image samplers are supported as uniform constants";
+                return false;
+            }
+
+            _textures.push_back({ id, decoration.set, decoration.binding });
+            return true;
+
+        case spv::StorageClassInput:
+        case spv::StorageClassOutput:
+        case spv::StorageClassPrivate:
+        case spv::StorageClassFunction:
+            break;
+
+        default:
+            error = fmt::format("Unsupported SPIR-V storage class {}", storageClass);
+            return false;
+        }
+
+        const uint32_t offset = AllocateArena(type.naturalSize);
+        _variableOffsets[id] = offset;
+        if (storageClass != spv::StorageClassInput && storageClass != spv::StorageClassOutput)
+            return true;
+
+        const bool input = storageClass == spv::StorageClassInput;
+        if (decoration.builtIn != ~0u)
+        {
+            switch (decoration.builtIn)
+            {
+            case spv::BuiltInPosition: _positionOffset = offset; break;
+            case spv::BuiltInVertexIndex: _vertexIndexOffset = offset; break;
+            case spv::BuiltInInstanceIndex: _instanceIndexOffset = offset; break;
+            case spv::BuiltInFragCoord: _fragCoordOffset = offset; break;
+            case spv::BuiltInFrontFacing: _frontFacingOffset = offset; break;
+            default: break;
+            }
+
+            return true;
+        }
+
+        if (type.op == spv::OpTypeStruct)
+        {
+            // Built-in block such as gl_PerVertex.
+            for (size_t i = 0; i < type.members.size(); ++i)
+            {
+                if (type.memberBuiltIns[i] == spv::BuiltInPosition && !input)
+                    _positionOffset = offset + type.naturalOffsets[i];
+            }
+
+            return true;
+        }
+
+        if (type.componentCount == 0 || type.columns != 1 || decoration.location >= 32)
+        {
+            error = "Only scalar and vector interface variables with location are supported";
+            return false;
+        }
+
+        const Interface item = { decoration.location, offset, type.componentCount, type.isInteger };
+        if (input)
+        {
+            _inputs.push_back(item);
+            _inputMask |= 1u << decoration.location;
+            if (decoration.flat || type.isInteger)
+                _flatInputMask |= 1u << decoration.location;
+        }
+        else
+        {
+            _outputs.push_back(item);
+            _outputMask |= 1u << decoration.location;
+        }
+
+        return true;
+    }
+
+    bool SpirvProgram::ValidateInstruction(const uint32_t* ins, uint32_t op, uint32_t wordCount, std::string& error)
+    {
+        switch (op)
+        {
+        case spv::OpStore:
+        {
+            const uint32_t storageClass = _types[_resultTypes[ins[1]]].storageClass;
+            if (storageClass != spv::StorageClassOutput
+                && storageClass != spv::StorageClassPrivate
+                && storageClass != spv::StorageClassFunction)
+            {
+                error = "Stores are only supported to output, private and function variables";
+                return false;
+            }
+
+            return true;
+        }
+
+        case spv::OpBranch:
+        case spv::OpBranchConditional:
+        case spv::OpSwitch:
+        case spv::OpReturn:
+        case spv::OpReturnValue:
+        case spv::OpKill:
+        case spv::OpUnreachable:
+            return true;
+
+        case spv::OpExtInst:
+            if (ins[3] != _glslInstructions || !IsSupportedExtInst(ins[4]))
+            {
+                error = fmt::format("Unsupported SPIR-V extended instruction {}", ins[4]);
+                return false;
+            }
+            break;
+
+        case spv::OpLoad:
+        case spv::OpAccessChain:
+        case spv::OpInBoundsAccessChain:
+        case spv::OpCompositeConstruct:
+        case spv::OpCompositeExtract:
+        case spv::OpCompositeInsert:
+        case spv::OpVectorShuffle:
+        case spv::OpVectorExtractDynamic:
+        case spv::OpVectorInsertDynamic:
+        case spv::OpCopyObject:
+        case spv::OpTranspose:
+        case spv::OpFNegate:
+        case spv::OpSNegate:
+        case spv::OpFAdd:
+        case spv::OpFSub:
+        case spv::OpFMul:
+        case spv::OpFDiv:
+        case spv::OpFMod:
+        case spv::OpFRem:
+        case spv::OpIAdd:
+        case spv::OpISub:
+        case spv::OpIMul:
+        case spv::OpSDiv:
+        case spv::OpUDiv:
+        case spv::OpSMod:
+        case spv::OpSRem:
+        case spv::OpUMod:
+        case spv::OpVectorTimesScalar:
+        case spv::OpMatrixTimesScalar:
+        case spv::OpVectorTimesMatrix:
+        case spv::OpMatrixTimesVector:
+        case spv::OpMatrixTimesMatrix:
+        case spv::OpDot:
+        case spv::OpConvertFToS:
+        case spv::OpConvertFToU:
+        case spv::OpConvertSToF:
+        case spv::OpConvertUToF:
+        case spv::OpUConvert:
+        case spv::OpSConvert:
+        case spv::OpFConvert:
+        case spv::OpBitcast:
+        case spv::OpFOrdEqual:
+        case spv::OpFUnordEqual:
+        case spv::OpFOrdNotEqual:
+        case spv::OpFUnordNotEqual:
+        case spv::OpFOrdLessThan:
+        case spv::OpFUnordLessThan:
+        case spv::OpFOrdGreaterThan:
+        case spv::OpFUnordGreaterThan:
+        case spv::OpFOrdLessThanEqual:
+        case spv::OpFUnordLessThanEqual:
+        case spv::OpFOrdGreaterThanEqual:
+        case spv::OpFUnordGreaterThanEqual:
+        case spv::OpIEqual:
+        case spv::OpINotEqual:
+        case spv::OpSLessThan:
+        case spv::OpSGreaterThan:
+        case spv::OpSLessThanEqual:
+        case spv::OpSGreaterThanEqual:
+        case spv::OpULessThan:
+        case spv::OpUGreaterThan:
+        case spv::OpULessThanEqual:
+        case spv::OpUGreaterThanEqual:
+        case spv::OpLogicalEqual:
+        case spv::OpLogicalNotEqual:
+        case spv::OpLogicalOr:
+        case spv::OpLogicalAnd:
+        case spv::OpLogicalNot:
+        case spv::OpSelect:
+        case spv::OpAny:
+        case spv::OpAll:
+        case spv::OpIsNan:
+        case spv::OpIsInf:
+        case spv::OpBitwiseAnd:
+        case spv::OpBitwiseOr:
+        case spv::OpBitwiseXor:
+        case spv::OpNot:
+        case spv::OpShiftLeftLogical:
+        case spv::OpShiftRightLogical:
+        case spv::OpShiftRightArithmetic:
+        case spv::OpDPdx:
+        case spv::OpDPdy:
+        case spv::OpFwidth:
+        case spv::OpDPdxFine:
+        case spv::OpDPdyFine:
+        case spv::OpFwidthFine:
+        case spv::OpDPdxCoarse:
+        case spv::OpDPdyCoarse:
+        case spv::OpFwidthCoarse:
+        case spv::OpSampledImage:
+        case spv::OpImageSampleImplicitLod:
+        case spv::OpImageSampleExplicitLod:
+        case spv::OpFunctionCall:
+        case spv::OpPhi:
+            break;
+
+        default:
+            error = fmt::format("Unsupported SPIR-V instruction {}", op);
+            return false;
+        }
+
+        _resultTypes[ins[2]] = ins[1];
+        if (IsAggregate(ins[1]))
+            _variableOffsets[ins[2]] = AllocateArena(_types[ins[1]].naturalSize);
+
+        (void)wordCount;
+        return true;
+    }
+
+    uint32_t SpirvProgram::AllocateArena(uint32_t size)
+    {
+        const uint32_t offset = _arenaSize;
+        _arenaSize += (size + 15) & ~15u;
+        return offset;
+    }
+
+    bool SpirvProgram::IsAggregate(uint32_t typeId) const
+    {
+        const uint32_t op = _types[typeId].op;
+        return op == spv::OpTypeStruct || op == spv::OpTypeArray;
+    }
+
+    SpirvInvocation::SpirvInvocation(const SpirvProgram& program)
+        : _program(program)
+        , _registers(program._constants)
+        , _arena(program._arenaSize)
+    {
+        for (size_t id = 0; id < _registers.size(); ++id)
+        {
+            if (program._variableOffsets[id] != ~0u)
+                _registers[id].pointer = _arena.data() + program._variableOffsets[id];
+        }
+
+        for (const auto& initializer : program._initializers)
+        {
+            Store(program._resultTypes[initializer.first], _registers[initializer.first], initializer.second);
+        }
+
+        _textures.resize(program._textures.size());
+    }
+
+    void SpirvInvocation::SetUniformBuffer(uint32_t set, uint32_t binding, const uint8_t* data)
+    {
+        for (const SpirvProgram::Resource& resource : _program._uniformBuffers)
+        {
+            if (resource.set == set && resource.binding == binding)
+            {
+                SpirvValue& value = _registers[resource.id];
+                value.pointer = const_cast<uint8_t*>(data);
+                value.matrixStride = 0;
+                value.rowMajor = false;
+            }
+        }
+    }
+
+    void SpirvInvocation::SetTexture(uint32_t binding, NullTexture* texture)
+    {
+        for (size_t i = 0; i < _program._textures.size(); ++i)
+        {
+            if (_program._textures[i].binding == binding)
+                _textures[i] = texture;
+        }
+    }
+
+    void SpirvInvocation::SetInput(uint32_t location, const float* values, uint32_t count)
+    {
+        for (const SpirvProgram::Interface& input : _program._inputs)
+        {
+            if (input.location != location)
+                continue;
+
+            // Missing components default to (0, 0, 0, 1) as with vertex fetch.
+            float* data = reinterpret_cast<float*>(_arena.data() + input.offset);
+            for (uint32_t c = 0; c < input.componentCount; ++c)
+            {
+                const float value = c < count ? values[c] : (c == 3 ? 1.0f : 0.0f);
+                if (input.isInteger)
+                    reinterpret_cast<int32_t*>(data)[c] = static_cast<int32_t>(value);
+                else
+                    data[c] = value;
+            }
+        }
+    }
+
+    uint32_t* SpirvInvocation::GetInputData(uint32_t location, uint32_t* componentCount)
+    {
+        for (const SpirvProgram::Interface& input : _program._inputs)
+        {
+            if (input.location == location)
+            {
+                *componentCount = input.componentCount;
+                return reinterpret_cast<uint32_t*>(_arena.data() + input.offset);
+            }
+        }
+
+        *componentCount = 0;
+        return nullptr;
+    }
+
+    const uint32_t* SpirvInvocation::GetOutputData(uint32_t location, uint32_t* componentCount) const
+    {
+        for (const SpirvProgram::Interface& output : _program._outputs)
+        {
+            if (output.location == location)
+            {
+                *componentCount = output.componentCount;
+                return reinterpret_cast<const uint32_t*>(_arena.data() + output.offset);
+            }
+        }
+
+        *componentCount = 0;
+        return nullptr;
+    }
+
+    void SpirvInvocation::SetVertexIndex(uint32_t index)
+    {
+        if (_program._vertexIndexOffset != ~0u)
+            memcpy(_arena.data() + _program._vertexIndexOffset, &index, sizeof(index));
+    }
+
+    void SpirvInvocation::SetInstanceIndex(uint32_t index)
+    {
+        if (_program._instanceIndexOffset != ~0u)
+            memcpy(_arena.data() + _program._instanceIndexOffset, &index, sizeof(index));
+    }
+
+    void SpirvInvocation::SetFragCoord(float x, float y, float z, float w)
+    {
+        if (_program._fragCoordOffset != ~0u)
+        {
+            const float value[4] = { x, y, z, w };
+            memcpy(_arena.data() + _program._fragCoordOffset, value, sizeof(value));
+        }
+    }
+
+    void SpirvInvocation::SetFrontFacing(bool frontFacing)
+    {
+        if (_program._frontFacingOffset != ~0u)
+        {
+            const uint32_t value = frontFacing ? 1 : 0;
+            memcpy(_arena.data() + _program._frontFacingOffset, &value, sizeof(value));
+        }
+    }
+
+    const float* SpirvInvocation::GetPosition() const
+    {
+        if (_program._positionOffset == ~0u)
+            return nullptr;
+
+        return reinterpret_cast<const float*>(_arena.data() + _program._positionOffset);
+    }
+
+    bool SpirvInvocation::Execute()
+    {
+        return ExecuteFunction(_program._entryFunction, 0) == Flow::Return;
+    }
+
+    SpirvInvocation::Flow SpirvInvocation::ExecuteFunction(uint32_t functionId, uint32_t resultId)
+    {
+        const uint32_t* code = _program._code.data();
+        const std::vector<uint32_t>& instructions = _program._instructions;
+        uint32_t pc = _program._functions[functionId].firstInstruction;
+        uint32_t currentBlock = 0;
+        uint32_t previousBlock = 0;
+
+        for (;;)
+        {
+            const uint32_t* ins = code + instructions[pc];
+            const uint32_t wordCount = ins[0] >> spv::WordCountShift;
+            const uint32_t op = ins[0] & spv::OpCodeMask;
+
+            switch (op)
+            {
+            case spv::OpLabel:
+                currentBlock = ins[1];
+                pc++;
+                break;
+
+            case spv::OpBranch:
+                previousBlock = currentBlock;
+                pc = _program._labels[ins[1]];
+                break;
+
+            case spv::OpBranchConditional:
+                previousBlock = currentBlock;
+                pc = _program._labels[_registers[ins[1]].u[0] ? ins[2] : ins[3]];
+                break;
+
+            case spv::OpSwitch:
+            {
+                const uint32_t selector = _registers[ins[1]].u[0];
+                uint32_t target = ins[2];
+                for (uint32_t i = 3; i + 1 < wordCount; i += 2)
+                {
+                    if (ins[i] == selector)
+                    {
+                        target = ins[i + 1];
+                        break;
+                    }
+                }
+
+                previousBlock = currentBlock;
+                pc = _program._labels[target];
+                break;
+            }
+
+            case spv::OpReturn:
+            case spv::OpUnreachable:
+                return Flow::Return;
+
+            case spv::OpReturnValue:
+                Assign(_program._resultTypes[resultId], resultId, GetBytes(ins[1]));
+                return Flow::Return;
+
+            case spv::OpKill:
+                return Flow::Kill;
+
+            case spv::OpPhi:
+            {
+                // Phi nodes at the start of a block read their operands simultaneously.
+                SpirvValue values[8];
+                uint32_t phiCount = 0;
+                uint32_t phiPc = pc;
+                for (; phiCount < 8; ++phiCount, ++phiPc)
+                {
+                    const uint32_t* phi = code + instructions[phiPc];
+                    if ((phi[0] & spv::OpCodeMask) != spv::OpPhi)
+                        break;
+
+                    const uint32_t phiWordCount = phi[0] >> spv::WordCountShift;
+                    for (uint32_t i = 3; i + 1 < phiWordCount; i += 2)
+                    {
+                        if (phi[i + 1] == previousBlock)
+                        {
+                            values[phiCount] = _registers[phi[i]];
+                            break;
+                        }
+                    }
+                }
+
+                for (uint32_t i = 0; i < phiCount; ++i, ++pc)
+                {
+                    const uint32_t* phi = code + instructions[pc];
+                    if (_program.IsAggregate(phi[1]))
+                        memcpy(_registers[phi[2]].pointer, values[i].pointer, _program._types[phi[1]].naturalSize);
+                    else
+                        _registers[phi[2]] = values[i];
+                }
+                break;
+            }
+
+            case spv::OpFunctionCall:
+            {
+                const auto& parameters = _program._functions[ins[3]].parameters;
+                for (size_t i = 0; i < parameters.size(); ++i)
+                {
+                    const uint32_t argument = ins[4 + i];
+                    if (_program.IsAggregate(_program._resultTypes[argument]))
+                        Assign(_program._resultTypes[argument], parameters[i], GetBytes(argument));
+                    else
+                        _registers[parameters[i]] = _registers[argument];
+                }
+
+                if (ExecuteFunction(ins[3], ins[2]) == Flow::Kill)
+                    return Flow::Kill;
+
+                pc++;
+                break;
+            }
+
+            case spv::OpVariable:
+                if (wordCount > 4)
+                    Store(ins[1], _registers[ins[2]], ins[4]);
+                pc++;
+                break;
+
+            default:
+                ExecuteInstruction(ins, op, wordCount);
+                pc++;
+                break;
+            }
+        }
+    }
+
+    void SpirvInvocation::ExecuteInstruction(const uint32_t* ins, uint32_t op, uint32_t wordCount)
+    {
+        const SpirvProgram::Type& resultType = _program._types[ins[1]];
+        SpirvValue& result = _registers[ins[2]];
+        const uint32_t count = resultType.componentCount;
+
+        switch (op)
+        {
+        case spv::OpStore:
+            Store(_program._resultTypes[ins[1]], _registers[ins[1]], ins[2]);
+            break;
+
+        case spv::OpLoad:
+            Load(_program._resultTypes[ins[3]], _registers[ins[3]], ins[2]);
+            break;
+
+        case spv::OpAccessChain:
+        case spv::OpInBoundsAccessChain:
+            AccessChain(ins, wordCount);
+            break;
+
+        case spv::OpCompositeConstruct:
+            if (_program.IsAggregate(ins[1]))
+            {
+                for (uint32_t i = 3; i < wordCount; ++i)
+                {
+                    const uint32_t offset = resultType.op == spv::OpTypeStruct
+                        ? resultType.naturalOffsets[i - 3]
+                        : (i - 3) * _program._types[resultType.elementType].naturalSize;
+                    const uint32_t constituentType = _program._resultTypes[ins[i]];
+                    memcpy(result.pointer + offset, GetBytes(ins[i]), _program._types[constituentType].naturalSize);
+                }
+            }
+            else
+            {
+                uint32_t component = 0;
+                for (uint32_t i = 3; i < wordCount; ++i)
+                {
+                    const SpirvValue& constituent = _registers[ins[i]];
+                    const uint32_t constituentCount = GetComponentCount(ins[i]);
+                    for (uint32_t c = 0; c < constituentCount && component < 16; ++c)
+                        result.u[component++] = constituent.u[c];
+                }
+            }
+            break;
+
+        case spv::OpCompositeExtract:
+        {
+            uint32_t memberType;
+            const uint32_t offset = GetCompositeOffset(_program._resultTypes[ins[3]], ins + 4, wordCount - 4, &memberType);
+            Assign(ins[1], ins[2], GetBytes(ins[3]) + offset);
+            break;
+        }
+
+        case spv::OpCompositeInsert:
+        {
+            Assign(ins[1], ins[2], GetBytes(ins[4]));
+            uint32_t memberType;
+            const uint32_t offset = GetCompositeOffset(ins[1], ins + 5, wordCount - 5, &memberType);
+            uint8_t* dest = _program.IsAggregate(ins[1]) ? result.pointer : reinterpret_cast<uint8_t*>(result.u);
+            memcpy(dest + offset, GetBytes(ins[3]), _program._types[memberType].naturalSize);
+            break;
+        }
+
+        case spv::OpVectorShuffle:
+        {
+            const SpirvValue& a = _registers[ins[3]];
+            const SpirvValue& b = _registers[ins[4]];
+            const uint32_t firstCount = GetComponentCount(ins[3]);
+            for (uint32_t c = 0; c < count; ++c)
+            {
+                const uint32_t select = ins[5 + c];
+                if (select == 0xFFFFFFFF)
+                    result.u[c] = 0;
+                else
+                    result.u[c] = select < firstCount ? a.u[select] : b.u[(select - firstCount) & 15];
+            }
+            break;
+        }
+
+        case spv::OpVectorExtractDynamic:
+            result.u[0] = _registers[ins[3]].u[std::min(_registers[ins[4]].u[0], GetComponentCount(ins[3]) - 1)];
+            break;
+
+        case spv::OpVectorInsertDynamic:
+            memcpy(result.u, _registers[ins[3]].u, sizeof(result.u));
+            result.u[std::min(_registers[ins[5]].u[0], count - 1)] = _registers[ins[4]].u[0];
+            break;
+
+        case spv::OpCopyObject:
+        case spv::OpBitcast:
+        case spv::OpUConvert:
+        case spv::OpSConvert:
+        case spv::OpFConvert:
+            if (_program.IsAggregate(ins[1]))
+                Assign(ins[1], ins[2], GetBytes(ins[3]));
+            else
+                result = _registers[ins[3]];
+            break;
+
+        case spv::OpTranspose:
+        {
+            const SpirvValue& a = _registers[ins[3]];
+            for (uint32_t column = 0; column < resultType.columns; ++column)
+            {
+                for (uint32_t row = 0; row < resultType.rows; ++row)
+                    result.f[column * resultType.rows + row] = a.f[row * resultType.columns + column];
+            }
+            break;
+        }
+
+        case spv::OpFNegate:
+            UnaryFloat(result, _registers[ins[3]], count, [](float a) { return -a; });
+            break;
+
+        case spv::OpSNegate:
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = 0u - _registers[ins[3]].u[c];
+            break;
+
+        case spv::OpFAdd:
+            BinaryFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a + b; });
+            break;
+
+        case spv::OpFSub:
+            BinaryFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a - b; });
+            break;
+
+        case spv::OpFMul:
+            BinaryFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a * b; });
+            break;
+
+        case spv::OpFDiv:
+            BinaryFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a / b; });
+            break;
+
+        case spv::OpFMod:
+            BinaryFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a - b * floorf(a / b); });
+            break;
+
+        case spv::OpFRem:
+            BinaryFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return fmodf(a, b); });
+            break;
+
+        case spv::OpIAdd:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a + b; });
+            break;
+
+        case spv::OpISub:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a - b; });
+            break;
+
+        case spv::OpIMul:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a * b; });
+            break;
+
+        case spv::OpSDiv:
+            BinaryInt(result, _registers[ins[3]], _registers[ins[4]], count, [](int32_t a, int32_t b) { return (b == 0 || (b == -1 && a == INT32_MIN)) ? 0 : a / b; });
+            break;
+
+        case spv::OpUDiv:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return b == 0 ? 0 : a / b; });
+            break;
+
+        case spv::OpSRem:
+            BinaryInt(result, _registers[ins[3]], _registers[ins[4]], count, [](int32_t a, int32_t b) { return (b == 0 || b == -1) ? 0 : a % b; });
+            break;
+
+        case spv::OpSMod:
+            BinaryInt(result, _registers[ins[3]], _registers[ins[4]], count, [](int32_t a, int32_t b)
+            {
+                if (b == 0 || b == -1)
+                    return 0;
+                const int32_t remainder = a % b;
+                return (remainder != 0 && ((remainder < 0) != (b < 0))) ? remainder + b : remainder;
+            });
+            break;
+
+        case spv::OpUMod:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return b == 0 ? 0 : a % b; });
+            break;
+
+        case spv::OpVectorTimesScalar:
+        case spv::OpMatrixTimesScalar:
+        {
+            const float scalar = _registers[ins[4]].f[0];
+            UnaryFloat(result, _registers[ins[3]], count, [scalar](float a) { return a * scalar; });
+            break;
+        }
+
+        case spv::OpVectorTimesMatrix:
+        {
+            // Row vector times matrix: dot of vector with each column.
+            const SpirvValue& vector = _registers[ins[3]];
+            const SpirvValue& matrix = _registers[ins[4]];
+            const uint32_t rows = GetComponentCount(ins[3]);
+            for (uint32_t column = 0; column < count; ++column)
+                result.f[column] = Dot(vector.f, matrix.f + column * rows, rows);
+            break;
+        }
+
+        case spv::OpMatrixTimesVector:
+        {
+            const SpirvValue& matrix = _registers[ins[3]];
+            const SpirvValue& vector = _registers[ins[4]];
+            const uint32_t columns = GetComponentCount(ins[4]);
+            for (uint32_t row = 0; row < count; ++row)
+            {
+                float sum = 0.0f;
+                for (uint32_t column = 0; column < columns; ++column)
+                    sum += matrix.f[column * count + row] * vector.f[column];
+                result.f[row] = sum;
+            }
+            break;
+        }
+
+        case spv::OpMatrixTimesMatrix:
+        {
+            const SpirvValue& left = _registers[ins[3]];
+            const SpirvValue& right = _registers[ins[4]];
+            const uint32_t rows = resultType.rows;
+            const uint32_t inner = _program._types[_program._resultTypes[ins[3]]].columns;
+            for (uint32_t column = 0; column < resultType.columns; ++column)
+            {
+                for (uint32_t row = 0; row < rows; ++row)
+                {
+                    float sum = 0.0f;
+                    for (uint32_t k = 0; k < inner; ++k)
+                        sum += left.f[k * rows + row] * right.f[column * inner + k];
+                    result.f[column * rows + row] = sum;
+                }
+            }
+            break;
+        }
+
+        case spv::OpDot:
+            result.f[0] = Dot(_registers[ins[3]].f, _registers[ins[4]].f, GetComponentCount(ins[3]));
+            break;
+
+        case spv::OpConvertFToS:
+            for (uint32_t c = 0; c < count; ++c)
+                result.i[c] = static_cast<int32_t>(Clamp(_registers[ins[3]].f[c], -2147483648.0f, 2147483520.0f));
+            break;
+
+        case spv::OpConvertFToU:
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = static_cast<uint32_t>(Clamp(_registers[ins[3]].f[c], 0.0f, 4294967040.0f));
+            break;
+
+        case spv::OpConvertSToF:
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = static_cast<float>(_registers[ins[3]].i[c]);
+            break;
+
+        case spv::OpConvertUToF:
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = static_cast<float>(_registers[ins[3]].u[c]);
+            break;
+
+        case spv::OpFOrdEqual:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a == b; });
+            break;
+
+        case spv::OpFUnordEqual:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return !(a < b || a > b); });
+            break;
+
+        case spv::OpFOrdNotEqual:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a < b || a > b; });
+            break;
+
+        case spv::OpFUnordNotEqual:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a != b; });
+            break;
+
+        case spv::OpFOrdLessThan:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a < b; });
+            break;
+
+        case spv::OpFUnordLessThan:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return !(a >= b); });
+            break;
+
+        case spv::OpFOrdGreaterThan:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a > b; });
+            break;
+
+        case spv::OpFUnordGreaterThan:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return !(a <= b); });
+            break;
+
+        case spv::OpFOrdLessThanEqual:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a <= b; });
+            break;
+
+        case spv::OpFUnordLessThanEqual:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return !(a > b); });
+            break;
+
+        case spv::OpFOrdGreaterThanEqual:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return a >= b; });
+            break;
+
+        case spv::OpFUnordGreaterThanEqual:
+            CompareFloat(result, _registers[ins[3]], _registers[ins[4]], count, [](float a, float b) { return !(a < b); });
+            break;
+
+        case spv::OpIEqual:
+        case spv::OpLogicalEqual:
+            CompareUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a == b; });
+            break;
+
+        case spv::OpINotEqual:
+        case spv::OpLogicalNotEqual:
+            CompareUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a != b; });
+            break;
+
+        case spv::OpSLessThan:
+            CompareInt(result, _registers[ins[3]], _registers[ins[4]], count, [](int32_t a, int32_t b) { return a < b; });
+            break;
+
+        case spv::OpSGreaterThan:
+            CompareInt(result, _registers[ins[3]], _registers[ins[4]], count, [](int32_t a, int32_t b) { return a > b; });
+            break;
+
+        case spv::OpSLessThanEqual:
+            CompareInt(result, _registers[ins[3]], _registers[ins[4]], count, [](int32_t a, int32_t b) { return a <= b; });
+            break;
+
+        case spv::OpSGreaterThanEqual:
+            CompareInt(result, _registers[ins[3]], _registers[ins[4]], count, [](int32_t a, int32_t b) { return a >= b; });
+            break;
+
+        case spv::OpULessThan:
+            CompareUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a < b; });
+            break;
+
+        case spv::OpUGreaterThan:
+            CompareUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a > b; });
+            break;
+
+        case spv::OpULessThanEqual:
+            CompareUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a <= b; });
+            break;
+
+        case spv::OpUGreaterThanEqual:
+            CompareUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a >= b; });
+            break;
+
+        case spv::OpLogicalOr:
+            CompareUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a || b; });
+            break;
+
+        case spv::OpLogicalAnd:
+            CompareUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a && b; });
+            break;
+
+        case spv::OpLogicalNot:
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = _registers[ins[3]].u[c] ? 0u : 1u;
+            break;
+
+        case spv::OpSelect:
+        {
+            const SpirvValue& condition = _registers[ins[3]];
+            const bool scalarCondition = GetComponentCount(ins[3]) == 1;
+            if (_program.IsAggregate(ins[1]))
+            {
+                Assign(ins[1], ins[2], GetBytes(condition.u[0] ? ins[4] : ins[5]));
+                break;
+            }
+
+            for (uint32_t c = 0; c < count; ++c)
+            {
+                const bool select = condition.u[scalarCondition ? 0 : c] != 0;
+                result.u[c] = select ? _registers[ins[4]].u[c] : _registers[ins[5]].u[c];
+            }
+            break;
+        }
+
+        case spv::OpAny:
+        case spv::OpAll:
+        {
+            const uint32_t operandCount = GetComponentCount(ins[3]);
+            bool any = false;
+            bool all = true;
+            for (uint32_t c = 0; c < operandCount; ++c)
+            {
+                any = any || _registers[ins[3]].u[c] != 0;
+                all = all && _registers[ins[3]].u[c] != 0;
+            }
+
+            result.u[0] = (op == spv::OpAny ? any : all) ? 1u : 0u;
+            break;
+        }
+
+        case spv::OpIsNan:
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = std::isnan(_registers[ins[3]].f[c]) ? 1u : 0u;
+            break;
+
+        case spv::OpIsInf:
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = std::isinf(_registers[ins[3]].f[c]) ? 1u : 0u;
+            break;
+
+        case spv::OpBitwiseAnd:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a & b; });
+            break;
+
+        case spv::OpBitwiseOr:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a | b; });
+            break;
+
+        case spv::OpBitwiseXor:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a ^ b; });
+            break;
+
+        case spv::OpNot:
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = ~_registers[ins[3]].u[c];
+            break;
+
+        case spv::OpShiftLeftLogical:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a << (b & 31); });
+            break;
+
+        case spv::OpShiftRightLogical:
+            BinaryUInt(result, _registers[ins[3]], _registers[ins[4]], count, [](uint32_t a, uint32_t b) { return a >> (b & 31); });
+            break;
+
+        case spv::OpShiftRightArithmetic:
+            BinaryInt(result, _registers[ins[3]], _registers[ins[4]], count, [](int32_t a, int32_t b) { return a >> (b & 31); });
+            break;
+
+        case spv::OpDPdx:
+        case spv::OpDPdy:
+        case spv::OpFwidth:
+        case spv::OpDPdxFine:
+        case spv::OpDPdyFine:
+        case spv::OpFwidthFine:
+        case spv::OpDPdxCoarse:
+        case spv::OpDPdyCoarse:
+        case spv::OpFwidthCoarse:
+            // Fragments are shaded one at a time, without helper invocations.
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = 0.0f;
+            break;
+
+        case spv::OpSampledImage:
+            result.pointer = _registers[ins[3]].pointer;
+            break;
+
+        case spv::OpImageSampleImplicitLod:
+        case spv::OpImageSampleExplicitLod:
+            Sample(_registers[ins[3]], _registers[ins[4]], result);
+            break;
+
+        case spv::OpExtInst:
+            ExecuteExtInst(ins, wordCount);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void SpirvInvocation::ExecuteExtInst(const uint32_t* ins, uint32_t wordCount)
+    {
+        SpirvValue& result = _registers[ins[2]];
+        const uint32_t count = _program._types[ins[1]].componentCount;
+        const SpirvValue& x = _registers[ins[5]];
+        const SpirvValue& y = _registers[wordCount > 6 ? ins[6] : ins[5]];
+        const SpirvValue& z = _registers[wordCount > 7 ? ins[7] : ins[5]];
+        const uint32_t operandCount = GetComponentCount(ins[5]);
+
+        switch (ins[4])
+        {
+        case GLSLstd450Round: UnaryFloat(result, x, count, [](float a) { return roundf(a); }); break;
+        case GLSLstd450RoundEven: UnaryFloat(result, x, count, [](float a) { return nearbyintf(a); }); break;
+        case GLSLstd450Trunc: UnaryFloat(result, x, count, [](float a) { return truncf(a); }); break;
+        case GLSLstd450FAbs: UnaryFloat(result, x, count, [](float a) { return fabsf(a); }); break;
+        case GLSLstd450FSign: UnaryFloat(result, x, count, [](float a) { return a > 0.0f ? 1.0f : (a < 0.0f ? -1.0f : 0.0f); }); break;
+        case GLSLstd450Floor: UnaryFloat(result, x, count, [](float a) { return floorf(a); }); break;
+        case GLSLstd450Ceil: UnaryFloat(result, x, count, [](float a) { return ceilf(a); }); break;
+        case GLSLstd450Fract: UnaryFloat(result, x, count, [](float a) { return a - floorf(a); }); break;
+        case GLSLstd450Radians: UnaryFloat(result, x, count, [](float a) { return a * 0.0174532925f; }); break;
+        case GLSLstd450Degrees: UnaryFloat(result, x, count, [](float a) { return a * 57.2957795f; }); break;
+        case GLSLstd450Sin: UnaryFloat(result, x, count, [](float a) { return sinf(a); }); break;
+        case GLSLstd450Cos: UnaryFloat(result, x, count, [](float a) { return cosf(a); }); break;
+        case GLSLstd450Tan: UnaryFloat(result, x, count, [](float a) { return tanf(a); }); break;
+        case GLSLstd450Asin: UnaryFloat(result, x, count, [](float a) { return asinf(a); }); break;
+        case GLSLstd450Acos: UnaryFloat(result, x, count, [](float a) { return acosf(a); }); break;
+        case GLSLstd450Atan: UnaryFloat(result, x, count, [](float a) { return atanf(a); }); break;
+        case GLSLstd450Sinh: UnaryFloat(result, x, count, [](float a) { return sinhf(a); }); break;
+        case GLSLstd450Cosh: UnaryFloat(result, x, count, [](float a) { return coshf(a); }); break;
+        case GLSLstd450Tanh: UnaryFloat(result, x, count, [](float a) { return tanhf(a); }); break;
+        case GLSLstd450Exp: UnaryFloat(result, x, count, [](float a) { return expf(a); }); break;
+        case GLSLstd450Log: UnaryFloat(result, x, count, [](float a) { return logf(a); }); break;
+        case GLSLstd450Exp2: UnaryFloat(result, x, count, [](float a) { return exp2f(a); }); break;
+        case GLSLstd450Log2: UnaryFloat(result, x, count, [](float a) { return log2f(a); }); break;
+        case GLSLstd450Sqrt: UnaryFloat(result, x, count, [](float a) { return sqrtf(a); }); break;
+        case GLSLstd450InverseSqrt: UnaryFloat(result, x, count, [](float a) { return 1.0f / sqrtf(a); }); break;
+        case GLSLstd450Atan2: BinaryFloat(result, x, y, count, [](float a, float b) { return atan2f(a, b); }); break;
+        case GLSLstd450Pow: BinaryFloat(result, x, y, count, [](float a, float b) { return powf(a, b); }); break;
+        case GLSLstd450Step: BinaryFloat(result, x, y, count, [](float edge, float a) { return a < edge ? 0.0f : 1.0f; }); break;
+        case GLSLstd450FMin:
+        case GLSLstd450NMin:
+            BinaryFloat(result, x, y, count, [](float a, float b) { return std::min(a, b); });
+            break;
+        case GLSLstd450FMax:
+        case GLSLstd450NMax:
+            BinaryFloat(result, x, y, count, [](float a, float b) { return std::max(a, b); });
+            break;
+        case GLSLstd450UMin: BinaryUInt(result, x, y, count, [](uint32_t a, uint32_t b) { return std::min(a, b); }); break;
+        case GLSLstd450UMax: BinaryUInt(result, x, y, count, [](uint32_t a, uint32_t b) { return std::max(a, b); }); break;
+        case GLSLstd450SMin: BinaryInt(result, x, y, count, [](int32_t a, int32_t b) { return std::min(a, b); }); break;
+        case GLSLstd450SMax: BinaryInt(result, x, y, count, [](int32_t a, int32_t b) { return std::max(a, b); }); break;
+
+        case GLSLstd450SAbs:
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = x.i[c] < 0 ? 0u - x.u[c] : x.u[c];
+            break;
+
+        case GLSLstd450SSign:
+            for (uint32_t c = 0; c < count; ++c)
+                result.i[c] = x.i[c] > 0 ? 1 : (x.i[c] < 0 ? -1 : 0);
+            break;
+
+        case GLSLstd450FClamp:
+        case GLSLstd450NClamp:
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = Clamp(x.f[c], y.f[c], z.f[c]);
+            break;
+
+        case GLSLstd450UClamp:
+            for (uint32_t c = 0; c < count; ++c)
+                result.u[c] = std::min(std::max(x.u[c], y.u[c]), z.u[c]);
+            break;
+
+        case GLSLstd450SClamp:
+            for (uint32_t c = 0; c < count; ++c)
+                result.i[c] = std::min(std::max(x.i[c], y.i[c]), z.i[c]);
+            break;
+
+        case GLSLstd450FMix:
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = x.f[c] + (y.f[c] - x.f[c]) * z.f[c];
+            break;
+
+        case GLSLstd450SmoothStep:
+            for (uint32_t c = 0; c < count; ++c)
+            {
+                const float t = Clamp((z.f[c] - x.f[c]) / (y.f[c] - x.f[c]), 0.0f, 1.0f);
+                result.f[c] = t * t * (3.0f - 2.0f * t);
+            }
+            break;
+
+        case GLSLstd450Fma:
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = x.f[c] * y.f[c] + z.f[c];
+            break;
+
+        case GLSLstd450Length:
+            result.f[0] = sqrtf(Dot(x.f, x.f, operandCount));
+            break;
+
+        case GLSLstd450Distance:
+        {
+            float sum = 0.0f;
+            for (uint32_t c = 0; c < operandCount; ++c)
+                sum += (x.f[c] - y.f[c]) * (x.f[c] - y.f[c]);
+            result.f[0] = sqrtf(sum);
+            break;
+        }
+
+        case GLSLstd450Cross:
+            result.f[0] = x.f[1] * y.f[2] - x.f[2] * y.f[1];
+            result.f[1] = x.f[2] * y.f[0] - x.f[0] * y.f[2];
+            result.f[2] = x.f[0] * y.f[1] - x.f[1] * y.f[0];
+            break;
+
+        case GLSLstd450Normalize:
+        {
+            const float length = sqrtf(Dot(x.f, x.f, operandCount));
+            const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+            UnaryFloat(result, x, count, [scale](float a) { return a * scale; });
+            break;
+        }
+
+        case GLSLstd450FaceForward:
+        {
+            const bool flip = Dot(z.f, y.f, operandCount) < 0.0f;
+            UnaryFloat(result, x, count, [flip](float a) { return flip ? a : -a; });
+            break;
+        }
+
+        case GLSLstd450Reflect:
+        {
+            const float d = 2.0f * Dot(y.f, x.f, operandCount);
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = x.f[c] - d * y.f[c];
+            break;
+        }
+
+        case GLSLstd450Refract:
+        {
+            const float eta = z.f[0];
+            const float d = Dot(y.f, x.f, operandCount);
+            const float k = 1.0f - eta * eta * (1.0f - d * d);
+            for (uint32_t c = 0; c < count; ++c)
+                result.f[c] = k < 0.0f ? 0.0f : eta * x.f[c] - (eta * d + sqrtf(k)) * y.f[c];
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    void SpirvInvocation::Load(uint32_t pointerType, const SpirvValue& pointer, uint32_t resultId)
+    {
+        const uint32_t typeId = _program._types[pointerType].elementType;
+        const SpirvProgram::Type& type = _program._types[typeId];
+        SpirvValue& result = _registers[resultId];
+
+        if (type.op == spv::OpTypeSampledImage)
+        {
+            // Combined image samplers carry the texture slot index.
+            for (size_t i = 0; i < _program._textures.size(); ++i)
+            {
+                if (&_registers[_program._textures[i].id] == &pointer)
+                {
+                    result.pointer = reinterpret_cast<uint8_t*>(_textures[i]);
+                    return;
+                }
+            }
+
+            result.pointer = nullptr;
+            return;
+        }
+
+        uint8_t* dest = _program.IsAggregate(typeId) ? result.pointer : reinterpret_cast<uint8_t*>(result.u);
+        if (IsExplicitLayout(pointerType))
+            ReadExplicit(typeId, pointer.pointer, pointer.matrixStride, pointer.rowMajor, dest);
+        else
+            memcpy(dest, pointer.pointer, type.naturalSize);
+    }
+
+    void SpirvInvocation::Store(uint32_t pointerType, const SpirvValue& pointer, uint32_t valueId)
+    {
+        const uint32_t typeId = _program._types[pointerType].elementType;
+        memcpy(pointer.pointer, GetBytes(valueId), _program._types[typeId].naturalSize);
+    }
+
+    void SpirvInvocation::ReadExplicit(uint32_t typeId, const uint8_t* source, uint32_t matrixStride, bool rowMajor, uint8_t* dest) const
+    {
+        if (source == nullptr)
+        {
+            memset(dest, 0, _program._types[typeId].naturalSize);
+            return;
+        }
+
+        const SpirvProgram::Type& type = _program._types[typeId];
+        switch (type.op)
+        {
+        case spv::OpTypeMatrix:
+        {
+            const uint32_t stride = matrixStride ? matrixStride : 16;
+            float* values = reinterpret_cast<float*>(dest);
+            for (uint32_t column = 0; column < type.columns; ++column)
+            {
+                for (uint32_t row = 0; row < type.rows; ++row)
+                {
+                    const uint32_t offset = rowMajor ? row * stride + column * 4 : column * stride + row * 4;
+                    memcpy(&values[column * type.rows + row], source + offset, 4);
+                }
+            }
+            break;
+        }
+
+        case spv::OpTypeStruct:
+            for (size_t i = 0; i < type.members.size(); ++i)
+            {
+                ReadExplicit(type.members[i], source + type.memberOffsets[i],
+                    type.memberMatrixStrides[i], type.memberRowMajor[i] != 0,
+                    dest + type.naturalOffsets[i]);
+            }
+            break;
+
+        case spv::OpTypeArray:
+        {
+            const uint32_t elementSize = _program._types[type.elementType].naturalSize;
+            for (uint32_t i = 0; i < type.length; ++i)
+            {
+                ReadExplicit(type.elementType, source + i * type.arrayStride, matrixStride, rowMajor, dest + i * elementSize);
+            }
+            break;
+        }
+
+        default:
+            memcpy(dest, source, type.naturalSize);
+            break;
+        }
+    }
+
+    void SpirvInvocation::AccessChain(const uint32_t* ins, uint32_t wordCount)
+    {
+        const SpirvValue& base = _registers[ins[3]];
+        const uint32_t basePointerType = _program._resultTypes[ins[3]];
+        const bool explicitLayout = IsExplicitLayout(basePointerType);
+        uint32_t typeId = _program._types[basePointerType].elementType;
+        uint8_t* pointer = base.pointer;
+        uint32_t matrixStride = base.matrixStride;
+        bool rowMajor = base.rowMajor;
+
+        for (uint32_t i = 4; i < wordCount; ++i)
+        {
+            const SpirvProgram::Type& type = _program._types[typeId];
+            uint32_t index = _registers[ins[i]].u[0];
+            switch (type.op)
+            {
+            case spv::OpTypeStruct:
+                index = std::min(index, static_cast<uint32_t>(type.members.size() - 1));
+                if (explicitLayout)
+                {
+                    pointer += type.memberOffsets[index];
+                    matrixStride = type.memberMatrixStrides[index];
+                    rowMajor = type.memberRowMajor[index] != 0;
+                }
+                else
+                {
+                    pointer += type.naturalOffsets[index];
+                }
+                typeId = type.members[index];
+                break;
+
+            case spv::OpTypeArray:
+            case spv::OpTypeRuntimeArray:
+                // Out of bounds accesses are clamped to the last element.
+                if (type.length)
+                    index = std::min(index, type.length - 1);
+                pointer += index * (explicitLayout ? type.arrayStride : _program._types[type.elementType].naturalSize);
+                typeId = type.elementType;
+                break;
+
+            case spv::OpTypeMatrix:
+                index = std::min(index, type.columns - 1);
+                if (explicitLayout)
+                    pointer += rowMajor ? index * 4 : index * (matrixStride ? matrixStride : 16);
+                else
+                    pointer += index * type.rows * 4;
+                typeId = type.elementType;
+                break;
+
+            default:
+                index = std::min(index, type.componentCount - 1);
+                pointer += index * 4;
+                typeId = type.elementType;
+                break;
+            }
+        }
+
+        SpirvValue& result = _registers[ins[2]];
+        result.pointer = pointer;
+        result.matrixStride = matrixStride;
+        result.rowMajor = rowMajor;
+    }
+
+    void SpirvInvocation::Assign(uint32_t typeId, uint32_t resultId, const uint8_t* source)
+    {
+        const SpirvProgram::Type& type = _program._types[typeId];
+        if (_program.IsAggregate(typeId))
+            memcpy(_registers[resultId].pointer, source, type.naturalSize);
+        else
+            memcpy(_registers[resultId].u, source, type.naturalSize);
+    }
+
+    uint32_t SpirvInvocation::GetCompositeOffset(uint32_t typeId, const uint32_t* indices, uint32_t indexCount, uint32_t* memberType) const
+    {
+        // Composites are stored with natural layout, both in registers and arena.
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < indexCount; ++i)
+        {
+            const SpirvProgram::Type& type = _program._types[typeId];
+            const uint32_t index = indices[i];
+            switch (type.op)
+            {
+            case spv::OpTypeStruct:
+                offset += type.naturalOffsets[index];
+                typeId = type.members[index];
+                break;
+
+            case spv::OpTypeMatrix:
+                offset += index * type.rows * 4;
+                typeId = type.elementType;
+                break;
+
+            case spv::OpTypeArray:
+                offset += index * _program._types[type.elementType].naturalSize;
+                typeId = type.elementType;
+                break;
+
+            default:
+                offset += index * 4;
+                typeId = type.elementType;
+                break;
+            }
+        }
+
+        *memberType = typeId;
+        return offset;
+    }
+
+    const uint8_t* SpirvInvocation::GetBytes(uint32_t id) const
+    {
+        if (_program.IsAggregate(_program._resultTypes[id]))
+            return _registers[id].pointer;
+
+        return reinterpret_cast<const uint8_t*>(_registers[id].u);
+    }
+
+    void SpirvInvocation::Sample(const SpirvValue& sampledImage, const SpirvValue& coordinate, SpirvValue& result) const
+    {
+        NullTexture* texture = reinterpret_cast<NullTexture*>(sampledImage.pointer);
+        if (texture == nullptr)
+        {
+            result.f[0] = result.f[1] = result.f[2] = 0.0f;
+            result.f[3] = 1.0f;
+            return;
+        }
+
+        // Bilinear filter of the top level with repeat addressing.
+        const int32_t width = static_cast<int32_t>(texture->GetWidth());
+        const int32_t height = static_cast<int32_t>(texture->GetHeight());
+        const uint8_t* data = texture->GetData(0, 0);
+        const uint32_t rowPitch = texture->GetRowPitch(0);
+        const PixelFormat format = texture->GetFormat();
+
+        const float u = coordinate.f[0] * width - 0.5f;
+        const float v = coordinate.f[1] * height - 0.5f;
+        const float floorU = floorf(u);
+        const float floorV = floorf(v);
+        const float fracU = u - floorU;
+        const float fracV = v - floorV;
+        const int32_t x0 = static_cast<int32_t>(floorU);
+        const int32_t y0 = static_cast<int32_t>(floorV);
+
+        auto fetch = [&](int32_t x, int32_t y, float* texel)
+        {
+            x = ((x % width) + width) % width;
+            y = ((y % height) + height) % height;
+            const uint8_t* row = data + y * rowPitch;
+            texel[0] = texel[1] = texel[2] = 0.0f;
+            texel[3] = 1.0f;
+            switch (format)
+            {
+            case PixelFormat::R8UNorm:
+                texel[0] = row[x] / 255.0f;
+                break;
+            case PixelFormat::RG8UNorm:
+                texel[0] = row[x * 2] / 255.0f;
+                texel[1] = row[x * 2 + 1] / 255.0f;
+                break;
+            case PixelFormat::RGBA8UNorm:
+                for (uint32_t c = 0; c < 4; ++c)
+                    texel[c] = row[x * 4 + c] / 255.0f;
+                break;
+            case PixelFormat::BGRA8UNorm:
+                texel[0] = row[x * 4 + 2] / 255.0f;
+                texel[1] = row[x * 4 + 1] / 255.0f;
+                texel[2] = row[x * 4] / 255.0f;
+                texel[3] = row[x * 4 + 3] / 255.0f;
+                break;
+            default:
+                break;
+            }
+        };
+
+        float t00[4], t10[4], t01[4], t11[4];
+        fetch(x0, y0, t00);
+        fetch(x0 + 1, y0, t10);
+        fetch(x0, y0 + 1, t01);
+        fetch(x0 + 1, y0 + 1, t11);
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            const float top = t00[c] + (t10[c] - t00[c]) * fracU;
+            const float bottom = t01[c] + (t11[c] - t01[c]) * fracU;
+            result.f[c] = top + (bottom - top) * fracV;
+        }
+    }
+
+    uint32_t SpirvInvocation::GetComponentCount(uint32_t id) const
+    {
+        return _program._types[_program._resultTypes[id]].componentCount;
+    }
+
+    bool SpirvInvocation::IsExplicitLayout(uint32_t pointerType) const
+    {
+        const uint32_t storageClass = _program._types[pointerType].storageClass;
+        return storageClass == spv::StorageClassUniform
+            || storageClass == spv::StorageClassStorageBuffer
+            || storageClass == spv::StorageClassPushConstant;
+    }
+}
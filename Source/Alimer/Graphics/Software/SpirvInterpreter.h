@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../../Graphics/Shader.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Alimer
+{
+    class NullTexture;
+
+    /// Register holding a SPIR-V result: up to a 4x4 matrix of 32-bit components, or a pointer.
+    struct SpirvValue
+    {
+        union
+        {
+            float f[16];
+            uint32_t u[16];
+            int32_t i[16];
+        };
+
+        uint8_t* pointer;
+        /// Byte stride between columns of the pointed matrix, 0 for natural layout.
+        uint32_t matrixStride;
+        bool rowMajor;
+    };
+
+    /// Decoded SPIR-V module covering the subset of instructions executed by SpirvInvocation.
+    class SpirvProgram final
+    {
+        friend class SpirvInvocation;
+
+    public:
+        SpirvProgram() = default;
+        ~SpirvProgram() = default;
+
+        /// Decode module and validate it only uses supported instructions.
+        bool Load(const uint32_t* code, size_t wordCount, std::string& error);
+
+        /// Return whether the module was loaded.
+        bool IsLoaded() const { return _entryFunction != 0; }
+
+        /// Return stage of the entry point.
+        ShaderStage GetStage() const { return _stage; }
+
+        /// Return mask of input locations.
+        uint32_t GetInputMask() const { return _inputMask; }
+
+        /// Return mask of output locations.
+        uint32_t GetOutputMask() const { return _outputMask; }
+
+        /// Return mask of input locations decorated as flat.
+        uint32_t GetFlatInputMask() const { return _flatInputMask; }
+
+    private:
+        struct Type
+        {
+            uint32_t op = 0;
+            /// Components of a scalar, vector or matrix value, 0 for other types.
+            uint32_t componentCount = 0;
+            uint32_t columns = 0;
+            uint32_t rows = 0;
+            bool isInteger = false;
+            bool isSigned = false;
+            uint32_t elementType = 0;
+            uint32_t length = 0;
+            uint32_t storageClass = 0;
+            uint32_t naturalSize = 0;
+            uint32_t arrayStride = 0;
+            std::vector<uint32_t> members;
+            std::vector<uint32_t> naturalOffsets;
+            std::vector<uint32_t> memberOffsets;
+            std::vector<uint32_t> memberMatrixStrides;
+            std::vector<uint8_t> memberRowMajor;
+            std::vector<uint32_t> memberBuiltIns;
+        };
+
+        struct Decoration
+        {
+            uint32_t location = ~0u;
+            uint32_t builtIn = ~0u;
+            uint32_t set = 0;
+            uint32_t binding = 0;
+            uint32_t arrayStride = 0;
+            bool flat = false;
+        };
+
+        struct MemberDecoration
+        {
+            uint32_t member;
+            uint32_t decoration;
+            uint32_t value;
+        };
+
+        struct Interface
+        {
+            uint32_t location;
+            uint32_t offset;
+            uint32_t componentCount;
+            bool isInteger;
+        };
+
+        struct Resource
+        {
+            uint32_t id;
+            uint32_t set;
+            uint32_t binding;
+        };
+
+        struct Function
+        {
+            uint32_t firstInstruction = 0;
+            std::vector<uint32_t> parameters;
+        };
+
+        bool LoadType(const uint32_t* ins, uint32_t op, std::string& error);
+        bool LoadVariable(const uint32_t* ins, std::string& error);
+        bool LoadConstant(const uint32_t* ins, uint32_t op, uint32_t wordCount, std::string& error);
+        bool ValidateInstruction(const uint32_t* ins, uint32_t op, uint32_t wordCount, std::string& error);
+        void ComputeNaturalLayout(Type& type);
+        uint32_t AllocateArena(uint32_t size);
+        bool IsAggregate(uint32_t typeId) const;
+
+        ShaderStage _stage = ShaderStage::None;
+        std::vector<uint32_t> _code;
+        /// Offsets in code of function body instructions.
+        std::vector<uint32_t> _instructions;
+        /// Instruction index of each label id.
+        std::vector<uint32_t> _labels;
+        std::vector<Function> _functions;
+        std::vector<Type> _types;
+        std::vector<Decoration> _decorations;
+        std::vector<std::vector<MemberDecoration>> _memberDecorations;
+        std::vector<SpirvValue> _constants;
+        /// Natural layout storage of composite constants of aggregate type.
+        std::vector<uint8_t> _constantData;
+        std::vector<uint32_t> _constantDataOffsets;
+        /// Pairs of module scope variable and initializer ids.
+        std::vector<std::pair<uint32_t, uint32_t>> _initializers;
+        /// Type of every result id.
+        std::vector<uint32_t> _resultTypes;
+        /// Arena offsets of variables with natural layout and of aggregate results, ~0u otherwise.
+        std::vector<uint32_t> _variableOffsets;
+        uint32_t _arenaSize = 0;
+        uint32_t _entryFunction = 0;
+        uint32_t _glslInstructions = 0;
+
+        std::vector<Interface> _inputs;
+        std::vector<Interface> _outputs;
+        std::vector<Resource> _uniformBuffers;
+        std::vector<Resource> _textures;
+        uint32_t _inputMask = 0;
+        uint32_t _outputMask = 0;
+        uint32_t _flatInputMask = 0;
+
+        uint32_t _positionOffset = ~0u;
+        uint32_t _vertexIndexOffset = ~0u;
+        uint32_t _instanceIndexOffset = ~0u;
+        uint32_t _fragCoordOffset = ~0u;
+        uint32_t _frontFacingOffset = ~0u;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(SpirvProgram);
+    };
+
+    /// Execution state of a SpirvProgram, owned by a single thread.
+    class SpirvInvocation final
+    {
+    public:
+        explicit SpirvInvocation(const SpirvProgram& program);
+        ~SpirvInvocation() = default;
+
+        /// Bind uniform buffer contents read with the std140 layout decorated in the module.
+        void SetUniformBuffer(uint32_t set, uint32_t binding, const uint8_t* data);
+
+        /// Bind texture sampled through combined image samplers at binding.
+        void SetTexture(uint32_t binding, NullTexture* texture);
+
+        /// Set input from float components, converted to the declared component type.
+        void SetInput(uint32_t location, const float* values, uint32_t count);
+
+        /// Return raw storage of input location, nullptr if not declared.
+        uint32_t* GetInputData(uint32_t location, uint32_t* componentCount);
+
+        /// Return raw storage of output location, nullptr if not declared.
+        const uint32_t* GetOutputData(uint32_t location, uint32_t* componentCount) const;
+
+        void SetVertexIndex(uint32_t index);
+        void SetInstanceIndex(uint32_t index);
+        void SetFragCoord(float x, float y, float z, float w);
+        void SetFrontFacing(bool frontFacing);
+
+        /// Return clip space position written by vertex stage.
+        const float* GetPosition() const;
+
+        /// Run entry point, return false when the invocation was discarded.
+        bool Execute();
+
+    private:
+        enum class Flow
+        {
+            Return,
+            Kill
+        };
+
+        Flow ExecuteFunction(uint32_t functionId, uint32_t resultId);
+        void ExecuteInstruction(const uint32_t* ins, uint32_t op, uint32_t wordCount);
+        void ExecuteExtInst(const uint32_t* ins, uint32_t wordCount);
+        void Load(uint32_t pointerType, const SpirvValue& pointer, uint32_t resultId);
+        void Store(uint32_t pointerType, const SpirvValue& pointer, uint32_t valueId);
+        void ReadExplicit(uint32_t typeId, const uint8_t* source, uint32_t matrixStride, bool rowMajor, uint8_t* dest) const;
+        void AccessChain(const uint32_t* ins, uint32_t wordCount);
+        void Assign(uint32_t typeId, uint32_t resultId, const uint8_t* source);
+        uint32_t GetCompositeOffset(uint32_t typeId, const uint32_t* indices, uint32_t indexCount, uint32_t* memberType) const;
+        const uint8_t* GetBytes(uint32_t id) const;
+        void Sample(const SpirvValue& sampledImage, const SpirvValue& coordinate, SpirvValue& result) const;
+        uint32_t GetComponentCount(uint32_t id) const;
+        bool IsExplicitLayout(uint32_t pointerType) const;
+
+        const SpirvProgram& _program;
+        std::vector<SpirvValue> _registers;
+        std::vector<uint8_t> _arena;
+        std::vector<NullTexture*> _textures;
+    };
+}
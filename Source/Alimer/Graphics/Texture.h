@@ -113,7 +113,11 @@ namespace Alimer
             return std::max(1u, _description.depth >> mipLevel);
         }
 
+        /// Get index of the texture in the bindless heap, InvalidBindlessIndex if it has no slot.
+        uint32_t GetBindlessIndex() const { return _bindlessIndex; }
+
     protected:
         TextureDescription _description{};
+        uint32_t _bindlessIndex = InvalidBindlessIndex;
     };
 }
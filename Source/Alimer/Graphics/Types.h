@@ -34,6 +34,10 @@ namespace Alimer
     static constexpr uint32_t MaxVertexAttributes = 16u;
     static constexpr uint32_t MaxVertexBufferBindings = 4u;
     static constexpr uint32_t MaxColorAttachments = 8u;
+    static constexpr uint32_t MaxFramesInFlight = 4u;
+    static constexpr uint32_t MaxPushConstantSize = 128u;
+    /// Bindless index of resources without a slot in the bindless heap.
+    static constexpr uint32_t InvalidBindlessIndex = ~0u;
 
     /// Enum describing the Graphics backend type.
     enum class GraphicsDeviceType
@@ -48,6 +52,8 @@ namespace Alimer
         Direct3D11,
         /// DirectX 12 backend.
         Direct3D12,
+        /// CPU software rasterizer backend.
+        Software,
     };
 
     /// Enum describing the number of samples.
@@ -0,0 +1,228 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "VulkanBindlessHeap.h"
+#include "VulkanGraphics.h"
+#include "../../Core/Log.h"
+
+namespace Alimer
+{
+    VulkanBindlessHeap::VulkanBindlessHeap(VulkanGraphics* graphics, uint32_t maxTextures, uint32_t maxBuffers)
+        : _graphics(graphics)
+        , _logicalDevice(graphics->GetLogicalDevice())
+    {
+        _textures.capacity = maxTextures;
+        _buffers.capacity = maxBuffers;
+
+        // Samplers are immutable, shaders pick one by index next to the texture index.
+        const VkFilter filters[VulkanBindlessSamplerCount] = { VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_FILTER_NEAREST, VK_FILTER_NEAREST };
+        const VkSamplerAddressMode addressModes[VulkanBindlessSamplerCount] = {
+            VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE
+        };
+
+        for (uint32_t i = 0; i < VulkanBindlessSamplerCount; i++)
+        {
+            VkSamplerCreateInfo samplerCreateInfo = {};
+            samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            samplerCreateInfo.magFilter = filters[i];
+            samplerCreateInfo.minFilter = filters[i];
+            samplerCreateInfo.mipmapMode = filters[i] == VK_FILTER_LINEAR ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            samplerCreateInfo.addressModeU = addressModes[i];
+            samplerCreateInfo.addressModeV = addressModes[i];
+            samplerCreateInfo.addressModeW = addressModes[i];
+            samplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE;
+            samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+            vkThrowIfFailed(vkCreateSampler(_logicalDevice, &samplerCreateInfo, nullptr, &_samplers[i]));
+        }
+
+        VkDescriptorSetLayoutBinding bindings[3] = {};
+        bindings[0] = { VulkanBindlessTextureBinding, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures, VK_SHADER_STAGE_ALL, nullptr };
+        bindings[1] = { VulkanBindlessSamplerBinding, VK_DESCRIPTOR_TYPE_SAMPLER, VulkanBindlessSamplerCount, VK_SHADER_STAGE_ALL, _samplers };
+        bindings[2] = { VulkanBindlessBufferBinding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxBuffers, VK_SHADER_STAGE_ALL, nullptr };
+
+        // Slots are written while frames using other slots are in flight and unwritten slots are never read.
+        const VkDescriptorBindingFlagsEXT heapBindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT
+            | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT
+            | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+        VkDescriptorBindingFlagsEXT bindingFlags[3] = { heapBindingFlags, 0, heapBindingFlags };
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo = {};
+
+        bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        bindingFlagsCreateInfo.bindingCount = 3;
+        bindingFlagsCreateInfo.pBindingFlags = bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+
+        layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+        layoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        layoutCreateInfo.bindingCount = 3;
+        layoutCreateInfo.pBindings = bindings;
+        if (vkCreateDescriptorSetLayout(_logicalDevice, &layoutCreateInfo, nullptr, &_setLayout) != VK_SUCCESS)
+        {
+            ALIMER_LOGCRITICAL("Vulkan - Failed to create bindless DescriptorSetLayout.");
+        }
+
+        VkDescriptorPoolSize poolSizes[3] = {
+            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures },
+            { VK_DESCRIPTOR_TYPE_SAMPLER, VulkanBindlessSamplerCount },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxBuffers }
+        };
+
+        VkDescriptorPoolCreateInfo poolCreateInfo = {};
+
+        poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        poolCreateInfo.maxSets = 1;
+        poolCreateInfo.poolSizeCount = 3;
+        poolCreateInfo.pPoolSizes = poolSizes;
+        if (vkCreateDescriptorPool(_logicalDevice, &poolCreateInfo, nullptr, &_pool) != VK_SUCCESS)
+        {
+            ALIMER_LOGCRITICAL("Vulkan - Failed to create bindless descriptor pool.");
+        }
+
+        VkDescriptorSetAllocateInfo allocateInfo = {};
+
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = _pool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &_setLayout;
+        if (vkAllocateDescriptorSets(_logicalDevice, &allocateInfo, &_descriptorSet) != VK_SUCCESS)
+        {
+            ALIMER_LOGCRITICAL("Vulkan - Failed to allocate bindless descriptor set.");
+        }
+    }
+
+    VulkanBindlessHeap::~VulkanBindlessHeap()
+    {
+        if (_pool != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorPool(_logicalDevice, _pool, nullptr);
+            _pool = VK_NULL_HANDLE;
+        }
+
+        if (_setLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(_logicalDevice, _setLayout, nullptr);
+            _setLayout = VK_NULL_HANDLE;
+        }
+
+        for (VkSampler& sampler : _samplers)
+        {
+            vkDestroySampler(_logicalDevice, sampler, nullptr);
+            sampler = VK_NULL_HANDLE;
+        }
+    }
+
+    uint32_t VulkanBindlessHeap::AllocateSlot(SlotAllocator& slots)
+    {
+        if (!slots.free.empty())
+        {
+            uint32_t index = slots.free.back();
+            slots.free.pop_back();
+            return index;
+        }
+
+        if (slots.next < slots.capacity)
+            return slots.next++;
+
+        return InvalidBindlessIndex;
+    }
+
+    void VulkanBindlessHeap::FreeSlot(SlotAllocator& slots, uint32_t index)
+    {
+        // Frames already submitted may still read the slot, it is reused once the frame being recorded retired.
+        slots.released[_graphics->GetFrameIndex()].push_back(index);
+    }
+
+    uint32_t VulkanBindlessHeap::AllocateTexture(VkImageView imageView, VkImageLayout imageLayout)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        uint32_t index = AllocateSlot(_textures);
+        if (index == InvalidBindlessIndex)
+        {
+            ALIMER_LOGERROR("Vulkan - Bindless heap is out of texture slots ({})", _textures.capacity);
+            return InvalidBindlessIndex;
+        }
+
+        VkDescriptorImageInfo imageInfo = { VK_NULL_HANDLE, imageView, imageLayout };
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = _descriptorSet;
+        write.dstBinding = VulkanBindlessTextureBinding;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(_logicalDevice, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    uint32_t VulkanBindlessHeap::AllocateBuffer(VkBuffer buffer, VkDeviceSize size)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        uint32_t index = AllocateSlot(_buffers);
+        if (index == InvalidBindlessIndex)
+        {
+            ALIMER_LOGERROR("Vulkan - Bindless heap is out of storage buffer slots ({})", _buffers.capacity);
+            return InvalidBindlessIndex;
+        }
+
+        VkDescriptorBufferInfo bufferInfo = { buffer, 0, size };
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = _descriptorSet;
+        write.dstBinding = VulkanBindlessBufferBinding;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(_logicalDevice, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    void VulkanBindlessHeap::FreeTexture(uint32_t index)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        FreeSlot(_textures, index);
+    }
+
+    void VulkanBindlessHeap::FreeBuffer(uint32_t index)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        FreeSlot(_buffers, index);
+    }
+
+    void VulkanBindlessHeap::BeginFrame(uint32_t frameIndex)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (SlotAllocator* slots : { &_textures, &_buffers })
+        {
+            std::vector<uint32_t>& released = slots->released[frameIndex];
+            slots->free.insert(slots->free.end(), released.begin(), released.end());
+            released.clear();
+        }
+    }
+}
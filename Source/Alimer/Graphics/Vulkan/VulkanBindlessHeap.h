@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Types.h"
+#include "VulkanPrerequisites.h"
+#include <mutex>
+#include <vector>
+
+namespace Alimer
+{
+    class VulkanGraphics;
+
+    /// Descriptor set of the bindless heap, shaders declare the heap arrays in this set.
+    static constexpr uint32_t VulkanBindlessSet = MaxDescriptorSets - 1;
+    static constexpr uint32_t VulkanBindlessTextureBinding = 0;
+    static constexpr uint32_t VulkanBindlessSamplerBinding = 1;
+    static constexpr uint32_t VulkanBindlessBufferBinding = 2;
+    /// Immutable samplers: linear wrap, linear clamp, point wrap and point clamp.
+    static constexpr uint32_t VulkanBindlessSamplerCount = 4;
+    static constexpr uint32_t VulkanBindlessMaxTextures = 16384;
+    static constexpr uint32_t VulkanBindlessMaxBuffers = 4096;
+
+    /// Global descriptor set of sampled images and storage buffers, written once when resources are created.
+    /// Shaders index it with resource indices passed through push constants.
+    class VulkanBindlessHeap final
+    {
+    public:
+        VulkanBindlessHeap(VulkanGraphics* graphics, uint32_t maxTextures, uint32_t maxBuffers);
+        ~VulkanBindlessHeap();
+
+        /// Write image view in a free texture slot, return its index or InvalidBindlessIndex when the heap is full.
+        uint32_t AllocateTexture(VkImageView imageView, VkImageLayout imageLayout);
+
+        /// Write buffer in a free storage buffer slot, return its index or InvalidBindlessIndex when the heap is full.
+        uint32_t AllocateBuffer(VkBuffer buffer, VkDeviceSize size);
+
+        /// Release texture slot, reused once the frame being recorded retired.
+        void FreeTexture(uint32_t index);
+
+        /// Release storage buffer slot, reused once the frame being recorded retired.
+        void FreeBuffer(uint32_t index);
+
+        /// Make slots released during the frame available again, called once its fence signaled.
+        void BeginFrame(uint32_t frameIndex);
+
+        VkDescriptorSetLayout GetSetLayout() const { return _setLayout; }
+        VkDescriptorSet GetDescriptorSet() const { return _descriptorSet; }
+
+    private:
+        struct SlotAllocator
+        {
+            uint32_t capacity = 0;
+            uint32_t next = 0;
+            std::vector<uint32_t> free;
+            std::vector<uint32_t> released[MaxFramesInFlight];
+        };
+
+        uint32_t AllocateSlot(SlotAllocator& slots);
+        void FreeSlot(SlotAllocator& slots, uint32_t index);
+
+        VulkanGraphics* _graphics;
+        VkDevice _logicalDevice;
+        VkSampler _samplers[VulkanBindlessSamplerCount] = {};
+        VkDescriptorSetLayout _setLayout = VK_NULL_HANDLE;
+        VkDescriptorPool _pool = VK_NULL_HANDLE;
+        VkDescriptorSet _descriptorSet = VK_NULL_HANDLE;
+        SlotAllocator _textures;
+        SlotAllocator _buffers;
+        /// Descriptor writes are externally synchronized, resources are created from any thread.
+        std::mutex _lock;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(VulkanBindlessHeap);
+    };
+}
@@ -22,21 +22,21 @@
 
 #include "VulkanBuffer.h"
 #include "VulkanGraphics.h"
+#include "VulkanBindlessHeap.h"
+#include "VulkanUploadContext.h"
 #include "VulkanConvert.h"
 #include "../../Core/Log.h"
+#include <cstring>
 
 namespace Alimer
 {
     VulkanBuffer::VulkanBuffer(VulkanGraphics* graphics, BufferUsageFlags usage, uint64_t size, uint32_t stride, ResourceUsage resourceUsage, const void* initialData)
-        : _logicalDevice(graphics->GetLogicalDevice())
+        : _graphics(graphics)
+        , _logicalDevice(graphics->GetLogicalDevice())
         , _allocator(graphics->GetAllocator())
+        , _size(size)
     {
-        VkBufferUsageFlags vkUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-
-        if (resourceUsage == ResourceUsage::Dynamic)
-        {
-            vkUsage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        }
+        VkBufferUsageFlags vkUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
         if (usage & BufferUsage::Vertex)
             vkUsage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
@@ -58,14 +58,28 @@ namespace Alimer
         createInfo.flags = 0;
         createInfo.size = size;
         createInfo.usage = vkUsage;
-        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        createInfo.queueFamilyIndexCount = 0;
-        createInfo.pQueueFamilyIndices = nullptr;
+        graphics->SetSharingMode(createInfo);
 
-        // TODO:
+        // Static data lives in device local memory and is uploaded through staging,
+        // dynamic and staging buffers are host visible and written directly.
         VmaAllocationCreateInfo allocInfo = {};
-        allocInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
-        allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        switch (resourceUsage)
+        {
+        case ResourceUsage::Dynamic:
+            allocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+            allocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            break;
+
+        case ResourceUsage::Staging:
+            allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            break;
+
+        default:
+            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+            break;
+        }
 
         VmaAllocationInfo vmaAllocInfo = {};
         VkResult result = vmaCreateBuffer(
@@ -76,21 +90,58 @@ namespace Alimer
             &_allocation,
             &vmaAllocInfo);
 
+        if (result != VK_SUCCESS)
+        {
+            ALIMER_LOGERROR("Vulkan - Failed to create buffer, error: {}", vkGetVulkanResultString(result));
+            return;
+        }
+
+        _mappedData = static_cast<uint8_t*>(vmaAllocInfo.pMappedData);
+
         if (initialData != nullptr)
         {
-            memcpy(vmaAllocInfo.pMappedData, initialData, vmaAllocInfo.size);
+            if (_mappedData)
+            {
+                memcpy(_mappedData, initialData, static_cast<size_t>(size));
+            }
+            else
+            {
+                graphics->GetUploadContext()->UploadBuffer(_vkHandle, 0, size, initialData);
+            }
+        }
+
+        VulkanBindlessHeap* bindlessHeap = graphics->GetBindlessHeap();
+        if (bindlessHeap != nullptr && (usage & BufferUsage::Storage))
+        {
+            _bindlessIndex = bindlessHeap->AllocateBuffer(_vkHandle, size);
+            if (_bindlessIndex != InvalidBindlessIndex)
+            {
+                _bindlessHeap = bindlessHeap;
+            }
         }
     }
 
     VulkanBuffer::~VulkanBuffer()
     {
-        vmaDestroyBuffer(_allocator, _vkHandle, _allocation);
+        if (_bindlessHeap != nullptr)
+        {
+            _bindlessHeap->FreeBuffer(_bindlessIndex);
+        }
+
+        _graphics->DestroyBuffer(_vkHandle, _allocation);
     }
 
     bool VulkanBuffer::SetData(uint32_t offset, uint32_t size, const void* data)
     {
-        ALIMER_LOGCRITICAL("VulkanBuffer::SetData not implemented");
-        //memcpy(_allocation->GetMappedData(), initialData, vmaAllocInfo.size);
-        return false;
+        if (offset + size > _size)
+        {
+            ALIMER_LOGERROR("Vulkan - Buffer update out of range");
+            return false;
+        }
+
+        // Buffer may still be read by submitted frames, the copy is ordered after them on the GPU.
+        // Data changing every frame belongs in transient allocations.
+        _graphics->UpdateBuffer(_vkHandle, offset, size, data);
+        return true;
     }
 }
@@ -30,6 +30,7 @@
 namespace Alimer
 {
 	class VulkanGraphics;
+	class VulkanBindlessHeap;
 
 	/// Vulkan Buffer.
 	class VulkanBuffer final : public BufferHandle
@@ -41,11 +42,18 @@ namespace Alimer
         bool SetData(uint32_t offset, uint32_t size, const void* data) override;
 
 		inline VkBuffer GetVkHandle() const { return _vkHandle; }
+        inline uint8_t* GetMappedData() const { return _mappedData; }
 
 	private:
+        VulkanGraphics* _graphics;
 		VkDevice _logicalDevice;
         VmaAllocator _allocator;
+        uint64_t _size;
         VkBuffer _vkHandle = VK_NULL_HANDLE;
         VmaAllocation _allocation = VK_NULL_HANDLE;
+        /// Persistently mapped memory of host visible buffers, null for device local.
+        uint8_t* _mappedData = nullptr;
+        /// Heap holding the bindless slot of storage buffers, null when it has none.
+        VulkanBindlessHeap* _bindlessHeap = nullptr;
 	};
 }
@@ -23,11 +23,13 @@
 #include "VulkanCommandQueue.h"
 #include "VulkanCommandBuffer.h"
 #include "VulkanBuffer.h"
+#include "VulkanTexture.h"
 #include "VulkanShader.h"
 #include "VulkanPipelineLayout.h"
 #include "VulkanPipelineState.h"
 #include "VulkanRenderPass.h"
 #include "VulkanGraphics.h"
+#include "VulkanBindlessHeap.h"
 #include "VulkanConvert.h"
 #include "../../Core/Log.h"
 #include "../../Util/HashMap.h"
@@ -47,6 +49,7 @@ namespace Alimer
         , _graphics(graphics)
         , _logicalDevice(_graphics->GetLogicalDevice())
         , _commandPool(commandPool)
+        , _secondary(secondary)
     {
         VkCommandBufferAllocateInfo cmdBufAllocateInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
         cmdBufAllocateInfo.pNext = nullptr;
@@ -82,6 +85,7 @@ namespace Alimer
     {
         _dirty = ~0u;
         _dirtySets = ~0u;
+        _dirtySetsDynamic = 0;
         _dirtyVbos = ~0u;
         memset(_vbo.buffers, 0, sizeof(_vbo.buffers));
         memset(&_indexState, 0, sizeof(_indexState));
@@ -91,6 +95,7 @@ namespace Alimer
         _currentVkPipelineLayout = VK_NULL_HANDLE;
         _currentPipelineLayout = nullptr;
         _currentShader = nullptr;
+        _currentPipelineState = nullptr;
         _currentTopology = PrimitiveTopology::Count;
     }
 
@@ -109,7 +114,12 @@ namespace Alimer
 
     void VulkanCommandBuffer::End()
     {
+        // Every operation is encoded directly, a recorded command would never be executed.
+        ALIMER_ASSERT(GetCommandCount() == 0);
         vkThrowIfFailed(vkEndCommandBuffer(_vkCommandBuffer));
+
+        // Transient data is read by the frame being recorded.
+        _graphics->GetUniformBufferPool()->RecycleBlock(_graphics->GetFrameIndex(), _uniformBlock);
     }
 
     void VulkanCommandBuffer::BeginRenderPassCore(RenderPass* renderPass, const Rectangle& renderArea, const Color* clearColors, uint32_t numClearColors, float clearDepth, uint8_t clearStencil)
@@ -127,31 +137,43 @@ namespace Alimer
             setRenderArea = Rectangle((int32_t)renderPass->GetWidth(), (int32_t)renderPass->GetHeight());
         }
 
-        std::vector<VkClearValue> clearValues(numClearColors + 1);
-        uint32_t i = 0;
-        for (; i < numClearColors; ++i)
+        if (_secondary)
+        {
+            // Continue render pass begun by the primary command buffer executing this one.
+            VkCommandBufferInheritanceInfo inheritanceInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+            inheritanceInfo.renderPass = _currentRenderPass->GetVkRenderPass();
+            inheritanceInfo.subpass = _currentSubpass;
+            inheritanceInfo.framebuffer = _currentRenderPass->GetVkFramebuffer();
+            Begin(&inheritanceInfo);
+            _subpassContents = VK_SUBPASS_CONTENTS_INLINE;
+        }
+        else
         {
-            clearValues[i].color.float32[0] = clearColors[i].r;
-            clearValues[i].color.float32[1] = clearColors[i].g;
-            clearValues[i].color.float32[2] = clearColors[i].b;
-            clearValues[i].color.float32[3] = clearColors[i].a;
+            numClearColors = std::min(numClearColors, MaxColorAttachments);
+            uint32_t i = 0;
+            for (; i < numClearColors; ++i)
+            {
+                _clearValues[i].color.float32[0] = clearColors[i].r;
+                _clearValues[i].color.float32[1] = clearColors[i].g;
+                _clearValues[i].color.float32[2] = clearColors[i].b;
+                _clearValues[i].color.float32[3] = clearColors[i].a;
+            }
+            _clearValues[i].depthStencil.depth = clearDepth;
+            _clearValues[i].depthStencil.stencil = clearStencil;
+
+            _renderPassBeginInfo = { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+            _renderPassBeginInfo.renderPass = _currentRenderPass->GetVkRenderPass();
+            _renderPassBeginInfo.framebuffer = _currentRenderPass->GetVkFramebuffer();
+            _renderPassBeginInfo.renderArea.offset.x = setRenderArea.x;
+            _renderPassBeginInfo.renderArea.offset.y = setRenderArea.y;
+            _renderPassBeginInfo.renderArea.extent.width = setRenderArea.width;
+            _renderPassBeginInfo.renderArea.extent.height = setRenderArea.height;
+            _renderPassBeginInfo.clearValueCount = numClearColors + 1;
+            _renderPassBeginInfo.pClearValues = _clearValues;
+            _renderPassPending = true;
         }
-        clearValues[i].depthStencil.depth = clearDepth;
-        clearValues[i].depthStencil.stencil = clearStencil;
-
-        VkRenderPassBeginInfo renderPassBeginInfo = { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
-        renderPassBeginInfo.renderPass = _currentRenderPass->GetVkRenderPass();
-        renderPassBeginInfo.framebuffer = _currentRenderPass->GetVkFramebuffer();
-        renderPassBeginInfo.renderArea.offset.x = setRenderArea.x;
-        renderPassBeginInfo.renderArea.offset.y = setRenderArea.y;
-        renderPassBeginInfo.renderArea.extent.width = setRenderArea.width;
-        renderPassBeginInfo.renderArea.extent.height = setRenderArea.height;
-        renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-        renderPassBeginInfo.pClearValues = clearValues.data();
-
-        vkCmdBeginRenderPass(_vkCommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-        // 
+
+        // Dynamic state can be set before the deferred vkCmdBeginRenderPass.
         SetViewport(Viewport(setRenderArea));
         SetScissor(setRenderArea);
         BeginGraphics();
@@ -159,20 +181,54 @@ namespace Alimer
 
     void VulkanCommandBuffer::EndRenderPassCore()
     {
-        vkCmdEndRenderPass(_vkCommandBuffer);
+        if (_secondary)
+        {
+            End();
+        }
+        else
+        {
+            FlushRenderPass(_subpassContents);
+            vkCmdEndRenderPass(_vkCommandBuffer);
+        }
+
+        _currentRenderPass = nullptr;
+    }
+
+    void VulkanCommandBuffer::FlushRenderPass(VkSubpassContents contents)
+    {
+        if (_renderPassPending)
+        {
+            vkCmdBeginRenderPass(_vkCommandBuffer, &_renderPassBeginInfo, contents);
+            _renderPassPending = false;
+            _subpassContents = contents;
+        }
+        else if (_subpassContents != contents)
+        {
+            ALIMER_LOGERROR("Vulkan - Render pass cannot mix inline draws and secondary command buffers.");
+        }
     }
 
     void VulkanCommandBuffer::ExecuteCommandsCore(uint32_t commandBufferCount, CommandBuffer* const* commandBuffers)
     {
-        std::vector<VkCommandBuffer> vkCommandBuffers;
-        for (uint32_t i = 0; i < commandBufferCount; i++)
+        if (IsInsideRenderPass())
         {
-            VulkanCommandBuffer* vulkanCmdBuffer = static_cast<VulkanCommandBuffer*>(commandBuffers[i]);
-            ALIMER_ASSERT(vulkanCmdBuffer->IsSecondary());
-            vkCommandBuffers[i] = vulkanCmdBuffer->GetVkCommandBuffer();
+            FlushRenderPass(VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
         }
 
-        vkCmdExecuteCommands(_vkCommandBuffer, commandBufferCount, vkCommandBuffers.data());
+        // Executed in array order, whatever order the secondaries finished recording in.
+        VkCommandBuffer vkCommandBuffers[16];
+        for (uint32_t offset = 0; offset < commandBufferCount; offset += 16)
+        {
+            const uint32_t count = std::min(commandBufferCount - offset, 16u);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                VulkanCommandBuffer* vulkanCmdBuffer = static_cast<VulkanCommandBuffer*>(commandBuffers[offset + i]);
+                ALIMER_ASSERT(vulkanCmdBuffer->IsSecondary());
+                vkCommandBuffers[i] = vulkanCmdBuffer->GetVkCommandBuffer();
+            }
+
+            vkCmdExecuteCommands(_vkCommandBuffer, count, vkCommandBuffers);
+        }
     }
 
     void VulkanCommandBuffer::SetViewport(const Viewport& viewport)
@@ -214,8 +270,27 @@ namespace Alimer
 
     }
 
+    void VulkanCommandBuffer::SetPipelineStateCore(PipelineState* pipelineState)
+    {
+        auto vulkanPipelineState = static_cast<VulkanPipelineState*>(pipelineState);
+        SetShaderCore(vulkanPipelineState->GetShader());
+
+        if (_currentPipelineState != vulkanPipelineState)
+        {
+            _currentPipelineState = vulkanPipelineState;
+            SetDirty(COMMAND_BUFFER_DIRTY_STATIC_STATE_BIT);
+        }
+    }
+
     void VulkanCommandBuffer::SetShaderCore(Shader* shader)
     {
+        // Shader set directly draws with the default render state.
+        if (_currentPipelineState != nullptr)
+        {
+            _currentPipelineState = nullptr;
+            SetDirty(COMMAND_BUFFER_DIRTY_STATIC_STATE_BIT);
+        }
+
         if (_currentShader == shader)
             return;
 
@@ -238,6 +313,12 @@ namespace Alimer
             const ResourceLayout &oldLayout = _currentPipelineLayout->GetResourceLayout();
 
             // TODO: Invalidate sets
+            _dirtySets |= 1u << VulkanBindlessSet;
+            if (newLayout.pushConstantSize != 0)
+            {
+                SetDirty(COMMAND_BUFFER_DIRTY_PUSH_CONSTANTS_BIT);
+            }
+
             _currentPipelineLayout = _currentShader->GetPipelineLayout();
             _currentVkPipelineLayout = _currentPipelineLayout->GetVkHandle();
         }
@@ -245,7 +326,9 @@ namespace Alimer
 
     void VulkanCommandBuffer::DrawCore(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance)
     {
-        PrepareDraw(topology);
+        if (!PrepareDraw(topology))
+            return;
+
         vkCmdDraw(_vkCommandBuffer, vertexCount, instanceCount, vertexStart, baseInstance);
     }
 
@@ -254,17 +337,21 @@ namespace Alimer
         ALIMER_ASSERT(_currentShader);
         ALIMER_ASSERT(!_isCompute);
         ALIMER_ASSERT(_indexState.buffer != nullptr);
-        PrepareDraw(topology);
+        if (!PrepareDraw(topology))
+            return;
+
         vkCmdDrawIndexed(_vkCommandBuffer, indexCount, instanceCount, startIndex, 0, 0);
     }
 
-    void VulkanCommandBuffer::PrepareDraw(PrimitiveTopology topology)
+    bool VulkanCommandBuffer::PrepareDraw(PrimitiveTopology topology)
     {
         ALIMER_ASSERT(_currentShader);
         ALIMER_ASSERT(!_isCompute);
 
+        FlushRenderPass(VK_SUBPASS_CONTENTS_INLINE);
         SetPrimitiveTopology(topology);
-        FlushRenderState();
+        if (!FlushRenderState())
+            return false;
 
         uint32_t updateVboMask = _dirtyVbos & _activeVbos;
         ForEachBitRange(updateVboMask, [&](uint32_t binding, uint32_t count)
@@ -283,6 +370,7 @@ namespace Alimer
                 _vbo.offsets + binding);
         });
         _dirtyVbos &= ~updateVboMask;
+        return true;
     }
 
     void VulkanCommandBuffer::SetVertexAttribute(uint32_t attrib, uint32_t binding, VkFormat format, VkDeviceSize offset)
@@ -354,9 +442,14 @@ namespace Alimer
         auto &b = _bindings.bindings[set][binding];
 
         if (b.buffer.buffer == vkBuffer
-            && b.buffer.offset == offset
             && b.buffer.range == range)
         {
+            // Same descriptor, only the dynamic offset has to be rebound.
+            if (b.buffer.offset != offset)
+            {
+                b.buffer.offset = offset;
+                _dirtySetsDynamic |= 1u << set;
+            }
             return;
         }
 
@@ -364,7 +457,46 @@ namespace Alimer
         _dirtySets |= 1u << set;
     }
 
-    void VulkanCommandBuffer::FlushRenderState()
+    void VulkanCommandBuffer::SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags /*stage*/)
+    {
+        auto vkTexture = static_cast<VulkanTexture*>(texture);
+        VkImageView imageView = vkTexture ? vkTexture->GetDefaultImageView() : VK_NULL_HANDLE;
+        VkImageLayout imageLayout = (vkTexture && (vkTexture->GetUsage() & TextureUsage::ShaderWrite))
+            ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        auto &b = _bindings.bindings[0][binding];
+        if (b.image.fp.imageView == imageView
+            && b.image.fp.imageLayout == imageLayout)
+        {
+            return;
+        }
+
+        b.image.fp.sampler = VK_NULL_HANDLE;
+        b.image.fp.imageView = imageView;
+        b.image.fp.imageLayout = imageLayout;
+        _dirtySets |= 1u << 0;
+    }
+
+    TransientAllocation VulkanCommandBuffer::AllocateUniformCore(uint64_t size)
+    {
+        VulkanTransientBufferPool* pool = _graphics->GetUniformBufferPool();
+
+        uint64_t offset;
+        if (!_uniformBlock.Allocate(size, pool->GetAlignment(), &offset))
+        {
+            pool->RecycleBlock(_graphics->GetFrameIndex(), _uniformBlock);
+            _uniformBlock = pool->RequestBlock(size);
+            _uniformBlock.Allocate(size, pool->GetAlignment(), &offset);
+        }
+
+        TransientAllocation allocation;
+        allocation.buffer = _uniformBlock.buffer.Get();
+        allocation.offset = offset;
+        allocation.data = _uniformBlock.data + offset;
+        return allocation;
+    }
+
+    bool VulkanCommandBuffer::FlushRenderState()
     {
         ALIMER_ASSERT(_currentPipelineLayout);
         //ALIMER_ASSERT(current_program);
@@ -376,7 +508,14 @@ namespace Alimer
             | COMMAND_BUFFER_DIRTY_STATIC_VERTEX_BIT))
         {
             VkPipeline oldPipeline = _currentVkPipeline;
-            FlushGraphicsPipeline();
+            if (!FlushGraphicsPipeline())
+            {
+                // Pipeline still compiling, skip the draw and look it up again on the next one.
+                _currentVkPipeline = oldPipeline;
+                SetDirty(COMMAND_BUFFER_DIRTY_PIPELINE_BIT);
+                return false;
+            }
+
             if (oldPipeline != _currentVkPipeline)
             {
                 vkCmdBindPipeline(_vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _currentVkPipeline);
@@ -385,165 +524,85 @@ namespace Alimer
         }
 
         FlushDescriptorSets();
-    }
 
-    void VulkanCommandBuffer::FlushGraphicsPipeline()
-    {
-        Hasher h;
-        _activeVbos = 0;
-        auto &layout = _currentPipelineLayout->GetResourceLayout();
-        ForEachBit(layout.attributeMask, [&](uint32_t bit)
+        const ResourceLayout& layout = _currentPipelineLayout->GetResourceLayout();
+        if (GetAndClear(COMMAND_BUFFER_DIRTY_PUSH_CONSTANTS_BIT) && layout.pushConstantSize != 0)
         {
-            h.u32(bit);
-            _activeVbos |= 1u << _attribs[bit].binding;
-            h.u32(_attribs[bit].binding);
-            h.u32(_attribs[bit].format);
-            h.u32(_attribs[bit].offset);
-        });
-
-        ForEachBit(_activeVbos, [&](uint32_t bit)
-        {
-            h.u32(static_cast<uint32_t>(_vbo.inputRates[bit]));
-            h.u32(_vbo.strides[bit]);
-        });
-
-        // TODO: use render pass hash.
-        h.pointer(_currentRenderPass->GetVkRenderPass());
-        //h.u64(_currentRenderPass->GetHash());
-        h.u32(_currentSubpass);
-        h.pointer(_currentShader);
-        //h.u64(_currentPipeline->GetHash());
-        h.u32(static_cast<uint32_t>(_currentTopology));
-
-        auto hash = h.get();
-        _currentVkPipeline = _currentShader->GetGraphicsPipeline(hash);
-        if (_currentVkPipeline == VK_NULL_HANDLE)
-        {
-            // Create new.
-            VkPipelineVertexInputStateCreateInfo vertexInputState = { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
-            VkVertexInputAttributeDescription vkAttribs[MaxVertexAttributes];
-            vertexInputState.pVertexAttributeDescriptions = vkAttribs;
-
-            uint32_t attributeMask = _currentPipelineLayout->GetResourceLayout().attributeMask;
-            uint32_t bindingMask = 0;
-            ForEachBit(attributeMask, [&](uint32_t bit) {
-                auto &attr = vkAttribs[vertexInputState.vertexAttributeDescriptionCount++];
-                attr.location = bit;
-                attr.binding = _attribs[bit].binding;
-                attr.format = _attribs[bit].format;
-                attr.offset = _attribs[bit].offset;
-                bindingMask |= 1u << attr.binding;
-            });
-
-            VkVertexInputBindingDescription vkVboBindings[MaxVertexBufferBindings];
-            vertexInputState.pVertexBindingDescriptions = vkVboBindings;
-            ForEachBit(bindingMask, [&](uint32_t bit) {
-                auto &bind = vkVboBindings[vertexInputState.vertexBindingDescriptionCount++];
-                bind.binding = bit;
-                bind.inputRate = vk::Convert(_vbo.inputRates[bit]);
-                bind.stride = _vbo.strides[bit];
-            });
+            vkCmdPushConstants(
+                _vkCommandBuffer,
+                _currentVkPipelineLayout,
+                static_cast<VkShaderStageFlags>(layout.pushConstantStages),
+                0,
+                layout.pushConstantSize,
+                _bindings.pushConstantData);
+        }
 
-            // Viewport state
-            VkPipelineViewportStateCreateInfo viewportState = { VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
-            viewportState.viewportCount = 1;
-            viewportState.scissorCount = 1;
-
-            // Rasterization state
-            VkPipelineRasterizationStateCreateInfo rasterizationState = { VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
-            rasterizationState.cullMode = VK_CULL_MODE_BACK_BIT;
-            // Default clockwise as DirectX coordinate.
-            rasterizationState.frontFace = VK_FRONT_FACE_CLOCKWISE;
-            rasterizationState.lineWidth = 1.0f;
-            rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
-            rasterizationState.depthBiasEnable = VK_FALSE;
-
-            // Multisample
-            VkPipelineMultisampleStateCreateInfo multpleSampleState = { VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
-            multpleSampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-            // Depth state
-            VkPipelineDepthStencilStateCreateInfo depthStencilState = { VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
-            depthStencilState.stencilTestEnable = VK_FALSE;
-            depthStencilState.depthTestEnable = VK_FALSE;
-            depthStencilState.depthWriteEnable = VK_FALSE;
-
-            // Blend state
-            VkPipelineColorBlendAttachmentState blendAttachments[MaxColorAttachments] = {};
-            blendAttachments[0].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-            blendAttachments[0].blendEnable = VK_FALSE;
-
-            VkPipelineColorBlendStateCreateInfo blendState = { VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
-            blendState.attachmentCount = 1;
-            blendState.pAttachments = blendAttachments;
-
-            // Dynamic state
-            VkPipelineDynamicStateCreateInfo dynamicState = { VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
-            dynamicState.dynamicStateCount = 2;
-            VkDynamicState states[2] = {
-                VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_VIEWPORT,
-            };
-            dynamicState.pDynamicStates = states;
+        return true;
+    }
 
-            // Input assembly
-            VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = { VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
-            inputAssemblyState.pNext = nullptr;
-            inputAssemblyState.flags = 0;
-            inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-            inputAssemblyState.primitiveRestartEnable = VK_FALSE;
+    void VulkanCommandBuffer::PushConstantsCore(const void* data, uint32_t size, uint32_t offset)
+    {
+        memcpy(_bindings.pushConstantData + offset, data, size);
+        SetDirty(COMMAND_BUFFER_DIRTY_PUSH_CONSTANTS_BIT);
+    }
 
-            // Stages
-            VkPipelineShaderStageCreateInfo stages[static_cast<uint32_t>(VulkanShaderStage::Count)];
-            uint32_t numStages = 0;
+    bool VulkanCommandBuffer::FlushGraphicsPipeline()
+    {
+        VulkanGraphicsPipelineState& state = _pipelineState;
+        state.subpass = _currentSubpass;
+        state.colorAttachmentCount = _currentRenderPass->GetColorAttachmentsCount();
+        state.topology = _currentTopology;
 
-            for (uint32_t i = 0; i < static_cast<uint32_t>(VulkanShaderStage::Count); i++)
+        // Render state blocks are copied only when they changed since the last flush.
+        if (_currentPipelineState != nullptr)
+        {
+            if (state.renderStateHash != _currentPipelineState->GetRenderStateHash())
             {
-                auto vkModule = _currentShader->GetVkShaderModule(i);
-                if (vkModule != VK_NULL_HANDLE)
-                {
-                    auto &stage = stages[numStages++];
-                    stage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
-                    stage.module = vkModule;
-                    stage.pName = "main";
-                    stage.stage = static_cast<VkShaderStageFlagBits>(1u << i);
-                }
+                state.renderStateHash = _currentPipelineState->GetRenderStateHash();
+                state.blendState = _currentPipelineState->GetBlendState();
+                state.rasterizerState = _currentPipelineState->GetRasterizerState();
+                state.depthStencilState = _currentPipelineState->GetDepthStencilState();
             }
+        }
+        else
+        {
+            static const Hash defaultRenderStateHash = PipelineState::HashRenderState(BlendState(), RasterizerState(), DepthStencilState());
+            if (state.renderStateHash != defaultRenderStateHash)
+            {
+                state.renderStateHash = defaultRenderStateHash;
+                state.blendState = BlendState();
+                state.rasterizerState = RasterizerState();
+                state.depthStencilState = DepthStencilState();
+            }
+        }
 
-            VkGraphicsPipelineCreateInfo createInfo = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
-            createInfo.pNext = nullptr;
-            createInfo.flags = 0;
-            createInfo.stageCount = numStages;
-            createInfo.pStages = stages;
-            createInfo.pVertexInputState = &vertexInputState;
-            createInfo.pTessellationState = nullptr;
-            createInfo.pViewportState = &viewportState;
-            createInfo.pRasterizationState = &rasterizationState;
-            createInfo.pMultisampleState = &multpleSampleState;
-            createInfo.pDepthStencilState = &depthStencilState;
-            createInfo.pColorBlendState = &blendState;
-            createInfo.pDynamicState = &dynamicState;
-            createInfo.pInputAssemblyState = &inputAssemblyState;
-            createInfo.layout = _currentVkPipelineLayout;
-            createInfo.renderPass = _currentRenderPass->GetVkRenderPass();
-            createInfo.subpass = _currentSubpass;
-            createInfo.basePipelineHandle = VK_NULL_HANDLE;
-            createInfo.basePipelineIndex = 0;
-
-            VkPipeline newPipeline;
-            if (vkCreateGraphicsPipelines(
-                _logicalDevice,
-                _graphics->GetPipelineCache(),
-                1,
-                &createInfo,
-                nullptr,
-                &newPipeline) != VK_SUCCESS)
+        // Unused attributes and bindings are cleared so recorded states compare equal.
+        _activeVbos = 0;
+        auto &layout = _currentPipelineLayout->GetResourceLayout();
+        for (uint32_t i = 0; i < MaxVertexAttributes; ++i)
+        {
+            if (layout.attributeMask & (1u << i))
             {
-                ALIMER_LOGCRITICAL("Vulkan - Failed to graphics pipeline");
+                state.attribs[i] = _attribs[i];
+                _activeVbos |= 1u << _attribs[i].binding;
             }
+            else
+            {
+                state.attribs[i] = {};
+            }
+        }
 
-            _currentShader->AddPipeline(hash, newPipeline);
-            _currentVkPipeline = newPipeline;
+        for (uint32_t i = 0; i < MaxVertexBufferBindings; ++i)
+        {
+            const bool active = (_activeVbos & (1u << i)) != 0;
+            state.inputRates[i] = active ? _vbo.inputRates[i] : VertexInputRate::Vertex;
+            state.strides[i] = active ? static_cast<uint32_t>(_vbo.strides[i]) : 0u;
         }
+
+        VkRenderPass renderPass = _currentRenderPass->GetVkRenderPass();
+        Hash hash = _currentShader->HashGraphicsPipeline(renderPass, state);
+        _currentVkPipeline = _currentShader->RequestGraphicsPipeline(hash, renderPass, _currentRenderPass->GetRenderPassHash(), state, _graphics->GetAsyncPipelineCompilation());
+        return _currentVkPipeline != VK_NULL_HANDLE;
     }
 
     void VulkanCommandBuffer::FlushDescriptorSet(uint32_t set)
@@ -564,8 +623,17 @@ namespace Alimer
             dynamicOffsets[numDynamicOffsets++] = _bindings.bindings[set][binding].buffer.offset;
         });
 
+        // Sampled images
+        ForEachBit(setLayout.sampledImageMask, [&](uint32_t binding) {
+            h.pointer(_bindings.bindings[set][binding].image.fp.imageView);
+            h.u32(_bindings.bindings[set][binding].image.fp.imageLayout);
+            ALIMER_ASSERT(_bindings.bindings[set][binding].image.fp.imageView != VK_NULL_HANDLE);
+        });
+
         auto hash = h.get();
-        std::pair<VkDescriptorSet, bool> allocated = _currentPipelineLayout->GetAllocator(set)->Find(hash);
+        VulkanDescriptorSetAllocator* allocator = _currentPipelineLayout->GetAllocator(set);
+        std::unique_lock<std::mutex> lock(allocator->GetLock());
+        std::pair<VkDescriptorSet, bool> allocated = allocator->Find(hash);
         if (!allocated.second)
         {
             uint32_t writeCount = 0;
@@ -591,9 +659,23 @@ namespace Alimer
                 write.pBufferInfo = &buffer;
             });
 
+            ForEachBit(setLayout.sampledImageMask, [&](uint32_t binding) {
+                auto &write = writes[writeCount++];
+                write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                write.pNext = nullptr;
+                write.descriptorCount = 1;
+                write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                write.dstArrayElement = 0;
+                write.dstBinding = binding;
+                write.dstSet = allocated.first;
+                write.pImageInfo = &_bindings.bindings[set][binding].image.fp;
+            });
+
             vkUpdateDescriptorSets(_logicalDevice, writeCount, writes, 0, nullptr);
         }
+        lock.unlock();
 
+        _allocatedSets[set] = allocated.first;
         vkCmdBindDescriptorSets(
             _vkCommandBuffer,
             _currentRenderPass ? VK_PIPELINE_BIND_POINT_GRAPHICS : VK_PIPELINE_BIND_POINT_COMPUTE,
@@ -608,8 +690,50 @@ namespace Alimer
     {
         auto &layout = _currentPipelineLayout->GetResourceLayout();
         uint32_t updateSet = layout.descriptorSetMask & _dirtySets;
+
+        // Bindless heap set is never rewritten per draw, only bound.
+        if (_currentPipelineLayout->HasBindlessSet() && (updateSet & (1u << VulkanBindlessSet)))
+        {
+            VkDescriptorSet bindlessSet = _graphics->GetBindlessHeap()->GetDescriptorSet();
+            vkCmdBindDescriptorSets(
+                _vkCommandBuffer,
+                _currentRenderPass ? VK_PIPELINE_BIND_POINT_GRAPHICS : VK_PIPELINE_BIND_POINT_COMPUTE,
+                _currentVkPipelineLayout,
+                VulkanBindlessSet,
+                1, &bindlessSet,
+                0, nullptr);
+            updateSet &= ~(1u << VulkanBindlessSet);
+            _dirtySets &= ~(1u << VulkanBindlessSet);
+        }
+
         ForEachBit(updateSet, [&](uint32_t set) { FlushDescriptorSet(set); });
         _dirtySets &= ~updateSet;
+        _dirtySetsDynamic &= ~updateSet;
+
+        uint32_t dynamicSet = layout.descriptorSetMask & _dirtySetsDynamic;
+        ForEachBit(dynamicSet, [&](uint32_t set) { RebindDescriptorSet(set); });
+        _dirtySetsDynamic &= ~dynamicSet;
+    }
+
+    void VulkanCommandBuffer::RebindDescriptorSet(uint32_t set)
+    {
+        auto &layout = _currentPipelineLayout->GetResourceLayout();
+        auto &setLayout = layout.sets[set];
+        uint32_t numDynamicOffsets = 0;
+        uint32_t dynamicOffsets[MaxBindingsPerSet];
+
+        ForEachBit(setLayout.uniformBufferMask, [&](uint32_t binding) {
+            dynamicOffsets[numDynamicOffsets++] = _bindings.bindings[set][binding].buffer.offset;
+        });
+
+        vkCmdBindDescriptorSets(
+            _vkCommandBuffer,
+            _currentRenderPass ? VK_PIPELINE_BIND_POINT_GRAPHICS : VK_PIPELINE_BIND_POINT_COMPUTE,
+            _currentVkPipelineLayout,
+            set,
+            1, &_allocatedSets[set],
+            numDynamicOffsets,
+            dynamicOffsets);
     }
 }
 
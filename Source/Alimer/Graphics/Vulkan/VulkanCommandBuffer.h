@@ -24,6 +24,8 @@
 
 #include "../CommandBuffer.h"
 #include "VulkanPrerequisites.h"
+#include "VulkanTransientBufferPool.h"
+#include "VulkanShader.h"
 #include <vector>
 
 namespace Alimer
@@ -33,6 +35,7 @@ namespace Alimer
     class VulkanCommandQueue;
     class VulkanPipelineLayout;
     class VulkanShader;
+    class VulkanPipelineState;
     class VulkanRenderPass;
 
     enum CommandBufferDirtyBits
@@ -55,14 +58,6 @@ namespace Alimer
     };
     using CommandBufferDirtyFlags = uint32_t;
 
-
-    struct VertexAttribState
-    {
-        uint32_t binding;
-        VkFormat format;
-        uint32_t offset;
-    };
-
     /// Vulkan CommandBuffer.
     class VulkanCommandBuffer final : public CommandBuffer
     {
@@ -83,16 +78,21 @@ namespace Alimer
         void SetScissors(uint32_t numScissors, const Rectangle* scissors) override;
 
         void SetShaderCore(Shader* shader) override;
+        void SetPipelineStateCore(PipelineState* pipelineState) override;
 
         void DrawCore(PrimitiveTopology topology, uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexStart, uint32_t baseInstance) override;
         void DrawIndexedCore(PrimitiveTopology topology, uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex) override;
 
-        void ExecuteCommandsCore(uint32_t commandBufferCount, CommandBuffer* const* commandBuffers);
+        void ExecuteCommandsCore(uint32_t commandBufferCount, CommandBuffer* const* commandBuffers) override;
 
         void SetVertexAttribute(uint32_t attrib, uint32_t binding, VkFormat format, VkDeviceSize offset);
         void SetVertexBufferCore(uint32_t binding, VertexBuffer* buffer, uint64_t offset, uint64_t stride, VertexInputRate inputRate) override;
         void SetIndexBufferCore(GpuBuffer* buffer, uint32_t offset, IndexType indexType) override;
         void SetUniformBufferCore(uint32_t set, uint32_t binding, GpuBuffer* buffer, uint64_t offset, uint64_t range) override;
+        TransientAllocation AllocateUniformCore(uint64_t size) override;
+        /// Bind texture as sampled image of descriptor set 0, samplers are declared separately by the shader.
+        void SetTextureCore(uint32_t binding, Texture* texture, ShaderStageFlags stage) override;
+        void PushConstantsCore(const void* data, uint32_t size, uint32_t offset) override;
 
         inline void SetPrimitiveTopology(PrimitiveTopology topology)
         {
@@ -110,11 +110,13 @@ namespace Alimer
         void BeginCompute();
         void BeginGraphics();
         void BeginContext();
-        void PrepareDraw(PrimitiveTopology topology);
+        bool PrepareDraw(PrimitiveTopology topology);
+        void FlushRenderPass(VkSubpassContents contents);
 
-        void FlushRenderState();
-        void FlushGraphicsPipeline();
+        bool FlushRenderState();
+        bool FlushGraphicsPipeline();
         void FlushDescriptorSet(uint32_t set);
+        void RebindDescriptorSet(uint32_t set);
         void FlushDescriptorSets();
 
     private:
@@ -137,13 +139,22 @@ namespace Alimer
         VkCommandBuffer _vkCommandBuffer;
         bool _secondary = false;
         VulkanRenderPass* _currentRenderPass = nullptr;
+        /// Primary render pass begin is deferred until its contents are known: inline draws or secondary command buffers.
+        bool _renderPassPending = false;
+        VkSubpassContents _subpassContents = VK_SUBPASS_CONTENTS_INLINE;
+        VkRenderPassBeginInfo _renderPassBeginInfo = {};
+        VkClearValue _clearValues[MaxColorAttachments + 1] = {};
         uint32_t _currentSubpass = 0;
         VulkanShader* _currentShader = nullptr;
+        /// Render state of draws, nullptr uses the default state blocks.
+        VulkanPipelineState* _currentPipelineState = nullptr;
         VulkanPipelineLayout* _currentPipelineLayout = nullptr;
         VkPipeline _currentVkPipeline = VK_NULL_HANDLE;
         VkPipelineLayout _currentVkPipelineLayout = VK_NULL_HANDLE;
 
         VkViewport _currentViewports[MaxViewportsAndScissors] = {};
+        /// Pipeline state of the last flush.
+        VulkanGraphicsPipelineState _pipelineState = {};
 
         struct VertexBindingState
         {
@@ -176,7 +187,7 @@ namespace Alimer
         struct ResourceBindings
         {
             ResourceBinding bindings[MaxDescriptorSets][MaxBindingsPerSet];
-            uint8_t push_constant_data[MaxDescriptorSets];
+            uint8_t pushConstantData[MaxPushConstantSize];
         };
 
         VertexAttribState _attribs[MaxVertexAttributes] = {};
@@ -188,6 +199,12 @@ namespace Alimer
         bool _isCompute = true;
         CommandBufferDirtyFlags _dirty = ~0u;
         uint32_t _dirtySets = 0;
+        /// Sets whose descriptors are unchanged but dynamic offsets changed.
+        uint32_t _dirtySetsDynamic = 0;
+        VkDescriptorSet _allocatedSets[MaxDescriptorSets] = {};
+
+        /// Current block of transient uniform data, returned to the pool on End.
+        VulkanTransientBlock _uniformBlock;
         uint32_t _dirtyVbos = 0;
         uint32_t _activeVbos = 0;
     };
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../PipelineState.h"
 #include "VulkanPrerequisites.h"
 #include "../Types.h"
 #include "../PixelFormat.h"
@@ -197,6 +198,135 @@ namespace Alimer
             }
         }
 
+        static inline VkPrimitiveTopology Convert(PrimitiveTopology topology)
+        {
+            switch (topology)
+            {
+            case PrimitiveTopology::Points:         return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+            case PrimitiveTopology::Lines:          return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+            case PrimitiveTopology::LineStrip:      return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+            case PrimitiveTopology::Triangles:      return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            case PrimitiveTopology::TriangleStrip:  return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+            default:
+                return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            }
+        }
+
+        static inline VkBlendFactor Convert(BlendFactor factor)
+        {
+            switch (factor)
+            {
+            case BlendFactor::Zero:                     return VK_BLEND_FACTOR_ZERO;
+            case BlendFactor::One:                      return VK_BLEND_FACTOR_ONE;
+            case BlendFactor::SourceColor:              return VK_BLEND_FACTOR_SRC_COLOR;
+            case BlendFactor::OneMinusSourceColor:      return VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+            case BlendFactor::SourceAlpha:              return VK_BLEND_FACTOR_SRC_ALPHA;
+            case BlendFactor::OneMinusSourceAlpha:      return VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            case BlendFactor::DestinationColor:         return VK_BLEND_FACTOR_DST_COLOR;
+            case BlendFactor::OneMinusDestinationColor: return VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR;
+            case BlendFactor::DestinationAlpha:         return VK_BLEND_FACTOR_DST_ALPHA;
+            case BlendFactor::OneMinusDestinationAlpha: return VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
+            case BlendFactor::SourceAlphaSaturated:     return VK_BLEND_FACTOR_SRC_ALPHA_SATURATE;
+            case BlendFactor::BlendColor:               return VK_BLEND_FACTOR_CONSTANT_COLOR;
+            case BlendFactor::OneMinusBlendColor:       return VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR;
+            default:
+                return VK_BLEND_FACTOR_ONE;
+            }
+        }
+
+        static inline VkBlendOp Convert(BlendOperation operation)
+        {
+            switch (operation)
+            {
+            case BlendOperation::Add:               return VK_BLEND_OP_ADD;
+            case BlendOperation::Subtract:          return VK_BLEND_OP_SUBTRACT;
+            case BlendOperation::ReverseSubtract:   return VK_BLEND_OP_REVERSE_SUBTRACT;
+            case BlendOperation::Min:               return VK_BLEND_OP_MIN;
+            case BlendOperation::Max:               return VK_BLEND_OP_MAX;
+            default:
+                return VK_BLEND_OP_ADD;
+            }
+        }
+
+        static inline VkCompareOp Convert(CompareFunction function)
+        {
+            switch (function)
+            {
+            case CompareFunction::Never:        return VK_COMPARE_OP_NEVER;
+            case CompareFunction::Less:         return VK_COMPARE_OP_LESS;
+            case CompareFunction::Equal:        return VK_COMPARE_OP_EQUAL;
+            case CompareFunction::LessEqual:    return VK_COMPARE_OP_LESS_OR_EQUAL;
+            case CompareFunction::Greater:      return VK_COMPARE_OP_GREATER;
+            case CompareFunction::NotEqual:     return VK_COMPARE_OP_NOT_EQUAL;
+            case CompareFunction::GreaterEqual: return VK_COMPARE_OP_GREATER_OR_EQUAL;
+            // CompareFunction::Always, not named as X11 defines Always.
+            default:
+                return VK_COMPARE_OP_ALWAYS;
+            }
+        }
+
+        static inline VkStencilOp Convert(StencilOperation operation)
+        {
+            switch (operation)
+            {
+            case StencilOperation::Keep:            return VK_STENCIL_OP_KEEP;
+            case StencilOperation::Zero:            return VK_STENCIL_OP_ZERO;
+            case StencilOperation::Replace:         return VK_STENCIL_OP_REPLACE;
+            case StencilOperation::IncrementClamp:  return VK_STENCIL_OP_INCREMENT_AND_CLAMP;
+            case StencilOperation::DecrementClamp:  return VK_STENCIL_OP_DECREMENT_AND_CLAMP;
+            case StencilOperation::Invert:          return VK_STENCIL_OP_INVERT;
+            case StencilOperation::IncrementWrap:   return VK_STENCIL_OP_INCREMENT_AND_WRAP;
+            case StencilOperation::DecrementWrap:   return VK_STENCIL_OP_DECREMENT_AND_WRAP;
+            default:
+                return VK_STENCIL_OP_KEEP;
+            }
+        }
+
+        static inline VkStencilOpState Convert(const StencilOpState& state, uint8_t readMask, uint8_t writeMask)
+        {
+            VkStencilOpState vkState = {};
+            vkState.failOp = Convert(state.failOperation);
+            vkState.passOp = Convert(state.passOperation);
+            vkState.depthFailOp = Convert(state.depthFailOperation);
+            vkState.compareOp = Convert(state.compareFunction);
+            vkState.compareMask = readMask;
+            vkState.writeMask = writeMask;
+            vkState.reference = 0;
+            return vkState;
+        }
+
+        static inline VkPolygonMode Convert(FillMode mode)
+        {
+            switch (mode)
+            {
+            case FillMode::Wireframe:   return VK_POLYGON_MODE_LINE;
+            default:
+                return VK_POLYGON_MODE_FILL;
+            }
+        }
+
+        static inline VkCullModeFlags Convert(CullMode mode)
+        {
+            switch (mode)
+            {
+            case CullMode::Front:   return VK_CULL_MODE_FRONT_BIT;
+            case CullMode::Back:    return VK_CULL_MODE_BACK_BIT;
+            // CullMode::None, not named as X11 defines None.
+            default:
+                return VK_CULL_MODE_NONE;
+            }
+        }
+
+        static inline VkFrontFace Convert(FrontFace face)
+        {
+            switch (face)
+            {
+            case FrontFace::CounterClockwise:   return VK_FRONT_FACE_COUNTER_CLOCKWISE;
+            default:
+                return VK_FRONT_FACE_CLOCKWISE;
+            }
+        }
+
         static inline VkIndexType Convert(IndexType type)
         {
             switch (type)
@@ -26,6 +26,7 @@
 #include "../../Core/Log.h"
 #include "../../Core/String.h"
 #include "../../Application/Window.h"
+#include "../../IO/FileSystem.h"
 #include "VulkanGraphics.h"
 #include "VulkanGpuAdapter.h"
 #include "VulkanCommandQueue.h"
@@ -33,6 +34,9 @@
 #include "VulkanRenderPass.h"
 #include "VulkanTexture.h"
 #include "VulkanBuffer.h"
+#include "VulkanUploadContext.h"
+#include "VulkanTransientBufferPool.h"
+#include "VulkanBindlessHeap.h"
 #include "VulkanShader.h"
 #include "VulkanPipelineLayout.h"
 #include "VulkanPipelineState.h"
@@ -43,11 +47,25 @@
 #endif
 
 #include "AlimerVersion.h"
+#include <algorithm>
 #include <map>
 using namespace std;
 
 namespace Alimer
 {
+    static const char* VulkanPipelineCacheFileName = "VulkanPipelineCache.bin";
+    static const char* VulkanPipelineRecordsFileName = "VulkanPipelines.bin";
+    static constexpr uint32_t VulkanPipelineRecordsMagic = 0x4C504C41u;
+    static constexpr uint32_t VulkanPipelineRecordsVersion = 3u;
+
+    struct VulkanPipelineRecordsHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t count;
+    };
+
     /*
     * A layer can expose extensions, keep track of those
     * extensions here.
@@ -155,6 +173,74 @@ namespace Alimer
         return true;
     }
 
+    static bool HasInstanceExtension(const char* name)
+    {
+        uint32_t extensionCount = 0;
+        if (vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr) != VK_SUCCESS)
+            return false;
+
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, extensions.data());
+        for (const VkExtensionProperties& extension : extensions)
+        {
+            if (strcmp(extension.extensionName, name) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    static bool HasDeviceExtension(const std::vector<const char*>& extensions, const char* name)
+    {
+        for (const char* extension : extensions)
+        {
+            if (strcmp(extension, name) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    /// Query descriptor indexing features needed by the bindless heap, fill features to enable and heap sizes.
+    static bool QueryDescriptorIndexing(VkPhysicalDevice physicalDevice, VkPhysicalDeviceDescriptorIndexingFeaturesEXT& enabledFeatures, uint32_t& maxTextures, uint32_t& maxBuffers)
+    {
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT };
+        VkPhysicalDeviceFeatures2KHR features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR };
+        features.pNext = &supportedFeatures;
+        vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features);
+
+        if (!supportedFeatures.runtimeDescriptorArray
+            || !supportedFeatures.descriptorBindingPartiallyBound
+            || !supportedFeatures.descriptorBindingUpdateUnusedWhilePending
+            || !supportedFeatures.descriptorBindingSampledImageUpdateAfterBind
+            || !supportedFeatures.descriptorBindingStorageBufferUpdateAfterBind)
+        {
+            return false;
+        }
+
+        enabledFeatures.runtimeDescriptorArray = VK_TRUE;
+        enabledFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+        enabledFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        enabledFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        enabledFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        // Indices from push constants are uniform, non uniform indexing is enabled for shaders that need it.
+        enabledFeatures.shaderSampledImageArrayNonUniformIndexing = supportedFeatures.shaderSampledImageArrayNonUniformIndexing;
+        enabledFeatures.shaderStorageBufferArrayNonUniformIndexing = supportedFeatures.shaderStorageBufferArrayNonUniformIndexing;
+
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT };
+        VkPhysicalDeviceProperties2KHR properties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR };
+        properties.pNext = &indexingProperties;
+        vkGetPhysicalDeviceProperties2KHR(physicalDevice, &properties);
+
+        maxTextures = std::min({ VulkanBindlessMaxTextures,
+            indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+            indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages });
+        maxBuffers = std::min({ VulkanBindlessMaxBuffers,
+            indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+            indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+        return maxTextures > 0 && maxBuffers > 0;
+    }
+
     static VKAPI_ATTR VkBool32 VKAPI_CALL VkDebugCallback(
         VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType,
         uint64_t object, size_t location, int32_t messageCode,
@@ -276,6 +362,13 @@ namespace Alimer
         instanceExtensionNames.push_back(VK_KHR_WAYLAND_SURFACE_EXTENSION_NAME);
 #endif
 
+        // Used to query descriptor indexing support of bindless resources.
+        if (HasInstanceExtension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+        {
+            instanceExtensionNames.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+            _physicalDeviceProperties2 = true;
+        }
+
         vector<const char*> instanceLayerNames;
         bool hasValidationLayer = false;
         if (validation)
@@ -378,8 +471,24 @@ namespace Alimer
     void VulkanGraphics::Finalize()
     {
         WaitIdle();
+
+        // Release transient blocks before tracked GPU resources are destroyed.
+        _bufferUpdateBlock = {};
+        _bufferUpdateFullBlocks.clear();
+        _bufferUpdates.clear();
+        _uniformBufferPool.reset();
+
         Graphics::Finalize();
 
+        // Compile jobs of shaders still alive use cached render passes.
+        {
+            std::lock_guard<std::mutex> lock(_shadersLock);
+            for (auto& it : _shaders)
+            {
+                it.second->WaitPipelineCompilation();
+            }
+        }
+
         // Destroy main swap chain.
         SafeDelete(_swapChain);
 
@@ -392,10 +501,25 @@ namespace Alimer
         _descriptorSetAllocators.clear();
         _pipelineLayouts.clear();
 
+        // Textures and buffers released their slots in Graphics::Finalize.
+        _bindlessHeap.reset();
+
+        SavePipelineCache();
+        SavePipelineRecords();
         vkDestroyPipelineCache(_logicalDevice, _pipelineCache, nullptr);
 
-        // Destroy default command buffer.
-        _defaultCommandBuffer.Reset();
+        // Destroy staging buffer and pending upload batches.
+        _uploadContext.reset();
+        _waitSemaphores.clear();
+        _waitStages.clear();
+
+        // Destroy released objects, frame command buffers, pools and sync primitives.
+        for (FrameData& frame : _frames)
+        {
+            DestroyPendingResources(frame);
+            DestroyFrameData(frame);
+        }
+        _frames.clear();
 
         // Destroy default command pool.
         if (_commandPool != VK_NULL_HANDLE)
@@ -404,9 +528,6 @@ namespace Alimer
             _commandPool = VK_NULL_HANDLE;
         }
 
-        vkDestroySemaphore(_logicalDevice, _semaphores.presentComplete, nullptr);
-        vkDestroySemaphore(_logicalDevice, _semaphores.renderComplete, nullptr);
-        vkDestroyFence(_logicalDevice, _frameFence, nullptr);
 
         // Destroy memory allocator.
         vmaDestroyAllocator(_allocator);
@@ -464,6 +585,12 @@ namespace Alimer
             { VK_KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE_EXTENSION_NAME, VkExtensionType::Required, false }
         };
 
+        if (_bindlessResources)
+        {
+            queryDeviceExtensions.push_back({ VK_KHR_MAINTENANCE3_EXTENSION_NAME, VkExtensionType::Optional, false });
+            queryDeviceExtensions.push_back({ VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, VkExtensionType::Optional, false });
+        }
+
         for (uint32_t i = 0; i < extCount; i++)
         {
             for (auto& queryDeviceExtension : queryDeviceExtensions)
@@ -509,6 +636,22 @@ namespace Alimer
         if (!requiredExtensionsEnabled)
             return false;
 
+        // Bindless resources fall back to per draw descriptor sets when descriptor indexing is missing.
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT };
+        uint32_t bindlessMaxTextures = 0;
+        uint32_t bindlessMaxBuffers = 0;
+        if (_bindlessResources)
+        {
+            if (!_physicalDeviceProperties2
+                || !HasDeviceExtension(deviceExtensions, VK_KHR_MAINTENANCE3_EXTENSION_NAME)
+                || !HasDeviceExtension(deviceExtensions, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)
+                || !QueryDescriptorIndexing(_vkPhysicalDevice, descriptorIndexingFeatures, bindlessMaxTextures, bindlessMaxBuffers))
+            {
+                ALIMER_LOGWARN("Vulkan - Descriptor indexing not supported, bindless resources disabled");
+                _bindlessResources = false;
+            }
+        }
+
         // Now create logical device.
         vector<VkDeviceQueueCreateInfo> queueCreateInfos{};
 
@@ -545,6 +688,26 @@ namespace Alimer
             _queueFamilyIndices.compute = _queueFamilyIndices.graphics;
         }
 
+        // Dedicated transfer queue for staging uploads, resources are then shared with the graphics family.
+        _queueFamilyIndices.transfer = GetQueueFamilyIndex(VK_QUEUE_TRANSFER_BIT);
+        _sharedQueueFamilies[0] = _queueFamilyIndices.graphics;
+        _sharedQueueFamilyCount = 1;
+        if (_queueFamilyIndices.transfer != _queueFamilyIndices.graphics
+            && _queueFamilyIndices.transfer != _queueFamilyIndices.compute)
+        {
+            VkDeviceQueueCreateInfo queueInfo = { VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+            queueInfo.queueFamilyIndex = _queueFamilyIndices.transfer;
+            queueInfo.queueCount = 1;
+            queueInfo.pQueuePriorities = &defaultQueuePriority;
+            queueCreateInfos.push_back(queueInfo);
+
+            _sharedQueueFamilies[_sharedQueueFamilyCount++] = _queueFamilyIndices.transfer;
+        }
+        else
+        {
+            _queueFamilyIndices.transfer = _queueFamilyIndices.graphics;
+        }
+
         // Create the logical device representation
         VkPhysicalDeviceFeatures gpuFeatures = vkGpuAdapter->GetFeatures();
         VkPhysicalDeviceFeatures enabledFeatures = {};
@@ -553,11 +716,21 @@ namespace Alimer
             enabledFeatures.samplerAnisotropy = VK_TRUE;
         }
 
+        if (gpuFeatures.depthClamp)
+        {
+            enabledFeatures.depthClamp = VK_TRUE;
+            _depthClampEnabled = true;
+        }
+
         VkDeviceCreateInfo deviceCreateInfo = {};
         deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());;
         deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
         deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
+        if (_bindlessResources)
+        {
+            deviceCreateInfo.pNext = &descriptorIndexingFeatures;
+        }
 
         if (deviceExtensions.size() > 0) {
             deviceCreateInfo.enabledExtensionCount = (uint32_t)deviceExtensions.size();
@@ -569,41 +742,55 @@ namespace Alimer
 
         CreateAllocator();
 
+        // Seed pipeline cache with data saved by previous run on this device and driver.
+        std::vector<uint8_t> pipelineCacheData = LoadPipelineCacheData();
         VkPipelineCacheCreateInfo pipelineCacheCreateInfo = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
         pipelineCacheCreateInfo.pNext = nullptr;
         pipelineCacheCreateInfo.flags = 0;
+        pipelineCacheCreateInfo.initialDataSize = pipelineCacheData.size();
+        pipelineCacheCreateInfo.pInitialData = pipelineCacheData.empty() ? nullptr : pipelineCacheData.data();
         vkThrowIfFailed(vkCreatePipelineCache(_logicalDevice, &pipelineCacheCreateInfo, nullptr, &_pipelineCache));
+        LoadPipelineRecords();
 
         // Get queue's.
         vkGetDeviceQueue(_logicalDevice, _queueFamilyIndices.graphics, 0, &_graphicsQueue);
         vkGetDeviceQueue(_logicalDevice, _queueFamilyIndices.compute, 0, &_computeQueue);
+        vkGetDeviceQueue(_logicalDevice, _queueFamilyIndices.transfer, 0, &_transferQueue);
 
-        // Create default command pool.
+        // Create command pool for one time submit commands.
         _commandPool = CreateCommandPool(
             _queueFamilyIndices.graphics,
             VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT
         );
 
-        // Create default primary command buffer;
-        _defaultCommandBuffer = new VulkanCommandBuffer(this, _commandPool, false);
-
-        // Create the main swap chain.
-        _swapChain = new VulkanSwapchain(this, _window.Get());
+        // Create staging upload context.
+        _uploadContext.reset(new VulkanUploadContext(this, _transferQueue, _queueFamilyIndices.transfer, VulkanStagingBufferSize));
 
-        // Create sync primitives
-        VkSemaphoreCreateInfo semaphoreCreateInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+        // Create transient uniform pool, offsets are aligned for dynamic uniform buffers.
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(_vkPhysicalDevice, &deviceProperties);
+        _uniformBufferPool.reset(new VulkanTransientBufferPool(this,
+            BufferUsage::Uniform,
+            VulkanTransientBlockSize,
+            deviceProperties.limits.minUniformBufferOffsetAlignment));
 
-        // Create a semaphore used to synchronize image presentation
-        // Ensures that the image is displayed before we start submitting new commands to the queu
-        vkThrowIfFailed(vkCreateSemaphore(_logicalDevice, &semaphoreCreateInfo, nullptr, &_semaphores.presentComplete));
+        // Create the heap before any texture or buffer, resources get their slot at creation.
+        if (_bindlessResources)
+        {
+            _bindlessHeap.reset(new VulkanBindlessHeap(this, bindlessMaxTextures, bindlessMaxBuffers));
+            ALIMER_LOGINFO("Vulkan - Bindless resources enabled [textures: {}, storage buffers: {}]", bindlessMaxTextures, bindlessMaxBuffers);
+        }
 
-        // Create a semaphore used to synchronize command submission
-        // Ensures that the image is not presented until all commands have been sumbitted and executed
-        vkThrowIfFailed(vkCreateSemaphore(_logicalDevice, &semaphoreCreateInfo, nullptr, &_semaphores.renderComplete));
+        // Create the main swap chain.
+        _swapChain = new VulkanSwapchain(this, _window.Get());
 
-        // Create frame fence.
-        VkFenceCreateInfo fenceCreateInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, 0 };
-        vkCreateFence(_logicalDevice, &fenceCreateInfo, NULL, &_frameFence);
+        // Create frames in flight.
+        _frames.resize(_maxFramesInFlight);
+        for (FrameData& frame : _frames)
+        {
+            CreateFrameData(frame);
+        }
+        _frameIndex = 0;
 
         return true;
     }
@@ -641,14 +828,493 @@ namespace Alimer
         }
     }
 
-    void VulkanGraphics::AddWaitSemaphore(VkSemaphore semaphore)
+    std::mutex& VulkanGraphics::GetQueueLock(VkQueue queue)
+    {
+        if (queue == _graphicsQueue)
+            return _graphicsQueueLock;
+
+        if (queue == _computeQueue)
+            return _computeQueueLock;
+
+        return _transferQueueLock;
+    }
+
+    void VulkanGraphics::AddWaitSemaphore(VkSemaphore semaphore, VkPipelineStageFlags stages)
+    {
+        std::lock_guard<std::mutex> lock(_waitSemaphoresLock);
+        _waitSemaphores.push_back(semaphore);
+        _waitStages.push_back(stages);
+    }
+
+    void VulkanGraphics::AddShader(VulkanShader* shader)
+    {
+        std::lock_guard<std::mutex> lock(_shadersLock);
+        _shaders[shader->GetCodeHash()] = shader;
+    }
+
+    void VulkanGraphics::RemoveShader(VulkanShader* shader)
+    {
+        std::lock_guard<std::mutex> lock(_shadersLock);
+        auto it = _shaders.find(shader->GetCodeHash());
+        if (it != _shaders.end() && it->second == shader)
+            _shaders.erase(it);
+    }
+
+    void VulkanGraphics::RecordGraphicsPipeline(VulkanShader* shader, Hash renderPassHash, const VulkanGraphicsPipelineState& state)
+    {
+        PipelineRecord record = {};
+        record.shaderHash = shader->GetCodeHash();
+        record.renderPassHash = renderPassHash;
+        record.state = state;
+        if (record.renderPassHash == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(_pipelineRecordsLock);
+        AddPipelineRecord(record);
+    }
+
+    void VulkanGraphics::AddPipelineRecord(const PipelineRecord& record)
     {
+        Hasher h;
+        h.u64(record.shaderHash);
+        h.u64(record.renderPassHash);
+        // Fields are hashed one by one, padding bytes of the state are unspecified.
+        h.u64(record.state.renderStateHash);
+        h.u32(record.state.subpass);
+        h.u32(record.state.colorAttachmentCount);
+        h.u32(static_cast<uint32_t>(record.state.topology));
+        for (uint32_t i = 0; i < MaxVertexAttributes; ++i)
+        {
+            h.u32(record.state.attribs[i].binding);
+            h.u32(static_cast<uint32_t>(record.state.attribs[i].format));
+            h.u32(record.state.attribs[i].offset);
+        }
+        for (uint32_t i = 0; i < MaxVertexBufferBindings; ++i)
+        {
+            h.u32(record.state.strides[i]);
+            h.u32(static_cast<uint32_t>(record.state.inputRates[i]));
+        }
+
+        auto hash = h.get();
+        if (_pipelineRecordIndices.find(hash) != _pipelineRecordIndices.end())
+            return;
+
+        _pipelineRecordIndices[hash] = _pipelineRecords.size();
+        _pipelineRecords.push_back(record);
+    }
+
+    void VulkanGraphics::WarmUpPipelines()
+    {
+        std::vector<PipelineRecord> records;
+        {
+            std::lock_guard<std::mutex> lock(_pipelineRecordsLock);
+            records = _pipelineRecords;
+        }
+
+        // Only shaders and render passes already created can be resolved, call again after loading more.
+        uint32_t created = 0;
+        for (const PipelineRecord& record : records)
+        {
+            VulkanShader* shader = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(_shadersLock);
+                auto it = _shaders.find(record.shaderHash);
+                if (it != _shaders.end())
+                    shader = it->second;
+            }
+
+            VkRenderPass renderPass = VK_NULL_HANDLE;
+            {
+                std::lock_guard<std::mutex> lock(_renderPassCacheLock);
+                auto it = _renderPassCache.find(record.renderPassHash);
+                if (it != end(_renderPassCache))
+                    renderPass = it->second;
+            }
+
+            if (shader == nullptr || renderPass == VK_NULL_HANDLE)
+                continue;
+
+            Hash hash = shader->HashGraphicsPipeline(renderPass, record.state);
+            if (shader->GetGraphicsPipeline(hash) != VK_NULL_HANDLE)
+                continue;
+
+            VkPipeline pipeline = shader->CreateGraphicsPipeline(renderPass, record.state);
+            if (pipeline == VK_NULL_HANDLE)
+                continue;
+
+            shader->AddPipeline(hash, pipeline);
+            created++;
+        }
+
+        ALIMER_LOGDEBUG("Vulkan - Warmed up {} of {} recorded pipelines.", created, records.size());
+    }
+
+    std::vector<uint8_t> VulkanGraphics::LoadPipelineCacheData()
+    {
+        auto stream = OpenStream(GetExecutableFolder() + VulkanPipelineCacheFileName);
+        if (!stream)
+            return {};
+
+        std::vector<uint8_t> data = stream->ReadBytes();
+
+        // Header is defined by VK_PIPELINE_CACHE_HEADER_VERSION_ONE, data of another device or driver is discarded.
+        const size_t headerSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+        if (data.size() < headerSize)
+        {
+            ALIMER_LOGWARN("Vulkan - Ignoring truncated pipeline cache file.");
+            return {};
+        }
+
+        uint32_t headerLength;
+        uint32_t headerVersion;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        memcpy(&headerLength, data.data(), sizeof(uint32_t));
+        memcpy(&headerVersion, data.data() + 4, sizeof(uint32_t));
+        memcpy(&vendorID, data.data() + 8, sizeof(uint32_t));
+        memcpy(&deviceID, data.data() + 12, sizeof(uint32_t));
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(_vkPhysicalDevice, &properties);
+        if (headerLength < headerSize
+            || headerLength > data.size()
+            || headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            || vendorID != properties.vendorID
+            || deviceID != properties.deviceID
+            || memcmp(data.data() + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            ALIMER_LOGINFO("Vulkan - Pipeline cache file was created by another device or driver, ignoring.");
+            return {};
+        }
+
+        return data;
+    }
+
+    void VulkanGraphics::SavePipelineCache()
+    {
+        size_t size = 0;
+        VkResult result = vkGetPipelineCacheData(_logicalDevice, _pipelineCache, &size, nullptr);
+        if (result != VK_SUCCESS || size == 0)
+            return;
+
+        std::vector<uint8_t> data(size);
+        result = vkGetPipelineCacheData(_logicalDevice, _pipelineCache, &size, data.data());
+        if (result != VK_SUCCESS)
+        {
+            ALIMER_LOGWARN("Vulkan - Failed to get pipeline cache data: {}.", vkGetVulkanResultString(result));
+            return;
+        }
+
+        auto stream = OpenStream(GetExecutableFolder() + VulkanPipelineCacheFileName, StreamMode::WriteOnly);
+        if (!stream)
+        {
+            ALIMER_LOGWARN("Vulkan - Failed to save pipeline cache.");
+            return;
+        }
+
+        stream->Write(data.data(), size);
+    }
+
+    void VulkanGraphics::LoadPipelineRecords()
+    {
+        auto stream = OpenStream(GetExecutableFolder() + VulkanPipelineRecordsFileName);
+        if (!stream)
+            return;
+
+        VulkanPipelineRecordsHeader header;
+        if (stream->Read(&header, sizeof(header)) != sizeof(header)
+            || header.magic != VulkanPipelineRecordsMagic
+            || header.version != VulkanPipelineRecordsVersion
+            || header.recordSize != sizeof(PipelineRecord))
+        {
+            ALIMER_LOGWARN("Vulkan - Ignoring incompatible pipeline list file.");
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_pipelineRecordsLock);
+        for (uint32_t i = 0; i < header.count; i++)
+        {
+            PipelineRecord record;
+            if (stream->Read(&record, sizeof(record)) != sizeof(record))
+                break;
+
+            AddPipelineRecord(record);
+        }
+    }
+
+    void VulkanGraphics::SavePipelineRecords()
+    {
+        std::lock_guard<std::mutex> lock(_pipelineRecordsLock);
+        if (_pipelineRecords.empty())
+            return;
+
+        auto stream = OpenStream(GetExecutableFolder() + VulkanPipelineRecordsFileName, StreamMode::WriteOnly);
+        if (!stream)
+        {
+            ALIMER_LOGWARN("Vulkan - Failed to save pipeline list.");
+            return;
+        }
+
+        VulkanPipelineRecordsHeader header;
+        header.magic = VulkanPipelineRecordsMagic;
+        header.version = VulkanPipelineRecordsVersion;
+        header.recordSize = static_cast<uint32_t>(sizeof(PipelineRecord));
+        header.count = static_cast<uint32_t>(_pipelineRecords.size());
+        stream->Write(&header, sizeof(header));
+        stream->Write(_pipelineRecords.data(), _pipelineRecords.size() * sizeof(PipelineRecord));
+    }
+
+    void VulkanGraphics::WaitFramesInFlight()
+    {
+        // Fence of the frame being recorded is signaled, it was waited in BeginFrame.
+        std::vector<VkFence> fences;
+        for (const FrameData& frame : _frames)
+        {
+            fences.push_back(frame.fence);
+        }
+
+        if (!fences.empty())
+        {
+            vkThrowIfFailed(vkWaitForFences(_logicalDevice, static_cast<uint32_t>(fences.size()), fences.data(), VK_TRUE, std::numeric_limits<uint64_t>::max()));
+        }
+    }
+
+    void VulkanGraphics::UpdateBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const void* data)
+    {
+        std::lock_guard<std::mutex> lock(_bufferUpdatesLock);
+
+        uint64_t stagingOffset;
+        if (!_bufferUpdateBlock.Allocate(size, 16, &stagingOffset))
+        {
+            if (_bufferUpdateBlock.buffer)
+            {
+                _bufferUpdateFullBlocks.push_back(std::move(_bufferUpdateBlock));
+            }
+            _bufferUpdateBlock = _uniformBufferPool->RequestBlock(size);
+            _bufferUpdateBlock.Allocate(size, 16, &stagingOffset);
+        }
+
+        memcpy(_bufferUpdateBlock.data + stagingOffset, data, static_cast<size_t>(size));
+
+        BufferUpdate update;
+        update.srcBuffer = static_cast<VulkanBuffer*>(_bufferUpdateBlock.buffer->GetHandle())->GetVkHandle();
+        update.dstBuffer = buffer;
+        update.region.srcOffset = stagingOffset;
+        update.region.dstOffset = offset;
+        update.region.size = size;
+        _bufferUpdates.push_back(update);
+    }
+
+    bool VulkanGraphics::RecordBufferUpdates(FrameData& frame)
+    {
+        std::lock_guard<std::mutex> lock(_bufferUpdatesLock);
+        if (_bufferUpdates.empty())
+            return false;
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkThrowIfFailed(vkBeginCommandBuffer(frame.updateCommandBuffer, &beginInfo));
+
+        // Copies wait for the frames in flight, they may still read the previous contents.
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(frame.updateCommandBuffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            1, &barrier, 0, nullptr, 0, nullptr);
+
+        std::vector<VkBuffer> writtenBuffers;
+        for (const BufferUpdate& update : _bufferUpdates)
+        {
+            // Repeated writes to one buffer are applied in order.
+            if (std::find(writtenBuffers.begin(), writtenBuffers.end(), update.dstBuffer) != writtenBuffers.end())
+            {
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                vkCmdPipelineBarrier(frame.updateCommandBuffer,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                    1, &barrier, 0, nullptr, 0, nullptr);
+                writtenBuffers.clear();
+            }
+
+            vkCmdCopyBuffer(frame.updateCommandBuffer, update.srcBuffer, update.dstBuffer, 1, &update.region);
+            writtenBuffers.push_back(update.dstBuffer);
+        }
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        vkCmdPipelineBarrier(frame.updateCommandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+            1, &barrier, 0, nullptr, 0, nullptr);
+        vkThrowIfFailed(vkEndCommandBuffer(frame.updateCommandBuffer));
+
+        // Staging is read by this frame submission.
+        for (VulkanTransientBlock& block : _bufferUpdateFullBlocks)
+        {
+            _uniformBufferPool->RecycleBlock(_frameIndex, block);
+        }
+        _bufferUpdateFullBlocks.clear();
+        _uniformBufferPool->RecycleBlock(_frameIndex, _bufferUpdateBlock);
+        _bufferUpdates.clear();
+        return true;
+    }
+
+    void VulkanGraphics::DestroyBuffer(VkBuffer buffer, VmaAllocation allocation)
+    {
+        std::lock_guard<std::mutex> lock(_destroyLock);
+        _frames[_frameIndex].destroyedBuffers.push_back(std::make_pair(buffer, allocation));
+    }
+
+    void VulkanGraphics::DestroyImage(VkImage image, VmaAllocation allocation)
+    {
+        std::lock_guard<std::mutex> lock(_destroyLock);
+        _frames[_frameIndex].destroyedImages.push_back(std::make_pair(image, allocation));
+    }
+
+    void VulkanGraphics::DestroyImageView(VkImageView imageView)
+    {
+        std::lock_guard<std::mutex> lock(_destroyLock);
+        _frames[_frameIndex].destroyedImageViews.push_back(imageView);
+    }
+
+    void VulkanGraphics::DestroyFramebuffer(VkFramebuffer framebuffer)
+    {
+        std::lock_guard<std::mutex> lock(_destroyLock);
+        _frames[_frameIndex].destroyedFramebuffers.push_back(framebuffer);
+    }
+
+    void VulkanGraphics::DestroyPipeline(VkPipeline pipeline)
+    {
+        std::lock_guard<std::mutex> lock(_destroyLock);
+        _frames[_frameIndex].destroyedPipelines.push_back(pipeline);
+    }
+
+    void VulkanGraphics::DestroyShaderModule(VkShaderModule shaderModule)
+    {
+        std::lock_guard<std::mutex> lock(_destroyLock);
+        _frames[_frameIndex].destroyedShaderModules.push_back(shaderModule);
+    }
+
+    void VulkanGraphics::DestroyPendingResources(FrameData& frame)
+    {
+        std::lock_guard<std::mutex> lock(_destroyLock);
+        for (VkPipeline pipeline : frame.destroyedPipelines)
+        {
+            vkDestroyPipeline(_logicalDevice, pipeline, nullptr);
+        }
+
+        for (VkShaderModule shaderModule : frame.destroyedShaderModules)
+        {
+            vkDestroyShaderModule(_logicalDevice, shaderModule, nullptr);
+        }
+
+        for (VkFramebuffer framebuffer : frame.destroyedFramebuffers)
+        {
+            vkDestroyFramebuffer(_logicalDevice, framebuffer, nullptr);
+        }
+
+        for (VkImageView imageView : frame.destroyedImageViews)
+        {
+            vkDestroyImageView(_logicalDevice, imageView, nullptr);
+        }
+
+        for (auto& it : frame.destroyedImages)
+        {
+            vmaDestroyImage(_allocator, it.first, it.second);
+        }
+
+        for (auto& it : frame.destroyedBuffers)
+        {
+            vmaDestroyBuffer(_allocator, it.first, it.second);
+        }
+
+        frame.destroyedPipelines.clear();
+        frame.destroyedShaderModules.clear();
+        frame.destroyedFramebuffers.clear();
+        frame.destroyedImageViews.clear();
+        frame.destroyedImages.clear();
+        frame.destroyedBuffers.clear();
+    }
+
+    void VulkanGraphics::CreateFrameData(FrameData& frame)
+    {
+        // Fence is created signaled so the first wait on each frame returns immediately.
+        VkFenceCreateInfo fenceCreateInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, VK_FENCE_CREATE_SIGNALED_BIT };
+        vkThrowIfFailed(vkCreateFence(_logicalDevice, &fenceCreateInfo, nullptr, &frame.fence));
+
+        // Create a semaphore used to synchronize image presentation
+        // Ensures that the image is displayed before we start submitting new commands to the queue
+        VkSemaphoreCreateInfo semaphoreCreateInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+        vkThrowIfFailed(vkCreateSemaphore(_logicalDevice, &semaphoreCreateInfo, nullptr, &frame.imageAcquired));
+
+        // Create a semaphore used to synchronize command submission
+        // Ensures that the image is not presented until all commands have been sumbitted and executed
+        vkThrowIfFailed(vkCreateSemaphore(_logicalDevice, &semaphoreCreateInfo, nullptr, &frame.renderComplete));
+
+        // Pool is reset as a whole once the frame fence signals.
+        frame.commandPool = CreateCommandPool(_queueFamilyIndices.graphics, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+        frame.commandBuffer = new VulkanCommandBuffer(this, frame.commandPool, false);
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = frame.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        vkThrowIfFailed(vkAllocateCommandBuffers(_logicalDevice, &allocateInfo, &frame.updateCommandBuffer));
+    }
+
+    void VulkanGraphics::DestroyFrameData(FrameData& frame)
+    {
+        frame.commandBuffer.Reset();
+        for (auto& it : frame.threadCommandPools)
+        {
+            it.second->secondaryCommandBuffers.clear();
+            vkDestroyCommandPool(_logicalDevice, it.second->commandPool, nullptr);
+        }
+        frame.threadCommandPools.clear();
+
+        vkDestroyCommandPool(_logicalDevice, frame.commandPool, nullptr);
+        vkDestroySemaphore(_logicalDevice, frame.imageAcquired, nullptr);
+        vkDestroySemaphore(_logicalDevice, frame.renderComplete, nullptr);
+        vkDestroyFence(_logicalDevice, frame.fence, nullptr);
+        frame.commandPool = VK_NULL_HANDLE;
+        frame.imageAcquired = VK_NULL_HANDLE;
+        frame.renderComplete = VK_NULL_HANDLE;
+        frame.fence = VK_NULL_HANDLE;
     }
 
     bool VulkanGraphics::BeginFrame()
     {
+        // Objects released since the last submission stay queued on its frame until the next slot is recycled.
+        const uint32_t frameIndex = (_frameIndex + 1) % static_cast<uint32_t>(_frames.size());
+        FrameData& frame = _frames[frameIndex];
+
+        // Wait only until the GPU is done with the resources of this frame slot, other frames may still be executing.
+        VkResult fenceResult;
+        do {
+            fenceResult = vkWaitForFences(_logicalDevice, 1, &frame.fence, VK_TRUE, 100000000);
+        } while (fenceResult == VK_TIMEOUT);
+        vkThrowIfFailed(fenceResult);
+
+        // Frame completed, destroy objects it released and recycle its command buffers and upload batches.
+        DestroyPendingResources(frame);
+        _frameIndex = frameIndex;
+        _uploadContext->BeginFrame(_frameIndex);
+        _uniformBufferPool->BeginFrame(_frameIndex);
+        if (_bindlessHeap)
+        {
+            _bindlessHeap->BeginFrame(_frameIndex);
+        }
+        vkThrowIfFailed(vkResetCommandPool(_logicalDevice, frame.commandPool, 0));
+        for (auto& it : frame.threadCommandPools)
+        {
+            vkThrowIfFailed(vkResetCommandPool(_logicalDevice, it.second->commandPool, 0));
+            it.second->secondaryCommandBuffersUsed = 0;
+        }
+
         // Acquire the next image from the swap chain
-        VkResult result = _swapChain->AcquireNextImage(_semaphores.presentComplete, &_swapchainImageIndex);
+        VkResult result = _swapChain->AcquireNextImage(frame.imageAcquired, &_swapchainImageIndex);
         // Recreate the swapchain if it's no longer compatible with the surface (OUT_OF_DATE) or no longer optimal for presentation (SUBOPTIMAL)
         if ((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_SUBOPTIMAL_KHR))
         {
@@ -664,41 +1330,51 @@ namespace Alimer
         }
 
         // Begin command buffer.
-        _defaultCommandBuffer->Begin(nullptr);
+        frame.commandBuffer->Begin(nullptr);
 
         return true;
     }
 
     void VulkanGraphics::EndFrame()
     {
-        _defaultCommandBuffer->End();
+        FrameData& frame = _frames[_frameIndex];
+        frame.commandBuffer->End();
+
+        uint32_t commandBufferCount = 0;
+        VkCommandBuffer commandBuffers[2];
+        if (RecordBufferUpdates(frame))
+        {
+            commandBuffers[commandBufferCount++] = frame.updateCommandBuffer;
+        }
+        commandBuffers[commandBufferCount++] = frame.commandBuffer->GetVkCommandBuffer();
+
+        // Submit pending uploads, the frame waits on them.
+        _uploadContext->EndFrame(_frameIndex);
 
-        VkCommandBuffer commandBuffer = _defaultCommandBuffer->GetVkCommandBuffer();
+        std::lock_guard<std::mutex> lock(_waitSemaphoresLock);
+        _waitSemaphores.push_back(frame.imageAcquired);
+        _waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
 
         // Submit command buffers.
-        VkPipelineStageFlags submitPipelineStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
         submitInfo.pNext = nullptr;
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = &_semaphores.presentComplete;
-        submitInfo.pWaitDstStageMask = &submitPipelineStages;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(_waitSemaphores.size());
+        submitInfo.pWaitSemaphores = _waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = _waitStages.data();
+        submitInfo.commandBufferCount = commandBufferCount;
+        submitInfo.pCommandBuffers = commandBuffers;
         submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = &_semaphores.renderComplete;
+        submitInfo.pSignalSemaphores = &frame.renderComplete;
 
-        vkThrowIfFailed(vkQueueSubmit(_graphicsQueue, 1, &submitInfo, _frameFence));
-
-        // Wait for fence to signal that all command buffers are ready,
-        VkResult fenceRes;
-        do {
-            fenceRes = vkWaitForFences(_logicalDevice, 1, &_frameFence, VK_TRUE, 100000000);
-        } while (fenceRes == VK_TIMEOUT);
-        vkThrowIfFailed(fenceRes);
-        vkResetFences(_logicalDevice, 1, &_frameFence);
+        // Fence is waited when this frame slot is reused, not here.
+        vkThrowIfFailed(vkResetFences(_logicalDevice, 1, &frame.fence));
+        std::lock_guard<std::mutex> queueLock(GetQueueLock(_graphicsQueue));
+        vkThrowIfFailed(vkQueueSubmit(_graphicsQueue, 1, &submitInfo, frame.fence));
+        _waitSemaphores.clear();
+        _waitStages.clear();
 
         // Submit Swapchain.
-        VkResult result = _swapChain->QueuePresent(_graphicsQueue, _swapchainImageIndex, _semaphores.renderComplete);
+        VkResult result = _swapChain->QueuePresent(_graphicsQueue, _swapchainImageIndex, frame.renderComplete);
         if (!((result == VK_SUCCESS) || (result == VK_SUBOPTIMAL_KHR)))
         {
             if (result == VK_ERROR_OUT_OF_DATE_KHR)
@@ -711,8 +1387,6 @@ namespace Alimer
                 vkThrowIfFailed(result);
             }
         }
-
-        // DestroyPendingResources();
     }
 
     SharedPtr<CommandBuffer> VulkanGraphics::RequestCommandBuffer(CommandBufferType type)
@@ -720,13 +1394,37 @@ namespace Alimer
         switch (type)
         {
         case CommandBufferType::Default:
-            return _defaultCommandBuffer;
+            return _frames[_frameIndex].commandBuffer;
+
+        case CommandBufferType::Secondary:
+        {
+            ThreadCommandPool* pool = GetThreadCommandPool();
+            if (pool->secondaryCommandBuffersUsed == pool->secondaryCommandBuffers.size())
+            {
+                pool->secondaryCommandBuffers.push_back(MakeShared<VulkanCommandBuffer>(this, pool->commandPool, true));
+            }
+
+            return pool->secondaryCommandBuffers[pool->secondaryCommandBuffersUsed++];
+        }
 
         default:
             ALIMER_LOGCRITICAL("Invalid CommandBuffer type requested: {}", str::ToString(type));
         }
     }
 
+    VulkanGraphics::ThreadCommandPool* VulkanGraphics::GetThreadCommandPool()
+    {
+        std::lock_guard<std::mutex> lock(_threadCommandPoolsLock);
+        std::unique_ptr<ThreadCommandPool>& pool = _frames[_frameIndex].threadCommandPools[std::this_thread::get_id()];
+        if (!pool)
+        {
+            pool.reset(new ThreadCommandPool());
+            pool->commandPool = CreateCommandPool(_queueFamilyIndices.graphics, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+        }
+
+        return pool.get();
+    }
+
     void VulkanGraphics::Submit(const SharedPtr<CommandBuffer> &commandBuffer)
     {
 
@@ -774,6 +1472,20 @@ namespace Alimer
 
     uint32_t VulkanGraphics::GetQueueFamilyIndex(VkQueueFlagBits queueFlags)
     {
+        // Dedicated queue for transfer, without graphics or compute.
+        if (queueFlags & VK_QUEUE_TRANSFER_BIT)
+        {
+            for (uint32_t i = 0; i < static_cast<uint32_t>(_queueFamilyProperties.size()); i++)
+            {
+                if ((_queueFamilyProperties[i].queueFlags & queueFlags)
+                    && ((_queueFamilyProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0)
+                    && ((_queueFamilyProperties[i].queueFlags & VK_QUEUE_COMPUTE_BIT) == 0))
+                {
+                    return i;
+                }
+            }
+        }
+
         if (queueFlags & VK_QUEUE_COMPUTE_BIT)
         {
             for (uint32_t i = 0; i < static_cast<uint32_t>(_queueFamilyProperties.size()); i++)
@@ -853,7 +1565,10 @@ namespace Alimer
         vkThrowIfFailed(vkCreateFence(_logicalDevice, &fenceCreateInfo, nullptr, &fence));
 
         // Submit to the queue
-        vkThrowIfFailed(vkQueueSubmit(queue, 1, &submitInfo, fence));
+        {
+            std::lock_guard<std::mutex> lock(GetQueueLock(queue));
+            vkThrowIfFailed(vkQueueSubmit(queue, 1, &submitInfo, fence));
+        }
 
         // Wait for the fence to signal that command buffer has finished executing.
         vkThrowIfFailed(vkWaitForFences(_logicalDevice, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
@@ -885,7 +1600,7 @@ namespace Alimer
         vk::SetImageLayout(commandBuffer, image, aspect, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, destLayout);
     }
 
-    VkRenderPass VulkanGraphics::GetVkRenderPass(const RenderPassDescription& description)
+    VkRenderPass VulkanGraphics::GetVkRenderPass(const RenderPassDescription& description, Hash& hash)
     {
         Hasher renderPassHasher;
 
@@ -901,7 +1616,10 @@ namespace Alimer
             renderPassHasher.u32(static_cast<uint32_t>(colorAttachment.storeAction));
         }
 
-        uint64_t hash = renderPassHasher.get();
+        hash = renderPassHasher.get();
+
+        // Render passes are created on any thread recording, pipeline warm up reads the cache too.
+        std::lock_guard<std::mutex> lock(_renderPassCacheLock);
         auto it = _renderPassCache.find(hash);
         if (it != end(_renderPassCache))
             return it->second;
@@ -1030,7 +1748,8 @@ namespace Alimer
     {
         Hasher h;
         h.data(reinterpret_cast<const uint32_t*>(layout.sets), sizeof(layout.sets));
-        //h.data(reinterpret_cast<const uint32_t *>(layout.ranges), sizeof(layout.ranges));
+        h.u32(layout.pushConstantSize);
+        h.u32(layout.pushConstantStages);
         h.u32(layout.attributeMask);
 
         auto hash = h.get();
@@ -25,12 +25,18 @@
 #include "../Graphics.h"
 #include "../../Util/HashMap.h"
 #include "VulkanSwapchain.h"
+#include "VulkanShader.h"
+#include "VulkanTransientBufferPool.h"
+#include <mutex>
+#include <thread>
 
 namespace Alimer
 {
 	class VulkanCommandBuffer;
     class VulkanDescriptorSetAllocator;
     class VulkanPipelineLayout;
+    class VulkanUploadContext;
+    class VulkanBindlessHeap;
 
 	/// Vulkan graphics backend.
 	class VulkanGraphics final : public Graphics
@@ -62,19 +68,66 @@ namespace Alimer
         Shader* CreateShader(const void *pVertexCode, size_t vertexCodeSize,
             const void *pFragmentCode, size_t fragmentCodeSize) override;
         PipelineState* CreateRenderPipelineState(const RenderPipelineDescription& description) override;
+        void WarmUpPipelines() override;
 
 		VkInstance GetInstance() const { return _instance; }
 		VkPhysicalDevice GetPhysicalDevice() const { return _vkPhysicalDevice; }
 		VkDevice GetLogicalDevice() const { return _logicalDevice; }
         VmaAllocator GetAllocator() const { return _allocator; }
         VkPipelineCache GetPipelineCache() const { return _pipelineCache; }
+        VulkanUploadContext* GetUploadContext() const { return _uploadContext.get(); }
+        VulkanTransientBufferPool* GetUniformBufferPool() const { return _uniformBufferPool.get(); }
+        /// Get the bindless descriptor heap, nullptr when bindless resources are disabled.
+        VulkanBindlessHeap* GetBindlessHeap() const { return _bindlessHeap.get(); }
+        /// Return whether the depthClamp feature is enabled, required to disable depth clip.
+        bool IsDepthClampEnabled() const { return _depthClampEnabled; }
+
+        /// Get index of the frame being recorded.
+        uint32_t GetFrameIndex() const { return _frameIndex; }
+
+        /// Set sharing mode of buffer or image create info, resources are shared by the graphics and transfer queues.
+        template <typename T> void SetSharingMode(T& createInfo) const
+        {
+            if (_sharedQueueFamilyCount > 1)
+            {
+                createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+                createInfo.queueFamilyIndexCount = _sharedQueueFamilyCount;
+                createInfo.pQueueFamilyIndices = _sharedQueueFamilies;
+            }
+            else
+            {
+                createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                createInfo.queueFamilyIndexCount = 0;
+                createInfo.pQueueFamilyIndices = nullptr;
+            }
+        }
+
+        /// Wait until the GPU completed every submitted frame.
+        void WaitFramesInFlight();
+
+        /// Write buffer range without stalling, the copy executes at the start of the next frame submission after the frames in flight stopped reading it.
+        void UpdateBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const void* data);
+
+        /// Destroy buffer once the frames that may use it retired.
+        void DestroyBuffer(VkBuffer buffer, VmaAllocation allocation);
+        /// Destroy image once the frames that may use it retired.
+        void DestroyImage(VkImage image, VmaAllocation allocation);
+        /// Destroy image view once the frames that may use it retired.
+        void DestroyImageView(VkImageView imageView);
+        /// Destroy framebuffer once the frames that may use it retired.
+        void DestroyFramebuffer(VkFramebuffer framebuffer);
+        /// Destroy pipeline once the frames that may use it retired.
+        void DestroyPipeline(VkPipeline pipeline);
+        /// Destroy shader module once the frames that may use it retired.
+        void DestroyShaderModule(VkShaderModule shaderModule);
 
 		VkCommandBuffer CreateCommandBuffer(VkCommandBufferLevel level, bool begin = false);
 		void FlushCommandBuffer(VkCommandBuffer commandBuffer, bool free = true);
 		void FlushCommandBuffer(VkCommandBuffer commandBuffer, VkQueue queue, bool free = true);
 		void ClearImageWithColor(VkCommandBuffer commandBuffer, VkImage image, VkImageSubresourceRange range, VkImageAspectFlags aspect, VkImageLayout sourceLayout, VkImageLayout destLayout, VkAccessFlagBits srcAccessMask, VkClearColorValue *clearValue);
 
-		VkRenderPass GetVkRenderPass(const RenderPassDescription& description);
+		/// Get render pass compatible with description, creating it on a miss, and the key it is cached and recorded by.
+		VkRenderPass GetVkRenderPass(const RenderPassDescription& description, Hash& hash);
 
         VulkanDescriptorSetAllocator* RequestDescriptorSetAllocator(const DescriptorSetLayout &layout);
         VulkanPipelineLayout* RequestPipelineLayout(const ResourceLayout &layout);
@@ -82,15 +135,79 @@ namespace Alimer
         uint32_t GetQueueFamilyIndex(VkQueueFlagBits queueFlags);
         VkCommandPool CreateCommandPool(uint32_t queueFamilyIndex, VkCommandPoolCreateFlags createFlags);
 
-        void AddWaitSemaphore(VkSemaphore semaphore);
+        /// Get lock guarding submission and presentation on given queue, queues sharing a handle share the lock.
+        std::mutex& GetQueueLock(VkQueue queue);
+
+        /// Add semaphore waited by the next frame submission.
+        void AddWaitSemaphore(VkSemaphore semaphore, VkPipelineStageFlags stages);
+
+        /// Add shader to the registry used to resolve recorded pipelines.
+        void AddShader(VulkanShader* shader);
+        /// Remove shader from the registry.
+        void RemoveShader(VulkanShader* shader);
+        /// Record pipeline created at runtime, saved on shutdown and created by WarmUpPipelines on the next run.
+        void RecordGraphicsPipeline(VulkanShader* shader, Hash renderPassHash, const VulkanGraphicsPipelineState& state);
 
 	private:
         void Finalize() override;
         bool BackendInitialize() override;
         void CreateAllocator();
 
+        /// Command pool of one recording thread, reset every frame.
+        struct ThreadCommandPool
+        {
+            VkCommandPool commandPool = VK_NULL_HANDLE;
+            std::vector<SharedPtr<VulkanCommandBuffer>> secondaryCommandBuffers;
+            uint32_t secondaryCommandBuffersUsed = 0;
+        };
+
+        /// Resources of one frame in flight, reused once its fence signals.
+        struct FrameData
+        {
+            VkFence fence = VK_NULL_HANDLE;
+            // Swap chain image acquired, waited by submission.
+            VkSemaphore imageAcquired = VK_NULL_HANDLE;
+            // Command buffer execution complete, waited by presentation.
+            VkSemaphore renderComplete = VK_NULL_HANDLE;
+            VkCommandPool commandPool = VK_NULL_HANDLE;
+            SharedPtr<VulkanCommandBuffer> commandBuffer;
+            // Buffer updates submitted ahead of the frame command buffer.
+            VkCommandBuffer updateCommandBuffer = VK_NULL_HANDLE;
+            // Per thread pools of secondary command buffers, Vulkan command pools are externally synchronized.
+            std::unordered_map<std::thread::id, std::unique_ptr<ThreadCommandPool>> threadCommandPools;
+            // Objects released while this frame was the last one submitted or recorded, destroyed once its fence signals.
+            std::vector<std::pair<VkBuffer, VmaAllocation>> destroyedBuffers;
+            std::vector<std::pair<VkImage, VmaAllocation>> destroyedImages;
+            std::vector<VkImageView> destroyedImageViews;
+            std::vector<VkFramebuffer> destroyedFramebuffers;
+            std::vector<VkPipeline> destroyedPipelines;
+            std::vector<VkShaderModule> destroyedShaderModules;
+        };
+
+        /// Graphics pipeline created by a run, keyed by values stable between runs.
+        struct PipelineRecord
+        {
+            Hash shaderHash;
+            Hash renderPassHash;
+            VulkanGraphicsPipelineState state;
+        };
+
+        std::vector<uint8_t> LoadPipelineCacheData();
+        void SavePipelineCache();
+        void LoadPipelineRecords();
+        void SavePipelineRecords();
+        void AddPipelineRecord(const PipelineRecord& record);
+
+        ThreadCommandPool* GetThreadCommandPool();
+        bool RecordBufferUpdates(FrameData& frame);
+        void CreateFrameData(FrameData& frame);
+        void DestroyFrameData(FrameData& frame);
+        void DestroyPendingResources(FrameData& frame);
+
 		VkInstance _instance = VK_NULL_HANDLE;
 		VkDebugReportCallbackEXT _debugCallback = VK_NULL_HANDLE;
+		bool _physicalDeviceProperties2 = false;
+		bool _depthClampEnabled = false;
 
 		// PhysicalDevice
 		VkPhysicalDevice _vkPhysicalDevice = VK_NULL_HANDLE;
@@ -101,7 +218,10 @@ namespace Alimer
 		struct {
 			uint32_t graphics;
 			uint32_t compute;
+			uint32_t transfer;
 		} _queueFamilyIndices;
+		uint32_t _sharedQueueFamilies[2];
+		uint32_t _sharedQueueFamilyCount = 1;
 
 		VkDevice _logicalDevice = VK_NULL_HANDLE;
         VmaAllocator _allocator = VK_NULL_HANDLE;
@@ -109,6 +229,11 @@ namespace Alimer
 		// Queue's.
 		VkQueue _graphicsQueue = VK_NULL_HANDLE;
 		VkQueue _computeQueue = VK_NULL_HANDLE;
+		VkQueue _transferQueue = VK_NULL_HANDLE;
+        // Vulkan queues are externally synchronized, the transfer queue may alias the graphics queue.
+        std::mutex _graphicsQueueLock;
+        std::mutex _computeQueueLock;
+        std::mutex _transferQueueLock;
 
         VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
 
@@ -118,24 +243,51 @@ namespace Alimer
         // Main swap chain
 		VulkanSwapchain* _swapChain = nullptr;
 
-        // Primary/Default command buffer
-        SharedPtr<VulkanCommandBuffer> _defaultCommandBuffer;
+        // Frames in flight, the CPU records one while the GPU executes the others.
+        std::vector<FrameData> _frames;
+        uint32_t _frameIndex = 0;
+        std::mutex _threadCommandPoolsLock;
+        std::mutex _destroyLock;
+
+        // Staging uploads and semaphores waited by the next frame submission.
+        std::unique_ptr<VulkanUploadContext> _uploadContext;
+        std::vector<VkSemaphore> _waitSemaphores;
+        std::vector<VkPipelineStageFlags> _waitStages;
+        std::mutex _waitSemaphoresLock;
+
+        // Per frame transient uniform data.
+        std::unique_ptr<VulkanTransientBufferPool> _uniformBufferPool;
+
+        // Buffer updates staged in transient blocks, copied by the next frame submission.
+        struct BufferUpdate
+        {
+            VkBuffer srcBuffer;
+            VkBuffer dstBuffer;
+            VkBufferCopy region;
+        };
+
+        VulkanTransientBlock _bufferUpdateBlock;
+        std::vector<VulkanTransientBlock> _bufferUpdateFullBlocks;
+        std::vector<BufferUpdate> _bufferUpdates;
+        std::mutex _bufferUpdatesLock;
+
+        // Global descriptor heap of bindless resources.
+        std::unique_ptr<VulkanBindlessHeap> _bindlessHeap;
 
-        // Synchronization semaphores
-        struct {
-            // Swap chain image presentation
-            VkSemaphore presentComplete;
-            // Command buffer submission and execution
-            VkSemaphore renderComplete;
-        } _semaphores;
-
-        VkFence _frameFence = VK_NULL_HANDLE;
         uint32_t _swapchainImageIndex = 0;
 
 		// Cache
-		std::unordered_map<uint64_t, VkRenderPass> _renderPassCache;
+		HashMap<VkRenderPass> _renderPassCache;
+        std::mutex _renderPassCacheLock;
 
         HashMap<std::unique_ptr<VulkanDescriptorSetAllocator>> _descriptorSetAllocators;
         HashMap<std::unique_ptr<VulkanPipelineLayout>> _pipelineLayouts;
+
+        // Shaders by code hash and pipelines recorded for warm up.
+        HashMap<VulkanShader*> _shaders;
+        std::mutex _shadersLock;
+        std::vector<PipelineRecord> _pipelineRecords;
+        HashMap<size_t> _pipelineRecordIndices;
+        std::mutex _pipelineRecordsLock;
 	};
 }
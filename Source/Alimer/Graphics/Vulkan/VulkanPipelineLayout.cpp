@@ -22,8 +22,10 @@
 
 #include "VulkanPipelineLayout.h"
 #include "VulkanGraphics.h"
+#include "VulkanBindlessHeap.h"
 #include "VulkanConvert.h"
 #include "../../Core/Log.h"
+#include <algorithm>
 
 namespace Alimer
 {
@@ -41,6 +43,13 @@ namespace Alimer
                 types++;
             }
 
+            if (layout.sampledImageMask & (1u << i))
+            {
+                bindings.push_back({ i, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, layout.stages, nullptr });
+                _poolSize.push_back({ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VulkanSetsCountPerPool });
+                types++;
+            }
+
             (void)types;
             ALIMER_ASSERT(types <= 1 && "Descriptor set aliasing!");
         }
@@ -137,16 +146,39 @@ namespace Alimer
     {
         VkDescriptorSetLayout layouts[MaxDescriptorSets] = {};
         uint32_t numSets = 0;
+
+        // Every layout shares the bindless set, so it stays bound across pipeline changes.
+        VulkanBindlessHeap* bindlessHeap = graphics->GetBindlessHeap();
+        if (bindlessHeap != nullptr)
+        {
+            layouts[VulkanBindlessSet] = bindlessHeap->GetSetLayout();
+            _layout.descriptorSetMask |= 1u << VulkanBindlessSet;
+            _hasBindlessSet = true;
+            numSets = VulkanBindlessSet + 1;
+        }
+
         for (uint32_t i = 0; i < MaxDescriptorSets; i++)
         {
             if (!layout.sets[i].stages)
                 continue;
 
+            if (bindlessHeap != nullptr && i == VulkanBindlessSet)
+                continue;
+
             _setAllocators[i] = graphics->RequestDescriptorSetAllocator(layout.sets[i]);
             layouts[i] = _setAllocators[i]->GetVkHandle();
             if (layout.descriptorSetMask & (1u << i))
             {
-                numSets = i + 1;
+                numSets = std::max(numSets, i + 1);
+            }
+        }
+
+        // Set layouts below the last one can't be null, fill unused sets with an empty layout.
+        for (uint32_t i = 0; i < numSets; i++)
+        {
+            if (layouts[i] == VK_NULL_HANDLE)
+            {
+                layouts[i] = graphics->RequestDescriptorSetAllocator(DescriptorSetLayout())->GetVkHandle();
             }
         }
 
@@ -159,6 +191,16 @@ namespace Alimer
             createInfo.pSetLayouts = layouts;
         }
 
+        VkPushConstantRange pushConstantRange;
+        if (layout.pushConstantSize)
+        {
+            pushConstantRange.stageFlags = static_cast<VkShaderStageFlags>(layout.pushConstantStages);
+            pushConstantRange.offset = 0;
+            pushConstantRange.size = layout.pushConstantSize;
+            createInfo.pushConstantRangeCount = 1;
+            createInfo.pPushConstantRanges = &pushConstantRange;
+        }
+
         if (vkCreatePipelineLayout(_logicalDevice, &createInfo, nullptr, &_vkHandle) != VK_SUCCESS)
         {
             ALIMER_LOGCRITICAL("Failed to create pipeline layout.\n");
@@ -27,6 +27,7 @@
 #include "../../Util/HashMap.h"
 #include "../../Util/ObjectPool.h"
 #include "../../Util/TemporaryHashmap.h"
+#include <mutex>
 #include <vector>
 
 namespace Alimer
@@ -48,6 +49,9 @@ namespace Alimer
 
         VkDescriptorSetLayout GetVkHandle() const { return _vkHandle; }
 
+        /// Lock to hold while finding and updating sets, command buffers record from multiple threads.
+        std::mutex& GetLock() { return _lock; }
+
     private:
         struct DescriptorSetNode : TemporaryHashmapEnabled<DescriptorSetNode>, IntrusiveListEnabled<DescriptorSetNode>
         {
@@ -64,6 +68,7 @@ namespace Alimer
         std::vector<VkDescriptorPoolSize> _poolSize;
         std::vector<VkDescriptorPool> _pools;
         TemporaryHashmap<DescriptorSetNode, VulkanDescriptorRingSize, true> _setNodes;
+        std::mutex _lock;
     };
 
     class VulkanPipelineLayout final
@@ -73,6 +78,8 @@ namespace Alimer
         ~VulkanPipelineLayout();
 
         const ResourceLayout& GetResourceLayout() const { return _layout; }
+        /// Return whether the bindless heap set is part of this layout.
+        bool HasBindlessSet() const { return _hasBindlessSet; }
         VkPipelineLayout GetVkHandle() const { return _vkHandle; }
         VulkanDescriptorSetAllocator* GetAllocator(uint32_t set) const
         {
@@ -84,5 +91,6 @@ namespace Alimer
         VkPipelineLayout _vkHandle = VK_NULL_HANDLE;
         ResourceLayout _layout;
         VulkanDescriptorSetAllocator* _setAllocators[MaxDescriptorSets] = {};
+        bool _hasBindlessSet = false;
     };
 }
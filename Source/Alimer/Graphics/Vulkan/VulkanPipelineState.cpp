@@ -30,11 +30,10 @@
 namespace Alimer
 {
     VulkanPipelineState::VulkanPipelineState(VulkanGraphics* graphics, const RenderPipelineDescription& description)
-        : PipelineState(graphics, true)
+        : PipelineState(graphics, description)
         , _logicalDevice(graphics->GetLogicalDevice())
         , _pipelineCache(graphics->GetPipelineCache())
     {
-        _shader = StaticCast<VulkanShader>(description.shader);
     }
 
     VulkanPipelineState::~VulkanPipelineState()
@@ -23,12 +23,11 @@
 #pragma once
 
 #include "../PipelineState.h"
-#include "VulkanPrerequisites.h"
+#include "VulkanShader.h"
 
 namespace Alimer
 {
 	class VulkanGraphics;
-    class VulkanShader;
 
 	/// Vulkan PipelineState implementation.
 	class VulkanPipelineState final : public PipelineState
@@ -37,13 +36,10 @@ namespace Alimer
         VulkanPipelineState(VulkanGraphics* graphics, const RenderPipelineDescription& description);
 		~VulkanPipelineState() override;
 
-        VulkanShader* GetShader() const { return _shader.Get(); }
-        
+        VulkanShader* GetShader() const { return static_cast<VulkanShader*>(_shader.Get()); }
 
 	private:
 		VkDevice _logicalDevice;
         VkPipelineCache _pipelineCache;
-        SharedPtr<VulkanShader> _shader;
-        
 	};
 }
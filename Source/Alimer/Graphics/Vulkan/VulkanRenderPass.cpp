@@ -31,8 +31,9 @@ namespace Alimer
 {
     VulkanRenderPass::VulkanRenderPass(VulkanGraphics* graphics, const RenderPassDescription& description)
         : RenderPass(graphics, description)
+        , _graphics(graphics)
         , _logicalDevice(graphics->GetLogicalDevice())
-        , _renderPass(graphics->GetVkRenderPass(description))
+        , _renderPass(graphics->GetVkRenderPass(description, _renderPassHash))
     {
         VkImageView views[MaxColorAttachments + 1];
         uint32_t numViews = 0;
@@ -76,7 +77,7 @@ namespace Alimer
     {
         if(_framebuffer != VK_NULL_HANDLE)
         {
-            vkDestroyFramebuffer(_logicalDevice, _framebuffer, nullptr);
+            _graphics->DestroyFramebuffer(_framebuffer);
             _framebuffer = VK_NULL_HANDLE;
         }
     }
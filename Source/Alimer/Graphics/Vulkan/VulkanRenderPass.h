@@ -24,6 +24,7 @@
 
 #include "../RenderPass.h"
 #include "VulkanPrerequisites.h"
+#include "../../Util/HashMap.h"
 
 namespace Alimer
 {
@@ -38,10 +39,15 @@ namespace Alimer
         void Destroy() override;
 
         VkRenderPass GetVkRenderPass() const { return _renderPass; }
+        /// Get hash of the render pass description, stable between runs.
+        Hash GetRenderPassHash() const { return _renderPassHash; }
         VkFramebuffer GetVkFramebuffer() const { return _framebuffer; }
 
     private:
+        VulkanGraphics* _graphics;
         VkDevice _logicalDevice;
+        /// Declared before the render pass, it is filled when the render pass is requested.
+        Hash _renderPassHash = 0;
         VkRenderPass _renderPass;
         VkFramebuffer _framebuffer;
     };
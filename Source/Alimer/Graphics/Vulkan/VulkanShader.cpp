@@ -24,6 +24,8 @@
 #include "VulkanGraphics.h"
 #include "VulkanPipelineLayout.h"
 #include "VulkanConvert.h"
+#include "../../Core/Log.h"
+#include "../../Util/Util.h"
 
 namespace Alimer
 {
@@ -46,10 +48,16 @@ namespace Alimer
 
     VulkanShader::VulkanShader(VulkanGraphics* graphics, const void *pCode, size_t codeSize)
         : Shader(graphics, pCode, codeSize)
+        , _graphics(graphics)
         , _logicalDevice(graphics->GetLogicalDevice())
     {
         _shaderModules[static_cast<unsigned>(ShaderStage::Compute)] = CreateShaderModule(_logicalDevice, pCode, codeSize);
         _pipelineLayout = graphics->RequestPipelineLayout(_layout);
+
+        Hasher h;
+        h.data(static_cast<const uint8_t*>(pCode), codeSize);
+        _codeHash = h.get();
+        _graphics->AddShader(this);
     }
 
     /// Constructor.
@@ -57,21 +65,40 @@ namespace Alimer
         const void *pVertexCode, size_t vertexCodeSize,
         const void *pFragmentCode, size_t fragmentCodeSize)
         : Shader(graphics, pVertexCode, vertexCodeSize, pFragmentCode, fragmentCodeSize)
+        , _graphics(graphics)
         , _logicalDevice(graphics->GetLogicalDevice())
     {
         _shaderModules[static_cast<unsigned>(VulkanShaderStage::Vertex)] = CreateShaderModule(_logicalDevice, pVertexCode, vertexCodeSize);
         _shaderModules[static_cast<unsigned>(VulkanShaderStage::Fragment)] = CreateShaderModule(_logicalDevice, pFragmentCode, fragmentCodeSize);
 
         _pipelineLayout = graphics->RequestPipelineLayout(_layout);
+
+        Hasher h;
+        h.data(static_cast<const uint8_t*>(pVertexCode), vertexCodeSize);
+        h.u32(0xff);
+        h.data(static_cast<const uint8_t*>(pFragmentCode), fragmentCodeSize);
+        _codeHash = h.get();
+        _graphics->AddShader(this);
     }
 
     VulkanShader::~VulkanShader()
     {
+        _graphics->RemoveShader(this);
+
+        // Compile jobs reference this shader.
+        WaitPipelineCompilation();
+
+        for (auto& it : _graphicsPipelineCache)
+        {
+            _graphics->DestroyPipeline(it.second);
+        }
+        _graphicsPipelineCache.clear();
+
         for (uint32_t i = 0; i < static_cast<unsigned>(VulkanShaderStage::Count); i++)
         {
             if (_shaderModules[i] != VK_NULL_HANDLE)
             {
-                vkDestroyShaderModule(_logicalDevice, _shaderModules[i], nullptr);
+                _graphics->DestroyShaderModule(_shaderModules[i]);
                 _shaderModules[i] = VK_NULL_HANDLE;
             }
         }
@@ -82,8 +109,251 @@ namespace Alimer
         return _shaderModules[static_cast<unsigned>(stage)];
     }
 
+    Hash VulkanShader::HashGraphicsPipeline(VkRenderPass renderPass, const VulkanGraphicsPipelineState& state) const
+    {
+        Hasher h;
+        uint32_t activeVbos = 0;
+        ForEachBit(_pipelineLayout->GetResourceLayout().attributeMask, [&](uint32_t bit)
+        {
+            h.u32(bit);
+            activeVbos |= 1u << state.attribs[bit].binding;
+            h.u32(state.attribs[bit].binding);
+            h.u32(state.attribs[bit].format);
+            h.u32(state.attribs[bit].offset);
+        });
+
+        ForEachBit(activeVbos, [&](uint32_t bit)
+        {
+            h.u32(static_cast<uint32_t>(state.inputRates[bit]));
+            h.u32(state.strides[bit]);
+        });
+
+        h.pointer(renderPass);
+        h.u32(state.subpass);
+        h.pointer(this);
+        h.u32(static_cast<uint32_t>(state.topology));
+        h.u64(state.renderStateHash);
+        return h.get();
+    }
+
+    VkPipeline VulkanShader::CreateGraphicsPipeline(VkRenderPass renderPass, const VulkanGraphicsPipelineState& state) const
+    {
+        VkPipelineVertexInputStateCreateInfo vertexInputState = { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+        VkVertexInputAttributeDescription vkAttribs[MaxVertexAttributes];
+        vertexInputState.pVertexAttributeDescriptions = vkAttribs;
+
+        uint32_t attributeMask = _pipelineLayout->GetResourceLayout().attributeMask;
+        uint32_t bindingMask = 0;
+        ForEachBit(attributeMask, [&](uint32_t bit) {
+            auto &attr = vkAttribs[vertexInputState.vertexAttributeDescriptionCount++];
+            attr.location = bit;
+            attr.binding = state.attribs[bit].binding;
+            attr.format = state.attribs[bit].format;
+            attr.offset = state.attribs[bit].offset;
+            bindingMask |= 1u << attr.binding;
+        });
+
+        VkVertexInputBindingDescription vkVboBindings[MaxVertexBufferBindings];
+        vertexInputState.pVertexBindingDescriptions = vkVboBindings;
+        ForEachBit(bindingMask, [&](uint32_t bit) {
+            auto &bind = vkVboBindings[vertexInputState.vertexBindingDescriptionCount++];
+            bind.binding = bit;
+            bind.inputRate = vk::Convert(state.inputRates[bit]);
+            bind.stride = state.strides[bit];
+        });
+
+        // Viewport state
+        VkPipelineViewportStateCreateInfo viewportState = { VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        // Rasterization state
+        const RasterizerState& rasterizer = state.rasterizerState;
+        VkPipelineRasterizationStateCreateInfo rasterizationState = { VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+        rasterizationState.depthClampEnable = (!rasterizer.depthClipEnable && _graphics->IsDepthClampEnabled()) ? VK_TRUE : VK_FALSE;
+        rasterizationState.cullMode = vk::Convert(rasterizer.cullMode);
+        rasterizationState.frontFace = vk::Convert(rasterizer.frontFace);
+        rasterizationState.lineWidth = 1.0f;
+        rasterizationState.polygonMode = vk::Convert(rasterizer.fillMode);
+        rasterizationState.depthBiasEnable = rasterizer.depthBias != 0 || rasterizer.slopeScaledDepthBias != 0.0f;
+        rasterizationState.depthBiasConstantFactor = static_cast<float>(rasterizer.depthBias);
+        rasterizationState.depthBiasClamp = rasterizer.depthBiasClamp;
+        rasterizationState.depthBiasSlopeFactor = rasterizer.slopeScaledDepthBias;
+
+        // Multisample
+        VkPipelineMultisampleStateCreateInfo multpleSampleState = { VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+        multpleSampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        multpleSampleState.alphaToCoverageEnable = state.blendState.alphaToCoverageEnable ? VK_TRUE : VK_FALSE;
+
+        // Depth state
+        const DepthStencilState& depthStencil = state.depthStencilState;
+        VkPipelineDepthStencilStateCreateInfo depthStencilState = { VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+        depthStencilState.depthTestEnable = depthStencil.depthTestEnable ? VK_TRUE : VK_FALSE;
+        depthStencilState.depthWriteEnable = depthStencil.depthWriteEnable ? VK_TRUE : VK_FALSE;
+        depthStencilState.depthCompareOp = vk::Convert(depthStencil.depthCompareFunction);
+        depthStencilState.stencilTestEnable = depthStencil.stencilEnable ? VK_TRUE : VK_FALSE;
+        depthStencilState.front = vk::Convert(depthStencil.frontFace, depthStencil.stencilReadMask, depthStencil.stencilWriteMask);
+        depthStencilState.back = vk::Convert(depthStencil.backFace, depthStencil.stencilReadMask, depthStencil.stencilWriteMask);
+
+        // Blend state
+        VkPipelineColorBlendAttachmentState blendAttachments[MaxColorAttachments] = {};
+        for (uint32_t i = 0; i < state.colorAttachmentCount; i++)
+        {
+            const RenderTargetBlendState& renderTarget = state.blendState.renderTargets[state.blendState.independentBlendEnable ? i : 0];
+            VkPipelineColorBlendAttachmentState& attachment = blendAttachments[i];
+            attachment.blendEnable = renderTarget.blendEnable ? VK_TRUE : VK_FALSE;
+            attachment.srcColorBlendFactor = vk::Convert(renderTarget.sourceColorBlendFactor);
+            attachment.dstColorBlendFactor = vk::Convert(renderTarget.destinationColorBlendFactor);
+            attachment.colorBlendOp = vk::Convert(renderTarget.colorBlendOperation);
+            attachment.srcAlphaBlendFactor = vk::Convert(renderTarget.sourceAlphaBlendFactor);
+            attachment.dstAlphaBlendFactor = vk::Convert(renderTarget.destinationAlphaBlendFactor);
+            attachment.alphaBlendOp = vk::Convert(renderTarget.alphaBlendOperation);
+            // ColorWriteMask bits match VkColorComponentFlagBits.
+            attachment.colorWriteMask = static_cast<VkColorComponentFlags>(renderTarget.colorWriteMask);
+        }
+
+        VkPipelineColorBlendStateCreateInfo blendState = { VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+        blendState.attachmentCount = state.colorAttachmentCount;
+        blendState.pAttachments = blendAttachments;
+
+        // Dynamic state
+        VkPipelineDynamicStateCreateInfo dynamicState = { VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+        dynamicState.dynamicStateCount = 2;
+        VkDynamicState states[2] = {
+            VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_VIEWPORT,
+        };
+        dynamicState.pDynamicStates = states;
+
+        // Input assembly
+        VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = { VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+        inputAssemblyState.pNext = nullptr;
+        inputAssemblyState.flags = 0;
+        inputAssemblyState.topology = vk::Convert(state.topology);
+        inputAssemblyState.primitiveRestartEnable = VK_FALSE;
+
+        // Stages
+        VkPipelineShaderStageCreateInfo stages[static_cast<uint32_t>(VulkanShaderStage::Count)];
+        uint32_t numStages = 0;
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(VulkanShaderStage::Count); i++)
+        {
+            auto vkModule = _shaderModules[i];
+            if (vkModule != VK_NULL_HANDLE)
+            {
+                auto &stage = stages[numStages++];
+                stage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+                stage.module = vkModule;
+                stage.pName = "main";
+                stage.stage = static_cast<VkShaderStageFlagBits>(1u << i);
+            }
+        }
+
+        VkGraphicsPipelineCreateInfo createInfo = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.stageCount = numStages;
+        createInfo.pStages = stages;
+        createInfo.pVertexInputState = &vertexInputState;
+        createInfo.pTessellationState = nullptr;
+        createInfo.pViewportState = &viewportState;
+        createInfo.pRasterizationState = &rasterizationState;
+        createInfo.pMultisampleState = &multpleSampleState;
+        createInfo.pDepthStencilState = &depthStencilState;
+        createInfo.pColorBlendState = &blendState;
+        createInfo.pDynamicState = &dynamicState;
+        createInfo.pInputAssemblyState = &inputAssemblyState;
+        createInfo.layout = _pipelineLayout->GetVkHandle();
+        createInfo.renderPass = renderPass;
+        createInfo.subpass = state.subpass;
+        createInfo.basePipelineHandle = VK_NULL_HANDLE;
+        createInfo.basePipelineIndex = 0;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        if (vkCreateGraphicsPipelines(
+            _logicalDevice,
+            _graphics->GetPipelineCache(),
+            1,
+            &createInfo,
+            nullptr,
+            &pipeline) != VK_SUCCESS)
+        {
+            ALIMER_LOGERROR("Vulkan - Failed to create graphics pipeline");
+            return VK_NULL_HANDLE;
+        }
+
+        return pipeline;
+    }
+
+    VkPipeline VulkanShader::RequestGraphicsPipeline(Hash hash, VkRenderPass renderPass, Hash renderPassHash, const VulkanGraphicsPipelineState& state, bool async)
+    {
+        JobSystem* jobs = JobSystem::GetInstance();
+        {
+            std::lock_guard<std::mutex> lock(_graphicsPipelineCacheLock);
+            auto it = _graphicsPipelineCache.find(hash);
+            if (it != _graphicsPipelineCache.end())
+                return it->second;
+
+            // Failed state is not retried, creation logged the error once.
+            if (_compilingPipelines.count(hash) || _failedPipelines.count(hash))
+                return VK_NULL_HANDLE;
+
+            // Mark as compiling so other threads recording the same state don't schedule it again.
+            if (async && jobs != nullptr)
+                _compilingPipelines[hash] = true;
+        }
+
+        _graphics->RecordGraphicsPipeline(this, renderPassHash, state);
+
+        if (async && jobs != nullptr)
+        {
+            // State is too large for inline job storage, the job owns the request.
+            GraphicsPipelineRequest* request = new GraphicsPipelineRequest();
+            request->hash = hash;
+            request->renderPass = renderPass;
+            request->state = state;
+
+            jobs->Schedule([this, request]()
+            {
+                VkPipeline pipeline = CreateGraphicsPipeline(request->renderPass, request->state);
+                {
+                    std::lock_guard<std::mutex> lock(_graphicsPipelineCacheLock);
+                    _compilingPipelines.erase(request->hash);
+                    if (pipeline == VK_NULL_HANDLE)
+                        _failedPipelines[request->hash] = true;
+                }
+
+                if (pipeline != VK_NULL_HANDLE)
+                    AddPipeline(request->hash, pipeline);
+
+                delete request;
+            }, &_compileCounter);
+
+            return VK_NULL_HANDLE;
+        }
+
+        VkPipeline pipeline = CreateGraphicsPipeline(renderPass, state);
+        if (pipeline == VK_NULL_HANDLE)
+        {
+            std::lock_guard<std::mutex> lock(_graphicsPipelineCacheLock);
+            _failedPipelines[hash] = true;
+            return VK_NULL_HANDLE;
+        }
+
+        return AddPipeline(hash, pipeline);
+    }
+
+    void VulkanShader::WaitPipelineCompilation()
+    {
+        if (!_compileCounter.IsDone()
+            && JobSystem::GetInstance() != nullptr)
+        {
+            JobSystem::GetInstance()->Wait(_compileCounter);
+        }
+    }
+
     VkPipeline VulkanShader::GetGraphicsPipeline(Hash hash)
     {
+        std::lock_guard<std::mutex> lock(_graphicsPipelineCacheLock);
         auto it = _graphicsPipelineCache.find(hash);
         if (it != _graphicsPipelineCache.end())
             return it->second;
@@ -91,8 +361,17 @@ namespace Alimer
         return VK_NULL_HANDLE;
     }
 
-    void VulkanShader::AddPipeline(Hash hash, VkPipeline pipeline)
+    VkPipeline VulkanShader::AddPipeline(Hash hash, VkPipeline pipeline)
     {
+        std::lock_guard<std::mutex> lock(_graphicsPipelineCacheLock);
+        auto it = _graphicsPipelineCache.find(hash);
+        if (it != _graphicsPipelineCache.end())
+        {
+            vkDestroyPipeline(_logicalDevice, pipeline, nullptr);
+            return it->second;
+        }
+
         _graphicsPipelineCache[hash] = pipeline;
+        return pipeline;
     }
 }
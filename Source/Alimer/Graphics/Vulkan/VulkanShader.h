@@ -23,8 +23,11 @@
 #pragma once
 
 #include "../Shader.h"
+#include "../PipelineState.h"
 #include "VulkanPrerequisites.h"
 #include "../../Util/HashMap.h"
+#include "../../Core/JobSystem.h"
+#include <mutex>
 #include <vector>
 
 namespace Alimer
@@ -43,6 +46,29 @@ namespace Alimer
         Count
     };
 
+    struct VertexAttribState
+    {
+        uint32_t binding;
+        VkFormat format;
+        uint32_t offset;
+    };
+
+    /// Fixed function and vertex input state a graphics pipeline is created from, plain data so it can be written to disk.
+    struct VulkanGraphicsPipelineState
+    {
+        /// Hash of the render state blocks, computed when the PipelineState was created.
+        Hash renderStateHash;
+        uint32_t subpass;
+        uint32_t colorAttachmentCount;
+        PrimitiveTopology topology;
+        VertexAttribState attribs[MaxVertexAttributes];
+        uint32_t strides[MaxVertexBufferBindings];
+        VertexInputRate inputRates[MaxVertexBufferBindings];
+        BlendState blendState;
+        RasterizerState rasterizerState;
+        DepthStencilState depthStencilState;
+    };
+
     /// D3D12 Shader implementation.
     class VulkanShader final : public Shader
     {
@@ -59,13 +85,54 @@ namespace Alimer
         VkShaderModule GetVkShaderModule(unsigned stage) const { return _shaderModules[stage]; }
         VkShaderModule GetVkShaderModule(ShaderStage stage) const;
         VulkanPipelineLayout* GetPipelineLayout() const { return _pipelineLayout; }
+        /// Get hash of the SPIR-V code, stable between runs.
+        Hash GetCodeHash() const { return _codeHash; }
+
+        /// Get hash of the pipeline created with render pass and state.
+        Hash HashGraphicsPipeline(VkRenderPass renderPass, const VulkanGraphicsPipelineState& state) const;
+        /// Create graphics pipeline through the device pipeline cache, returns VK_NULL_HANDLE on failure.
+        VkPipeline CreateGraphicsPipeline(VkRenderPass renderPass, const VulkanGraphicsPipelineState& state) const;
+
+        /**
+        * Get pipeline for hash, creating it on a miss.
+        *
+        * @param renderPass Render pass owned by the graphics render pass cache, it outlives compile jobs.
+        * @param renderPassHash Key of the render pass, recorded with the state for warm up on the next run.
+        * @param async Create on a worker thread and return VK_NULL_HANDLE until the pipeline is ready.
+        * @return The pipeline or VK_NULL_HANDLE while compiling or when creation failed.
+        */
+        VkPipeline RequestGraphicsPipeline(Hash hash, VkRenderPass renderPass, Hash renderPassHash, const VulkanGraphicsPipelineState& state, bool async);
+
+        /// Wait for pipelines compiling on worker threads.
+        void WaitPipelineCompilation();
+
+        /// Get pipeline for hash, VK_NULL_HANDLE when missing or still compiling.
         VkPipeline GetGraphicsPipeline(Hash hash);
-        void AddPipeline(Hash hash, VkPipeline pipeline);
+        /// Add pipeline created for hash, returns the pipeline cached first when another thread created it concurrently.
+        VkPipeline AddPipeline(Hash hash, VkPipeline pipeline);
 
     private:
+        /// Pipeline compiled on a worker thread, heap allocated and released by the job.
+        struct GraphicsPipelineRequest
+        {
+            Hash hash;
+            VkRenderPass renderPass;
+            VulkanGraphicsPipelineState state;
+        };
+
+        VulkanGraphics* _graphics;
         VkDevice _logicalDevice;
+        Hash _codeHash = 0;
         VkShaderModule _shaderModules[static_cast<unsigned>(VulkanShaderStage::Count)] = {};
         VulkanPipelineLayout* _pipelineLayout = nullptr;
+        /// Created pipelines by hash.
         HashMap<VkPipeline> _graphicsPipelineCache;
+        /// Hashes of pipelines compiling on worker threads.
+        HashMap<bool> _compilingPipelines;
+        /// Hashes of pipelines that failed to compile, not retried.
+        HashMap<bool> _failedPipelines;
+        std::mutex _graphicsPipelineCacheLock;
+        /// Pipelines compiling on worker threads, waited before destruction.
+        JobCounter _compileCounter;
     };
 }
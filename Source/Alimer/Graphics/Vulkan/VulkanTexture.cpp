@@ -22,6 +22,8 @@
 
 #include "VulkanTexture.h"
 #include "VulkanGraphics.h"
+#include "VulkanBindlessHeap.h"
+#include "VulkanUploadContext.h"
 #include "VulkanConvert.h"
 #include "../../Core/Log.h"
 #include "../../Util/HashMap.h"
@@ -30,6 +32,7 @@ namespace Alimer
 {
     VulkanTexture::VulkanTexture(VulkanGraphics* graphics, const TextureDescription& description, VkImage vkImage, VkImageUsageFlags usage)
         : Texture(graphics)
+        , _graphics(graphics)
         , _logicalDevice(graphics->GetLogicalDevice())
         , _vkHandle(vkImage)
     {
@@ -38,32 +41,119 @@ namespace Alimer
         if (usage & (VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT))
         {
-            VkImageViewCreateInfo viewCreateInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
-            viewCreateInfo.image = vkImage;
-            viewCreateInfo.format = vk::Convert(description.format);
-            viewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_R;
-            viewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_G;
-            viewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_B;
-            viewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_A;
-            viewCreateInfo.subresourceRange.aspectMask = vk::FormatToAspectMask(viewCreateInfo.format);
-            viewCreateInfo.subresourceRange.baseMipLevel = 0;
-            viewCreateInfo.subresourceRange.baseArrayLayer = 0;
-            viewCreateInfo.subresourceRange.levelCount = _description.mipLevels;
-            viewCreateInfo.subresourceRange.layerCount = _description.arrayLayers;
-            viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D; // get_image_view_type(tmpinfo, nullptr);
-
-            if (vkCreateImageView(_logicalDevice, &viewCreateInfo, nullptr, &_defaultImageView) != VK_SUCCESS)
-            {
-                vkDestroyImage(_logicalDevice, _vkHandle, nullptr);
-                return;
-            }
+            CreateDefaultImageView();
         }
     }
 
     VulkanTexture::VulkanTexture(VulkanGraphics* graphics, const TextureDescription& description, const ImageLevel* initialData)
         : Texture(graphics, description)
+        , _graphics(graphics)
+        , _logicalDevice(graphics->GetLogicalDevice())
+        , _allocator(graphics->GetAllocator())
+    {
+        const VkFormat format = vk::Convert(description.format);
+        const bool depthStencil = vk::FormatToAspectMask(format) != VK_IMAGE_ASPECT_COLOR_BIT;
+
+        VkImageCreateInfo createInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+        createInfo.flags = 0;
+        switch (description.type)
+        {
+        case TextureType::Type1D:
+            createInfo.imageType = VK_IMAGE_TYPE_1D;
+            break;
+        case TextureType::Type3D:
+            createInfo.imageType = VK_IMAGE_TYPE_3D;
+            break;
+        case TextureType::TypeCube:
+            createInfo.imageType = VK_IMAGE_TYPE_2D;
+            createInfo.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+            break;
+        default:
+            createInfo.imageType = VK_IMAGE_TYPE_2D;
+            break;
+        }
+        createInfo.format = format;
+        createInfo.extent = { description.width, description.height, description.depth };
+        createInfo.mipLevels = description.mipLevels;
+        createInfo.arrayLayers = description.arrayLayers;
+        createInfo.samples = static_cast<VkSampleCountFlagBits>(description.samples);
+        createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        createInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        if (description.usage & TextureUsage::ShaderRead)
+            createInfo.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (description.usage & TextureUsage::ShaderWrite)
+            createInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        if (description.usage & TextureUsage::RenderTarget)
+            createInfo.usage |= depthStencil ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        graphics->SetSharingMode(createInfo);
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+        VkResult result = vmaCreateImage(_allocator, &createInfo, &allocInfo, &_vkHandle, &_allocation, nullptr);
+        if (result != VK_SUCCESS)
+        {
+            ALIMER_LOGERROR("Vulkan - Failed to create image, error: {}", vkGetVulkanResultString(result));
+            return;
+        }
+
+        CreateDefaultImageView();
+
+        // Render targets are transitioned by their render pass, sampled images are uploaded in shader read layout.
+        const VkImageLayout layout = (description.usage & TextureUsage::ShaderWrite) ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        if (initialData || !(description.usage & TextureUsage::RenderTarget))
+        {
+            graphics->GetUploadContext()->UploadImage(_vkHandle, description, initialData, layout);
+        }
+
+        VulkanBindlessHeap* bindlessHeap = graphics->GetBindlessHeap();
+        if (bindlessHeap != nullptr
+            && (description.usage & TextureUsage::ShaderRead)
+            && _defaultImageView != VK_NULL_HANDLE)
+        {
+            _bindlessIndex = bindlessHeap->AllocateTexture(_defaultImageView, layout);
+            if (_bindlessIndex != InvalidBindlessIndex)
+            {
+                _bindlessHeap = bindlessHeap;
+            }
+        }
+    }
+
+    void VulkanTexture::CreateDefaultImageView()
     {
+        VkImageViewCreateInfo viewCreateInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+        viewCreateInfo.image = _vkHandle;
+        viewCreateInfo.format = vk::Convert(_description.format);
+        viewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_R;
+        viewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_G;
+        viewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_B;
+        viewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_A;
+        viewCreateInfo.subresourceRange.aspectMask = vk::FormatToAspectMask(viewCreateInfo.format);
+        viewCreateInfo.subresourceRange.baseMipLevel = 0;
+        viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+        viewCreateInfo.subresourceRange.levelCount = _description.mipLevels;
+        viewCreateInfo.subresourceRange.layerCount = _description.arrayLayers;
+        switch (_description.type)
+        {
+        case TextureType::Type1D:
+            viewCreateInfo.viewType = _description.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_1D_ARRAY : VK_IMAGE_VIEW_TYPE_1D;
+            break;
+        case TextureType::Type3D:
+            viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+            break;
+        case TextureType::TypeCube:
+            viewCreateInfo.viewType = _description.arrayLayers > 6 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+            break;
+        default:
+            viewCreateInfo.viewType = _description.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+            break;
+        }
 
+        if (vkCreateImageView(_logicalDevice, &viewCreateInfo, nullptr, &_defaultImageView) != VK_SUCCESS)
+        {
+            ALIMER_LOGERROR("Vulkan - Failed to create image view");
+        }
     }
 
     VulkanTexture::~VulkanTexture()
@@ -73,10 +163,24 @@ namespace Alimer
 
     void VulkanTexture::Destroy()
     {
+        if (_bindlessHeap != nullptr)
+        {
+            _bindlessHeap->FreeTexture(_bindlessIndex);
+            _bindlessHeap = nullptr;
+            _bindlessIndex = InvalidBindlessIndex;
+        }
+
         if (_defaultImageView != VK_NULL_HANDLE)
         {
-            vkDestroyImageView(_logicalDevice, _defaultImageView, nullptr);
+            _graphics->DestroyImageView(_defaultImageView);
             _defaultImageView = VK_NULL_HANDLE;
         }
+
+        if (_allocation != VK_NULL_HANDLE)
+        {
+            _graphics->DestroyImage(_vkHandle, _allocation);
+            _vkHandle = VK_NULL_HANDLE;
+            _allocation = VK_NULL_HANDLE;
+        }
     }
 }
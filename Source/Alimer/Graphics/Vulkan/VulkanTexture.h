@@ -29,6 +29,7 @@
 namespace Alimer
 {
 	class VulkanGraphics;
+	class VulkanBindlessHeap;
 
 	/// Vulkan Texture.
 	class VulkanTexture final : public Texture
@@ -44,8 +45,16 @@ namespace Alimer
 		inline VkImageView GetDefaultImageView() const { return _defaultImageView; }
 
 	private:
+        void CreateDefaultImageView();
+
+        VulkanGraphics* _graphics;
 		VkDevice _logicalDevice;
-		VkImage _vkHandle;
-		VkImageView _defaultImageView;
+        VmaAllocator _allocator = VK_NULL_HANDLE;
+		VkImage _vkHandle = VK_NULL_HANDLE;
+        /// Memory of images owned by the texture, null for swap chain images.
+        VmaAllocation _allocation = VK_NULL_HANDLE;
+		VkImageView _defaultImageView = VK_NULL_HANDLE;
+        /// Heap holding the bindless slot of the texture, null when it has none.
+        VulkanBindlessHeap* _bindlessHeap = nullptr;
 	};
 }
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "VulkanTransientBufferPool.h"
+#include "VulkanGraphics.h"
+#include "VulkanBuffer.h"
+#include "../../Core/Log.h"
+#include <algorithm>
+
+namespace Alimer
+{
+    VulkanTransientBufferPool::VulkanTransientBufferPool(VulkanGraphics* graphics, BufferUsage usage, uint64_t blockSize, uint64_t alignment)
+        : _graphics(graphics)
+        , _usage(usage)
+        , _blockSize(blockSize)
+        , _alignment(std::max<uint64_t>(alignment, 16))
+    {
+        _frameBlocks.resize(MaxFramesInFlight);
+    }
+
+    VulkanTransientBlock VulkanTransientBufferPool::RequestBlock(uint64_t minSize)
+    {
+        if (minSize <= _blockSize)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            if (!_freeBlocks.empty())
+            {
+                VulkanTransientBlock block = std::move(_freeBlocks.back());
+                _freeBlocks.pop_back();
+                block.offset = 0;
+                return block;
+            }
+        }
+
+        // Blocks larger than the default size are not pooled.
+        GpuBufferDescription description = {};
+        description.elementCount = 1;
+        description.elementSize = static_cast<uint32_t>(std::max(minSize, _blockSize));
+        description.usage = _usage;
+        description.resourceUsage = ResourceUsage::Dynamic;
+
+        VulkanTransientBlock block;
+        block.buffer = new GpuBuffer(_graphics, description);
+        block.data = static_cast<VulkanBuffer*>(block.buffer->GetHandle())->GetMappedData();
+        block.offset = 0;
+        block.size = block.buffer->GetSize();
+        return block;
+    }
+
+    void VulkanTransientBufferPool::RecycleBlock(uint32_t frameIndex, VulkanTransientBlock& block)
+    {
+        if (!block.buffer)
+            return;
+
+        // Oversized blocks are kept alive as well, the GPU reads them until the frame retires.
+        std::lock_guard<std::mutex> lock(_lock);
+        _frameBlocks[frameIndex].push_back(std::move(block));
+        block = {};
+    }
+
+    void VulkanTransientBufferPool::BeginFrame(uint32_t frameIndex)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (VulkanTransientBlock& block : _frameBlocks[frameIndex])
+        {
+            if (block.size == _blockSize)
+            {
+                _freeBlocks.push_back(std::move(block));
+            }
+        }
+        _frameBlocks[frameIndex].clear();
+    }
+}
@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../GpuBuffer.h"
+#include "VulkanPrerequisites.h"
+#include <mutex>
+#include <vector>
+
+namespace Alimer
+{
+    class VulkanGraphics;
+
+    static constexpr uint64_t VulkanTransientBlockSize = 256 * 1024;
+
+    /// Persistently mapped buffer linearly suballocated by one command buffer.
+    struct VulkanTransientBlock
+    {
+        SharedPtr<GpuBuffer> buffer;
+        uint8_t* data = nullptr;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+
+        /// Allocate aligned range, return false when the block is full.
+        bool Allocate(uint64_t allocationSize, uint64_t alignment, uint64_t* allocationOffset)
+        {
+            const uint64_t alignedOffset = (offset + alignment - 1) & ~(alignment - 1);
+            if (!buffer || alignedOffset + allocationSize > size)
+                return false;
+
+            *allocationOffset = alignedOffset;
+            offset = alignedOffset + allocationSize;
+            return true;
+        }
+    };
+
+    /// Pool of transient blocks, blocks used by a frame are recycled once the frame retires.
+    class VulkanTransientBufferPool final
+    {
+    public:
+        VulkanTransientBufferPool(VulkanGraphics* graphics, BufferUsage usage, uint64_t blockSize, uint64_t alignment);
+        ~VulkanTransientBufferPool() = default;
+
+        /// Request an empty block of at least given size.
+        VulkanTransientBlock RequestBlock(uint64_t minSize);
+
+        /// Return block used by the frame.
+        void RecycleBlock(uint32_t frameIndex, VulkanTransientBlock& block);
+
+        /// Make blocks used by the frame available again, called once its fence signaled.
+        void BeginFrame(uint32_t frameIndex);
+
+        uint64_t GetAlignment() const { return _alignment; }
+
+    private:
+        VulkanGraphics* _graphics;
+        BufferUsage _usage;
+        uint64_t _blockSize;
+        uint64_t _alignment;
+        std::mutex _lock;
+        std::vector<VulkanTransientBlock> _freeBlocks;
+        std::vector<std::vector<VulkanTransientBlock>> _frameBlocks;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(VulkanTransientBufferPool);
+    };
+}
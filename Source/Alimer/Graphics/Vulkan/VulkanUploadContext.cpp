@@ -0,0 +1,378 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "VulkanUploadContext.h"
+#include "VulkanGraphics.h"
+#include "VulkanConvert.h"
+#include "../../Core/Log.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Alimer
+{
+    // Staging offsets are aligned for texel blocks of every format.
+    static constexpr VkDeviceSize StagingAlignment = 16;
+
+    static inline VkDeviceSize AlignStaging(VkDeviceSize value)
+    {
+        return (value + StagingAlignment - 1) & ~(StagingAlignment - 1);
+    }
+
+    VulkanUploadContext::VulkanUploadContext(VulkanGraphics* graphics, VkQueue queue, uint32_t queueFamilyIndex, VkDeviceSize stagingSize)
+        : _graphics(graphics)
+        , _logicalDevice(graphics->GetLogicalDevice())
+        , _allocator(graphics->GetAllocator())
+        , _queue(queue)
+        , _stagingSize(stagingSize)
+    {
+        _commandPool = graphics->CreateCommandPool(queueFamilyIndex, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+        VkBufferCreateInfo createInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        createInfo.size = stagingSize;
+        createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo vmaAllocInfo = {};
+        vkThrowIfFailed(vmaCreateBuffer(_allocator, &createInfo, &allocInfo, &_stagingBuffer, &_stagingAllocation, &vmaAllocInfo));
+        _stagingData = static_cast<uint8_t*>(vmaAllocInfo.pMappedData);
+
+        _frameBatches.resize(MaxFramesInFlight);
+    }
+
+    VulkanUploadContext::~VulkanUploadContext()
+    {
+        // Device is idle, every batch completed.
+        for (auto& batch : _batches)
+        {
+            ResetBatch(batch.get());
+            vkDestroyFence(_logicalDevice, batch->fence, nullptr);
+            vkDestroySemaphore(_logicalDevice, batch->semaphore, nullptr);
+        }
+        _batches.clear();
+
+        vmaDestroyBuffer(_allocator, _stagingBuffer, _stagingAllocation);
+        vkDestroyCommandPool(_logicalDevice, _commandPool, nullptr);
+    }
+
+    void VulkanUploadContext::UploadBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const void* data)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        StagingRegion staging = AllocateStaging(size);
+        memcpy(staging.data, data, static_cast<size_t>(size));
+
+        Batch* batch = GetBatch();
+        if (std::find(batch->writtenBuffers.begin(), batch->writtenBuffers.end(), buffer) != batch->writtenBuffers.end())
+        {
+            // Order with previous copy to the same buffer in this batch.
+            VkMemoryBarrier barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(batch->commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                1, &barrier, 0, nullptr, 0, nullptr);
+            batch->writtenBuffers.clear();
+        }
+        batch->writtenBuffers.push_back(buffer);
+
+        VkBufferCopy region;
+        region.srcOffset = staging.offset;
+        region.dstOffset = offset;
+        region.size = size;
+        vkCmdCopyBuffer(batch->commandBuffer, staging.buffer, buffer, 1, &region);
+    }
+
+    void VulkanUploadContext::UploadImage(VkImage image, const TextureDescription& description, const ImageLevel* initialData, VkImageLayout finalLayout)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = vk::FormatToAspectMask(vk::Convert(description.format));
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = description.mipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = description.arrayLayers;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (!initialData)
+        {
+            // Visibility to the graphics queue comes from the batch semaphore.
+            barrier.newLayout = finalLayout;
+            vkCmdPipelineBarrier(GetBatch()->commandBuffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                0, nullptr, 0, nullptr, 1, &barrier);
+            return;
+        }
+
+        // Pack every subresource, in layer major order, into one staging region.
+        const uint32_t subresourceCount = description.arrayLayers * description.mipLevels;
+        std::vector<VkBufferImageCopy> regions(subresourceCount);
+        VkDeviceSize totalSize = 0;
+        for (uint32_t i = 0; i < subresourceCount; ++i)
+        {
+            const uint32_t level = i % description.mipLevels;
+            const uint32_t width = std::max(1u, description.width >> level);
+            const uint32_t height = std::max(1u, description.height >> level);
+            const uint32_t depth = std::max(1u, description.depth >> level);
+
+            VkBufferImageCopy& region = regions[i];
+            region.bufferOffset = totalSize;
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = barrier.subresourceRange.aspectMask;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = i / description.mipLevels;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { width, height, depth };
+
+            totalSize = AlignStaging(totalSize + CalculateDataSize(width, height, description.format) * depth);
+        }
+
+        StagingRegion staging = AllocateStaging(totalSize);
+        for (uint32_t i = 0; i < subresourceCount; ++i)
+        {
+            uint32_t rows;
+            uint32_t rowPitch;
+            CalculateDataSize(regions[i].imageExtent.width, regions[i].imageExtent.height, description.format, &rows, &rowPitch);
+            rows *= regions[i].imageExtent.depth;
+
+            const uint32_t sourcePitch = initialData[i].rowPitch ? initialData[i].rowPitch : rowPitch;
+            const uint8_t* source = static_cast<const uint8_t*>(initialData[i].data);
+            uint8_t* dest = staging.data + regions[i].bufferOffset;
+            for (uint32_t row = 0; row < rows; ++row)
+            {
+                memcpy(dest + row * rowPitch, source + row * sourcePitch, rowPitch);
+            }
+
+            regions[i].bufferOffset += staging.offset;
+        }
+
+        Batch* batch = GetBatch();
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        vkCmdPipelineBarrier(batch->commandBuffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &barrier);
+
+        vkCmdCopyBufferToImage(batch->commandBuffer,
+            staging.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            subresourceCount, regions.data());
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = finalLayout;
+        vkCmdPipelineBarrier(batch->commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    void VulkanUploadContext::Flush()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        FlushBatch();
+    }
+
+    void VulkanUploadContext::BeginFrame(uint32_t frameIndex)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        // The frame waited on its batches, they completed and their semaphores were consumed.
+        ReleaseStaging(false);
+        for (Batch* batch : _frameBatches[frameIndex])
+        {
+            while (std::find(_pendingStaging.begin(), _pendingStaging.end(), batch) != _pendingStaging.end())
+            {
+                ReleaseStaging(true);
+            }
+
+            ResetBatch(batch);
+            _freeBatches.push_back(batch);
+        }
+        _frameBatches[frameIndex].clear();
+    }
+
+    void VulkanUploadContext::EndFrame(uint32_t frameIndex)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        FlushBatch();
+        _frameBatches[frameIndex].insert(_frameBatches[frameIndex].end(), _flushedBatches.begin(), _flushedBatches.end());
+        _flushedBatches.clear();
+    }
+
+    VulkanUploadContext::Batch* VulkanUploadContext::GetBatch()
+    {
+        if (_recording)
+            return _recording;
+
+        if (_freeBatches.empty())
+        {
+            std::unique_ptr<Batch> batch(new Batch());
+
+            VkCommandBufferAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+            allocateInfo.commandPool = _commandPool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            vkThrowIfFailed(vkAllocateCommandBuffers(_logicalDevice, &allocateInfo, &batch->commandBuffer));
+
+            VkFenceCreateInfo fenceCreateInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+            vkThrowIfFailed(vkCreateFence(_logicalDevice, &fenceCreateInfo, nullptr, &batch->fence));
+
+            VkSemaphoreCreateInfo semaphoreCreateInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+            vkThrowIfFailed(vkCreateSemaphore(_logicalDevice, &semaphoreCreateInfo, nullptr, &batch->semaphore));
+
+            _freeBatches.push_back(batch.get());
+            _batches.push_back(std::move(batch));
+        }
+
+        _recording = _freeBatches.back();
+        _freeBatches.pop_back();
+
+        VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkThrowIfFailed(vkBeginCommandBuffer(_recording->commandBuffer, &beginInfo));
+        return _recording;
+    }
+
+    VulkanUploadContext::StagingRegion VulkanUploadContext::AllocateStaging(VkDeviceSize size)
+    {
+        size = AlignStaging(size);
+
+        if (size > _stagingSize)
+        {
+            // Larger than the whole ring, use a buffer owned by the batch.
+            VkBufferCreateInfo createInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+            createInfo.size = size;
+            createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+            TemporaryBuffer temporary;
+            VmaAllocationInfo vmaAllocInfo = {};
+            vkThrowIfFailed(vmaCreateBuffer(_allocator, &createInfo, &allocInfo, &temporary.buffer, &temporary.allocation, &vmaAllocInfo));
+            GetBatch()->temporaryBuffers.push_back(temporary);
+            return { temporary.buffer, 0, static_cast<uint8_t*>(vmaAllocInfo.pMappedData) };
+        }
+
+        for (;;)
+        {
+            VkDeviceSize offset = _stagingHead;
+            VkDeviceSize padding = 0;
+            if (offset + size > _stagingSize)
+            {
+                // Skip the end of the ring and wrap around.
+                padding = _stagingSize - offset;
+                offset = 0;
+            }
+
+            if (_stagingUsed + padding + size <= _stagingSize)
+            {
+                Batch* batch = GetBatch();
+                batch->stagingUsed += padding + size;
+                _stagingUsed += padding + size;
+                _stagingHead = offset + size;
+                return { _stagingBuffer, offset, _stagingData + offset };
+            }
+
+            // Ring is full, submit what was recorded and wait for the oldest batch.
+            FlushBatch();
+            ReleaseStaging(true);
+        }
+    }
+
+    void VulkanUploadContext::FlushBatch()
+    {
+        if (!_recording)
+            return;
+
+        vkThrowIfFailed(vkEndCommandBuffer(_recording->commandBuffer));
+
+        VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &_recording->commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &_recording->semaphore;
+        {
+            // Queue may be the graphics queue the frames are submitted to.
+            std::lock_guard<std::mutex> lock(_graphics->GetQueueLock(_queue));
+            vkThrowIfFailed(vkQueueSubmit(_queue, 1, &submitInfo, _recording->fence));
+        }
+
+        // Uploaded resources may be read by any stage.
+        _graphics->AddWaitSemaphore(_recording->semaphore, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+        _pendingStaging.push_back(_recording);
+        _flushedBatches.push_back(_recording);
+        _recording = nullptr;
+    }
+
+    void VulkanUploadContext::ReleaseStaging(bool wait)
+    {
+        while (!_pendingStaging.empty())
+        {
+            Batch* batch = _pendingStaging.front();
+            if (wait)
+            {
+                vkThrowIfFailed(vkWaitForFences(_logicalDevice, 1, &batch->fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+                wait = false;
+            }
+            else if (vkGetFenceStatus(_logicalDevice, batch->fence) != VK_SUCCESS)
+            {
+                break;
+            }
+
+            _stagingUsed -= batch->stagingUsed;
+            batch->stagingUsed = 0;
+            _pendingStaging.pop_front();
+        }
+
+        if (_stagingUsed == 0 && !_recording)
+        {
+            _stagingHead = 0;
+        }
+    }
+
+    void VulkanUploadContext::ResetBatch(Batch* batch)
+    {
+        for (const TemporaryBuffer& temporary : batch->temporaryBuffers)
+        {
+            vmaDestroyBuffer(_allocator, temporary.buffer, temporary.allocation);
+        }
+        batch->temporaryBuffers.clear();
+        batch->writtenBuffers.clear();
+        vkResetFences(_logicalDevice, 1, &batch->fence);
+    }
+}
@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Texture.h"
+#include "VulkanPrerequisites.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Alimer
+{
+    class VulkanGraphics;
+
+    static constexpr VkDeviceSize VulkanStagingBufferSize = 16 * 1024 * 1024;
+
+    /// Uploads data to device local resources through a host visible staging ring buffer, copies are batched and submitted on the transfer queue.
+    class VulkanUploadContext final
+    {
+    public:
+        VulkanUploadContext(VulkanGraphics* graphics, VkQueue queue, uint32_t queueFamilyIndex, VkDeviceSize stagingSize);
+        ~VulkanUploadContext();
+
+        /// Copy data to buffer range.
+        void UploadBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const void* data);
+
+        /// Copy every subresource to image, or only transition it when data is null, leaving it in final layout.
+        void UploadImage(VkImage image, const TextureDescription& description, const ImageLevel* initialData, VkImageLayout finalLayout);
+
+        /// Submit recorded copies, the next frame submission waits on them.
+        void Flush();
+
+        /// Recycle batches waited by the frame, called once its fence signaled.
+        void BeginFrame(uint32_t frameIndex);
+
+        /// Flush and attach submitted batches to the frame about to be submitted.
+        void EndFrame(uint32_t frameIndex);
+
+    private:
+        struct TemporaryBuffer
+        {
+            VkBuffer buffer;
+            VmaAllocation allocation;
+        };
+
+        struct Batch
+        {
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+            VkSemaphore semaphore = VK_NULL_HANDLE;
+            /// Bytes of the staging ring used by the batch, released once the fence signals.
+            VkDeviceSize stagingUsed = 0;
+            std::vector<TemporaryBuffer> temporaryBuffers;
+            /// Buffers written by the batch, a barrier orders repeated writes.
+            std::vector<VkBuffer> writtenBuffers;
+        };
+
+        struct StagingRegion
+        {
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            uint8_t* data;
+        };
+
+        Batch* GetBatch();
+        StagingRegion AllocateStaging(VkDeviceSize size);
+        void FlushBatch();
+        void ReleaseStaging(bool wait);
+        void ResetBatch(Batch* batch);
+
+        VulkanGraphics* _graphics;
+        VkDevice _logicalDevice;
+        VmaAllocator _allocator;
+        VkQueue _queue;
+        VkCommandPool _commandPool = VK_NULL_HANDLE;
+        std::mutex _lock;
+
+        // Staging ring buffer, persistently mapped.
+        VkBuffer _stagingBuffer = VK_NULL_HANDLE;
+        VmaAllocation _stagingAllocation = VK_NULL_HANDLE;
+        uint8_t* _stagingData = nullptr;
+        VkDeviceSize _stagingSize;
+        VkDeviceSize _stagingHead = 0;
+        VkDeviceSize _stagingUsed = 0;
+
+        std::vector<std::unique_ptr<Batch>> _batches;
+        std::vector<Batch*> _freeBatches;
+        Batch* _recording = nullptr;
+        /// Submitted batches still holding staging memory, in submission order.
+        std::deque<Batch*> _pendingStaging;
+        /// Submitted batches not yet waited by a frame submission.
+        std::vector<Batch*> _flushedBatches;
+        /// Submitted batches waited by each frame in flight.
+        std::vector<std::vector<Batch*>> _frameBatches;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(VulkanUploadContext);
+    };
+}
@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Math/BoundingBox.h"
+#include "../Math/Sphere.h"
+#include "../Math/Matrix4x4.h"
+#include "../Math/MathUtil.h"
+
+namespace Alimer
+{
+    float BoundingBox::GetSurfaceArea() const
+    {
+        Vector3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    void BoundingBox::Merge(const BoundingBox& box)
+    {
+        min = Vector3(Min(min.x, box.min.x), Min(min.y, box.min.y), Min(min.z, box.min.z));
+        max = Vector3(Max(max.x, box.max.x), Max(max.y, box.max.y), Max(max.z, box.max.z));
+    }
+
+    void BoundingBox::Merge(const Vector3& point)
+    {
+        min = Vector3(Min(min.x, point.x), Min(min.y, point.y), Min(min.z, point.z));
+        max = Vector3(Max(max.x, point.x), Max(max.y, point.y), Max(max.z, point.z));
+    }
+
+    bool BoundingBox::Contains(const Vector3& point) const
+    {
+        return point.x >= min.x && point.x <= max.x
+            && point.y >= min.y && point.y <= max.y
+            && point.z >= min.z && point.z <= max.z;
+    }
+
+    bool BoundingBox::Contains(const BoundingBox& box) const
+    {
+        return box.min.x >= min.x && box.max.x <= max.x
+            && box.min.y >= min.y && box.max.y <= max.y
+            && box.min.z >= min.z && box.max.z <= max.z;
+    }
+
+    bool BoundingBox::Intersects(const BoundingBox& box) const
+    {
+        return box.min.x <= max.x && box.max.x >= min.x
+            && box.min.y <= max.y && box.max.y >= min.y
+            && box.min.z <= max.z && box.max.z >= min.z;
+    }
+
+    bool BoundingBox::Intersects(const Sphere& sphere) const
+    {
+        return sphere.Intersects(*this);
+    }
+
+    BoundingBox BoundingBox::Transform(const Matrix4x4& transform) const
+    {
+        // Transform the center and project the extents on the transformed axes.
+        const Vector3 center = GetCenter();
+        const Vector3 extents = GetExtents();
+
+        Vector3 newCenter(
+            center.x * transform._11 + center.y * transform._21 + center.z * transform._31 + transform._41,
+            center.x * transform._12 + center.y * transform._22 + center.z * transform._32 + transform._42,
+            center.x * transform._13 + center.y * transform._23 + center.z * transform._33 + transform._43);
+
+        Vector3 newExtents(
+            extents.x * Abs(transform._11) + extents.y * Abs(transform._21) + extents.z * Abs(transform._31),
+            extents.x * Abs(transform._12) + extents.y * Abs(transform._22) + extents.z * Abs(transform._32),
+            extents.x * Abs(transform._13) + extents.y * Abs(transform._23) + extents.z * Abs(transform._33));
+
+        return BoundingBox(newCenter - newExtents, newCenter + newExtents);
+    }
+
+    BoundingBox BoundingBox::Merge(const BoundingBox& left, const BoundingBox& right)
+    {
+        BoundingBox result = left;
+        result.Merge(right);
+        return result;
+    }
+}
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/Vector3.h"
+
+namespace Alimer
+{
+    class Matrix4x4;
+    class Sphere;
+
+    /// Defines an axis aligned bounding box.
+    class ALIMER_API BoundingBox
+    {
+    public:
+        /// The minimum point.
+        Vector3 min;
+
+        /// The maximum point.
+        Vector3 max;
+
+        BoundingBox() noexcept : min(Vector3::Zero), max(Vector3::Zero) {}
+
+        BoundingBox(const BoundingBox&) = default;
+        BoundingBox& operator=(const BoundingBox&) = default;
+
+        BoundingBox(BoundingBox&&) = default;
+        BoundingBox& operator=(BoundingBox&&) = default;
+
+        constexpr BoundingBox(const Vector3& min_, const Vector3& max_) : min(min_), max(max_) {}
+
+        // Comparison operators
+        bool operator == (const BoundingBox& rhs) const { return min == rhs.min && max == rhs.max; }
+        bool operator != (const BoundingBox& rhs) const { return min != rhs.min || max != rhs.max; }
+
+        /// Return center point.
+        Vector3 GetCenter() const { return (max + min) * 0.5f; }
+
+        /// Return half size along each axis.
+        Vector3 GetExtents() const { return (max - min) * 0.5f; }
+
+        /// Return surface area.
+        float GetSurfaceArea() const;
+
+        /// Grow to include the other box.
+        void Merge(const BoundingBox& box);
+
+        /// Grow to include point.
+        void Merge(const Vector3& point);
+
+        /// Return true if the point is inside.
+        bool Contains(const Vector3& point) const;
+
+        /// Return true if the other box is fully inside.
+        bool Contains(const BoundingBox& box) const;
+
+        /// Return true if the boxes overlap.
+        bool Intersects(const BoundingBox& box) const;
+
+        /// Return true if the sphere overlaps.
+        bool Intersects(const Sphere& sphere) const;
+
+        /// Return bounding box enclosing this box transformed by matrix.
+        BoundingBox Transform(const Matrix4x4& transform) const;
+
+        /// Return union of two boxes.
+        static BoundingBox Merge(const BoundingBox& left, const BoundingBox& right);
+    };
+}
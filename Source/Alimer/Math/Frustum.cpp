@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Math/Frustum.h"
+#include "../Math/Matrix4x4.h"
+#include "../Math/MathUtil.h"
+
+#if ALIMER_AVX2
+#   include <immintrin.h>
+#elif ALIMER_SSE2
+#   include <emmintrin.h>
+#elif ALIMER_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace Alimer
+{
+    constexpr uint32_t Frustum::PlaneCount;
+
+    Frustum::Frustum() noexcept
+    {
+        Define(Matrix4x4::Identity);
+    }
+
+    Frustum::Frustum(const Matrix4x4& viewProjection)
+    {
+        Define(viewProjection);
+    }
+
+    void Frustum::Define(const Matrix4x4& m)
+    {
+        // Planes from the clip space inequalities -w <= x <= w, -w <= y <= w, 0 <= z <= w.
+        _planes[0] = Plane(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+        _planes[1] = Plane(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+        _planes[2] = Plane(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+        _planes[3] = Plane(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+        _planes[4] = Plane(m._13, m._23, m._33, m._43);
+        _planes[5] = Plane(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+
+        for (auto& plane : _planes)
+        {
+            plane.Normalize();
+        }
+
+        UpdatePlaneData();
+    }
+
+    void Frustum::UpdatePlaneData()
+    {
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            if (i < PlaneCount)
+            {
+                _planeX[i] = _planes[i].normal.x;
+                _planeY[i] = _planes[i].normal.y;
+                _planeZ[i] = _planes[i].normal.z;
+                _planeD[i] = _planes[i].d;
+            }
+            else
+            {
+                _planeX[i] = 0.0f;
+                _planeY[i] = 0.0f;
+                _planeZ[i] = 0.0f;
+                _planeD[i] = 1.0f;
+            }
+        }
+    }
+
+    bool Frustum::Contains(const Vector3& point) const
+    {
+        for (const auto& plane : _planes)
+        {
+            if (plane.Distance(point) < 0.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool Frustum::Intersects(const BoundingBox& box) const
+    {
+        // Box is outside when center distance plus projected extents is behind any plane.
+        const Vector3 center = box.GetCenter();
+        const Vector3 extents = box.GetExtents();
+
+#if ALIMER_AVX2
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 nx = _mm256_loadu_ps(_planeX);
+        const __m256 ny = _mm256_loadu_ps(_planeY);
+        const __m256 nz = _mm256_loadu_ps(_planeZ);
+
+        __m256 distance = _mm256_loadu_ps(_planeD);
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(nx, _mm256_set1_ps(center.x)));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(ny, _mm256_set1_ps(center.y)));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(nz, _mm256_set1_ps(center.z)));
+
+        __m256 radius = _mm256_mul_ps(_mm256_andnot_ps(signMask, nx), _mm256_set1_ps(extents.x));
+        radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_andnot_ps(signMask, ny), _mm256_set1_ps(extents.y)));
+        radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_andnot_ps(signMask, nz), _mm256_set1_ps(extents.z)));
+
+        const __m256 outside = _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ);
+        return _mm256_movemask_ps(outside) == 0;
+#elif ALIMER_SSE2
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 centerX = _mm_set1_ps(center.x);
+        const __m128 centerY = _mm_set1_ps(center.y);
+        const __m128 centerZ = _mm_set1_ps(center.z);
+        const __m128 extentsX = _mm_set1_ps(extents.x);
+        const __m128 extentsY = _mm_set1_ps(extents.y);
+        const __m128 extentsZ = _mm_set1_ps(extents.z);
+
+        int outsideMask = 0;
+        for (uint32_t i = 0; i < 8; i += 4)
+        {
+            const __m128 nx = _mm_loadu_ps(_planeX + i);
+            const __m128 ny = _mm_loadu_ps(_planeY + i);
+            const __m128 nz = _mm_loadu_ps(_planeZ + i);
+
+            __m128 distance = _mm_loadu_ps(_planeD + i);
+            distance = _mm_add_ps(distance, _mm_mul_ps(nx, centerX));
+            distance = _mm_add_ps(distance, _mm_mul_ps(ny, centerY));
+            distance = _mm_add_ps(distance, _mm_mul_ps(nz, centerZ));
+
+            __m128 radius = _mm_mul_ps(_mm_andnot_ps(signMask, nx), extentsX);
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, ny), extentsY));
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, nz), extentsZ));
+
+            outsideMask |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        return outsideMask == 0;
+#elif ALIMER_NEON
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (uint32_t i = 0; i < 8; i += 4)
+        {
+            const float32x4_t nx = vld1q_f32(_planeX + i);
+            const float32x4_t ny = vld1q_f32(_planeY + i);
+            const float32x4_t nz = vld1q_f32(_planeZ + i);
+
+            float32x4_t distance = vld1q_f32(_planeD + i);
+            distance = vmlaq_n_f32(distance, nx, center.x);
+            distance = vmlaq_n_f32(distance, ny, center.y);
+            distance = vmlaq_n_f32(distance, nz, center.z);
+
+            float32x4_t radius = vmulq_n_f32(vabsq_f32(nx), extents.x);
+            radius = vmlaq_n_f32(radius, vabsq_f32(ny), extents.y);
+            radius = vmlaq_n_f32(radius, vabsq_f32(nz), extents.z);
+
+            outside = vorrq_u32(outside, vcltq_f32(vaddq_f32(distance, radius), vdupq_n_f32(0.0f)));
+        }
+
+        uint32x2_t folded = vorr_u32(vget_low_u32(outside), vget_high_u32(outside));
+        return vget_lane_u32(vpmax_u32(folded, folded), 0) == 0;
+#else
+        for (const auto& plane : _planes)
+        {
+            const float distance = plane.Distance(center);
+            const float radius = extents.x * Abs(plane.normal.x) + extents.y * Abs(plane.normal.y) + extents.z * Abs(plane.normal.z);
+            if (distance + radius < 0.0f)
+                return false;
+        }
+
+        return true;
+#endif
+    }
+
+    bool Frustum::Intersects(const Sphere& sphere) const
+    {
+        for (const auto& plane : _planes)
+        {
+            if (plane.Distance(sphere.center) < -sphere.radius)
+                return false;
+        }
+
+        return true;
+    }
+}
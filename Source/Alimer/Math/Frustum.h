@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/Plane.h"
+#include "../Math/BoundingBox.h"
+#include "../Math/Sphere.h"
+
+namespace Alimer
+{
+    class Matrix4x4;
+
+    enum class FrustumPlane : uint32_t
+    {
+        Left = 0,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        Count
+    };
+
+    /// Defines a view frustum made of six inward facing planes.
+    class ALIMER_API Frustum
+    {
+    public:
+        static constexpr uint32_t PlaneCount = static_cast<uint32_t>(FrustumPlane::Count);
+
+        /// Constructor.
+        Frustum() noexcept;
+
+        /// Construct from view projection matrix.
+        explicit Frustum(const Matrix4x4& viewProjection);
+
+        /// Define frustum planes from view projection matrix.
+        void Define(const Matrix4x4& viewProjection);
+
+        /// Return plane.
+        const Plane& GetPlane(FrustumPlane plane) const { return _planes[static_cast<uint32_t>(plane)]; }
+
+        /// Return true if the point is inside.
+        bool Contains(const Vector3& point) const;
+
+        /// Return true if the box is inside or intersects, tests all planes at once using SIMD.
+        bool Intersects(const BoundingBox& box) const;
+
+        /// Return true if the sphere is inside or intersects.
+        bool Intersects(const Sphere& sphere) const;
+
+    private:
+        void UpdatePlaneData();
+
+        Plane _planes[PlaneCount];
+
+        /// Planes as structure of arrays padded to 8 with planes that accept everything.
+        float _planeX[8];
+        float _planeY[8];
+        float _planeZ[8];
+        float _planeD[8];
+    };
+}
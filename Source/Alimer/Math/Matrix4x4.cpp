@@ -21,6 +21,7 @@
 //
 
 #include "../Math/Matrix4x4.h"
+#include "../Math/Quaternion.h"
 #include "../Math/MathUtil.h"
 
 #if ALIMER_SSE2
@@ -125,7 +126,7 @@ namespace Alimer
 
 #if ALIMER_SSE2
         XMStoreFloat4x4(reinterpret_cast<XMFLOAT4X4*>(result),
-            XMMatrixPerspectiveFovRH(fieldOfView, aspectRatio, fieldOfView, farPlaneDistance)
+            XMMatrixPerspectiveFovRH(fieldOfView, aspectRatio, nearPlaneDistance, farPlaneDistance)
         );
 #else
         float sinFov;
@@ -208,4 +209,74 @@ namespace Alimer
         CreateLookAt(cameraPosition, cameraTarget, cameraUpVector, &result);
         return result;
     }
+    
+    void Matrix4x4::Multiply(const Matrix4x4& left, const Matrix4x4& right, Matrix4x4* result)
+    {
+        ALIMER_ASSERT(result);
+
+        // Result may alias one of the inputs.
+        Matrix4x4 temp;
+        for (uint32_t row = 0; row < 4; ++row)
+        {
+            const float x = left.m[row][0];
+            const float y = left.m[row][1];
+            const float z = left.m[row][2];
+            const float w = left.m[row][3];
+            temp.m[row][0] = x * right.m[0][0] + y * right.m[1][0] + z * right.m[2][0] + w * right.m[3][0];
+            temp.m[row][1] = x * right.m[0][1] + y * right.m[1][1] + z * right.m[2][1] + w * right.m[3][1];
+            temp.m[row][2] = x * right.m[0][2] + y * right.m[1][2] + z * right.m[2][2] + w * right.m[3][2];
+            temp.m[row][3] = x * right.m[0][3] + y * right.m[1][3] + z * right.m[2][3] + w * right.m[3][3];
+        }
+
+        *result = temp;
+    }
+
+    Matrix4x4 Matrix4x4::Multiply(const Matrix4x4& left, const Matrix4x4& right)
+    {
+        Matrix4x4 result;
+        Multiply(left, right, &result);
+        return result;
+    }
+
+    void Matrix4x4::CreateTransform(const Vector3& translation, const Quaternion& rotation, const Vector3& scale, Matrix4x4* result)
+    {
+        ALIMER_ASSERT(result);
+
+        const float xx = rotation.x * rotation.x;
+        const float yy = rotation.y * rotation.y;
+        const float zz = rotation.z * rotation.z;
+        const float xy = rotation.x * rotation.y;
+        const float xz = rotation.x * rotation.z;
+        const float yz = rotation.y * rotation.z;
+        const float wx = rotation.w * rotation.x;
+        const float wy = rotation.w * rotation.y;
+        const float wz = rotation.w * rotation.z;
+
+        result->_11 = (1.0f - 2.0f * (yy + zz)) * scale.x;
+        result->_12 = 2.0f * (xy + wz) * scale.x;
+        result->_13 = 2.0f * (xz - wy) * scale.x;
+        result->_14 = 0.0f;
+
+        result->_21 = 2.0f * (xy - wz) * scale.y;
+        result->_22 = (1.0f - 2.0f * (xx + zz)) * scale.y;
+        result->_23 = 2.0f * (yz + wx) * scale.y;
+        result->_24 = 0.0f;
+
+        result->_31 = 2.0f * (xz + wy) * scale.z;
+        result->_32 = 2.0f * (yz - wx) * scale.z;
+        result->_33 = (1.0f - 2.0f * (xx + yy)) * scale.z;
+        result->_34 = 0.0f;
+
+        result->_41 = translation.x;
+        result->_42 = translation.y;
+        result->_43 = translation.z;
+        result->_44 = 1.0f;
     }
+
+    Matrix4x4 Matrix4x4::CreateTransform(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+    {
+        Matrix4x4 result;
+        CreateTransform(translation, rotation, scale, &result);
+        return result;
+    }
+}
@@ -91,6 +91,16 @@ namespace Alimer
         float operator() (size_t row, size_t column) const { return m[row][column]; }
         float& operator() (size_t row, size_t column) { return m[row][column]; }
 
+        /// Multiply with matrix, applies this transformation first.
+        Matrix4x4 operator *(const Matrix4x4& rhs) const { return Multiply(*this, rhs); }
+
+        static void Multiply(const Matrix4x4& left, const Matrix4x4& right, Matrix4x4* result);
+        static Matrix4x4 Multiply(const Matrix4x4& left, const Matrix4x4& right);
+
+        /// Create transformation applying scale, rotation and translation in that order.
+        static void CreateTransform(const Vector3& translation, const Quaternion& rotation, const Vector3& scale, Matrix4x4* result);
+        static Matrix4x4 CreateTransform(const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
+
         static void CreatePerspectiveFieldOfView(float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance, Matrix4x4* result);
         static Matrix4x4 CreatePerspectiveFieldOfView(float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance);
 
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/Vector3.h"
+
+namespace Alimer
+{
+    /// Defines a plane in 3D space, points p on the plane satisfy Dot(normal, p) + d = 0.
+    class ALIMER_API Plane
+    {
+    public:
+        /// The plane normal.
+        Vector3 normal;
+
+        /// Distance of the plane from the origin along the normal, negated.
+        float d;
+
+        Plane() noexcept : normal(0.0f, 1.0f, 0.0f), d(0.0f) {}
+
+        Plane(const Plane&) = default;
+        Plane& operator=(const Plane&) = default;
+
+        Plane(Plane&&) = default;
+        Plane& operator=(Plane&&) = default;
+
+        constexpr Plane(const Vector3& normal_, float d_) : normal(normal_), d(d_) {}
+        constexpr Plane(float a, float b, float c, float d_) : normal(a, b, c), d(d_) {}
+
+        /// Construct from normal and point on the plane.
+        Plane(const Vector3& normal_, const Vector3& point) : normal(normal_), d(-Vector3::Dot(normal_, point)) {}
+
+        // Comparison operators
+        bool operator == (const Plane& rhs) const { return normal == rhs.normal && d == rhs.d; }
+        bool operator != (const Plane& rhs) const { return normal != rhs.normal || d != rhs.d; }
+
+        /// Normalize the plane so that the normal has unit length.
+        void Normalize();
+
+        /// Return signed distance of point from the plane, assumes normalized plane.
+        float Distance(const Vector3& point) const { return Vector3::Dot(normal, point) + d; }
+    };
+}
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Math/Ray.h"
+#include "../Math/BoundingBox.h"
+#include "../Math/Sphere.h"
+#include "../Math/MathUtil.h"
+
+namespace Alimer
+{
+    bool Ray::Intersects(const BoundingBox& box, float* distance) const
+    {
+        // Slab test, axes parallel to the ray only need the origin inside the slab.
+        float tmin = 0.0f;
+        float tmax = std::numeric_limits<float>::max();
+
+        const float* rayOrigin = origin.Data();
+        const float* rayDirection = direction.Data();
+        const float* boxMin = box.min.Data();
+        const float* boxMax = box.max.Data();
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            if (Abs(rayDirection[axis]) < M_EPSILON)
+            {
+                if (rayOrigin[axis] < boxMin[axis] || rayOrigin[axis] > boxMax[axis])
+                    return false;
+            }
+            else
+            {
+                const float invDirection = 1.0f / rayDirection[axis];
+                float t1 = (boxMin[axis] - rayOrigin[axis]) * invDirection;
+                float t2 = (boxMax[axis] - rayOrigin[axis]) * invDirection;
+                if (t1 > t2)
+                {
+                    float temp = t1;
+                    t1 = t2;
+                    t2 = temp;
+                }
+
+                tmin = Max(tmin, t1);
+                tmax = Min(tmax, t2);
+                if (tmin > tmax)
+                    return false;
+            }
+        }
+
+        if (distance)
+        {
+            *distance = tmin;
+        }
+
+        return true;
+    }
+
+    bool Ray::Intersects(const Sphere& sphere, float* distance) const
+    {
+        const Vector3 offset = origin - sphere.center;
+        const float b = Vector3::Dot(offset, direction);
+        const float c = offset.LengthSquared() - sphere.radius * sphere.radius;
+
+        // Origin outside and pointing away.
+        if (c > 0.0f && b > 0.0f)
+            return false;
+
+        const float discriminant = b * b - c;
+        if (discriminant < 0.0f)
+            return false;
+
+        if (distance)
+        {
+            *distance = Max(-b - sqrtf(discriminant), 0.0f);
+        }
+
+        return true;
+    }
+}
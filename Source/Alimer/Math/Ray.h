@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/Vector3.h"
+
+namespace Alimer
+{
+    class BoundingBox;
+    class Sphere;
+
+    /// Defines a ray with origin and direction.
+    class ALIMER_API Ray
+    {
+    public:
+        /// The ray origin.
+        Vector3 origin;
+
+        /// The ray direction, expected to be normalized.
+        Vector3 direction;
+
+        Ray() noexcept : origin(Vector3::Zero), direction(Vector3::Forward) {}
+
+        Ray(const Ray&) = default;
+        Ray& operator=(const Ray&) = default;
+
+        Ray(Ray&&) = default;
+        Ray& operator=(Ray&&) = default;
+
+        constexpr Ray(const Vector3& origin_, const Vector3& direction_) : origin(origin_), direction(direction_) {}
+
+        // Comparison operators
+        bool operator == (const Ray& rhs) const { return origin == rhs.origin && direction == rhs.direction; }
+        bool operator != (const Ray& rhs) const { return origin != rhs.origin || direction != rhs.direction; }
+
+        /// Return point at distance along the ray.
+        Vector3 GetPoint(float distance) const { return origin + direction * distance; }
+
+        /// Return true if the ray hits the box, distance receives the entry distance (0 when starting inside).
+        bool Intersects(const BoundingBox& box, float* distance = nullptr) const;
+
+        /// Return true if the ray hits the sphere, distance receives the entry distance (0 when starting inside).
+        bool Intersects(const Sphere& sphere, float* distance = nullptr) const;
+    };
+}
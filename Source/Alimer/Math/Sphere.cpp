@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Math/Sphere.h"
+#include "../Math/BoundingBox.h"
+#include "../Math/MathUtil.h"
+
+namespace Alimer
+{
+    bool Sphere::Contains(const Vector3& point) const
+    {
+        return (point - center).LengthSquared() <= radius * radius;
+    }
+
+    bool Sphere::Intersects(const Sphere& sphere) const
+    {
+        float radiusSum = radius + sphere.radius;
+        return (sphere.center - center).LengthSquared() <= radiusSum * radiusSum;
+    }
+
+    bool Sphere::Intersects(const BoundingBox& box) const
+    {
+        // Distance from the center to the closest point of the box.
+        Vector3 closest(
+            Clamp(center.x, box.min.x, box.max.x),
+            Clamp(center.y, box.min.y, box.max.y),
+            Clamp(center.z, box.min.z, box.max.z));
+        return (closest - center).LengthSquared() <= radius * radius;
+    }
+}
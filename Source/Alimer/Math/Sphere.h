@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/Vector3.h"
+
+namespace Alimer
+{
+    class BoundingBox;
+
+    /// Defines a bounding sphere.
+    class ALIMER_API Sphere
+    {
+    public:
+        /// The sphere center.
+        Vector3 center;
+
+        /// The sphere radius.
+        float radius;
+
+        Sphere() noexcept : center(Vector3::Zero), radius(0.0f) {}
+
+        Sphere(const Sphere&) = default;
+        Sphere& operator=(const Sphere&) = default;
+
+        Sphere(Sphere&&) = default;
+        Sphere& operator=(Sphere&&) = default;
+
+        constexpr Sphere(const Vector3& center_, float radius_) : center(center_), radius(radius_) {}
+
+        // Comparison operators
+        bool operator == (const Sphere& rhs) const { return center == rhs.center && radius == rhs.radius; }
+        bool operator != (const Sphere& rhs) const { return center != rhs.center || radius != rhs.radius; }
+
+        /// Return true if the point is inside.
+        bool Contains(const Vector3& point) const;
+
+        /// Return true if the spheres overlap.
+        bool Intersects(const Sphere& sphere) const;
+
+        /// Return true if the box overlaps.
+        bool Intersects(const BoundingBox& box) const;
+    };
+}
@@ -0,0 +1,200 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Math/TransformBatch.h"
+
+#if ALIMER_AVX2
+#   include <immintrin.h>
+#elif ALIMER_SSE2
+#   include <emmintrin.h>
+#elif ALIMER_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace Alimer
+{
+#if ALIMER_AVX2
+    using SimdFloat = __m256;
+    static constexpr uint32_t SimdWidth = 8;
+    static ALIMER_FORCE_INLINE SimdFloat SimdLoad(const float* data) { return _mm256_loadu_ps(data); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdReplicate(float value) { return _mm256_set1_ps(value); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { return _mm256_add_ps(a, b); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdSubtract(SimdFloat a, SimdFloat b) { return _mm256_sub_ps(a, b); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdMultiply(SimdFloat a, SimdFloat b) { return _mm256_mul_ps(a, b); }
+#elif ALIMER_SSE2
+    using SimdFloat = __m128;
+    static constexpr uint32_t SimdWidth = 4;
+    static ALIMER_FORCE_INLINE SimdFloat SimdLoad(const float* data) { return _mm_loadu_ps(data); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdReplicate(float value) { return _mm_set1_ps(value); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { return _mm_add_ps(a, b); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdSubtract(SimdFloat a, SimdFloat b) { return _mm_sub_ps(a, b); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdMultiply(SimdFloat a, SimdFloat b) { return _mm_mul_ps(a, b); }
+#elif ALIMER_NEON
+    using SimdFloat = float32x4_t;
+    static constexpr uint32_t SimdWidth = 4;
+    static ALIMER_FORCE_INLINE SimdFloat SimdLoad(const float* data) { return vld1q_f32(data); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdReplicate(float value) { return vdupq_n_f32(value); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { return vaddq_f32(a, b); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdSubtract(SimdFloat a, SimdFloat b) { return vsubq_f32(a, b); }
+    static ALIMER_FORCE_INLINE SimdFloat SimdMultiply(SimdFloat a, SimdFloat b) { return vmulq_f32(a, b); }
+#else
+    static constexpr uint32_t SimdWidth = 1;
+#endif
+
+#if ALIMER_SSE2
+    /// Transpose four SoA registers into four matrix rows and store them into consecutive matrices.
+    static ALIMER_FORCE_INLINE void StoreRows(__m128 x, __m128 y, __m128 z, __m128 w, uint32_t row, Matrix4x4* results)
+    {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(results[0].m[row], x);
+        _mm_storeu_ps(results[1].m[row], y);
+        _mm_storeu_ps(results[2].m[row], z);
+        _mm_storeu_ps(results[3].m[row], w);
+    }
+#elif ALIMER_NEON
+    static ALIMER_FORCE_INLINE void StoreRows(float32x4_t x, float32x4_t y, float32x4_t z, float32x4_t w, uint32_t row, Matrix4x4* results)
+    {
+        float32x4x2_t xy = vtrnq_f32(x, y);
+        float32x4x2_t zw = vtrnq_f32(z, w);
+        vst1q_f32(results[0].m[row], vcombine_f32(vget_low_f32(xy.val[0]), vget_low_f32(zw.val[0])));
+        vst1q_f32(results[1].m[row], vcombine_f32(vget_low_f32(xy.val[1]), vget_low_f32(zw.val[1])));
+        vst1q_f32(results[2].m[row], vcombine_f32(vget_high_f32(xy.val[0]), vget_high_f32(zw.val[0])));
+        vst1q_f32(results[3].m[row], vcombine_f32(vget_high_f32(xy.val[1]), vget_high_f32(zw.val[1])));
+    }
+#endif
+
+#if ALIMER_AVX2
+    static ALIMER_FORCE_INLINE void StoreRows(__m256 x, __m256 y, __m256 z, __m256 w, uint32_t row, Matrix4x4* results)
+    {
+        StoreRows(_mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z), _mm256_castps256_ps128(w), row, results);
+        StoreRows(_mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1), row, results + 4);
+    }
+#endif
+
+    void TransformBatch::Clear()
+    {
+        _translationX.clear();
+        _translationY.clear();
+        _translationZ.clear();
+        _rotationX.clear();
+        _rotationY.clear();
+        _rotationZ.clear();
+        _rotationW.clear();
+        _scaleX.clear();
+        _scaleY.clear();
+        _scaleZ.clear();
+    }
+
+    void TransformBatch::Reserve(uint32_t capacity)
+    {
+        _translationX.reserve(capacity);
+        _translationY.reserve(capacity);
+        _translationZ.reserve(capacity);
+        _rotationX.reserve(capacity);
+        _rotationY.reserve(capacity);
+        _rotationZ.reserve(capacity);
+        _rotationW.reserve(capacity);
+        _scaleX.reserve(capacity);
+        _scaleY.reserve(capacity);
+        _scaleZ.reserve(capacity);
+    }
+
+    uint32_t TransformBatch::Add(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+    {
+        uint32_t index = GetCount();
+        _translationX.push_back(translation.x);
+        _translationY.push_back(translation.y);
+        _translationZ.push_back(translation.z);
+        _rotationX.push_back(rotation.x);
+        _rotationY.push_back(rotation.y);
+        _rotationZ.push_back(rotation.z);
+        _rotationW.push_back(rotation.w);
+        _scaleX.push_back(scale.x);
+        _scaleY.push_back(scale.y);
+        _scaleZ.push_back(scale.z);
+        return index;
+    }
+
+    void TransformBatch::ComputeMatrices(Matrix4x4* results) const
+    {
+        const uint32_t count = GetCount();
+        uint32_t i = 0;
+
+#if ALIMER_SSE2 || ALIMER_NEON
+        const SimdFloat zero = SimdReplicate(0.0f);
+        const SimdFloat one = SimdReplicate(1.0f);
+
+        for (; i + SimdWidth <= count; i += SimdWidth)
+        {
+            const SimdFloat x = SimdLoad(&_rotationX[i]);
+            const SimdFloat y = SimdLoad(&_rotationY[i]);
+            const SimdFloat z = SimdLoad(&_rotationZ[i]);
+            const SimdFloat w = SimdLoad(&_rotationW[i]);
+            const SimdFloat x2 = SimdAdd(x, x);
+            const SimdFloat y2 = SimdAdd(y, y);
+            const SimdFloat z2 = SimdAdd(z, z);
+
+            const SimdFloat xx = SimdMultiply(x, x2);
+            const SimdFloat yy = SimdMultiply(y, y2);
+            const SimdFloat zz = SimdMultiply(z, z2);
+            const SimdFloat xy = SimdMultiply(x, y2);
+            const SimdFloat xz = SimdMultiply(x, z2);
+            const SimdFloat yz = SimdMultiply(y, z2);
+            const SimdFloat wx = SimdMultiply(w, x2);
+            const SimdFloat wy = SimdMultiply(w, y2);
+            const SimdFloat wz = SimdMultiply(w, z2);
+
+            const SimdFloat scaleX = SimdLoad(&_scaleX[i]);
+            const SimdFloat scaleY = SimdLoad(&_scaleY[i]);
+            const SimdFloat scaleZ = SimdLoad(&_scaleZ[i]);
+
+            const SimdFloat m11 = SimdMultiply(SimdSubtract(one, SimdAdd(yy, zz)), scaleX);
+            const SimdFloat m12 = SimdMultiply(SimdAdd(xy, wz), scaleX);
+            const SimdFloat m13 = SimdMultiply(SimdSubtract(xz, wy), scaleX);
+
+            const SimdFloat m21 = SimdMultiply(SimdSubtract(xy, wz), scaleY);
+            const SimdFloat m22 = SimdMultiply(SimdSubtract(one, SimdAdd(xx, zz)), scaleY);
+            const SimdFloat m23 = SimdMultiply(SimdAdd(yz, wx), scaleY);
+
+            const SimdFloat m31 = SimdMultiply(SimdAdd(xz, wy), scaleZ);
+            const SimdFloat m32 = SimdMultiply(SimdSubtract(yz, wx), scaleZ);
+            const SimdFloat m33 = SimdMultiply(SimdSubtract(one, SimdAdd(xx, yy)), scaleZ);
+
+            StoreRows(m11, m12, m13, zero, 0, results + i);
+            StoreRows(m21, m22, m23, zero, 1, results + i);
+            StoreRows(m31, m32, m33, zero, 2, results + i);
+            StoreRows(SimdLoad(&_translationX[i]), SimdLoad(&_translationY[i]), SimdLoad(&_translationZ[i]), one, 3, results + i);
+        }
+#endif
+
+        // Remaining transforms that don't fill a whole register.
+        for (; i < count; ++i)
+        {
+            Matrix4x4::CreateTransform(
+                Vector3(_translationX[i], _translationY[i], _translationZ[i]),
+                Quaternion(_rotationX[i], _rotationY[i], _rotationZ[i], _rotationW[i]),
+                Vector3(_scaleX[i], _scaleY[i], _scaleZ[i]),
+                &results[i]);
+        }
+    }
+}
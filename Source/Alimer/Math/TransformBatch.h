@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/Matrix4x4.h"
+#include "../Math/Quaternion.h"
+#include <vector>
+
+namespace Alimer
+{
+    /// Stores local transforms as structure of arrays and composes them into matrices several at a time using SIMD.
+    class ALIMER_API TransformBatch final
+    {
+    public:
+        /// Constructor.
+        TransformBatch() = default;
+
+        /// Remove all transforms.
+        void Clear();
+
+        /// Reserve storage for given number of transforms.
+        void Reserve(uint32_t capacity);
+
+        /// Add transform, returns its index in the batch.
+        uint32_t Add(const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
+
+        /// Return number of transforms.
+        uint32_t GetCount() const { return static_cast<uint32_t>(_translationX.size()); }
+
+        /// Compose all transforms into results, same output as Matrix4x4::CreateTransform.
+        void ComputeMatrices(Matrix4x4* results) const;
+
+    private:
+        std::vector<float> _translationX;
+        std::vector<float> _translationY;
+        std::vector<float> _translationZ;
+        std::vector<float> _rotationX;
+        std::vector<float> _rotationY;
+        std::vector<float> _rotationZ;
+        std::vector<float> _rotationW;
+        std::vector<float> _scaleX;
+        std::vector<float> _scaleY;
+        std::vector<float> _scaleZ;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(TransformBatch);
+    };
+}
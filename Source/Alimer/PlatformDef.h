@@ -142,6 +142,7 @@
 * SIMD defines
 */
 #define ALIMER_SSE2 0
+#define ALIMER_AVX2 0
 #define ALIMER_NEON 0
 #define ALIMER_VMX 0
 
@@ -149,7 +150,11 @@
 #	undef ALIMER_SSE2
 #	define ALIMER_SSE2 1
 #endif
-#if defined(_M_ARM) || defined(__ARM_NEON__)
+#if defined(__AVX2__)
+#	undef ALIMER_AVX2
+#	define ALIMER_AVX2 1
+#endif
+#if defined(_M_ARM) || defined(_M_ARM64) || defined(__ARM_NEON__) || defined(__ARM_NEON)
 #	undef ALIMER_NEON
 #	define ALIMER_NEON 1
 #endif
@@ -22,17 +22,31 @@
 
 #pragma once
 
-#include "../AlimerConfig.h"
+#include "../Graphics/Shader.h"
 
 namespace Alimer
 {
-	/// Defines a Material.
-    class ALIMER_API Material
+	/// Defines a Material, reference counted so renderables sharing it keep it alive.
+    class ALIMER_API Material : public RefCounted
 	{
     public:
         Material();
         ~Material() = default;
 
+        /// Set shader used to draw with this material.
+        void SetShader(Shader* shader) { _shader = shader; }
+
+        /// Return shader used to draw with this material.
+        Shader* GetShader() const { return _shader.Get(); }
+
+        /// Set whether the material is blended and drawn back to front after opaque geometry.
+        void SetTransparent(bool transparent) { _transparent = transparent; }
+
+        /// Return true if the material is blended.
+        bool IsTransparent() const { return _transparent; }
+
     private:
+        SharedPtr<Shader> _shader;
+        bool _transparent = false;
 	};
 }
@@ -23,6 +23,8 @@
 #pragma once
 
 #include "../Resource/Resource.h"
+#include "../Graphics/VertexBuffer.h"
+#include "../Graphics/IndexBuffer.h"
 
 namespace Alimer
 {
@@ -37,8 +39,29 @@ namespace Alimer
         Mesh(Graphics* graphics);
         ~Mesh() = default;
 
+        /// Set vertex buffer.
+        void SetVertexBuffer(VertexBuffer* buffer) { _vertexBuffer = buffer; }
+
+        /// Return vertex buffer.
+        VertexBuffer* GetVertexBuffer() const { return _vertexBuffer.Get(); }
+
+        /// Set index buffer, the mesh is drawn non indexed without one.
+        void SetIndexBuffer(IndexBuffer* buffer) { _indexBuffer = buffer; }
+
+        /// Return index buffer.
+        IndexBuffer* GetIndexBuffer() const { return _indexBuffer.Get(); }
+
+        /// Set primitive topology.
+        void SetPrimitiveTopology(PrimitiveTopology topology) { _topology = topology; }
+
+        /// Return primitive topology.
+        PrimitiveTopology GetPrimitiveTopology() const { return _topology; }
+
     private:
         /// Graphics subsystem.
         WeakPtr<Graphics> _graphics;
+        SharedPtr<VertexBuffer> _vertexBuffer;
+        SharedPtr<IndexBuffer> _indexBuffer;
+        PrimitiveTopology _topology = PrimitiveTopology::Triangles;
 	};
 }
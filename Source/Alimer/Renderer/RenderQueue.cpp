@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Renderer/RenderQueue.h"
+#include "../Renderer/Material.h"
+#include "../Renderer/Mesh.h"
+#include "../Scene/Components/Renderable.h"
+#include <cstring>
+
+namespace Alimer
+{
+    static uint64_t GetPointerBits(const void* pointer, uint32_t bits)
+    {
+        // Fibonacci hashing spreads the pointer over the key field, collisions only cost batching.
+        const uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)) * 0x9E3779B97F4A7C15ull;
+        return pointer ? (value >> (64 - bits)) : 0;
+    }
+
+    static uint32_t GetDepthBits(float depth)
+    {
+        // Bit pattern of non negative floats is ordered like their value.
+        if (!(depth > 0.0f))
+            return 0;
+
+        uint32_t bits;
+        memcpy(&bits, &depth, sizeof(bits));
+        return bits;
+    }
+
+    uint64_t RenderQueue::GetSortKey(RenderPassType pass, const Shader* shader, const Material* material, const Mesh* mesh, float depth)
+    {
+        const uint64_t passBits = static_cast<uint64_t>(pass) << 60;
+        if (pass == RenderPassType::Opaque)
+        {
+            // pass:4 | shader:12 | material:16 | mesh:16 | depth:16
+            return passBits
+                | (GetPointerBits(shader, 12) << 48)
+                | (GetPointerBits(material, 16) << 32)
+                | (GetPointerBits(mesh, 16) << 16)
+                | (GetDepthBits(depth) >> 16);
+        }
+
+        // pass:4 | inverted depth:32 | shader:8 | material:10 | mesh:10
+        return passBits
+            | (static_cast<uint64_t>(~GetDepthBits(depth)) << 28)
+            | (GetPointerBits(shader, 8) << 20)
+            | (GetPointerBits(material, 10) << 10)
+            | GetPointerBits(mesh, 10);
+    }
+
+    void RenderQueue::Clear()
+    {
+        _queued.clear();
+        _items.clear();
+        _instances.clear();
+        _batches.clear();
+    }
+
+    void RenderQueue::Reserve(uint32_t count)
+    {
+        _queued.reserve(count);
+        _items.reserve(count);
+        _sortBuffer.reserve(count);
+        _instances.reserve(count);
+    }
+
+    void RenderQueue::Push(const RenderableInfo& info, float depth)
+    {
+        const Material* material = info.renderable->GetMaterial();
+        const Shader* shader = material ? material->GetShader() : nullptr;
+        const RenderPassType pass = (material && material->IsTransparent()) ? RenderPassType::Transparent : RenderPassType::Opaque;
+
+        SortItem item;
+        item.key = GetSortKey(pass, shader, material, info.renderable->GetMesh(), depth);
+        item.index = static_cast<uint32_t>(_queued.size());
+        _items.push_back(item);
+        _queued.push_back(info);
+    }
+
+    void RenderQueue::Sort()
+    {
+        RadixSort();
+        BuildBatches();
+    }
+
+    void RenderQueue::RadixSort()
+    {
+        const size_t count = _items.size();
+        if (count < 2)
+            return;
+
+        // Histogram all eight byte digits in a single pass over the keys.
+        uint32_t histograms[8][256];
+        memset(histograms, 0, sizeof(histograms));
+        for (const SortItem& item : _items)
+        {
+            for (uint32_t digit = 0; digit < 8; ++digit)
+            {
+                histograms[digit][(item.key >> (digit * 8)) & 0xFF]++;
+            }
+        }
+
+        _sortBuffer.resize(count);
+        SortItem* source = _items.data();
+        SortItem* dest = _sortBuffer.data();
+        for (uint32_t digit = 0; digit < 8; ++digit)
+        {
+            uint32_t* histogram = histograms[digit];
+            const uint32_t shift = digit * 8;
+
+            // Skip digits shared by every key, common for pass and state bits.
+            if (histogram[(source[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t bucket = 0; bucket < 256; ++bucket)
+            {
+                const uint32_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                dest[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+            }
+
+            std::swap(source, dest);
+        }
+
+        if (source != _items.data())
+        {
+            _items.swap(_sortBuffer);
+        }
+    }
+
+    void RenderQueue::BuildBatches()
+    {
+        _instances.clear();
+        _batches.clear();
+
+        const RenderableComponent* previous = nullptr;
+        for (const SortItem& item : _items)
+        {
+            const RenderableInfo& info = _queued[item.index];
+            const RenderableComponent* renderable = info.renderable;
+
+            // Renderables sharing mesh and material become instances of a single draw.
+            if (previous
+                && renderable->GetMesh() != nullptr
+                && renderable->GetMesh() == previous->GetMesh()
+                && renderable->GetMaterial() == previous->GetMaterial())
+            {
+                _batches.back().count++;
+            }
+            else
+            {
+                const Material* material = renderable->GetMaterial();
+                RenderBatch batch;
+                batch.shader = material ? material->GetShader() : nullptr;
+                batch.start = static_cast<uint32_t>(_instances.size());
+                batch.count = 1;
+                _batches.push_back(batch);
+            }
+
+            _instances.push_back(info);
+            previous = renderable;
+        }
+    }
+}
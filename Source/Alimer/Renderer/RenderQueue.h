@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Scene/Scene.h"
+#include <vector>
+
+namespace Alimer
+{
+    class Shader;
+    class Material;
+    class Mesh;
+
+    /// Defines the pass renderables are queued in, stored in the highest sort key bits.
+    enum class RenderPassType : uint8_t
+    {
+        Opaque = 0,
+        Transparent = 1
+    };
+
+    /// Defines a run of sorted renderables sharing shader, material and mesh, drawn with one instanced draw.
+    struct RenderBatch
+    {
+        Shader* shader;
+        uint32_t start;
+        uint32_t count;
+    };
+
+    /// Queue of renderables ordered by 64-bit sort key and merged into instanced batches.
+    class ALIMER_API RenderQueue final
+    {
+    public:
+        RenderQueue() = default;
+        ~RenderQueue() = default;
+
+        /// Clear queued renderables and batches.
+        void Clear();
+
+        /// Reserve space for given number of renderables.
+        void Reserve(uint32_t count);
+
+        /// Queue renderable at given view space depth.
+        void Push(const RenderableInfo& info, float depth);
+
+        /// Sort queued renderables by key and build the batches.
+        void Sort();
+
+        /// Return number of queued renderables.
+        uint32_t GetCount() const { return static_cast<uint32_t>(_items.size()); }
+
+        /// Return renderables in sorted order, valid after Sort.
+        const std::vector<RenderableInfo>& GetInstances() const { return _instances; }
+
+        /// Return batches of the sorted renderables, valid after Sort.
+        const std::vector<RenderBatch>& GetBatches() const { return _batches; }
+
+        /// Compute sort key, opaque keys are ordered by state then front to back, transparent keys back to front.
+        static uint64_t GetSortKey(RenderPassType pass, const Shader* shader, const Material* material, const Mesh* mesh, float depth);
+
+    private:
+        struct SortItem
+        {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        void RadixSort();
+        void BuildBatches();
+
+        std::vector<RenderableInfo> _queued;
+        std::vector<SortItem> _items;
+        std::vector<SortItem> _sortBuffer;
+        std::vector<RenderableInfo> _instances;
+        std::vector<RenderBatch> _batches;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(RenderQueue);
+    };
+}
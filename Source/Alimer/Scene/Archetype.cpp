@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Scene/Archetype.h"
+#include "../Math/MathUtil.h"
+#include <algorithm>
+#include <cstddef>
+
+namespace Alimer
+{
+    ArchetypeChunk::ArchetypeChunk(uint32_t size, uint32_t capacity)
+        : _memory(new uint8_t[size])
+        , _capacity(capacity)
+    {
+    }
+
+    Archetype::Archetype(Hash hash, const std::vector<ArchetypeComponentInfo>& components, uint32_t chunkSize)
+        : _hash(hash)
+        , _components(components)
+        , _chunkSize(chunkSize)
+    {
+        ALIMER_ASSERT(_components.size() <= MaxComponents);
+        _offsets.resize(_components.size());
+
+        uint32_t stride = sizeof(Entity*) + sizeof(uint32_t);
+        for (auto& component : _components)
+        {
+            ALIMER_ASSERT(component.alignment <= alignof(std::max_align_t));
+            stride += component.size;
+        }
+
+        // Start from the packed estimate and shrink until the aligned layout fits inside the chunk.
+        _chunkCapacity = Max(chunkSize / stride, 1u);
+        while (_chunkCapacity > 1 && ComputeLayout(_chunkCapacity) > chunkSize)
+        {
+            _chunkCapacity--;
+        }
+
+        // Components larger than the chunk get a chunk of their own.
+        _chunkSize = Max(ComputeLayout(_chunkCapacity), chunkSize);
+    }
+
+    uint32_t Archetype::ComputeLayout(uint32_t capacity)
+    {
+        uint32_t offset = capacity * static_cast<uint32_t>(sizeof(Entity*));
+        offset = Align(offset, alignof(uint32_t));
+        _masksOffset = offset;
+        offset += capacity * static_cast<uint32_t>(sizeof(uint32_t));
+
+        for (size_t i = 0; i < _components.size(); ++i)
+        {
+            offset = Align(offset, _components[i].alignment);
+            _offsets[i] = offset;
+            offset += capacity * _components[i].size;
+        }
+
+        return offset;
+    }
+
+    ArchetypeChunk* Archetype::Allocate(Entity* entity, uint32_t* index)
+    {
+        if (_freeChunks.empty())
+        {
+            _chunks.emplace_back(new ArchetypeChunk(_chunkSize, _chunkCapacity));
+            _chunks.back()->_masksOffset = _masksOffset;
+            _freeChunks.push_back(_chunks.back().get());
+        }
+
+        ArchetypeChunk* chunk = _freeChunks.back();
+        uint32_t slot;
+        if (!chunk->_vacants.empty())
+        {
+            slot = chunk->_vacants.back();
+            chunk->_vacants.pop_back();
+        }
+        else
+        {
+            slot = chunk->_count++;
+        }
+
+        chunk->GetEntities()[slot] = entity;
+        chunk->GetMasks()[slot] = 0;
+
+        if (chunk->IsFull())
+        {
+            _freeChunks.pop_back();
+        }
+
+        *index = slot;
+        return chunk;
+    }
+
+    void Archetype::Free(ArchetypeChunk* chunk, uint32_t index)
+    {
+        ALIMER_ASSERT(index < chunk->_count);
+        ALIMER_ASSERT(chunk->GetMasks()[index] == 0);
+
+        const bool wasFull = chunk->IsFull();
+        chunk->GetEntities()[index] = nullptr;
+        if (index == chunk->_count - 1)
+        {
+            chunk->_count--;
+        }
+        else
+        {
+            chunk->_vacants.push_back(index);
+        }
+
+        if (wasFull)
+        {
+            _freeChunks.push_back(chunk);
+        }
+    }
+
+    uint32_t Archetype::GetComponentIndex(uint32_t id) const
+    {
+        for (size_t i = 0; i < _components.size(); ++i)
+        {
+            if (_components[i].id == id)
+                return static_cast<uint32_t>(i);
+        }
+
+        return MaxComponents;
+    }
+
+    bool Archetype::HasComponents(const uint32_t* ids, uint32_t count) const
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!HasComponent(ids[i]))
+                return false;
+        }
+
+        return true;
+    }
+
+    Hash Archetype::ComputeHash(std::vector<uint32_t> ids)
+    {
+        std::sort(ids.begin(), ids.end());
+
+        Hasher hasher;
+        hasher.u32(static_cast<uint32_t>(ids.size()));
+        for (uint32_t id : ids)
+        {
+            hasher.u32(id);
+        }
+        return hasher.get();
+    }
+}
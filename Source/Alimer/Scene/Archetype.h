@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../AlimerConfig.h"
+#include "../Util/HashMap.h"
+#include <vector>
+#include <memory>
+
+namespace Alimer
+{
+    class Entity;
+
+    /// Describes a component type stored inside an Archetype.
+    struct ArchetypeComponentInfo
+    {
+        uint32_t id;
+        uint32_t size;
+        uint32_t alignment;
+    };
+
+    /// Fixed size block of memory holding a number of entities of the same Archetype, stored as structure of arrays.
+    class ALIMER_API ArchetypeChunk final
+    {
+        friend class Archetype;
+
+    public:
+        /// Default size of a chunk in bytes.
+        static constexpr uint32_t DefaultSize = 16 * 1024;
+
+        /// Constructor.
+        ArchetypeChunk(uint32_t size, uint32_t capacity);
+
+        /// Return the number of slots used so far (including vacant ones).
+        uint32_t GetCount() const { return _count; }
+
+        /// Return the number of slots this chunk can hold.
+        uint32_t GetCapacity() const { return _capacity; }
+
+        /// Return the number of live entities.
+        uint32_t GetAliveCount() const { return _count - static_cast<uint32_t>(_vacants.size()); }
+
+        /// Return true if the chunk has no free slots.
+        bool IsFull() const { return _vacants.empty() && _count == _capacity; }
+
+        /// Return the entity array, vacant slots contain nullptr.
+        Entity** GetEntities() const { return reinterpret_cast<Entity**>(_memory.get()); }
+
+        /// Return the per slot mask of constructed components, vacant slots contain 0.
+        uint32_t* GetMasks() const { return reinterpret_cast<uint32_t*>(_memory.get() + _masksOffset); }
+
+        /// Return the start of a component array given its offset inside the chunk.
+        uint8_t* GetData(uint32_t offset) const { return _memory.get() + offset; }
+
+    private:
+        std::unique_ptr<uint8_t[]> _memory;
+        uint32_t _masksOffset = 0;
+        uint32_t _capacity = 0;
+        uint32_t _count = 0;
+        std::vector<uint32_t> _vacants;
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(ArchetypeChunk);
+    };
+
+    /// Defines a unique set of component types, entities sharing the same set are packed together into chunks.
+    class ALIMER_API Archetype final
+    {
+    public:
+        /// Maximum number of component types in one archetype.
+        static constexpr uint32_t MaxComponents = 32;
+
+        /// Constructor.
+        Archetype(Hash hash, const std::vector<ArchetypeComponentInfo>& components, uint32_t chunkSize = ArchetypeChunk::DefaultSize);
+
+        /// Destructor.
+        ~Archetype() = default;
+
+        /// Allocate a slot for given entity, returns the owning chunk and the slot index.
+        ArchetypeChunk* Allocate(Entity* entity, uint32_t* index);
+
+        /// Release the slot, components must be destroyed before.
+        void Free(ArchetypeChunk* chunk, uint32_t index);
+
+        /// Return the index of component inside this archetype or MaxComponents if not found.
+        uint32_t GetComponentIndex(uint32_t id) const;
+
+        /// Return true if the archetype contains given component type.
+        bool HasComponent(uint32_t id) const { return GetComponentIndex(id) != MaxComponents; }
+
+        /// Return true if the archetype contains all given component types.
+        bool HasComponents(const uint32_t* ids, uint32_t count) const;
+
+        /// Return the address of component slot.
+        void* GetComponent(ArchetypeChunk* chunk, uint32_t index, uint32_t componentIndex) const
+        {
+            return chunk->GetData(_offsets[componentIndex]) + index * _components[componentIndex].size;
+        }
+
+        /// Return the offset of component array inside each chunk.
+        uint32_t GetOffset(uint32_t componentIndex) const { return _offsets[componentIndex]; }
+
+        /// Return the unique hash of the component set.
+        Hash GetHash() const { return _hash; }
+
+        /// Return the number of slots per chunk.
+        uint32_t GetChunkCapacity() const { return _chunkCapacity; }
+
+        /// Return the chunks.
+        const std::vector<std::unique_ptr<ArchetypeChunk>>& GetChunks() const { return _chunks; }
+
+        /// Compute the hash of a set of component ids.
+        static Hash ComputeHash(std::vector<uint32_t> ids);
+
+    private:
+        uint32_t ComputeLayout(uint32_t capacity);
+
+        Hash _hash;
+        std::vector<ArchetypeComponentInfo> _components;
+        std::vector<uint32_t> _offsets;
+        uint32_t _masksOffset = 0;
+        uint32_t _chunkSize;
+        uint32_t _chunkCapacity;
+        std::vector<std::unique_ptr<ArchetypeChunk>> _chunks;
+        std::vector<ArchetypeChunk*> _freeChunks;
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(Archetype);
+    };
+}
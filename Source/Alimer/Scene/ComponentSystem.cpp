@@ -22,6 +22,7 @@
 
 #include "../Scene/ComponentSystem.h"
 #include "../Scene/Scene.h"
+#include <algorithm>
 
 namespace Alimer
 {
@@ -37,6 +38,28 @@ namespace Alimer
 
     }
 
+    static bool Intersects(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+    {
+        for (uint32_t id : a)
+        {
+            if (std::find(b.begin(), b.end(), id) != b.end())
+                return true;
+        }
+
+        return false;
+    }
+
+    bool ComponentSystem::ConflictsWith(const ComponentSystem* other) const
+    {
+        // Systems that don't declare access are treated as exclusive.
+        if (!HasDeclaredAccess() || !other->HasDeclaredAccess())
+            return true;
+
+        return Intersects(_writes, other->_writes)
+            || Intersects(_writes, other->_reads)
+            || Intersects(_reads, other->_writes);
+    }
+
     void ComponentSystem::SetScene(Scene* scene)
     {
         _scene = scene;
@@ -22,7 +22,7 @@
 
 #pragma once
 
-#include "../Scene/Component.h"
+#include "../Scene/Entity.h"
 #include <vector>
 #include <typeindex>
 
@@ -53,12 +53,28 @@ namespace Alimer
         /// Gets true if the system is currently active.
         bool IsActive() const { return _active; }
 
+        /// Gets true if the system declared the components it reads or writes.
+        bool HasDeclaredAccess() const { return !_reads.empty() || !_writes.empty(); }
+
+        /// Gets true if this system cannot run concurrently with other system.
+        bool ConflictsWith(const ComponentSystem* other) const;
+
     protected:
         void SetScene(Scene* scene);
 
+        /// Declare that the system reads component of type T during Update.
+        template <typename T>
+        void Reads() { _reads.push_back(ComponentIDMapping::GetId<T>()); }
+
+        /// Declare that the system writes component of type T during Update.
+        template <typename T>
+        void Writes() { _writes.push_back(ComponentIDMapping::GetId<T>()); }
+
         std::type_index _type;
         Scene* _scene;
         bool _active;
+        std::vector<uint32_t> _reads;
+        std::vector<uint32_t> _writes;
 
     private:
         DISALLOW_COPY_MOVE_AND_ASSIGN(ComponentSystem);
@@ -26,22 +26,38 @@
 namespace Alimer
 {
     CameraComponent::CameraComponent()
+        : _view(Matrix4x4::Identity)
+        , _projection(Matrix4x4::Identity)
+        , _viewProjection(Matrix4x4::Identity)
     {
     }
 
-    /*void CameraComponent::Update(const glm::mat4& worldTransform)
+    void CameraComponent::Update(const Matrix4x4& worldTransform)
     {
-        _projection = glm::perspective(glm::radians(_fovy), _aspect, _znear, _zfar);
-        _view = glm::inverse(worldTransform);
+        // Camera looks down negative Z of its world transform.
+        Vector3 position(worldTransform._41, worldTransform._42, worldTransform._43);
+        Vector3 backward(worldTransform._31, worldTransform._32, worldTransform._33);
+        Vector3 up(worldTransform._21, worldTransform._22, worldTransform._23);
+
+        Matrix4x4::CreateLookAt(position, position - backward, up, &_view);
+        Matrix4x4::CreatePerspectiveFieldOfView(ToRadians(_fovy), _aspect, _znear, _zfar, &_projection);
+        Matrix4x4::Multiply(_view, _projection, &_viewProjection);
+        _frustum.Define(_viewProjection);
     }
 
-    glm::mat4 CameraComponent::GetView() const
+    void CameraComponent::SetFieldOfView(float fovy)
     {
-        return _view;
+        _fovy = fovy;
     }
 
-    glm::mat4 CameraComponent::GetProjection() const
+    void CameraComponent::SetAspectRatio(float aspect)
     {
-        return _projection;
-    }*/
+        _aspect = aspect;
+    }
+
+    void CameraComponent::SetClipDistances(float znear, float zfar)
+    {
+        _znear = znear;
+        _zfar = zfar;
+    }
 }
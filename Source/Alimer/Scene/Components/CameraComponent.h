@@ -24,6 +24,7 @@
 
 #include "../../Scene/Component.h"
 #include "../../Math/Matrix4x4.h"
+#include "../../Math/Frustum.h"
 
 namespace Alimer
 {
@@ -34,10 +35,22 @@ namespace Alimer
         CameraComponent();
         ~CameraComponent() = default;
 
-        //void Update(const glm::mat4& worldTransform);
+        /// Update view, projection and frustum from the camera world transform.
+        void Update(const Matrix4x4& worldTransform);
 
-        //glm::mat4 GetView() const;
-        //glm::mat4 GetProjection() const;
+        /// Set vertical field of view in degrees.
+        void SetFieldOfView(float fovy);
+
+        /// Set aspect ratio.
+        void SetAspectRatio(float aspect);
+
+        /// Set near and far clip distances.
+        void SetClipDistances(float znear, float zfar);
+
+        const Matrix4x4& GetView() const { return _view; }
+        const Matrix4x4& GetProjection() const { return _projection; }
+        const Matrix4x4& GetViewProjection() const { return _viewProjection; }
+        const Frustum& GetFrustum() const { return _frustum; }
 
     private:
         // Field of view (in degrees)
@@ -49,5 +62,7 @@ namespace Alimer
         // Calculated values.
         Matrix4x4 _view;
         Matrix4x4 _projection;
+        Matrix4x4 _viewProjection;
+        Frustum _frustum;
 	};
 }
@@ -63,10 +63,10 @@ namespace Alimer
 
     }
 
-    //void TriangleRenderable::Render(CommandBuffer* commandBuffer)
+    //void TriangleRenderable::Render(CommandBuffer* commandBuffer, const RenderableInfo* instances, uint32_t instanceCount)
     //{
         /*commandBuffer->SetVertexBuffer(_vertexBuffer.Get(), 0);
         commandBuffer->SetPipeline(_renderPipeline);
-        commandBuffer->Draw(PrimitiveTopology::Triangles, 3);*/
+        commandBuffer->Draw(PrimitiveTopology::Triangles, 3, instanceCount);*/
     //}
 }
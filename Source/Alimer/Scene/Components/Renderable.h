@@ -24,13 +24,36 @@
 
 #include "../../Scene/Component.h"
 #include "../../Graphics/Graphics.h"
+#include "../../Renderer/Mesh.h"
+#include "../../Renderer/Material.h"
 #include "../../Math/MathUtil.h"
 
 namespace Alimer
 {
+    class CommandBuffer;
+    struct RenderableInfo;
+
     class ALIMER_API RenderableComponent : public Component
     {
     public:
+        /// Set mesh, renderables sharing mesh and material are drawn with a single instanced draw.
+        void SetMesh(Mesh* mesh) { _mesh = mesh; }
+
+        /// Return mesh.
+        Mesh* GetMesh() const { return _mesh.Get(); }
+
+        /// Set material.
+        void SetMaterial(Material* material) { _material = material; }
+
+        /// Return material.
+        Material* GetMaterial() const { return _material.Get(); }
+
+        /// Record draw of the given instances sharing this renderable material, called when the mesh has no vertex buffer.
+        virtual void Render(CommandBuffer* /*commandBuffer*/, const RenderableInfo* /*instances*/, uint32_t /*instanceCount*/) {}
+
+    protected:
+        SharedPtr<Mesh> _mesh;
+        SharedPtr<Material> _material;
     };
 
     class ALIMER_API TriangleRenderable final : public RenderableComponent
@@ -39,7 +62,7 @@ namespace Alimer
         TriangleRenderable();
         virtual ~TriangleRenderable();
 
-        //void Render(CommandBuffer* commandBuffer) override;
+        //void Render(CommandBuffer* commandBuffer, const RenderableInfo* instances, uint32_t instanceCount) override;
     private:
         //SharedPtr<GpuBuffer> _vertexBuffer;
         //SharedPtr<PipelineState> _renderPipeline;
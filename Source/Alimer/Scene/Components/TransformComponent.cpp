@@ -20,12 +20,124 @@
 // THE SOFTWARE.
 //
 
+
 #include "Scene/Components/TransformComponent.h"
+#include "Scene/Scene.h"
+#include <algorithm>
 
 namespace Alimer
 {
     TransformComponent::TransformComponent()
+        : _worldTransform(Matrix4x4::Identity)
+    {
+    }
+
+    TransformComponent::~TransformComponent()
+    {
+        SetParent(nullptr);
+
+        // Orphaned children become roots.
+        for (TransformComponent* child : _children)
+        {
+            child->_parent = nullptr;
+            child->_dirty = true;
+            child->UpdateDepth();
+        }
+
+        // Queries must not see the proxy of a destroyed transform.
+        if (_scene)
+        {
+            _scene->RemoveTransform(this);
+        }
+    }
+
+    void TransformComponent::SetTransform(const Transform& transform)
+    {
+        _transform = transform;
+        _dirty = true;
+    }
+
+    void TransformComponent::SetTranslation(const Vector3& translation)
+    {
+        _transform.translation = translation;
+        _dirty = true;
+    }
+
+    void TransformComponent::SetRotation(const Quaternion& rotation)
+    {
+        _transform.rotation = rotation;
+        _dirty = true;
+    }
+
+    void TransformComponent::SetScale(const Vector3& scale)
     {
-        
+        _transform.scale = scale;
+        _dirty = true;
+    }
+
+    void TransformComponent::SetBoundingBox(const BoundingBox& localBounds)
+    {
+        _localBounds = localBounds;
+        _dirty = true;
+    }
+
+    void TransformComponent::SetParent(TransformComponent* parent)
+    {
+        if (_parent == parent)
+            return;
+
+        // Reject cycles.
+        for (TransformComponent* ancestor = parent; ancestor != nullptr; ancestor = ancestor->_parent)
+        {
+            if (ancestor == this)
+            {
+                ALIMER_ASSERT_MSG(false, "Cannot parent transform to its own descendant");
+                return;
+            }
+        }
+
+        if (_parent)
+        {
+            auto& siblings = _parent->_children;
+            siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+        }
+
+        _parent = parent;
+        if (_parent)
+        {
+            _parent->_children.push_back(this);
+        }
+
+        _dirty = true;
+        UpdateDepth();
+        if (_scene)
+        {
+            _scene->InvalidateTransforms();
+        }
+    }
+
+    void TransformComponent::UpdateDepth()
+    {
+        _depth = _parent ? _parent->_depth + 1 : 0;
+        for (TransformComponent* child : _children)
+        {
+            child->UpdateDepth();
+        }
+    }
+
+    void TransformComponent::SetWorldTransform(const Matrix4x4& localTransform)
+    {
+        if (_parent)
+        {
+            Matrix4x4::Multiply(localTransform, _parent->_worldTransform, &_worldTransform);
+        }
+        else
+        {
+            _worldTransform = localTransform;
+        }
+
+        _worldBounds = _localBounds.Transform(_worldTransform);
+        _dirty = false;
+        _worldChanged = true;
     }
 }
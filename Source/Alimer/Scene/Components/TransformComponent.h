@@ -20,32 +20,102 @@
 // THE SOFTWARE.
 //
 
+
 #pragma once
 
 #include "../../Math/MathUtil.h"
+#include "../../Math/Quaternion.h"
+#include "../../Math/BoundingBox.h"
 #include "../../Scene/Component.h"
+#include <vector>
 
 namespace Alimer
 {
+    class Scene;
+
+    /// Local translation, rotation and scale.
     struct Transform
     {
-        //glm::vec3 scale = glm::vec3(1.0f);
-        //glm::vec3 translation = glm::vec3(0.0f);
-        //glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        Vector3 scale = Vector3::One;
+        Vector3 translation = Vector3::Zero;
+        Quaternion rotation = Quaternion::Identity;
     };
 
 	/// Defines a Transform Component.
     class ALIMER_API TransformComponent : public Component
 	{
+        friend class Scene;
+
     public:
         TransformComponent();
-        virtual ~TransformComponent() = default;
+        virtual ~TransformComponent();
+
+        /// Set local transform.
+        void SetTransform(const Transform& transform);
+
+        /// Set local translation.
+        void SetTranslation(const Vector3& translation);
+
+        /// Set local rotation.
+        void SetRotation(const Quaternion& rotation);
+
+        /// Set local scale.
+        void SetScale(const Vector3& scale);
+
+        /// Return local transform.
+        const Transform& GetTransform() const { return _transform; }
+
+        /// Set parent transform, nullptr detaches from current parent.
+        void SetParent(TransformComponent* parent);
+
+        /// Return parent transform or nullptr.
+        TransformComponent* GetParent() const { return _parent; }
+
+        /// Return child transforms.
+        const std::vector<TransformComponent*>& GetChildren() const { return _children; }
+
+        /// Return depth in the hierarchy, root transforms have depth 0.
+        uint32_t GetDepth() const { return _depth; }
+
+        /// Return cached world matrix, valid after the scene updated transforms.
+        const Matrix4x4& GetWorldTransform() const { return _worldTransform; }
+
+        /// Set bounds in local space, world bounds follow the world matrix.
+        void SetBoundingBox(const BoundingBox& localBounds);
+
+        /// Return bounds in local space.
+        const BoundingBox& GetBoundingBox() const { return _localBounds; }
+
+        /// Return cached world space bounds, valid after the scene updated transforms.
+        const BoundingBox& GetWorldBoundingBox() const { return _worldBounds; }
+
+        /// Return true if the local transform changed since the last update.
+        bool IsDirty() const { return _dirty; }
+
+        /// Return true if the world matrix changed during the last update.
+        bool IsWorldChanged() const { return _worldChanged; }
+
+    private:
+        void UpdateDepth();
 
-        Transform transform;
+        /// Return true if the world matrix must be recomputed during this update.
+        bool NeedsWorldUpdate() const { return _dirty || (_parent && _parent->_worldChanged); }
 
-        //glm::mat4 worldTransform;
+        /// Set world matrix from the local one, parent must have been updated already.
+        void SetWorldTransform(const Matrix4x4& localTransform);
 
-        uint32_t lastTimestamp = ~0u;
-        const uint32_t *currentTimestamp = nullptr;
+        Transform _transform;
+        Matrix4x4 _worldTransform;
+        BoundingBox _localBounds;
+        BoundingBox _worldBounds;
+        TransformComponent* _parent = nullptr;
+        std::vector<TransformComponent*> _children;
+        uint32_t _depth = 0;
+        /// Proxy in the scene spatial index.
+        uint32_t _spatialProxy = ~0u;
+        /// Scene caching this transform, notified when the hierarchy changes.
+        Scene* _scene = nullptr;
+        bool _dirty = true;
+        bool _worldChanged = false;
 	};
 }
@@ -27,6 +27,26 @@ namespace Alimer
 {
     uint32_t ComponentIDMapping::_ids;
     uint32_t ComponentIDMapping::_groupIds;
+    constexpr uint32_t EntityGroupBase::InvalidIndex;
+    const EntityId EntityId::Invalid;
+
+    uint32_t EntityGroupBase::GetIndex(const Entity &entity) const
+    {
+        if (_groupId >= entity._groupIndices.size())
+            return InvalidIndex;
+
+        return entity._groupIndices[_groupId];
+    }
+
+    void EntityGroupBase::SetIndex(Entity &entity, uint32_t index) const
+    {
+        if (_groupId >= entity._groupIndices.size())
+        {
+            entity._groupIndices.resize(_groupId + 1, InvalidIndex);
+        }
+
+        entity._groupIndices[_groupId] = index;
+    }
 
     void Entity::SetName(const std::string& name)
     {
@@ -41,15 +61,34 @@ namespace Alimer
     {
     }
 
-    EntityHandle EntityManager::CreateEntity()
+    EntityId EntityManager::CreateEntity()
     {
-        EntityHandle entity = EntityHandle(_pool.Allocate(this));
-        _entities.push_back(entity.Get());
-        return entity;
+        uint32_t slot;
+        if (!_freeSlots.empty())
+        {
+            slot = _freeSlots.back();
+            _freeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(_slots.size());
+            _slots.push_back({ nullptr, 0 });
+        }
+
+        EntityId id(slot, _slots[slot].generation);
+        Entity* entity = _pool.Allocate(this, id);
+        entity->_index = static_cast<uint32_t>(_entities.size());
+        _entities.push_back(entity);
+        _slots[slot].entity = entity;
+        return id;
     }
 
-    void EntityManager::DeleteEntity(Entity *entity)
+    void EntityManager::DeleteEntity(EntityId id)
     {
+        Entity* entity = GetEntity(id);
+        if (!entity)
+            return;
+
         auto &components = entity->GetComponents();
         for (auto &component : components)
         {
@@ -57,30 +96,83 @@ namespace Alimer
                 FreeComponent(component.first, component.second);
         }
 
-        _pool.Free(entity);
+        if (entity->_archetype)
+        {
+            entity->_archetype->Free(entity->_chunk, entity->_chunkIndex);
+        }
 
-        auto itr = std::find(std::begin(_entities), std::end(_entities), entity);
-        auto offset = size_t(itr - std::begin(_entities));
-        if (offset != _entities.size() - 1)
+        RemoveLooseEntity(*entity);
+
+        uint32_t index = entity->_index;
+        if (index != _entities.size() - 1)
         {
-            std::swap(_entities[offset], _entities.back());
+            _entities[index] = _entities.back();
+            _entities[index]->_index = index;
         }
         _entities.pop_back();
+
+        // Bump the generation so outstanding handles become invalid.
+        _slots[id.index].entity = nullptr;
+        _slots[id.index].generation++;
+        _freeSlots.push_back(id.index);
+
+        _pool.Free(entity);
     }
 
 
     void EntityManager::FreeComponent(uint32_t id, Component *component)
     {
-        _components[id]->FreeComponent(component);
+        Entity* entity = component->_entity;
         for (auto &groupId : _componentToGroups[id])
         {
-            _groups[groupId]->RemoveComponent(component);
+            _groups[groupId]->RemoveEntity(*entity);
+        }
+
+        uint32_t componentIndex = entity->_archetype ? entity->_archetype->GetComponentIndex(id) : Archetype::MaxComponents;
+        if (componentIndex != Archetype::MaxComponents)
+        {
+            // Component lives inside the archetype chunk, destroy in place and keep the slot.
+            component->~Component();
+            entity->_chunk->GetMasks()[entity->_chunkIndex] &= ~(1u << componentIndex);
+        }
+        else
+        {
+            _components[id]->FreeComponent(component);
+        }
+    }
+
+    void EntityManager::AddLooseEntity(Entity &entity)
+    {
+        if (entity._looseIndex != ~0u)
+            return;
+
+        entity._looseIndex = static_cast<uint32_t>(_looseEntities.size());
+        _looseEntities.push_back(&entity);
+    }
+
+    void EntityManager::RemoveLooseEntity(Entity &entity)
+    {
+        uint32_t index = entity._looseIndex;
+        if (index == ~0u)
+            return;
+
+        if (index != _looseEntities.size() - 1)
+        {
+            _looseEntities[index] = _looseEntities.back();
+            _looseEntities[index]->_looseIndex = index;
         }
+        _looseEntities.pop_back();
+        entity._looseIndex = ~0u;
     }
 
     void EntityManager::ResetGroups()
     {
         _componentToGroups.clear();
         _groups.clear();
+
+        for (Entity* entity : _entities)
+        {
+            entity->_groupIndices.clear();
+        }
     }
 }
@@ -31,6 +31,7 @@
 #include "../Core/Object.h"
 #include "../Util/ObjectPool.h"
 #include "../Scene/Component.h"
+#include "../Scene/Archetype.h"
 #include <assert.h>
 
 namespace Alimer
@@ -60,47 +61,71 @@ namespace Alimer
         static uint32_t _groupIds;
     };
 
-    /// Defines a base ComponentSystem.
+    /// Defines a base EntityGroup, entities store their dense index inside each group they belong to.
     class ALIMER_API EntityGroupBase
     {
     public:
+        static constexpr uint32_t InvalidIndex = ~0u;
+
+        /// Constructor.
+        explicit EntityGroupBase(uint32_t groupId) : _groupId(groupId) {}
+
         /// Destructor.
         virtual ~EntityGroupBase() = default;
 
         virtual void AddEntity(Entity &entity) = 0;
-        virtual void RemoveComponent(Component *component) = 0;
+        virtual void RemoveEntity(Entity &entity) = 0;
+
+    protected:
+        /// Return the dense index of entity inside this group or InvalidIndex.
+        uint32_t GetIndex(const Entity &entity) const;
+
+        /// Set the dense index of entity inside this group.
+        void SetIndex(Entity &entity, uint32_t index) const;
+
+        uint32_t _groupId;
     };
 
     template <typename... T>
     class EntityGroup : public EntityGroupBase
     {
     public:
+        explicit EntityGroup(uint32_t groupId) : EntityGroupBase(groupId) {}
+
         void AddEntity(Entity &entity) override final
         {
-            if (HasAllComponents<T...>(entity))
+            if (!HasAllComponents<T...>(entity))
+                return;
+
+            uint32_t index = GetIndex(entity);
+            if (index != InvalidIndex)
             {
-                _entities.push_back(&entity);
-                _groups.push_back(std::make_tuple(entity.GetComponent<T>()...));
+                // Already in the group, refresh the pointers in case a component got replaced.
+                _groups[index] = std::make_tuple(entity.template GetComponent<T>()...);
+                return;
             }
+
+            SetIndex(entity, static_cast<uint32_t>(_entities.size()));
+            _entities.push_back(&entity);
+            _groups.push_back(std::make_tuple(entity.template GetComponent<T>()...));
         }
 
-        void RemoveComponent(Component *component) override final
+        void RemoveEntity(Entity &entity) override final
         {
-            auto itr = std::find_if(std::begin(_groups), std::end(_groups), [&](const std::tuple<T*...> &t) {
-                return HasComponent(t, component);
-            });
-
-            if (itr == std::end(_groups))
+            uint32_t index = GetIndex(entity);
+            if (index == InvalidIndex)
                 return;
 
-            auto offset = size_t(itr - begin(_groups));
-            if (offset != _groups.size() - 1)
+            uint32_t last = static_cast<uint32_t>(_entities.size() - 1);
+            if (index != last)
             {
-                std::swap(_groups[offset], _groups.back());
-                std::swap(_entities[offset], _entities.back());
+                _groups[index] = _groups[last];
+                _entities[index] = _entities[last];
+                SetIndex(*_entities[index], index);
             }
             _groups.pop_back();
             _entities.pop_back();
+            SetIndex(entity, InvalidIndex);
         }
 
         std::vector<std::tuple<T *...>> &GetGroups()
@@ -112,27 +137,6 @@ namespace Alimer
         std::vector<std::tuple<T *...>> _groups;
         std::vector<Entity*> _entities;
 
-        template <size_t Index>
-        struct HasComponentTraits
-        {
-            template <typename T>
-            static bool HasComponent(const T &t, const Component *component)
-            {
-                return static_cast<Component*>(std::get<Index>(t)) == component
-                    || HasComponentTraits<Index - 1>::HasComponent(t, component);
-            }
-        };
-
-        template <>
-        struct HasComponentTraits<0>
-        {
-            template <typename T>
-            static bool HasComponent(const T &t, const Component *component)
-            {
-                return static_cast<Component*>(std::get<0>(t)) == component;
-            }
-        };
-
         template <typename... Us>
         struct HasAllComponentsTraits;
 
@@ -160,22 +164,43 @@ namespace Alimer
         {
             return HasAllComponentsTraits<Us...>::HasComponent(entity);
         }
+    };
 
-        template <typename... Us>
-        static bool HasComponent(const std::tuple<Us *...> &t, const Component *component)
-        {
-            return HasComponentTraits<sizeof...(Us) - 1>::HasComponent(t, component);
-        }
+    /// Generational handle to an Entity, stays trivially copyable and detects deleted entities.
+    struct EntityId
+    {
+        /// Slot index inside the EntityManager.
+        uint32_t index;
+
+        /// Generation of the slot when the handle was created.
+        uint32_t generation;
+
+        EntityId() noexcept : index(~0u), generation(0) {}
+        constexpr EntityId(uint32_t index_, uint32_t generation_) : index(index_), generation(generation_) {}
+
+        // Comparison operators
+        bool operator == (const EntityId& rhs) const { return index == rhs.index && generation == rhs.generation; }
+        bool operator != (const EntityId& rhs) const { return index != rhs.index || generation != rhs.generation; }
+
+        /// Return the handle packed into 64-bit value.
+        uint64_t GetValue() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+
+        /// Return true if the handle has been assigned, use EntityManager::IsValid to check if the entity is still alive.
+        bool IsNull() const { return index == ~0u; }
+
+        // Constants
+        static const EntityId Invalid;
     };
 
     /// Defines a Entity class.
-    class ALIMER_API Entity final : public Object
+    class ALIMER_API Entity final
     {
-        ALIMER_OBJECT(Entity, Object);
+        friend class EntityManager;
+        friend class EntityGroupBase;
 
     public:
         Entity() = default;
-        Entity(EntityManager *manager) : _manager(manager) {}
+        Entity(EntityManager *manager, EntityId id) : _manager(manager), _id(id) {}
         Entity(const Entity &other) = default;
         Entity &operator = (const Entity &other) = default;
 
@@ -227,20 +252,34 @@ namespace Alimer
             return _manager;
         }
 
+        /// Return the generational handle of this entity.
+        EntityId GetId() const { return _id; }
+
         /// Gets the name of this object.
         std::string GetName() const { return _name; }
 
         /// Sets the name of this object.
         void SetName(const std::string& name);
 
+        /// Return the archetype this entity is packed into or nullptr if components are pool allocated.
+        Archetype* GetArchetype() const { return _archetype; }
+
     private:
         EntityManager * _manager = nullptr;
+        EntityId _id;
         std::string _name;
         std::unordered_map<uint32_t, Component*> _components;
+        Archetype* _archetype = nullptr;
+        ArchetypeChunk* _chunk = nullptr;
+        uint32_t _chunkIndex = 0;
+        /// Index inside EntityManager entities.
+        uint32_t _index = 0;
+        /// Index inside EntityManager loose entities, ~0u while all components are packed into the archetype.
+        uint32_t _looseIndex = ~0u;
+        /// Dense index inside each group, indexed by group id.
+        std::vector<uint32_t> _groupIndices;
     };
 
-    using EntityHandle = SharedPtr<Entity>;
-
     class ComponentAllocatorBase
     {
     public:
@@ -267,9 +306,26 @@ namespace Alimer
         virtual ~EntityManager();
 
         /// Create a new Entity.
-        EntityHandle CreateEntity();
+        EntityId CreateEntity();
+
+        /// Create a new Entity with given components default constructed and packed into archetype chunks.
+        template <typename... T>
+        EntityId CreateEntity();
+
+        /// Delete the entity and all its components, stale handles are ignored.
+        void DeleteEntity(EntityId id);
 
-        void DeleteEntity(Entity *entity);
+        /// Return true if the handle refers to a live entity.
+        bool IsValid(EntityId id) const
+        {
+            return id.index < _slots.size() && _slots[id.index].generation == id.generation && _slots[id.index].entity;
+        }
+
+        /// Return the entity referenced by handle or nullptr if it was deleted.
+        Entity* GetEntity(EntityId id) const
+        {
+            return IsValid(id) ? _slots[id.index].entity : nullptr;
+        }
 
         template <typename... T>
         std::vector<std::tuple<T*...>> &GetComponentGroup()
@@ -279,7 +335,7 @@ namespace Alimer
             if (itr == std::end(_groups))
             {
                 RegisterGroup<T...>(groupId);
-                auto tmp = _groups.insert(std::make_pair(groupId, std::unique_ptr<EntityGroupBase>(new EntityGroup<T...>())));
+                auto tmp = _groups.insert(std::make_pair(groupId, std::unique_ptr<EntityGroupBase>(new EntityGroup<T...>(groupId))));
                 itr = tmp.first;
 
                 auto *group = static_cast<EntityGroup<T...> *>(itr->second.get());
@@ -297,36 +353,117 @@ namespace Alimer
         T *AllocateComponent(Entity &entity, Args&&... args)
         {
             uint32_t id = ComponentIDMapping::GetId<T>();
-            auto itr = _components.find(id);
-            if (itr == _components.end())
+            auto &component = entity.GetComponents()[id];
+            if (component)
             {
-                auto tmp = _components.insert(std::make_pair(id, std::unique_ptr<ComponentAllocatorBase>(new ComponentAllocator<T>)));
-                itr = tmp.first;
+                FreeComponent(id, component);
             }
 
-            auto *allocator = static_cast<ComponentAllocator<T> *>(itr->second.get());
-            auto &component = entity.GetComponents()[id];
-            if (component)
+            uint32_t componentIndex = entity._archetype ? entity._archetype->GetComponentIndex(id) : Archetype::MaxComponents;
+            if (componentIndex != Archetype::MaxComponents)
+            {
+                component = ConstructComponent<T>(entity, componentIndex, std::forward<Args>(args)...);
+            }
+            else
             {
-                allocator->FreeComponent(component);
+                auto itr = _components.find(id);
+                if (itr == _components.end())
+                {
+                    auto tmp = _components.insert(std::make_pair(id, std::unique_ptr<ComponentAllocatorBase>(new ComponentAllocator<T>)));
+                    itr = tmp.first;
+                }
+
+                auto *allocator = static_cast<ComponentAllocator<T> *>(itr->second.get());
                 component = allocator->pool.Allocate(std::forward<Args>(args)...);
                 component->_entity = &entity;
-                for (auto &groupId : _componentToGroups[id])
+                AddLooseEntity(entity);
+            }
+
+            for (auto &groupId : _componentToGroups[id])
+            {
+                _groups[groupId]->AddEntity(entity);
+            }
+
+            return static_cast<T *>(component);
+        }
+
+        /// Iterate all entities containing given components, archetype chunks first then entities with pool allocated components.
+        template <typename... T, typename Func>
+        void ForEach(Func func)
+        {
+            ForEachChunk<T...>([&func](const ArchetypeChunk& chunk, uint32_t required, T*... arrays)
+            {
+                ForEachInChunk<T...>(chunk, required, func, arrays...);
+            });
+            ForEachLoose<T...>(func);
+        }
+
+        /// Iterate archetype chunks containing given components, func receives the chunk, the mask of required components and one array per component.
+        template <typename... T, typename Func>
+        void ForEachChunk(Func func)
+        {
+            const uint32_t ids[] = { ComponentIDMapping::GetId<T>()... };
+            for (auto &itr : _archetypes)
+            {
+                Archetype* archetype = itr.second.get();
+                if (!archetype->HasComponents(ids, sizeof...(T)))
+                    continue;
+
+                uint32_t required = 0;
+                for (uint32_t id : ids)
+                {
+                    required |= 1u << archetype->GetComponentIndex(id);
+                }
+
+                for (auto &chunk : archetype->GetChunks())
                 {
-                    _groups[groupId]->AddEntity(entity);
+                    if (chunk->GetAliveCount() == 0)
+                        continue;
+
+                    func(*chunk, required,
+                        reinterpret_cast<T*>(chunk->GetData(archetype->GetOffset(archetype->GetComponentIndex(ComponentIDMapping::GetId<T>()))))...);
                 }
             }
-            else
+        }
+
+        /// Iterate entities containing given components which are not all packed into one archetype.
+        template <typename... T, typename Func>
+        void ForEachLoose(Func func)
+        {
+            const uint32_t ids[] = { ComponentIDMapping::GetId<T>()... };
+            for (Entity* entity : _looseEntities)
             {
-                component = allocator->pool.Allocate(std::forward<Args>(args)...);
-                component->_entity = &entity;
-                for (auto &groupId : _componentToGroups[id])
+                // Visited through the archetype chunks.
+                if (entity->_archetype && entity->_archetype->HasComponents(ids, sizeof...(T)))
+                    continue;
+
+                bool hasAll = true;
+                for (uint32_t id : ids)
                 {
-                    _groups[groupId]->AddEntity(entity);
+                    hasAll = hasAll && entity->HasComponent(id);
+                }
+
+                if (hasAll)
+                {
+                    func(*entity, *entity->GetComponent<T>()...);
                 }
             }
+        }
 
-            return static_cast<T *>(component);
+        /// Call func for every slot of chunk holding the required components, arrays are the component arrays given by ForEachChunk.
+        template <typename... T, typename Func>
+        static void ForEachInChunk(const ArchetypeChunk &chunk, uint32_t required, Func &func, T*... arrays)
+        {
+            const uint32_t count = chunk.GetCount();
+            const uint32_t* masks = chunk.GetMasks();
+            Entity** entities = chunk.GetEntities();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if ((masks[i] & required) == required)
+                {
+                    func(*entities[i], arrays[i]...);
+                }
+            }
         }
 
         void FreeComponent(uint32_t id, Component *component);
@@ -334,8 +471,55 @@ namespace Alimer
         void ResetGroups();
 
     private:
+        template <typename... T>
+        Archetype* GetArchetype()
+        {
+            std::vector<ArchetypeComponentInfo> components = {
+                { ComponentIDMapping::GetId<T>(), static_cast<uint32_t>(sizeof(T)), static_cast<uint32_t>(alignof(T)) }...
+            };
+
+            std::vector<uint32_t> ids;
+            for (auto &component : components)
+            {
+                ids.push_back(component.id);
+            }
+
+            Hash hash = Archetype::ComputeHash(ids);
+            auto itr = _archetypes.find(hash);
+            if (itr == std::end(_archetypes))
+            {
+                itr = _archetypes.insert(std::make_pair(hash, std::unique_ptr<Archetype>(new Archetype(hash, components)))).first;
+            }
+
+            return itr->second.get();
+        }
+
+        template <typename T, typename... Args>
+        T *ConstructComponent(Entity &entity, uint32_t componentIndex, Args&&... args)
+        {
+            void* memory = entity._archetype->GetComponent(entity._chunk, entity._chunkIndex, componentIndex);
+            T* component = new (memory) T(std::forward<Args>(args)...);
+            component->_entity = &entity;
+            entity._chunk->GetMasks()[entity._chunkIndex] |= 1u << componentIndex;
+            return component;
+        }
+
+        void AddLooseEntity(Entity &entity);
+        void RemoveLooseEntity(Entity &entity);
+
+        struct EntitySlot
+        {
+            Entity* entity;
+            uint32_t generation;
+        };
+
         ObjectPool<Entity> _pool;
+        std::vector<EntitySlot> _slots;
+        std::vector<uint32_t> _freeSlots;
         std::vector<Entity*> _entities;
+        /// Entities with at least one pool allocated component, not reachable through archetype chunks alone.
+        std::vector<Entity*> _looseEntities;
+        HashMap<std::unique_ptr<Archetype>> _archetypes;
         std::unordered_map<uint32_t, std::unique_ptr<EntityGroupBase>> _groups;
         std::unordered_map<uint32_t, std::unique_ptr<ComponentAllocatorBase>> _components;
         std::unordered_map<uint32_t, std::unordered_set<uint32_t>> _componentToGroups;
@@ -376,6 +560,40 @@ namespace Alimer
         DISALLOW_COPY_MOVE_AND_ASSIGN(EntityManager);
     };
 
+    template <typename... T>
+    EntityId EntityManager::CreateEntity()
+    {
+        static_assert(sizeof...(T) > 0, "Archetype requires at least one component");
+
+        EntityId entity = CreateEntity();
+        Entity &target = *_slots[entity.index].entity;
+        target._archetype = GetArchetype<T...>();
+        target._chunk = target._archetype->Allocate(&target, &target._chunkIndex);
+
+        // Construct every component first so groups see the complete entity once.
+        Component* components[] = {
+            target.GetComponents()[ComponentIDMapping::GetId<T>()] =
+                ConstructComponent<T>(target, target._archetype->GetComponentIndex(ComponentIDMapping::GetId<T>()))...
+        };
+        (void)components;
+
+        std::unordered_set<uint32_t> groupIds;
+        const uint32_t ids[] = { ComponentIDMapping::GetId<T>()... };
+        for (uint32_t id : ids)
+        {
+            auto itr = _componentToGroups.find(id);
+            if (itr != std::end(_componentToGroups))
+                groupIds.insert(std::begin(itr->second), std::end(itr->second));
+        }
+
+        for (uint32_t groupId : groupIds)
+        {
+            _groups[groupId]->AddEntity(target);
+        }
+
+        return entity;
+    }
+
     template <typename T, typename... Args>
     T *Entity::AddComponent(Args&&... args)
     {
@@ -386,12 +604,12 @@ namespace Alimer
     void Entity::RemoveComponent()
     {
         auto id = ComponentIDMapping::GetId<T>();
-        auto itr = components.find(id);
-        if (itr != std::end(components))
+        auto itr = _components.find(id);
+        if (itr != std::end(_components))
         {
             assert(itr->second);
-            pool->free_component(id, itr->second);
-            components.erase(itr);
+            _manager->FreeComponent(id, itr->second);
+            _components.erase(itr);
         }
     }
 }
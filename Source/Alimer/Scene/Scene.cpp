@@ -26,16 +26,17 @@
 #include "../Scene/Systems/CameraSystem.h"
 #include "../Scene/Systems/RenderSystem.h"
 #include "../Core/Log.h"
+#include <algorithm>
 using namespace std;
 
 namespace Alimer
 {
 	Scene::Scene()
         : _spatials(_entityManager.GetComponentGroup<TransformComponent>())
+        , _transformsVersion(~0u)
+        , _hierarchyVersion(0)
 	{
-        _defaultCamera = CreateEntity();
-        _defaultCamera->AddComponent<TransformComponent>();
-        _defaultCamera->AddComponent<CameraComponent>();
+        _defaultCamera = CreateEntity<TransformComponent, CameraComponent>();
         //_defaultCamera->AddComponent<AudioListener>();
 
         _activeCamera = _defaultCamera;
@@ -47,12 +48,17 @@ namespace Alimer
 
 	Scene::~Scene()
 	{
+        for (TransformComponent* transform : _transforms)
+        {
+            transform->_scene = nullptr;
+        }
+
         _entityManager.ResetGroups();
 	}
 
-    EntityHandle Scene::CreateEntity()
+    EntityId Scene::CreateEntity()
     {
-        EntityHandle entity = _entityManager.CreateEntity();
+        EntityId entity = _entityManager.CreateEntity();
         _entities.push_back(entity);
         return entity;
     }
@@ -64,10 +70,8 @@ namespace Alimer
 
     void Scene::Update(double deltaTime)
     {
-        for (auto& system : _activeSystems)
-        {
-            system->Update(deltaTime);
-        }
+        UpdateCachedTransforms();
+        _scheduler.Update(_activeSystems, deltaTime);
     }
 
     void Scene::Render(CommandBuffer* commandBuffer)
@@ -77,22 +81,142 @@ namespace Alimer
 
     void Scene::UpdateCachedTransforms()
     {
-        /*const glm::mat4 &parentTransform = glm::mat4(1.0f);
+        // Keep transforms sorted by depth so parents are always updated before their children.
+        // New transforms show up in the group size, cached ones notify this scene when destroyed or reparented.
+        const uint32_t hierarchyVersion = _hierarchyVersion.load(std::memory_order_relaxed);
+        if (_transformsVersion != hierarchyVersion
+            || _transforms.size() != _spatials.size())
+        {
+            _transforms.clear();
+            _transforms.reserve(_spatials.size());
+            for (auto &s : _spatials)
+            {
+                TransformComponent* transform = std::get<0>(s);
+                transform->_scene = this;
+                _transforms.push_back(transform);
+            }
+
+            std::stable_sort(_transforms.begin(), _transforms.end(),
+                [](const TransformComponent* lhs, const TransformComponent* rhs)
+            {
+                return lhs->GetDepth() < rhs->GetDepth();
+            });
+
+            _transformsVersion = hierarchyVersion;
+        }
+
+        // Parents must be final before their children, so compose one depth level at a time.
+        const uint32_t count = static_cast<uint32_t>(_transforms.size());
+        uint32_t levelStart = 0;
+        while (levelStart < count)
+        {
+            const uint32_t depth = _transforms[levelStart]->GetDepth();
+            uint32_t levelEnd = levelStart;
+
+            _transformBatch.Clear();
+            _dirtyTransforms.clear();
+            for (; levelEnd < count && _transforms[levelEnd]->GetDepth() == depth; ++levelEnd)
+            {
+                TransformComponent* transform = _transforms[levelEnd];
+                if (transform->NeedsWorldUpdate())
+                {
+                    const Transform& local = transform->GetTransform();
+                    _transformBatch.Add(local.translation, local.rotation, local.scale);
+                    _dirtyTransforms.push_back(transform);
+                }
+                else
+                {
+                    transform->_worldChanged = false;
+                }
+            }
+
+            if (!_dirtyTransforms.empty())
+            {
+                _localTransforms.resize(_dirtyTransforms.size());
+                _transformBatch.ComputeMatrices(_localTransforms.data());
+                for (size_t i = 0; i < _dirtyTransforms.size(); ++i)
+                {
+                    TransformComponent* transform = _dirtyTransforms[i];
+                    transform->SetWorldTransform(_localTransforms[i]);
+                    if (transform->_spatialProxy == SpatialIndex::InvalidProxy)
+                    {
+                        transform->_spatialProxy = _spatialIndex.Insert(transform->GetWorldBoundingBox(), transform);
+                    }
+                    else
+                    {
+                        _spatialIndex.Update(transform->_spatialProxy, transform->GetWorldBoundingBox());
+                    }
+                }
+            }
+
+            levelStart = levelEnd;
+        }
+    }
+
+    void Scene::RemoveTransform(TransformComponent* transform)
+    {
+        if (transform->_spatialProxy != SpatialIndex::InvalidProxy)
+        {
+            _spatialIndex.Remove(transform->_spatialProxy);
+            transform->_spatialProxy = SpatialIndex::InvalidProxy;
+        }
+
+        transform->_scene = nullptr;
+        InvalidateTransforms();
+    }
+
+    void Scene::Query(const Frustum& frustum, std::vector<TransformComponent*>& result) const
+    {
+        _spatialIndex.Query(frustum, [&frustum, &result](uint32_t, void* userData)
+        {
+            TransformComponent* transform = static_cast<TransformComponent*>(userData);
+            if (frustum.Intersects(transform->GetWorldBoundingBox()))
+            {
+                result.push_back(transform);
+            }
+        });
+    }
+
+    void Scene::Query(const Sphere& sphere, std::vector<TransformComponent*>& result) const
+    {
+        _spatialIndex.Query(sphere, [&sphere, &result](uint32_t, void* userData)
+        {
+            TransformComponent* transform = static_cast<TransformComponent*>(userData);
+            if (sphere.Intersects(transform->GetWorldBoundingBox()))
+            {
+                result.push_back(transform);
+            }
+        });
+    }
+
+    void Scene::Query(const BoundingBox& box, std::vector<TransformComponent*>& result) const
+    {
+        _spatialIndex.Query(box, [&box, &result](uint32_t, void* userData)
+        {
+            TransformComponent* transform = static_cast<TransformComponent*>(userData);
+            if (box.Intersects(transform->GetWorldBoundingBox()))
+            {
+                result.push_back(transform);
+            }
+        });
+    }
+
+    void Scene::Raycast(const Ray& ray, float maxDistance, std::vector<RaycastResult>& result) const
+    {
+        const size_t start = result.size();
+        _spatialIndex.Raycast(ray, maxDistance, [&ray, maxDistance, &result](uint32_t, void* userData, float)
+        {
+            TransformComponent* transform = static_cast<TransformComponent*>(userData);
+            float distance;
+            if (ray.Intersects(transform->GetWorldBoundingBox(), &distance) && distance <= maxDistance)
+            {
+                result.push_back({ transform, distance });
+            }
+        });
 
-        for (auto &s : _spatials)
+        std::sort(result.begin() + start, result.end(), [](const RaycastResult& lhs, const RaycastResult& rhs)
         {
-            TransformComponent *transform;
-            tie(transform) = s;
-            //transform->Update();
-            ComputeTransform(
-                transform->transform.translation, transform->transform.rotation, transform->transform.scale,
-                transform->worldTransform,
-                parentTransform);
-            //std::tie(aabb, cached_transform, timestamp) = s;
-            //if (transform->lastTimestamp != *transform->currentTimestamp)
-            //{
-            //    transform->lastTimestamp = *transform->currentTimestamp;
-            //}
-        }*/
+            return lhs.distance < rhs.distance;
+        });
     }
 }
@@ -24,8 +24,12 @@
 
 #include "../Scene/Entity.h"
 #include "../Scene/ComponentSystem.h"
+#include "../Scene/SystemScheduler.h"
+#include "../Scene/SpatialIndex.h"
 #include "../Math/MathUtil.h"
+#include "../Math/TransformBatch.h"
 #include "../Graphics/Graphics.h"
+#include <atomic>
 
 namespace Alimer
 {
@@ -40,11 +44,18 @@ namespace Alimer
     };
     using VisibilitySet = std::vector<RenderableInfo>;
 
+    struct RaycastResult
+    {
+        TransformComponent *transform;
+        float distance;
+    };
+
 
     /// Defines a scene, which is a container of SceneObject's.
     class Scene final : public Serializable
     {
         ALIMER_OBJECT(Scene, Serializable);
+        friend class TransformComponent;
 
     public:
         /// Constructor.
@@ -54,13 +65,20 @@ namespace Alimer
         ~Scene();
 
         /// Creates a new entity in the Scene.
-        EntityHandle CreateEntity();
+        EntityId CreateEntity();
+
+        /// Creates a new entity in the Scene with given components packed into archetype chunks.
+        template <typename... T>
+        EntityId CreateEntity();
+
+        /// Return the entity referenced by handle or nullptr if it was deleted.
+        Entity* GetEntity(EntityId id) const { return _entityManager.GetEntity(id); }
 
         /// Return the Entity containing the default camera.
-        EntityHandle GetDefaultCamera() const { return _defaultCamera; }
+        EntityId GetDefaultCamera() const { return _defaultCamera; }
 
         /// Return the Entity containing the active camera.
-        EntityHandle GetActiveCamera() const { return _activeCamera; }
+        EntityId GetActiveCamera() const { return _activeCamera; }
 
         EntityManager &GetEntityManager();
 
@@ -70,6 +88,21 @@ namespace Alimer
         /// Render the scene to given command buffer.
         void Render(CommandBuffer* commandBuffer);
 
+        /// Return spatial index of transform world bounds, up to date after Update.
+        const SpatialIndex& GetSpatialIndex() const { return _spatialIndex; }
+
+        /// Gather transforms whose world bounds intersect the frustum.
+        void Query(const Frustum& frustum, std::vector<TransformComponent*>& result) const;
+
+        /// Gather transforms whose world bounds intersect the sphere.
+        void Query(const Sphere& sphere, std::vector<TransformComponent*>& result) const;
+
+        /// Gather transforms whose world bounds intersect the box.
+        void Query(const BoundingBox& box, std::vector<TransformComponent*>& result) const;
+
+        /// Gather transforms whose world bounds are hit by the ray, sorted by distance.
+        void Raycast(const Ray& ray, float maxDistance, std::vector<RaycastResult>& result) const;
+
         /// Creates a new system of the given type and add to system.
         template <typename T, typename... Args>
         T& AddSystem(Args&&... args);
@@ -88,25 +121,47 @@ namespace Alimer
 
     private:
         void UpdateCachedTransforms();
+        /// Request sorting transforms again, called when a cached transform is destroyed or reparented.
+        void InvalidateTransforms() { _hierarchyVersion.fetch_add(1, std::memory_order_relaxed); }
+        /// Drop spatial proxy of a destroyed transform and request sorting transforms again.
+        void RemoveTransform(TransformComponent* transform);
         template <typename T>
         void RemoveFromActive();
 
     protected:
         EntityManager _entityManager;
 
-        EntityHandle _defaultCamera;
-        EntityHandle _activeCamera;
+        EntityId _defaultCamera;
+        EntityId _activeCamera;
 
         std::vector<std::tuple<TransformComponent*>> &_spatials;
+        /// Transforms sorted by hierarchy depth.
+        std::vector<TransformComponent*> _transforms;
+        /// Hierarchy version _transforms was sorted for.
+        uint32_t _transformsVersion;
+        std::atomic<uint32_t> _hierarchyVersion;
+        TransformBatch _transformBatch;
+        std::vector<TransformComponent*> _dirtyTransforms;
+        std::vector<Matrix4x4> _localTransforms;
+        SpatialIndex _spatialIndex;
         
-        std::vector<EntityHandle> _entities;
+        std::vector<EntityId> _entities;
         std::vector<std::unique_ptr<ComponentSystem>> _systems;
         std::vector<ComponentSystem*> _activeSystems;
+        SystemScheduler _scheduler;
 
     private:
         DISALLOW_COPY_MOVE_AND_ASSIGN(Scene);
     };
 
+    template <typename... T>
+    EntityId Scene::CreateEntity()
+    {
+        EntityId entity = _entityManager.CreateEntity<T...>();
+        _entities.push_back(entity);
+        return entity;
+    }
+
     template <typename T, typename... Args>
     T& Scene::AddSystem(Args&&... args)
     {
@@ -127,6 +182,7 @@ namespace Alimer
         _systems.emplace_back(std::make_unique<T>(std::forward<Args>(args)...));
         _systems.back()->SetScene(this);
         _activeSystems.push_back(_systems.back().get());
+        _scheduler.Invalidate();
         return *(dynamic_cast<T*>(_systems.back().get()));
     }
 
@@ -180,5 +236,6 @@ namespace Alimer
         {
             return system->GetType() == type;
         }), std::end(_activeSystems));
+        _scheduler.Invalidate();
     }
 }
@@ -0,0 +1,351 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Scene/SpatialIndex.h"
+#include "../Math/MathUtil.h"
+
+namespace Alimer
+{
+    constexpr uint32_t SpatialIndex::InvalidProxy;
+    constexpr uint32_t SpatialIndex::MaxStackDepth;
+
+    SpatialIndex::SpatialIndex()
+        : _root(InvalidProxy)
+        , _freeList(InvalidProxy)
+        , _proxyCount(0)
+        , _margin(0.1f)
+    {
+    }
+
+    uint32_t SpatialIndex::AllocateNode()
+    {
+        uint32_t index;
+        if (_freeList != InvalidProxy)
+        {
+            index = _freeList;
+            _freeList = _nodes[index].parent;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(_nodes.size());
+            _nodes.emplace_back();
+        }
+
+        Node& node = _nodes[index];
+        node.userData = nullptr;
+        node.parent = InvalidProxy;
+        node.child1 = InvalidProxy;
+        node.child2 = InvalidProxy;
+        node.height = 0;
+        return index;
+    }
+
+    void SpatialIndex::FreeNode(uint32_t node)
+    {
+        _nodes[node].parent = _freeList;
+        _nodes[node].height = -1;
+        _freeList = node;
+    }
+
+    uint32_t SpatialIndex::Insert(const BoundingBox& box, void* userData)
+    {
+        const uint32_t proxy = AllocateNode();
+        const Vector3 margin(_margin);
+        _nodes[proxy].box = BoundingBox(box.min - margin, box.max + margin);
+        _nodes[proxy].userData = userData;
+        InsertLeaf(proxy);
+        _proxyCount++;
+        return proxy;
+    }
+
+    void SpatialIndex::Remove(uint32_t proxy)
+    {
+        ALIMER_ASSERT(proxy < _nodes.size() && _nodes[proxy].IsLeaf() && _nodes[proxy].height == 0);
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        _proxyCount--;
+    }
+
+    bool SpatialIndex::Update(uint32_t proxy, const BoundingBox& box)
+    {
+        ALIMER_ASSERT(proxy < _nodes.size() && _nodes[proxy].IsLeaf());
+
+        // Still inside the enlarged box, nothing to do.
+        if (_nodes[proxy].box.Contains(box))
+            return false;
+
+        RemoveLeaf(proxy);
+        const Vector3 margin(_margin);
+        _nodes[proxy].box = BoundingBox(box.min - margin, box.max + margin);
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void SpatialIndex::Clear()
+    {
+        _nodes.clear();
+        _root = InvalidProxy;
+        _freeList = InvalidProxy;
+        _proxyCount = 0;
+    }
+
+    void SpatialIndex::InsertLeaf(uint32_t leaf)
+    {
+        if (_root == InvalidProxy)
+        {
+            _root = leaf;
+            _nodes[leaf].parent = InvalidProxy;
+            return;
+        }
+
+        // Find the best sibling by descending along the cheapest surface area increase.
+        const BoundingBox leafBox = _nodes[leaf].box;
+        uint32_t index = _root;
+        while (!_nodes[index].IsLeaf())
+        {
+            const Node& node = _nodes[index];
+            const float area = node.box.GetSurfaceArea();
+            const float combinedArea = BoundingBox::Merge(node.box, leafBox).GetSurfaceArea();
+
+            // Cost of creating a new parent for this node and the leaf.
+            const float cost = 2.0f * combinedArea;
+
+            // Minimum cost of pushing the leaf further down the tree.
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            float childCosts[2];
+            const uint32_t children[2] = { node.child1, node.child2 };
+            for (uint32_t i = 0; i < 2; ++i)
+            {
+                const Node& child = _nodes[children[i]];
+                const float mergedArea = BoundingBox::Merge(leafBox, child.box).GetSurfaceArea();
+                childCosts[i] = (child.IsLeaf() ? mergedArea : mergedArea - child.box.GetSurfaceArea()) + inheritanceCost;
+            }
+
+            if (cost < childCosts[0] && cost < childCosts[1])
+                break;
+
+            index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+        }
+
+        const uint32_t sibling = index;
+        const uint32_t oldParent = _nodes[sibling].parent;
+        const uint32_t newParent = AllocateNode();
+        _nodes[newParent].parent = oldParent;
+        _nodes[newParent].box = BoundingBox::Merge(leafBox, _nodes[sibling].box);
+        _nodes[newParent].height = _nodes[sibling].height + 1;
+        _nodes[newParent].child1 = sibling;
+        _nodes[newParent].child2 = leaf;
+        _nodes[sibling].parent = newParent;
+        _nodes[leaf].parent = newParent;
+
+        if (oldParent != InvalidProxy)
+        {
+            if (_nodes[oldParent].child1 == sibling)
+            {
+                _nodes[oldParent].child1 = newParent;
+            }
+            else
+            {
+                _nodes[oldParent].child2 = newParent;
+            }
+        }
+        else
+        {
+            _root = newParent;
+        }
+
+        RefitAncestors(_nodes[leaf].parent);
+    }
+
+    void SpatialIndex::RemoveLeaf(uint32_t leaf)
+    {
+        if (leaf == _root)
+        {
+            _root = InvalidProxy;
+            return;
+        }
+
+        const uint32_t parent = _nodes[leaf].parent;
+        const uint32_t grandParent = _nodes[parent].parent;
+        const uint32_t sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+        if (grandParent != InvalidProxy)
+        {
+            // Replace the parent with the sibling.
+            if (_nodes[grandParent].child1 == parent)
+            {
+                _nodes[grandParent].child1 = sibling;
+            }
+            else
+            {
+                _nodes[grandParent].child2 = sibling;
+            }
+
+            _nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+            RefitAncestors(grandParent);
+        }
+        else
+        {
+            _root = sibling;
+            _nodes[sibling].parent = InvalidProxy;
+            FreeNode(parent);
+        }
+    }
+
+    void SpatialIndex::RefitAncestors(uint32_t index)
+    {
+        while (index != InvalidProxy)
+        {
+            index = Balance(index);
+
+            Node& node = _nodes[index];
+            const Node& child1 = _nodes[node.child1];
+            const Node& child2 = _nodes[node.child2];
+            node.height = 1 + Max(child1.height, child2.height);
+            node.box = BoundingBox::Merge(child1.box, child2.box);
+
+            index = node.parent;
+        }
+    }
+
+    uint32_t SpatialIndex::Balance(uint32_t indexA)
+    {
+        Node& a = _nodes[indexA];
+        if (a.IsLeaf() || a.height < 2)
+            return indexA;
+
+        const uint32_t indexB = a.child1;
+        const uint32_t indexC = a.child2;
+        Node& b = _nodes[indexB];
+        Node& c = _nodes[indexC];
+        const int32_t balance = c.height - b.height;
+
+        // Rotate C up.
+        if (balance > 1)
+        {
+            const uint32_t indexF = c.child1;
+            const uint32_t indexG = c.child2;
+            Node& f = _nodes[indexF];
+            Node& g = _nodes[indexG];
+
+            c.child1 = indexA;
+            c.parent = a.parent;
+            a.parent = indexC;
+
+            if (c.parent != InvalidProxy)
+            {
+                if (_nodes[c.parent].child1 == indexA)
+                {
+                    _nodes[c.parent].child1 = indexC;
+                }
+                else
+                {
+                    _nodes[c.parent].child2 = indexC;
+                }
+            }
+            else
+            {
+                _root = indexC;
+            }
+
+            if (f.height > g.height)
+            {
+                c.child2 = indexF;
+                a.child2 = indexG;
+                g.parent = indexA;
+                a.box = BoundingBox::Merge(b.box, g.box);
+                c.box = BoundingBox::Merge(a.box, f.box);
+                a.height = 1 + Max(b.height, g.height);
+                c.height = 1 + Max(a.height, f.height);
+            }
+            else
+            {
+                c.child2 = indexG;
+                a.child2 = indexF;
+                f.parent = indexA;
+                a.box = BoundingBox::Merge(b.box, f.box);
+                c.box = BoundingBox::Merge(a.box, g.box);
+                a.height = 1 + Max(b.height, f.height);
+                c.height = 1 + Max(a.height, g.height);
+            }
+
+            return indexC;
+        }
+
+        // Rotate B up.
+        if (balance < -1)
+        {
+            const uint32_t indexD = b.child1;
+            const uint32_t indexE = b.child2;
+            Node& d = _nodes[indexD];
+            Node& e = _nodes[indexE];
+
+            b.child1 = indexA;
+            b.parent = a.parent;
+            a.parent = indexB;
+
+            if (b.parent != InvalidProxy)
+            {
+                if (_nodes[b.parent].child1 == indexA)
+                {
+                    _nodes[b.parent].child1 = indexB;
+                }
+                else
+                {
+                    _nodes[b.parent].child2 = indexB;
+                }
+            }
+            else
+            {
+                _root = indexB;
+            }
+
+            if (d.height > e.height)
+            {
+                b.child2 = indexD;
+                a.child1 = indexE;
+                e.parent = indexA;
+                a.box = BoundingBox::Merge(c.box, e.box);
+                b.box = BoundingBox::Merge(a.box, d.box);
+                a.height = 1 + Max(c.height, e.height);
+                b.height = 1 + Max(a.height, d.height);
+            }
+            else
+            {
+                b.child2 = indexE;
+                a.child1 = indexD;
+                d.parent = indexA;
+                a.box = BoundingBox::Merge(c.box, d.box);
+                b.box = BoundingBox::Merge(a.box, e.box);
+                a.height = 1 + Max(c.height, d.height);
+                b.height = 1 + Max(a.height, e.height);
+            }
+
+            return indexB;
+        }
+
+        return indexA;
+    }
+}
@@ -0,0 +1,191 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Math/Sphere.h"
+#include "../Math/Frustum.h"
+#include "../Math/Ray.h"
+#include <vector>
+
+namespace Alimer
+{
+    /// Dynamic bounding box tree, leaves store enlarged boxes so small movements don't restructure the tree.
+    class ALIMER_API SpatialIndex final
+    {
+    public:
+        static constexpr uint32_t InvalidProxy = ~0u;
+
+        /// Constructor.
+        SpatialIndex();
+
+        /// Insert bounding box with user data, returns the proxy handle.
+        uint32_t Insert(const BoundingBox& box, void* userData);
+
+        /// Remove proxy from the tree.
+        void Remove(uint32_t proxy);
+
+        /// Move proxy to new bounding box, returns true if the tree changed.
+        bool Update(uint32_t proxy, const BoundingBox& box);
+
+        /// Remove all proxies.
+        void Clear();
+
+        /// Set distance the stored boxes are enlarged by.
+        void SetMargin(float margin) { _margin = margin; }
+
+        /// Return user data of proxy.
+        void* GetUserData(uint32_t proxy) const { return _nodes[proxy].userData; }
+
+        /// Return enlarged bounding box of proxy.
+        const BoundingBox& GetBoundingBox(uint32_t proxy) const { return _nodes[proxy].box; }
+
+        /// Return number of allocated nodes, every proxy handle is below this value.
+        uint32_t GetCapacity() const { return static_cast<uint32_t>(_nodes.size()); }
+
+        /// Return number of proxies.
+        uint32_t GetProxyCount() const { return _proxyCount; }
+
+        /// Return height of the tree.
+        int32_t GetHeight() const { return _root != InvalidProxy ? _nodes[_root].height : 0; }
+
+        /// Call func(proxy, userData) for every proxy.
+        template <typename Func>
+        void ForEachProxy(Func func) const;
+
+        /// Call func(proxy, userData) for every proxy whose box passes test(box), subtrees failing the test are skipped.
+        template <typename Test, typename Func>
+        void Query(Test test, Func func) const;
+
+        /// Call func(proxy, userData) for every proxy intersecting the frustum.
+        template <typename Func>
+        void Query(const Frustum& frustum, Func func) const
+        {
+            Query([&frustum](const BoundingBox& box) { return frustum.Intersects(box); }, func);
+        }
+
+        /// Call func(proxy, userData) for every proxy intersecting the sphere.
+        template <typename Func>
+        void Query(const Sphere& sphere, Func func) const
+        {
+            Query([&sphere](const BoundingBox& box) { return sphere.Intersects(box); }, func);
+        }
+
+        /// Call func(proxy, userData) for every proxy intersecting the box.
+        template <typename Func>
+        void Query(const BoundingBox& bounds, Func func) const
+        {
+            Query([&bounds](const BoundingBox& box) { return bounds.Intersects(box); }, func);
+        }
+
+        /// Call func(proxy, userData, distance) for every proxy hit by the ray within maxDistance.
+        template <typename Func>
+        void Raycast(const Ray& ray, float maxDistance, Func func) const;
+
+    private:
+        /// Maximum traversal stack depth, balanced trees stay far below.
+        static constexpr uint32_t MaxStackDepth = 256;
+
+        struct Node
+        {
+            BoundingBox box;
+            void* userData;
+            /// Parent node, or next free node when unused.
+            uint32_t parent;
+            uint32_t child1;
+            uint32_t child2;
+            /// Leaf has height 0, free node -1.
+            int32_t height;
+
+            bool IsLeaf() const { return child1 == InvalidProxy; }
+        };
+
+        uint32_t AllocateNode();
+        void FreeNode(uint32_t node);
+        void InsertLeaf(uint32_t leaf);
+        void RemoveLeaf(uint32_t leaf);
+        uint32_t Balance(uint32_t node);
+        void RefitAncestors(uint32_t node);
+
+        std::vector<Node> _nodes;
+        uint32_t _root;
+        uint32_t _freeList;
+        uint32_t _proxyCount;
+        float _margin;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(SpatialIndex);
+    };
+
+    template <typename Func>
+    void SpatialIndex::ForEachProxy(Func func) const
+    {
+        Query([](const BoundingBox&) { return true; }, func);
+    }
+
+    template <typename Test, typename Func>
+    void SpatialIndex::Query(Test test, Func func) const
+    {
+        if (_root == InvalidProxy)
+            return;
+
+        uint32_t stack[MaxStackDepth];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = _root;
+
+        while (stackSize > 0)
+        {
+            const uint32_t index = stack[--stackSize];
+            const Node& node = _nodes[index];
+            if (!test(node.box))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                func(index, node.userData);
+            }
+            else
+            {
+                ALIMER_ASSERT(stackSize + 2 <= MaxStackDepth);
+                stack[stackSize++] = node.child1;
+                stack[stackSize++] = node.child2;
+            }
+        }
+    }
+
+    template <typename Func>
+    void SpatialIndex::Raycast(const Ray& ray, float maxDistance, Func func) const
+    {
+        Query([&ray, maxDistance](const BoundingBox& box)
+        {
+            float distance;
+            return ray.Intersects(box, &distance) && distance <= maxDistance;
+        }, [this, &ray, &func](uint32_t proxy, void* userData)
+        {
+            float distance = 0.0f;
+            ray.Intersects(_nodes[proxy].box, &distance);
+            func(proxy, userData, distance);
+        });
+    }
+}
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Scene/SystemScheduler.h"
+
+namespace Alimer
+{
+    SystemScheduler::SystemScheduler()
+        : _dirty(true)
+    {
+    }
+
+    void SystemScheduler::Build(const std::vector<ComponentSystem*>& systems)
+    {
+        const uint32_t count = static_cast<uint32_t>(systems.size());
+        _nodes.clear();
+        _nodes.resize(count);
+        _pending.reset(new std::atomic<uint32_t>[count]);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _nodes[i].system = systems[i];
+            _nodes[i].dependencyCount = 0;
+
+            // Conflicting systems keep their registration order.
+            for (uint32_t j = 0; j < i; ++j)
+            {
+                if (systems[i]->ConflictsWith(systems[j]))
+                {
+                    _nodes[j].successors.push_back(i);
+                    _nodes[i].dependencyCount++;
+                }
+            }
+        }
+
+        _dirty = false;
+    }
+
+    void SystemScheduler::Update(const std::vector<ComponentSystem*>& systems, double deltaTime)
+    {
+        JobSystem* jobSystem = JobSystem::GetInstance();
+        if (systems.size() < 2
+            || jobSystem == nullptr)
+        {
+            for (auto& system : systems)
+            {
+                system->Update(deltaTime);
+            }
+
+            return;
+        }
+
+        if (_dirty)
+        {
+            Build(systems);
+        }
+
+        const uint32_t count = static_cast<uint32_t>(_nodes.size());
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _pending[i].store(_nodes[i].dependencyCount, std::memory_order_relaxed);
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (_nodes[i].dependencyCount == 0)
+            {
+                jobSystem->Schedule([this, jobSystem, i, deltaTime]() { Execute(jobSystem, i, deltaTime); }, &_counter);
+            }
+        }
+
+        // Main thread helps executing systems until all of them finished.
+        jobSystem->Wait(_counter);
+    }
+
+    void SystemScheduler::Execute(JobSystem* jobSystem, uint32_t index, double deltaTime)
+    {
+        const Node& node = _nodes[index];
+        node.system->Update(deltaTime);
+
+        // Successors are scheduled before this job completes, so the counter can't reach zero early.
+        for (uint32_t successor : node.successors)
+        {
+            if (_pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                jobSystem->Schedule([this, jobSystem, successor, deltaTime]() { Execute(jobSystem, successor, deltaTime); }, &_counter);
+            }
+        }
+    }
+}
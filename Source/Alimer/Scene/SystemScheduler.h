@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Scene/ComponentSystem.h"
+#include "../Core/JobSystem.h"
+
+namespace Alimer
+{
+    /// Schedules ComponentSystem updates, systems with non conflicting component access run concurrently on JobSystem workers.
+    class ALIMER_API SystemScheduler final
+    {
+    public:
+        /// Constructor.
+        SystemScheduler();
+
+        /// Mark dependency graph for rebuild, call when the system list changes.
+        void Invalidate() { _dirty = true; }
+
+        /// Update given systems, respecting registration order between conflicting systems.
+        void Update(const std::vector<ComponentSystem*>& systems, double deltaTime);
+
+    private:
+        struct Node
+        {
+            ComponentSystem* system;
+            uint32_t dependencyCount;
+            std::vector<uint32_t> successors;
+        };
+
+        void Build(const std::vector<ComponentSystem*>& systems);
+        void Execute(JobSystem* jobSystem, uint32_t index, double deltaTime);
+
+        bool _dirty;
+        std::vector<Node> _nodes;
+        std::unique_ptr<std::atomic<uint32_t>[]> _pending;
+        JobCounter _counter;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(SystemScheduler);
+    };
+}
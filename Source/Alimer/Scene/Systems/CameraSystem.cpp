@@ -27,19 +27,17 @@ namespace Alimer
 {
     CameraSystem::CameraSystem(EntityManager& entityManager)
         : ComponentSystem(typeid(CameraSystem))
-        , _cameras(entityManager.GetComponentGroup<CameraComponent, TransformComponent>())
+        , _entityManager(entityManager)
     {
-        
+        Reads<TransformComponent>();
+        Writes<CameraComponent>();
     }
 
     void CameraSystem::Update(double deltaTime)
     {
-        for (auto &c : _cameras)
+        _entityManager.ForEach<CameraComponent, TransformComponent>([](Entity&, CameraComponent& camera, TransformComponent& transform)
         {
-            CameraComponent *camera;
-            TransformComponent *transform;
-            std::tie(camera, transform) = c;
-            //camera->Update(transform->worldTransform);
-        }
+            camera.Update(transform.GetWorldTransform());
+        });
     }
 }
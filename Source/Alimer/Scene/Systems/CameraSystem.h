@@ -38,6 +38,6 @@ namespace Alimer
         void Update(double deltaTime) override;
 
     private:
-        std::vector<std::tuple<CameraComponent*, TransformComponent*>> &_cameras;
+        EntityManager& _entityManager;
 	};
 }
@@ -23,71 +23,236 @@
 #include "../Systems/RenderSystem.h"
 #include "../Scene.h"
 #include "../../Graphics/Graphics.h"
+#include "../../Core/Log.h"
+#include <algorithm>
 
 namespace Alimer
 {
+    constexpr uint32_t RenderSystem::CullChunkSize;
+    constexpr uint32_t RenderSystem::InstanceDataSet;
+    constexpr uint32_t RenderSystem::MaxInstancesPerDraw;
+
     RenderSystem::RenderSystem(EntityManager& entityManager)
         : ComponentSystem(typeid(RenderSystem))
-        , _renderables(entityManager.GetComponentGroup<TransformComponent, RenderableComponent>())
+        , _entityManager(entityManager)
     {
-        
+        Reads<TransformComponent>();
+        Reads<RenderableComponent>();
+        Reads<CameraComponent>();
     }
 
-    // TODO: Add frustum
-    template <typename T>
-    static void GatherVisibleRenderables(VisibilitySet &list, const T &objects)
+    RenderSystem::~RenderSystem()
     {
-        for (auto &o : objects)
-        {
-            TransformComponent *transform = std::get<0>(o);
-            RenderableComponent *renderable = std::get<1>(o);
+        WaitForCulling();
+    }
 
-            if (transform)
-            {
-                // if (frustum.intersects_fast(transform->world_aabb))
-                list.push_back({ renderable, transform });
-            }
-            else
+    static void GatherVisibleRenderables(VisibilitySet &list, const RenderSystem::CullChunk* chunks, size_t count, const Frustum &frustum)
+    {
+        auto gather = [&list, &frustum](Entity&, TransformComponent& transform, RenderableComponent& renderable)
+        {
+            if (frustum.Intersects(transform.GetWorldBoundingBox()))
             {
-                list.push_back({ renderable, nullptr });
+                list.push_back({ &renderable, &transform });
             }
+        };
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            EntityManager::ForEachInChunk<TransformComponent, RenderableComponent>(
+                *chunks[i].chunk, chunks[i].required, gather, chunks[i].transforms, chunks[i].renderables);
         }
     }
 
     void RenderSystem::Update(double deltaTime)
     {
         // Gather visibles.
+        WaitForCulling();
         _visibleSet.clear();
 
-        // TODO: Add async culling.
-        if (_renderables.size())
+        Entity* cameraEntity = _scene->GetEntity(_scene->GetActiveCamera());
+        CameraComponent* activeCamera = cameraEntity ? cameraEntity->GetComponent<CameraComponent>() : nullptr;
+        if (!activeCamera)
+            return;
+
+        _view = activeCamera->GetView();
+        _cullFrustum = activeCamera->GetFrustum();
+
+        // Renderables with pool allocated components are few, cull them right away.
+        _entityManager.ForEachLoose<TransformComponent, RenderableComponent>([this](Entity&, TransformComponent& transform, RenderableComponent& renderable)
         {
-            CameraComponent* activeCamera = _scene->GetActiveCamera()->GetComponent<CameraComponent>();
+            if (_cullFrustum.Intersects(transform.GetWorldBoundingBox()))
+            {
+                _visibleSet.push_back({ &renderable, &transform });
+            }
+        });
+
+        // Archetype chunks are grouped into jobs of about CullChunkSize slots.
+        _cullChunks.clear();
+        _cullJobs.clear();
+        uint32_t jobSlots = 0;
+        _entityManager.ForEachChunk<TransformComponent, RenderableComponent>([this, &jobSlots](const ArchetypeChunk& chunk, uint32_t required, TransformComponent* transforms, RenderableComponent* renderables)
+        {
+            if (_cullJobs.empty() || jobSlots >= CullChunkSize)
+            {
+                _cullJobs.push_back(static_cast<uint32_t>(_cullChunks.size()));
+                jobSlots = 0;
+            }
+
+            _cullChunks.push_back({ &chunk, required, transforms, renderables });
+            jobSlots += chunk.GetCount();
+        });
 
-            GatherVisibleRenderables(_visibleSet, _renderables);
+        const uint32_t jobCount = static_cast<uint32_t>(_cullJobs.size());
+        if (jobCount == 0)
+            return;
 
-            /*for (auto &c : _renderables)
+        _cullJobs.push_back(static_cast<uint32_t>(_cullChunks.size()));
+
+        JobSystem* jobSystem = JobSystem::GetInstance();
+        if (jobSystem == nullptr || jobCount == 1)
+        {
+            GatherVisibleRenderables(_visibleSet, _cullChunks.data(), _cullChunks.size(), _cullFrustum);
+            return;
+        }
+
+        // Cull chunks in parallel into their own lists, merged once all jobs finished.
+        _chunkVisibleSets.resize(jobCount);
+        for (uint32_t job = 0; job < jobCount; ++job)
+        {
+            jobSystem->Schedule([this, job]()
             {
-                TransformComponent *transform;
-                RenderableComponent *renderable;
-                std::tie(transform, renderable) = c;
-            }*/
+                const uint32_t begin = _cullJobs[job];
+                VisibilitySet& list = _chunkVisibleSets[job];
+                list.clear();
+                GatherVisibleRenderables(list, _cullChunks.data() + begin, _cullJobs[job + 1] - begin, _cullFrustum);
+            }, &_cullCounter);
+        }
+
+        _cullPending = true;
+        if (!_asyncCulling)
+        {
+            WaitForCulling();
+        }
+    }
+
+    void RenderSystem::WaitForCulling()
+    {
+        if (!_cullPending)
+            return;
+
+        gJobSystem().Wait(_cullCounter);
+        _cullPending = false;
+
+        size_t visibleCount = 0;
+        for (const auto& list : _chunkVisibleSets)
+        {
+            visibleCount += list.size();
+        }
+
+        _visibleSet.reserve(_visibleSet.size() + visibleCount);
+        for (const auto& list : _chunkVisibleSets)
+        {
+            _visibleSet.insert(_visibleSet.end(), list.begin(), list.end());
         }
     }
 
+    const VisibilitySet& RenderSystem::GetVisibleSet()
+    {
+        WaitForCulling();
+        return _visibleSet;
+    }
+
     void RenderSystem::Render(CommandBuffer* commandBuffer)
     {
+        WaitForCulling();
+
+        // Queue visibles by state and view depth, merging shared mesh and material into instanced batches.
+        _renderQueue.Clear();
+        _renderQueue.Reserve(static_cast<uint32_t>(_visibleSet.size()));
+        for (const RenderableInfo& visible : _visibleSet)
+        {
+            float depth = 0.0f;
+            if (visible.transform)
+            {
+                // Right handed view space looks down negative z.
+                const Vector3 center = visible.transform->GetWorldBoundingBox().GetCenter();
+                depth = -(center.x * _view._13 + center.y * _view._23 + center.z * _view._33 + _view._43);
+            }
+
+            _renderQueue.Push(visible, depth);
+        }
+        _renderQueue.Sort();
+
         commandBuffer->BeginRenderPass(nullptr, Color(0.0f, 0.2f, 0.4f, 1.0f));
 
         // Bind per camera UBO
         //commandBuffer->SetUniformBuffer(0, 0, _perCameraUboBuffer.Get());
 
-        for (auto &visible : _visibleSet)
+        const RenderableInfo* instances = _renderQueue.GetInstances().data();
+        Shader* currentShader = nullptr;
+        for (const RenderBatch& batch : _renderQueue.GetBatches())
         {
-            //visible.renderable->Render(commandBuffer);
-            //visible.renderable->Render(context, vis.transform, queue);
+            if (batch.shader && batch.shader != currentShader)
+            {
+                commandBuffer->SetShader(batch.shader);
+                currentShader = batch.shader;
+            }
+
+            const RenderableInfo& first = instances[batch.start];
+            Mesh* mesh = first.renderable->GetMesh();
+            if (mesh && mesh->GetVertexBuffer())
+            {
+                DrawBatch(commandBuffer, mesh, &first, batch.count);
+            }
+            else
+            {
+                // Renderables without mesh geometry record their own draws.
+                first.renderable->Render(commandBuffer, &first, batch.count);
+            }
         }
 
         commandBuffer->EndRenderPass();
     }
+
+    void RenderSystem::DrawBatch(CommandBuffer* commandBuffer, Mesh* mesh, const RenderableInfo* instances, uint32_t instanceCount)
+    {
+        VertexBuffer* vertexBuffer = mesh->GetVertexBuffer();
+        IndexBuffer* indexBuffer = mesh->GetIndexBuffer();
+        commandBuffer->SetVertexBuffer(0, vertexBuffer);
+        if (indexBuffer)
+        {
+            commandBuffer->SetIndexBuffer(indexBuffer);
+        }
+
+        // World matrices of the instances are read by gl_InstanceIndex, split in draws the uniform range can hold.
+        for (uint32_t start = 0; start < instanceCount; start += MaxInstancesPerDraw)
+        {
+            const uint32_t count = std::min(instanceCount - start, MaxInstancesPerDraw);
+            const uint64_t size = count * sizeof(Matrix4x4);
+            TransientAllocation allocation = commandBuffer->AllocateUniform(size);
+            if (!allocation.data)
+            {
+                // Remaining instances of the batch have nowhere to store their world matrices.
+                ALIMER_LOGERROR("RenderSystem - Failed to allocate instance data, skipping {} instances.", instanceCount - start);
+                break;
+            }
+
+            Matrix4x4* worldMatrices = reinterpret_cast<Matrix4x4*>(allocation.data);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const TransformComponent* transform = instances[start + i].transform;
+                worldMatrices[i] = transform ? transform->GetWorldTransform() : Matrix4x4::Identity;
+            }
+
+            commandBuffer->SetUniformBuffer(InstanceDataSet, 0, allocation, size);
+            if (indexBuffer)
+            {
+                commandBuffer->DrawIndexed(mesh->GetPrimitiveTopology(), indexBuffer->GetIndexCount(), count);
+            }
+            else
+            {
+                commandBuffer->Draw(mesh->GetPrimitiveTopology(), vertexBuffer->GetVertexCount(), count);
+            }
+        }
+    }
 }
@@ -26,6 +26,8 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/CameraComponent.h"
 #include "../Components/Renderable.h"
+#include "../../Renderer/RenderQueue.h"
+#include "../../Core/JobSystem.h"
 
 namespace Alimer
 {
@@ -36,13 +38,56 @@ namespace Alimer
 	{
     public:
         RenderSystem(EntityManager& entityManager);
+        ~RenderSystem() override;
 
         void Update(double deltaTime) override;
 
         void Render(CommandBuffer* commandBuffer);
 
+        /// Set whether Update returns before culling jobs finish, letting them overlap with work done until Render.
+        /// Entities with renderables must not be created or destroyed in between.
+        void SetAsyncCulling(bool enabled) { _asyncCulling = enabled; }
+
+        /// Return true if culling overlaps with work done until Render.
+        bool IsAsyncCulling() const { return _asyncCulling; }
+
+        /// Return renderables visible from the active camera, waits for pending culling jobs.
+        const VisibilitySet& GetVisibleSet();
+
+        /// Archetype chunk holding transform and renderable arrays, culled by a single job.
+        struct CullChunk
+        {
+            const ArchetypeChunk* chunk;
+            uint32_t required;
+            TransformComponent* transforms;
+            RenderableComponent* renderables;
+        };
+
     private:
-        std::vector<std::tuple<TransformComponent*, RenderableComponent*>> &_renderables;
+        void WaitForCulling();
+        void DrawBatch(CommandBuffer* commandBuffer, Mesh* mesh, const RenderableInfo* instances, uint32_t instanceCount);
+
+        /// Number of archetype slots culled by a single job.
+        static constexpr uint32_t CullChunkSize = 1024;
+        /// Descriptor set of per instance data, matches DESCRIPTOR_SET_INDEX_INSTANCES in alimer.glsl.
+        static constexpr uint32_t InstanceDataSet = 1;
+        /// Maximum instances per draw, world matrices fit the minimum guaranteed uniform range of 16KB.
+        static constexpr uint32_t MaxInstancesPerDraw = 256;
+
+        EntityManager& _entityManager;
         VisibilitySet _visibleSet;
+        /// Chunks to cull this frame.
+        std::vector<CullChunk> _cullChunks;
+        /// First chunk of each culling job, followed by the chunk count.
+        std::vector<uint32_t> _cullJobs;
+        /// Visibility lists filled by culling jobs, one per job.
+        std::vector<VisibilitySet> _chunkVisibleSets;
+        Frustum _cullFrustum;
+        /// View matrix of the camera visibility was gathered for, used to compute sort depth.
+        Matrix4x4 _view;
+        RenderQueue _renderQueue;
+        JobCounter _cullCounter;
+        bool _cullPending = false;
+        bool _asyncCulling = false;
 	};
 }
@@ -0,0 +1,387 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+#include <tuple>
+#include <utility>
+
+namespace Alimer
+{
+    /// Open addressing map with 64-bit hash keys, using Robin Hood linear probing over flat arrays.
+    /// Iterators and element references are invalidated by insertion and erasure.
+    template <typename T>
+    class FlatHashMap
+    {
+    public:
+        using key_type = uint64_t;
+        using mapped_type = T;
+        using value_type = std::pair<uint64_t, T>;
+        using size_type = size_t;
+
+        template <typename Map, typename Value>
+        class IteratorBase
+        {
+        public:
+            IteratorBase() = default;
+            IteratorBase(Map* map, size_t index) : _map(map), _index(index)
+            {
+                SkipEmpty();
+            }
+
+            /// Allow conversion of iterator to const iterator.
+            template <typename OtherMap, typename OtherValue>
+            IteratorBase(const IteratorBase<OtherMap, OtherValue>& other) : _map(other._map), _index(other._index)
+            {
+            }
+
+            Value& operator*() const { return _map->_slots[_index]; }
+            Value* operator->() const { return &_map->_slots[_index]; }
+
+            IteratorBase& operator++()
+            {
+                ++_index;
+                SkipEmpty();
+                return *this;
+            }
+
+            IteratorBase operator++(int)
+            {
+                IteratorBase result = *this;
+                ++*this;
+                return result;
+            }
+
+            bool operator==(const IteratorBase& other) const { return _index == other._index; }
+            bool operator!=(const IteratorBase& other) const { return _index != other._index; }
+
+        private:
+            template <typename, typename> friend class IteratorBase;
+            friend class FlatHashMap;
+
+            void SkipEmpty()
+            {
+                while (_index < _map->_capacity && _map->_distances[_index] == 0)
+                    ++_index;
+            }
+
+            Map* _map = nullptr;
+            size_t _index = 0;
+        };
+
+        using iterator = IteratorBase<FlatHashMap, value_type>;
+        using const_iterator = IteratorBase<const FlatHashMap, const value_type>;
+
+        FlatHashMap() = default;
+
+        FlatHashMap(const FlatHashMap& other)
+        {
+            reserve(other._size);
+            for (const value_type& value : other)
+                emplace(value.first, value.second);
+        }
+
+        FlatHashMap(FlatHashMap&& other) noexcept
+        {
+            swap(other);
+        }
+
+        ~FlatHashMap()
+        {
+            clear();
+            Deallocate();
+        }
+
+        FlatHashMap& operator=(const FlatHashMap& other)
+        {
+            if (this != &other)
+            {
+                FlatHashMap copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        FlatHashMap& operator=(FlatHashMap&& other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        void swap(FlatHashMap& other) noexcept
+        {
+            std::swap(_slots, other._slots);
+            std::swap(_distances, other._distances);
+            std::swap(_capacity, other._capacity);
+            std::swap(_size, other._size);
+            std::swap(_shift, other._shift);
+            std::swap(_seed, other._seed);
+        }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, _capacity); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, _capacity); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        friend iterator begin(FlatHashMap& map) { return map.begin(); }
+        friend iterator end(FlatHashMap& map) { return map.end(); }
+        friend const_iterator begin(const FlatHashMap& map) { return map.begin(); }
+        friend const_iterator end(const FlatHashMap& map) { return map.end(); }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        /// Destroy all elements, keeping the allocated storage.
+        void clear()
+        {
+            for (size_t i = 0; i < _capacity && _size > 0; ++i)
+            {
+                if (_distances[i] != 0)
+                {
+                    _slots[i].~value_type();
+                    _distances[i] = 0;
+                    --_size;
+                }
+            }
+        }
+
+        /// Grow storage to hold count elements without rehashing.
+        void reserve(size_t count)
+        {
+            size_t capacity = MinCapacity;
+            while (capacity - capacity / MaxLoadDivisor < count)
+                capacity <<= 1;
+
+            if (capacity > _capacity)
+                Rehash(capacity);
+        }
+
+        iterator find(key_type key)
+        {
+            return iterator(this, FindIndex(key));
+        }
+
+        const_iterator find(key_type key) const
+        {
+            return const_iterator(this, FindIndex(key));
+        }
+
+        size_t count(key_type key) const
+        {
+            return FindIndex(key) != _capacity ? 1 : 0;
+        }
+
+        T& operator[](key_type key)
+        {
+            return emplace(key).first->second;
+        }
+
+        template <typename... P>
+        std::pair<iterator, bool> emplace(key_type key, P&&... p)
+        {
+            size_t index = FindIndex(key);
+            if (index != _capacity)
+                return std::make_pair(iterator(this, index), false);
+
+            if (_size + 1 > _capacity - _capacity / MaxLoadDivisor)
+                Rehash(_capacity != 0 ? _capacity * 2 : MinCapacity);
+
+            value_type value(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<P>(p)...));
+            index = Insert(std::move(value));
+            if (index == _capacity)
+                index = FindIndex(key);
+
+            return std::make_pair(iterator(this, index), true);
+        }
+
+        template <typename P>
+        std::pair<iterator, bool> insert(P&& value)
+        {
+            return emplace(value.first, std::forward<P>(value).second);
+        }
+
+        /// Erase element, later elements of the probe sequence shift back so no tombstones are left.
+        void erase(const_iterator it)
+        {
+            EraseIndex(it._index);
+        }
+
+        size_t erase(key_type key)
+        {
+            size_t index = FindIndex(key);
+            if (index == _capacity)
+                return 0;
+
+            EraseIndex(index);
+            return 1;
+        }
+
+    private:
+        static constexpr size_t MinCapacity = 16;
+        /// Grow once more than 7/8 of the slots are used.
+        static constexpr size_t MaxLoadDivisor = 8;
+        /// Probe distances are stored plus one in a byte, zero marks an empty slot.
+        static constexpr uint32_t MaxDistance = 255;
+
+        size_t HomeIndex(key_type key) const
+        {
+            // Fibonacci hashing spreads keys that only differ in their low or high bits.
+            return static_cast<size_t>(((key ^ _seed) * 0x9e3779b97f4a7c15ull) >> _shift);
+        }
+
+        size_t FindIndex(key_type key) const
+        {
+            if (_size == 0)
+                return _capacity;
+
+            const size_t mask = _capacity - 1;
+            size_t index = HomeIndex(key);
+            for (uint32_t distance = 1; distance <= _distances[index]; ++distance)
+            {
+                if (_slots[index].first == key)
+                    return index;
+
+                index = (index + 1) & mask;
+            }
+
+            return _capacity;
+        }
+
+        /// Place value known not to be present, return its slot or capacity when the table had to grow.
+        size_t Insert(value_type&& value)
+        {
+            const size_t mask = _capacity - 1;
+            size_t index = HomeIndex(value.first);
+            size_t result = _capacity;
+            uint32_t distance = 1;
+            for (;;)
+            {
+                if (_distances[index] == 0)
+                {
+                    new (&_slots[index]) value_type(std::move(value));
+                    _distances[index] = static_cast<uint8_t>(distance);
+                    ++_size;
+                    return result != _capacity ? result : index;
+                }
+
+                // Rich slots give way to poor ones, bounding the variance of probe lengths.
+                if (_distances[index] < distance)
+                {
+                    if (result == _capacity)
+                        result = index;
+
+                    std::swap(value, _slots[index]);
+                    uint32_t swapped = _distances[index];
+                    _distances[index] = static_cast<uint8_t>(distance);
+                    distance = swapped;
+                }
+
+                index = (index + 1) & mask;
+                if (++distance > MaxDistance)
+                {
+                    // Grow and place the element still carried, slots moved so the caller looks the key up again.
+                    // A sparse table means keys cluster on the same home slots, so change the seed instead of growing.
+                    value_type carried(std::move(value));
+                    if (_size * 2 < _capacity)
+                    {
+                        _seed += 0x9e3779b97f4a7c15ull;
+                        Rehash(_capacity);
+                    }
+                    else
+                    {
+                        Rehash(_capacity * 2);
+                    }
+                    Insert(std::move(carried));
+                    return _capacity;
+                }
+            }
+        }
+
+        void EraseIndex(size_t index)
+        {
+            const size_t mask = _capacity - 1;
+            _slots[index].~value_type();
+            --_size;
+
+            size_t next = (index + 1) & mask;
+            while (_distances[next] > 1)
+            {
+                new (&_slots[index]) value_type(std::move(_slots[next]));
+                _slots[next].~value_type();
+                _distances[index] = static_cast<uint8_t>(_distances[next] - 1);
+                index = next;
+                next = (next + 1) & mask;
+            }
+
+            _distances[index] = 0;
+        }
+
+        void Rehash(size_t capacity)
+        {
+            value_type* oldSlots = _slots;
+            uint8_t* oldDistances = _distances;
+            size_t oldCapacity = _capacity;
+
+            _slots = static_cast<value_type*>(::operator new(capacity * sizeof(value_type)));
+            _distances = static_cast<uint8_t*>(calloc(capacity, 1));
+            _capacity = capacity;
+            _size = 0;
+            _shift = 64;
+            for (size_t i = capacity; i > 1; i >>= 1)
+                --_shift;
+
+            for (size_t i = 0; i < oldCapacity; ++i)
+            {
+                if (oldDistances[i] != 0)
+                {
+                    Insert(std::move(oldSlots[i]));
+                    oldSlots[i].~value_type();
+                }
+            }
+
+            ::operator delete(oldSlots);
+            free(oldDistances);
+        }
+
+        void Deallocate()
+        {
+            ::operator delete(_slots);
+            free(_distances);
+            _slots = nullptr;
+            _distances = nullptr;
+            _capacity = 0;
+        }
+
+        value_type* _slots = nullptr;
+        uint8_t* _distances = nullptr;
+        size_t _capacity = 0;
+        size_t _size = 0;
+        uint32_t _shift = 64;
+        uint64_t _seed = 0;
+    };
+}
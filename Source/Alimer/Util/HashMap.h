@@ -24,10 +24,15 @@
 // Licensed under MIT: https://github.com/Themaister/Granite/blob/master/LICENSE
 
 #pragma once
+#include "../Util/FlatHashMap.h"
 #include <memory>
 #include <stdint.h>
+#include <string.h>
 #include <unordered_map>
 #include <string>
+#if defined(_MSC_VER) && defined(_M_X64)
+#	include <intrin.h>
+#endif
 
 namespace Alimer
 {
@@ -41,9 +46,11 @@ namespace Alimer
 		}
 	};
 
+	/// Map from precomputed hash, open addressing keeps lookups in hot caches within a few cache lines.
 	template <typename T>
-	using HashMap = std::unordered_map<Hash, T, UnityHasher>;
+	using HashMap = FlatHashMap<T>;
 
+	/// Incremental 64-bit hasher, wyhash style: every step folds a 64x64 bit multiply and bulk data is consumed 16 to 48 bytes per step.
 	class Hasher
 	{
 	public:
@@ -56,16 +63,12 @@ namespace Alimer
 		template <typename T>
 		inline void data(const T *data, size_t size)
 		{
-			size /= sizeof(*data);
-            for (size_t i = 0; i < size; i++)
-            {
-                _value = (_value * 0x100000001b3ull) ^ data[i];
-            }
+			bytes(reinterpret_cast<const uint8_t*>(data), size);
 		}
 
 		inline void u32(uint32_t value)
 		{
-            _value = (_value * 0x100000001b3ull) ^ value;
+            _value = Mix(value ^ Prime1, _value ^ Prime0);
 		}
 
 		inline void s32(int32_t value)
@@ -86,8 +89,7 @@ namespace Alimer
 
 		inline void u64(uint64_t value)
 		{
-			u32(value & 0xffffffffu);
-			u32(value >> 32);
+            _value = Mix(value ^ Prime1, _value ^ Prime0);
 		}
 
         template <typename T>
@@ -98,17 +100,12 @@ namespace Alimer
 
 		inline void string(const char *str)
 		{
-            char c;
-            u32(0xff);
-            while ((c = *str++) != '\0')
-                u32(uint8_t(c));
+            bytes(reinterpret_cast<const uint8_t*>(str), strlen(str));
 		}
 
         inline void string(const std::string &str)
         {
-            u32(0xff);
-            for (auto &c : str)
-                u32(uint8_t(c));
+            bytes(reinterpret_cast<const uint8_t*>(str.data()), str.size());
         }
 
 		inline Hash get() const
@@ -117,6 +114,103 @@ namespace Alimer
 		}
 
 	private:
+        static constexpr uint64_t Prime0 = 0xa0761d6478bd642full;
+        static constexpr uint64_t Prime1 = 0xe7037ed1a0b428dbull;
+        static constexpr uint64_t Prime2 = 0x8ebc6af09c88c6e3ull;
+        static constexpr uint64_t Prime3 = 0x589965cc75374cc3ull;
+
+        /// Multiply to 128 bits and fold the halves.
+        static inline uint64_t Mix(uint64_t a, uint64_t b)
+        {
+#if defined(__SIZEOF_INT128__)
+            __uint128_t r = static_cast<__uint128_t>(a) * b;
+            return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            uint64_t high;
+            uint64_t low = _umul128(a, b, &high);
+            return low ^ high;
+#else
+            uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+            uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            uint64_t t = rl + (rm0 << 32);
+            uint64_t carry = t < rl;
+            uint64_t low = t + (rm1 << 32);
+            carry += low < t;
+            uint64_t high = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+            return low ^ high;
+#endif
+        }
+
+        static inline uint64_t Read64(const uint8_t* p)
+        {
+            uint64_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        static inline uint64_t Read32(const uint8_t* p)
+        {
+            uint32_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline void bytes(const uint8_t* p, size_t size)
+        {
+            uint64_t seed = _value ^ Prime0;
+            uint64_t a;
+            uint64_t b;
+            if (size <= 16)
+            {
+                if (size >= 4)
+                {
+                    // Overlapping reads cover 4 to 16 bytes without branching per byte.
+                    const size_t offset = (size >> 3) << 2;
+                    a = (Read32(p) << 32) | Read32(p + offset);
+                    b = (Read32(p + size - 4) << 32) | Read32(p + size - 4 - offset);
+                }
+                else if (size > 0)
+                {
+                    a = (uint64_t(p[0]) << 16) | (uint64_t(p[size >> 1]) << 8) | p[size - 1];
+                    b = 0;
+                }
+                else
+                {
+                    a = b = 0;
+                }
+            }
+            else
+            {
+                size_t remaining = size;
+                if (remaining > 48)
+                {
+                    uint64_t seed1 = seed;
+                    uint64_t seed2 = seed;
+                    do
+                    {
+                        seed = Mix(Read64(p) ^ Prime1, Read64(p + 8) ^ seed);
+                        seed1 = Mix(Read64(p + 16) ^ Prime2, Read64(p + 24) ^ seed1);
+                        seed2 = Mix(Read64(p + 32) ^ Prime3, Read64(p + 40) ^ seed2);
+                        p += 48;
+                        remaining -= 48;
+                    } while (remaining > 48);
+                    seed ^= seed1 ^ seed2;
+                }
+
+                while (remaining > 16)
+                {
+                    seed = Mix(Read64(p) ^ Prime1, Read64(p + 8) ^ seed);
+                    p += 16;
+                    remaining -= 16;
+                }
+
+                a = Read64(p + remaining - 16);
+                b = Read64(p + remaining - 8);
+            }
+
+            _value = Mix(Prime1 ^ size, Mix(a ^ Prime1, b ^ seed));
+        }
+
 		Hash _value = 0xcbf49ce238222325ull;
 	};
 }
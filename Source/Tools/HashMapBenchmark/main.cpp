@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Util/HashMap.h"
+#include <chrono>
+#include <stdio.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    /// Previous HashMap implementation, kept as baseline.
+    template <typename T>
+    using NodeHashMap = std::unordered_map<Hash, T, UnityHasher>;
+
+    struct Timings
+    {
+        double insert;
+        double hit;
+        double miss;
+        double erase;
+    };
+
+    /// Keys as produced by the renderer caches, hashes of small state blocks.
+    std::vector<Hash> MakeKeys(size_t count, uint32_t seed)
+    {
+        std::vector<Hash> keys(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Hasher hasher;
+            hasher.u32(seed);
+            hasher.u64(i);
+            keys[i] = hasher.get();
+        }
+        return keys;
+    }
+
+    template <typename Clock>
+    double NanosecondsPerOp(typename Clock::time_point start, size_t ops)
+    {
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        return elapsed.count() / double(ops);
+    }
+
+    template <typename Map>
+    Timings Run(const std::vector<Hash>& keys, const std::vector<Hash>& missingKeys, size_t lookupRounds, uint64_t& sink)
+    {
+        using Clock = std::chrono::steady_clock;
+        Timings timings;
+        Map map;
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < keys.size(); ++i)
+            map[keys[i]] = i;
+        timings.insert = NanosecondsPerOp<Clock>(start, keys.size());
+
+        start = Clock::now();
+        for (size_t round = 0; round < lookupRounds; ++round)
+        {
+            for (Hash key : keys)
+            {
+                auto it = map.find(key);
+                if (it != map.end())
+                    sink += it->second;
+            }
+        }
+        timings.hit = NanosecondsPerOp<Clock>(start, keys.size() * lookupRounds);
+
+        start = Clock::now();
+        for (size_t round = 0; round < lookupRounds; ++round)
+        {
+            for (Hash key : missingKeys)
+            {
+                if (map.find(key) != map.end())
+                    ++sink;
+            }
+        }
+        timings.miss = NanosecondsPerOp<Clock>(start, missingKeys.size() * lookupRounds);
+
+        start = Clock::now();
+        for (Hash key : keys)
+            sink += map.erase(key);
+        timings.erase = NanosecondsPerOp<Clock>(start, keys.size());
+
+        return timings;
+    }
+}
+
+int main()
+{
+    static const size_t counts[] = { 64, 1024, 16384, 262144 };
+    // Roughly the same number of lookups for every size.
+    static const size_t totalLookups = 1 << 24;
+
+    uint64_t sink = 0;
+    printf("%10s %-14s %10s %10s %10s %10s\n", "elements", "map", "insert", "hit", "miss", "erase");
+    for (size_t count : counts)
+    {
+        const std::vector<Hash> keys = MakeKeys(count, 0);
+        const std::vector<Hash> missingKeys = MakeKeys(count, 1);
+        const size_t lookupRounds = totalLookups / count;
+
+        Timings node = Run<NodeHashMap<size_t>>(keys, missingKeys, lookupRounds, sink);
+        Timings flat = Run<HashMap<size_t>>(keys, missingKeys, lookupRounds, sink);
+
+        printf("%10zu %-14s %10.2f %10.2f %10.2f %10.2f\n", count, "unordered_map", node.insert, node.hit, node.miss, node.erase);
+        printf("%10zu %-14s %10.2f %10.2f %10.2f %10.2f\n", count, "HashMap", flat.insert, flat.hit, flat.miss, flat.erase);
+    }
+    printf("ns per operation (checksum %llu)\n", static_cast<unsigned long long>(sink));
+    return 0;
+}
@@ -9,4 +9,16 @@ layout (set = DESCRIPTOR_SET_INDEX_COMMON, binding = 0) uniform AlimerPerCamera
 	mat4 projectionMatrix;
 } camera;
 
+#ifdef ALIMER_INSTANCED
+#define DESCRIPTOR_SET_INDEX_INSTANCES	1
+#define ALIMER_MAX_INSTANCES	256
+
+layout (set = DESCRIPTOR_SET_INDEX_INSTANCES, binding = 0) uniform AlimerPerInstance
+{
+	mat4 worldMatrices[ALIMER_MAX_INSTANCES];
+} instances;
+
+#define ALIMER_WORLD_MATRIX instances.worldMatrices[gl_InstanceIndex]
+#endif
+
 #endif